@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2024  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,25 +19,32 @@
 */
 
 #include "Bot.hpp"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
+#include "../util/ActivityMeter.hpp"
 #include "../util/chrono.hpp"
 #include "FailCounter.hpp"
+#include "plugins/AsyncPlugin.hpp"
 
 namespace bvn
 {
 
+const unsigned int Bot::worker_threads = 4;
+
 Bot::Bot(const Configuration& conf)
 : mat(conf),
-  commands({}),
-  stopped(false)
+  commands(),
+  stopped(false),
+  workers(worker_threads),
+  pending()
 {
 }
 
 bool Bot::registerPlugin(Plugin& plug)
 {
-  const auto pluginCommands = plug.commands();
+  const auto& pluginCommands = plug.commands();
   if (pluginCommands.empty())
   {
     return false;
@@ -51,7 +58,7 @@ bool Bot::registerPlugin(Plugin& plug)
       std::cerr << "Error: Empty plugin commands are not allowed!\n";
       return false;
     }
-    if (commands.find(cmd) != commands.end())
+    if (commands.find(cmd) != nullptr)
     {
       std::cerr << "Error: Command '" << cmd << "' is already registered for "
                 << "another plugin!\n";
@@ -62,7 +69,7 @@ bool Bot::registerPlugin(Plugin& plug)
   // Register commands of plugin.
   for (const std::string& cmd: pluginCommands)
   {
-    commands.emplace(cmd, plug);
+    commands.add(cmd, plug);
   }
 
   return true;
@@ -73,14 +80,14 @@ bool Bot::handleCommandDeactivations()
   const auto& to_deactivate = mat.configuration().deactivatedCommands();
   for(const auto& cmd: to_deactivate)
   {
-    const auto iter = commands.find(cmd);
-    if (iter == commands.end())
+    Plugin* plugin = commands.find(cmd);
+    if (plugin == nullptr)
     {
       std::cerr << "Error: No command by the name '" << cmd << "' is active. "
                 << "Therefore, it cannot be deactivated.\n";
       return false;
     }
-    if (!iter->second.get().allowDeactivation(cmd))
+    if (!plugin->allowDeactivation(cmd))
     {
       std::cerr << "Error: Deactivating the command '" << cmd << "' is not "
                 << "allowed. This may be due to the fact that this command is "
@@ -89,9 +96,10 @@ bool Bot::handleCommandDeactivations()
       return false;
     }
     std::clog << "Info: Command '" << cmd << "' is deactivated.\n";
-    commands.erase(iter);
+    commands.remove(cmd);
   }
 
+  commands.freeze();
   return true;
 }
 
@@ -103,6 +111,10 @@ void Bot::start()
               << " Bot will not start.\n";
     return;
   }
+  if (!commands.frozen())
+  {
+    commands.freeze();
+  }
 
   if (!mat.login())
   {
@@ -112,6 +124,7 @@ void Bot::start()
 
   checkServerVersion();
 
+  // The limit is cached by Matrix, so uploads do not need to request it.
   const auto uploadSize = mat.getUploadLimit();
   if (!uploadSize.has_value())
   {
@@ -151,9 +164,10 @@ void Bot::start()
 
   while (!stopRequested())
   {
-    // Sleep a moment to avoid DOS-ing the server.
+    // Wait a moment to avoid DOS-ing the server.
     // The sync endpoint is not rate-limited, but we do not have to overdo it.
-    std::this_thread::sleep_for(mat.configuration().syncDelay());
+    // Answers of commands that finish in the meantime are sent right away.
+    waitAndSendAnswers(mat.configuration().syncDelay());
 
     const bool syncSuccess = mat.sync(next_batch, rooms, invites, next_batch);
     counter.next(syncSuccess);
@@ -165,6 +179,8 @@ void Bot::start()
       if (counter.limitExceeded())
       {
         std::cerr << nowToString() << " Error: Failure limit was exceeded, quitting!\n";
+        sendFinishedAnswers(true);
+        workers.shutdown();
         mat.logout();
         return;
       }
@@ -190,6 +206,12 @@ void Bot::start()
       break;
     }
   }
+
+  // Commands that are still running get answered before the bot quits.
+  sendFinishedAnswers(true);
+  // Jobs of commands that timed out may still run. They use the plugins, so
+  // they have to end before the owner of the bot destroys the plugins.
+  workers.shutdown();
 }
 
 void Bot::checkServerVersion()
@@ -224,39 +246,121 @@ void Bot::handleRoomEvents(const std::string& prefix, const std::vector<matrix::
       if (msg.body.rfind(prefix, 0) == 0)
       {
         // Found it!
-        const auto spacePos = msg.body.find(' ', prefix.size());
-        const std::string command = (spacePos != std::string::npos)
-            ? msg.body.substr(prefix.size(), spacePos - prefix.size())
-            : msg.body.substr(prefix.size());
+        const std::string_view message(msg.body.data() + prefix.size(), msg.body.size() - prefix.size());
+        const std::string_view command = message.substr(0, message.find(' '));
         if (command.empty())
         {
           // Nice try, but there are no empty commands.
           continue;
         }
-        const auto iter = commands.find(command);
-        if (iter == commands.end())
+        Plugin* plugin = commands.find(command);
+        if (plugin == nullptr)
         {
           // There is no such command.
-          mat.sendMessage(room.id, Message("The bot does not recognize the command '" + prefix + command + "'."));
+          mat.sendMessage(room.id, Message(std::string("The bot does not recognize the command '")
+                                           .append(prefix).append(command).append("'.")));
           continue;
         }
 
-        // Let the plugin handle the command.
-        const std::string_view message(msg.body.data() + prefix.size(), msg.body.size() - prefix.size());
-        const Message answer = iter->second.get().handleCommand(command, message, msg.sender, room.id, msg.server_ts);
-        if (!answer.body.empty())
+        // Core commands may change the state of the bot, so they are handled
+        // right away. All other commands are passed to the worker threads.
+        if (!plugin->allowDeactivation(command))
         {
-          if (!mat.sendMessage(room.id, answer))
-          {
-            // Sending messages could fail due to rate limit or because the bot has left the room.
-            std::cerr << "Error: Could not send answer for command " + command + "!\n";
-          }
+          sendAnswer(room.id, command, plugin->handleCommand(command, message, msg.sender, room.id, msg.server_ts));
+          continue;
         }
+        // Background work of the plugins waits while commands are running.
+        ActivityMeter::commands().begin();
+        const Deadline deadline(mat.configuration().commandTimeout(command));
+        Invocation inv{ std::string(command), std::string(message), msg.sender, room.id, msg.server_ts, deadline };
+        pending.push_back(PendingAnswer{ room.id, std::string(command),
+                                         AsyncPlugin::dispatch(*plugin, std::move(inv), workers),
+                                         deadline });
       }
     }
   }
 }
 
+void Bot::sendAnswer(const std::string& roomId, const std::string_view& command, const Message& answer)
+{
+  if (!answer.body.empty())
+  {
+    if (!mat.sendMessage(roomId, answer))
+    {
+      // Sending messages could fail due to rate limit or because the bot has left the room.
+      std::cerr << "Error: Could not send answer for command " << command << "!\n";
+    }
+  }
+}
+
+void Bot::sendFinishedAnswers(const bool wait)
+{
+  auto iter = pending.begin();
+  while (iter != pending.end())
+  {
+    if (wait)
+    {
+      if (iter->deadline.limited())
+      {
+        iter->answer.wait_for(iter->deadline.remaining());
+      }
+      else
+      {
+        iter->answer.wait();
+      }
+    }
+    const bool ready = iter->answer.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    if (!ready && !iter->deadline.expired())
+    {
+      ++iter;
+      continue;
+    }
+    // A cancelled deadline means that a request of the command has run into
+    // the time limit, so the answer is just an error message of the plugin.
+    if (!ready || iter->deadline.cancelled())
+    {
+      // Abort any remaining requests of the command.
+      iter->deadline.cancel();
+      std::cerr << nowToString() << " Error: Command " << iter->command
+                << " exceeded its time limit.\n";
+      sendAnswer(iter->roomId, iter->command,
+                 Message("Error: The command " + iter->command + " timed out."));
+      iter = pending.erase(iter);
+      ActivityMeter::commands().end();
+      continue;
+    }
+    try
+    {
+      sendAnswer(iter->roomId, iter->command, iter->answer.get());
+    }
+    catch (const std::exception& ex)
+    {
+      std::cerr << nowToString() << " Error: Command " << iter->command
+                << " failed: " << ex.what() << "\n";
+      sendAnswer(iter->roomId, iter->command,
+                 Message("Error: The command " + iter->command + " could not be completed."));
+    }
+    iter = pending.erase(iter);
+    ActivityMeter::commands().end();
+  }
+}
+
+void Bot::waitAndSendAnswers(const std::chrono::milliseconds& duration)
+{
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (!pending.empty())
+  {
+    sendFinishedAnswers(false);
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= end)
+    {
+      return;
+    }
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(end - now, std::chrono::milliseconds(50)));
+  }
+  std::this_thread::sleep_until(end);
+}
+
 void Bot::joinRoom(const std::string& roomId)
 {
   if (!mat.joinRoom(roomId))
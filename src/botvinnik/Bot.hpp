@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,10 +21,13 @@
 #ifndef BVN_BOT_HPP
 #define BVN_BOT_HPP
 
-#include <functional>
-#include <unordered_map>
+#include <atomic>
+#include <future>
 #include "../conf/Configuration.hpp"
 #include "../matrix/Matrix.hpp"
+#include "../util/Deadline.hpp"
+#include "../util/ThreadPool.hpp"
+#include "CommandRegistry.hpp"
 #include "plugins/Plugin.hpp"
 
 namespace bvn
@@ -64,6 +67,8 @@ class Bot
      * \remarks Only call this once, and only after all plugins have been
      *          registered. Otherwise this method might fail, because only the
      *          commands of registered plugins can be deactivated.
+     *          The set of active commands is frozen into a perfect hash table
+     *          afterwards.
      */
     bool handleCommandDeactivations();
 
@@ -71,6 +76,8 @@ class Bot
     /** \brief Starts the bot.
      *
      * \remarks Any plugins / commands have to be registered before the start.
+     *          When this method returns, all jobs of commands have ended, so
+     *          the plugins can be destroyed safely.
      */
     void start();
 
@@ -100,6 +107,12 @@ class Bot
     Matrix& matrix();
 
 
+    /** \brief number of worker threads that handle commands of non-core
+     *         plugins
+     */
+    static const unsigned int worker_threads;
+
+
     // Help class needs to iterate over registered commands and plugins of the
     // bot, i. e. it needs access to private data.
     friend Help;
@@ -121,9 +134,45 @@ class Bot
      */
     void handleRoomEvents(const std::string& prefix, const std::vector<matrix::Room>& rooms);
 
+    /** \brief Sends the answer to a command.
+     *
+     * \param roomId   id of the room where the command was sent
+     * \param command  name of the command
+     * \param answer   the answer to send; empty answers are not sent
+     */
+    void sendAnswer(const std::string& roomId, const std::string_view& command, const Message& answer);
+
+    /** \brief Sends the answers of all commands that have been completed by
+     *         the worker threads.
+     *
+     * Commands that exceeded their time limit are cancelled, and a message
+     * about the timeout is sent instead of their answer.
+     *
+     * \param wait  if true, waits until all pending commands are completed or
+     *              have exceeded their time limit
+     */
+    void sendFinishedAnswers(const bool wait);
+
+    /** \brief Waits for the given duration while sending completed answers.
+     *
+     * \param duration  the time to wait
+     */
+    void waitAndSendAnswers(const std::chrono::milliseconds& duration);
+
+    /** Command whose answer is still being computed by the worker threads */
+    struct PendingAnswer
+    {
+      std::string roomId;  /**< id of the room where the command was sent */
+      std::string command; /**< name of the command */
+      std::future<Message> answer; /**< future that gets the answer */
+      Deadline deadline; /**< time limit for the command */
+    }; // struct
+
     Matrix mat; /**< handles matrix requests */
-    std::unordered_map<std::string, std::reference_wrapper<Plugin> > commands; /**< registered commands */
-    bool stopped; /**< whether the bot shall stop */
+    CommandRegistry commands; /**< registered commands */
+    std::atomic<bool> stopped; /**< whether the bot shall stop */
+    ThreadPool workers; /**< worker threads that handle the commands */
+    std::vector<PendingAnswer> pending; /**< commands that are not answered yet */
 }; // class
 
 } // namespace
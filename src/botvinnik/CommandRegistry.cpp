@@ -0,0 +1,209 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "CommandRegistry.hpp"
+#include <algorithm>
+
+namespace bvn
+{
+
+CommandRegistry::CommandRegistry()
+: entries({}),
+  displacements({}),
+  slots({})
+{
+}
+
+bool CommandRegistry::add(const std::string_view& command, Plugin& plugin)
+{
+  if (linearFind(command) >= 0)
+  {
+    return false;
+  }
+  entries.emplace_back(std::string(command), plugin);
+  displacements.clear();
+  slots.clear();
+  return true;
+}
+
+bool CommandRegistry::remove(const std::string_view& command)
+{
+  const int idx = linearFind(command);
+  if (idx < 0)
+  {
+    return false;
+  }
+  entries.erase(entries.begin() + idx);
+  displacements.clear();
+  slots.clear();
+  return true;
+}
+
+Plugin* CommandRegistry::find(const std::string_view& command) const
+{
+  if (!frozen())
+  {
+    const int idx = linearFind(command);
+    return idx >= 0 ? &entries[idx].second.get() : nullptr;
+  }
+
+  const std::uint32_t seed = displacements[hash(0, command) % displacements.size()];
+  const int idx = slots[hash(seed, command) % slots.size()];
+  if ((idx >= 0) && (entries[idx].first == command))
+  {
+    return &entries[idx].second.get();
+  }
+  return nullptr;
+}
+
+void CommandRegistry::freeze()
+{
+  if (entries.empty())
+  {
+    return;
+  }
+  // A load factor of 0.5 lets the seed search finish after a few tries. If
+  // it does not, a bigger table is used.
+  std::size_t tableSize = 2 * entries.size();
+  while (!build(tableSize))
+  {
+    tableSize *= 2;
+  }
+}
+
+bool CommandRegistry::build(const std::size_t tableSize)
+{
+  // Hash and displace: commands are distributed into buckets first. Then,
+  // starting with the largest bucket, a seed is searched for each bucket that
+  // puts all commands of that bucket into free slots of the table.
+  const std::size_t bucketCount = std::max<std::size_t>(1, entries.size() / 2);
+  std::vector<std::vector<int>> buckets(bucketCount);
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    buckets[hash(0, entries[i].first) % bucketCount].push_back(static_cast<int>(i));
+  }
+  std::vector<std::size_t> order(bucketCount);
+  for (std::size_t i = 0; i < bucketCount; ++i)
+  {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&buckets](const std::size_t a, const std::size_t b)
+  {
+    return buckets[a].size() > buckets[b].size();
+  });
+
+  constexpr std::uint32_t maxSeed = 1 << 16;
+  std::vector<std::uint32_t> seeds(bucketCount, 0);
+  std::vector<int> table(tableSize, -1);
+  std::vector<std::size_t> candidate;
+  for (const std::size_t b: order)
+  {
+    const auto& bucket = buckets[b];
+    if (bucket.empty())
+    {
+      break;
+    }
+    std::uint32_t seed = 1;
+    for ( ; seed < maxSeed; ++seed)
+    {
+      candidate.clear();
+      bool fits = true;
+      for (const int idx: bucket)
+      {
+        const std::size_t slot = hash(seed, entries[idx].first) % tableSize;
+        if ((table[slot] != -1)
+            || (std::find(candidate.begin(), candidate.end(), slot) != candidate.end()))
+        {
+          fits = false;
+          break;
+        }
+        candidate.push_back(slot);
+      }
+      if (fits)
+      {
+        break;
+      }
+    }
+    if (seed == maxSeed)
+    {
+      return false;
+    }
+    seeds[b] = seed;
+    for (std::size_t i = 0; i < bucket.size(); ++i)
+    {
+      table[candidate[i]] = bucket[i];
+    }
+  }
+
+  displacements = std::move(seeds);
+  slots = std::move(table);
+  return true;
+}
+
+bool CommandRegistry::frozen() const
+{
+  return !slots.empty();
+}
+
+bool CommandRegistry::empty() const
+{
+  return entries.empty();
+}
+
+std::size_t CommandRegistry::size() const
+{
+  return entries.size();
+}
+
+std::vector<CommandRegistry::value_type>::const_iterator CommandRegistry::begin() const
+{
+  return entries.begin();
+}
+
+std::vector<CommandRegistry::value_type>::const_iterator CommandRegistry::end() const
+{
+  return entries.end();
+}
+
+std::uint64_t CommandRegistry::hash(const std::uint32_t seed, const std::string_view& command)
+{
+  // FNV-1a, where the seed modifies the offset basis
+  std::uint64_t h = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+  for (const char c: command)
+  {
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+int CommandRegistry::linearFind(const std::string_view& command) const
+{
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if (entries[i].first == command)
+    {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+} // namespace
@@ -0,0 +1,154 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_COMMANDREGISTRY_HPP
+#define BVN_COMMANDREGISTRY_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "plugins/Plugin.hpp"
+
+namespace bvn
+{
+
+/** \brief Maps bot commands to the plugins that handle them.
+ *
+ * Commands are collected during plugin registration. Once all commands are
+ * known, freeze() builds a perfect hash table over the complete command set,
+ * so that every later lookup needs exactly one hash computation and one
+ * string comparison. Lookups are done with string views, so no string has to
+ * be constructed to find a command.
+ */
+class CommandRegistry
+{
+  public:
+    /** \brief type of a single entry: command name and plugin handling the
+     *         command
+     */
+    typedef std::pair<std::string, std::reference_wrapper<Plugin> > value_type;
+
+
+    /** \brief Creates an empty registry.
+     */
+    CommandRegistry();
+
+
+    /** \brief Adds a command to the registry.
+     *
+     * \param command   name of the command
+     * \param plugin    the plugin that handles the command
+     * \return Returns true, if the command was added.
+     *         Returns false, if the command already exists.
+     * \remarks Adding a command to a frozen registry discards the perfect
+     *          hash table, i. e. freeze() has to be called again afterwards.
+     */
+    bool add(const std::string_view& command, Plugin& plugin);
+
+
+    /** \brief Removes a command from the registry.
+     *
+     * \param command   name of the command
+     * \return Returns true, if the command was removed.
+     *         Returns false, if there was no such command.
+     * \remarks Removing a command from a frozen registry discards the perfect
+     *          hash table, i. e. freeze() has to be called again afterwards.
+     */
+    bool remove(const std::string_view& command);
+
+
+    /** \brief Finds the plugin that handles a command.
+     *
+     * \param command   name of the command
+     * \return Returns a pointer to the plugin that handles the command.
+     *         Returns nullptr, if there is no such command.
+     */
+    Plugin* find(const std::string_view& command) const;
+
+
+    /** \brief Builds the perfect hash table for the current set of commands.
+     */
+    void freeze();
+
+
+    /** \brief Checks whether the registry has been frozen.
+     *
+     * \return Returns true, if lookups use the perfect hash table.
+     */
+    bool frozen() const;
+
+
+    /** \brief Checks whether the registry is empty.
+     *
+     * \return Returns true, if no commands are registered.
+     */
+    bool empty() const;
+
+
+    /** \brief Gets the number of registered commands.
+     *
+     * \return Returns the number of registered commands.
+     */
+    std::size_t size() const;
+
+
+    /** \brief iterator to the first registered command
+     */
+    std::vector<value_type>::const_iterator begin() const;
+
+    /** \brief iterator past the last registered command
+     */
+    std::vector<value_type>::const_iterator end() const;
+  private:
+    /** \brief Calculates the seeded FNV-1a hash of a command.
+     *
+     * \param seed     seed for the hash function
+     * \param command  the command to hash
+     * \return Returns the hash value.
+     */
+    static std::uint64_t hash(const std::uint32_t seed, const std::string_view& command);
+
+
+    /** \brief Tries to build the perfect hash table with a given table size.
+     *
+     * \param tableSize  number of slots in the table
+     * \return Returns true, if the table could be built.
+     */
+    bool build(const std::size_t tableSize);
+
+
+    /** \brief Finds the index of a command in the entries without the hash table.
+     *
+     * \param command   name of the command
+     * \return Returns the index of the command, or -1 if there is no such command.
+     */
+    int linearFind(const std::string_view& command) const;
+
+    std::vector<value_type> entries;           /**< registered commands */
+    std::vector<std::uint32_t> displacements;  /**< seed per first-level bucket */
+    std::vector<int> slots;                    /**< index into entries per slot, or -1 */
+}; // class
+
+} // namespace
+
+#endif // BVN_COMMANDREGISTRY_HPP
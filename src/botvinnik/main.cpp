@@ -25,6 +25,7 @@
 #include "../conf/Configuration.hpp"
 #include "../matrix/Matrix.hpp"
 #include "../net/Curly.hpp"
+#include "../net/HttpCache.hpp"
 #include "../util/GitInfos.hpp"
 #include "../ReturnCodes.hpp"
 #include "../Version.hpp"
@@ -100,6 +101,20 @@ void showHelp()
             << "                           in some predefined locations.\n";
 }
 
+/** \brief Unsets the stores of the HTTP cache and of the media cache when it
+ *         goes out of scope.
+ */
+struct BackingStoreGuard
+{
+  bvn::Matrix& mat; /**< the Matrix instance that owns the media cache */
+
+  ~BackingStoreGuard()
+  {
+    bvn::HttpCache::upstreams().setStore(nullptr);
+    mat.mediaCache().setStore(nullptr);
+  }
+}; // struct
+
 int main(int argc, char** argv)
 {
   std::string configurationFile; /**< path of configuration file */
@@ -194,7 +209,16 @@ int main(int argc, char** argv)
               << "The bot will not start.\n";
     return bvn::rcPluginRegistrationError;
   }
-  bvn::Wikipedia wiki;
+  // Responses of upstream services are cached for all plugins in one database.
+  bvn::PersistentCache cache(bvn::PersistentCache::defaultFileName());
+  // HTTP responses of the plugins are kept there, too. The HTTP cache and the
+  // bot outlive the cache, so the guard unsets both stores before
+  // the cache is destroyed, no matter how main() is left.
+  const BackingStoreGuard storeGuard{ bot.matrix() };
+  bvn::HttpCache::upstreams().setStore(&cache);
+  // So are the URIs of media that was uploaded to the homeserver.
+  bot.matrix().mediaCache().setStore(&cache);
+  bvn::Wikipedia wiki(&cache);
   if (!bot.registerPlugin(wiki))
   {
     // Should never happen!
@@ -220,7 +244,7 @@ int main(int argc, char** argv)
     return bvn::rcPluginRegistrationError;
   }
   #endif
-  bvn::Xkcd xkcd(bot.matrix());
+  bvn::Xkcd xkcd(bot.matrix(), bvn::XkcdDb::defaultFileName(), config.xkcdPreUploadsPerHour());
   if (!bot.registerPlugin(xkcd))
   {
     // Should never happen!
@@ -228,7 +252,10 @@ int main(int argc, char** argv)
               << "The bot will not start.\n";
     return bvn::rcPluginRegistrationError;
   }
-  bvn::Debian deb;
+  xkcd.start();
+  bvn::DebianSources debianSources(config.debianSources(), config.debianSourcesRefresh());
+  debianSources.start();
+  bvn::Debian deb(&debianSources);
   if (!bot.registerPlugin(deb))
   {
     // Should never happen!
@@ -244,7 +271,7 @@ int main(int argc, char** argv)
               << "The bot will not start.\n";
     return bvn::rcPluginRegistrationError;
   }
-  bvn::CheatSheet cheat;
+  bvn::CheatSheet cheat(&cache, config.cheatSheetDirectory(), config.cheatSheetReload());
   if (!bot.registerPlugin(cheat))
   {
     // Should never happen!
@@ -260,7 +287,12 @@ int main(int argc, char** argv)
               << "The bot will not start.\n";
     return bvn::rcPluginRegistrationError;
   }
-  bvn::Giphy gif(config.gifApiKey(), bot.matrix());
+  bvn::GiphyPool::Settings gifPool;
+  gifPool.poolSize = config.giphyPoolSize();
+  gifPool.keywords = config.giphyPoolKeywords();
+  gifPool.refresh = config.giphyPoolRefresh();
+  gifPool.uploadsPerHour = config.giphyPoolUploadsPerHour();
+  bvn::Giphy gif(config.gifApiKey(), bot.matrix(), gifPool);
   if (!bot.registerPlugin(gif))
   {
     // Should never happen!
@@ -268,7 +300,7 @@ int main(int argc, char** argv)
               << "The bot will not start.\n";
     return bvn::rcPluginRegistrationError;
   }
-  bvn::Weather weather;
+  bvn::Weather weather(bvn::GeocodeCache::defaultFileName(), config.geoNamesFile(), config.geoNamesPrimary());
   if (!bot.registerPlugin(weather))
   {
     // Should never happen!
@@ -0,0 +1,61 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "AsyncPlugin.hpp"
+
+namespace bvn
+{
+
+Message AsyncPlugin::handleCommand(const std::string_view& command, const std::string_view& message,
+                                   const std::string_view& userId, const std::string_view& roomId,
+                                   const std::chrono::milliseconds& server_ts)
+{
+  // A pool without threads runs all jobs directly in this thread.
+  ThreadPool inlinePool(0);
+  Invocation inv{ std::string(command), std::string(message), std::string(userId),
+                  std::string(roomId), server_ts, Deadline::current() };
+  return handleCommandAsync(std::move(inv), inlinePool).get();
+}
+
+std::future<Message> AsyncPlugin::dispatch(Plugin& plugin, Invocation inv, ThreadPool& pool)
+{
+  // Jobs submitted to the pool inherit the deadline of the invocation.
+  Deadline::Scope scope(inv.deadline);
+  AsyncPlugin* async = dynamic_cast<AsyncPlugin*>(&plugin);
+  if (async != nullptr)
+  {
+    return async->handleCommandAsync(std::move(inv), pool);
+  }
+
+  // Adapter for synchronous plugins: run the whole handler as one job.
+  return pool.submit([&plugin, inv = std::move(inv)]()
+  {
+    return plugin.handleCommand(inv.command, inv.message, inv.userId, inv.roomId, inv.server_ts);
+  });
+}
+
+std::future<Message> AsyncPlugin::readyAnswer(Message answer)
+{
+  std::promise<Message> promise;
+  promise.set_value(std::move(answer));
+  return promise.get_future();
+}
+
+} // namespace
@@ -0,0 +1,104 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_PLUGIN_ASYNCPLUGIN_HPP
+#define BVN_PLUGIN_ASYNCPLUGIN_HPP
+
+#include <future>
+#include "DeactivatablePlugin.hpp"
+#include "../../util/Deadline.hpp"
+#include "../../util/ThreadPool.hpp"
+
+namespace bvn
+{
+
+/** \brief Holds all data of a single command invocation.
+ *
+ * In contrast to the string views passed to Plugin::handleCommand(), the
+ * strings are owned by the invocation, so it can be passed to other threads
+ * and outlive the event that triggered the command.
+ */
+struct Invocation
+{
+  std::string command; /**< name of the command */
+  std::string message; /**< complete message text, without the prefix */
+  std::string userId;  /**< id of the user who sent the command */
+  std::string roomId;  /**< id of the room where the command was sent */
+  std::chrono::milliseconds server_ts; /**< server timestamp of the event */
+  Deadline deadline; /**< time limit for handling the command */
+}; // struct
+
+
+/** \brief Abstract plugin that handles commands asynchronously.
+ *
+ * Plugins that have to wait for several network requests can derive from this
+ * class to split their work into jobs which are executed by a thread pool.
+ */
+class AsyncPlugin: public DeactivatablePlugin
+{
+  public:
+    /** \brief Starts handling a command.
+     *
+     * \param inv   the command invocation
+     * \param pool  the thread pool to execute the jobs of the command with
+     * \return Returns a future that gets the response message. An empty
+     *         message indicates an unknown command.
+     */
+    virtual std::future<Message> handleCommandAsync(Invocation inv, ThreadPool& pool) = 0;
+
+
+    /** \brief Reacts to a given command synchronously.
+     *
+     * \param command  name of the command
+     * \param message  complete message text, without the prefix
+     * \param userId   id of the user who sent the command
+     * \param roomId   id of the room where the command was sent
+     * \param server_ts  server timestamp of the event
+     * \return Returns a Message containing the response.
+     * \remarks This runs handleCommandAsync() within the calling thread and
+     *          with the current deadline of that thread.
+     */
+    Message handleCommand(const std::string_view& command, const std::string_view& message, const std::string_view& userId, const std::string_view& roomId, const std::chrono::milliseconds& server_ts) final;
+
+
+    /** \brief Starts handling a command with any kind of plugin.
+     *
+     * Asynchronous plugins get the invocation passed directly. The command
+     * handler of synchronous plugins is executed as a job of the pool.
+     * All jobs of the command run with the deadline of the invocation.
+     *
+     * \param plugin  the plugin that handles the command
+     * \param inv     the command invocation
+     * \param pool    the thread pool to execute the command with
+     * \return Returns a future that gets the response message.
+     */
+    static std::future<Message> dispatch(Plugin& plugin, Invocation inv, ThreadPool& pool);
+  protected:
+    /** \brief Gets a future that already holds the given answer.
+     *
+     * \param answer  the answer to a command
+     * \return Returns a future that is ready and holds the answer.
+     */
+    static std::future<Message> readyAnswer(Message answer);
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_ASYNCPLUGIN_HPP
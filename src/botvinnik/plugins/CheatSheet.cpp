@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2021, 2022, 2023  Dirk Stolle
+    Copyright (C) 2021, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,17 +20,28 @@
 
 #include "CheatSheet.hpp"
 #include <iostream>
+#include "../../net/CircuitBreaker.hpp"
 #include "../../net/Curly.hpp"
 #include "../../net/htmlspecialchars.hpp"
 #include "../../net/url_encode.hpp"
-#include "../../util/Strings.hpp"
+#include "../../util/Arguments.hpp"
 
 namespace bvn
 {
 
-std::vector<std::string> CheatSheet::commands() const
+// Cheat sheets are edited rarely.
+const std::chrono::hours CheatSheet::cache_ttl = std::chrono::hours(24 * 7);
+
+CheatSheet::CheatSheet(PersistentCache* cache, const std::string& directory, const std::chrono::seconds& reloadInterval)
+: mCache(cache),
+  mIndex(directory, reloadInterval)
+{
+}
+
+const std::vector<std::string>& CheatSheet::commands() const
 {
-  return { "cheat", "cheats" };
+  static const std::vector<std::string> cmds = { "cheat", "cheats" };
+  return cmds;
 }
 
 Message CheatSheet::handleCommand(const std::string_view& command, const std::string_view& message,
@@ -44,13 +55,20 @@ Message CheatSheet::handleCommand(const std::string_view& command, const std::st
     return Message();
   }
 
-  std::string topic(message.substr(command.size() + 1));
-  trim(topic);
+  const std::string_view topic = Arguments(message, command).rest();
   if (topic.size() < 2)
   {
     return Message("Cheat sheet topic to search for must be at least two characters long!");
   }
 
+  // Local cheat sheets need no request at all.
+  const auto local = mIndex.find(topic);
+  if (local.has_value())
+  {
+    return Message(local.value(),
+                   std::string("<pre>").append(htmlspecialchars(local.value())).append("</pre>"));
+  }
+
   std::string encodedTopic;
   try
   {
@@ -59,11 +77,24 @@ Message CheatSheet::handleCommand(const std::string_view& command, const std::st
   catch (const std::exception& ex)
   {
     std::cerr << "Error: Could not URL-encode cheat.sh search topic!\n";
-    return Message("Error: Could not get information for topic '" + topic + "'!");
+    return Message(std::string("Error: Could not get information for topic '")
+                   .append(topic).append("'!"));
   }
 
+  if (mCache != nullptr)
+  {
+    const auto cached = mCache->get("cheat", encodedTopic);
+    if (cached.has_value())
+    {
+      return cheatSheetMessage(cached.value(), encodedTopic);
+    }
+  }
 
   Curly curl;
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+  // The plugin caches the response itself, so it does not use the HTTP
+  // cache of Curly as well.
+  curl.coalesceRequests(true);
   // URL is something like https://cheat.sh/bash?qT, e. g. for topic "bash".
   curl.setURL(std::string("https://cheat.sh/").append(encodedTopic)
               .append("?qT"));
@@ -74,16 +105,30 @@ Message CheatSheet::handleCommand(const std::string_view& command, const std::st
   std::string response;
   if (!curl.perform(response) || curl.getResponseCode() != 200)
   {
+    if (curl.circuitOpen())
+    {
+      return Message("cheat.sh is currently unavailable. Please try again later.");
+    }
     std::cerr << "Error: Request to cheat.sh failed!\n"
               << "URL: " << curl.getURL() << '\n'
               << "HTTP status code: " << curl.getResponseCode() << '\n'
               << "Response: " << response << '\n';
-    return Message("The request to get a cheat sheet for topic '" + topic + "' failed. Server returned unexpected response.");
+    return Message(std::string("The request to get a cheat sheet for topic '")
+                   .append(topic).append("' failed. Server returned unexpected response."));
   }
 
+  if (mCache != nullptr)
+  {
+    mCache->put("cheat", encodedTopic, response, cache_ttl);
+  }
+  return cheatSheetMessage(response, encodedTopic);
+}
+
+Message CheatSheet::cheatSheetMessage(const std::string& sheet, const std::string& encodedTopic)
+{
   return Message(
-      response.append("\n\nSource: https://cheat.sh/").append(encodedTopic),
-      std::string("<pre>").append(htmlspecialchars(response)).append("</pre>")
+      std::string(sheet).append("\n\nSource: https://cheat.sh/").append(encodedTopic),
+      std::string("<pre>").append(htmlspecialchars(sheet)).append("</pre>")
           .append("<br />\nSource: https://cheat.sh/").append(encodedTopic));
 }
 
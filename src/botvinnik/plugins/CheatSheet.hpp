@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2021, 2022, 2023, 2024  Dirk Stolle
+    Copyright (C) 2021, 2022, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,7 +21,9 @@
 #ifndef BVN_PLUGIN_CHEATSHEET_HPP
 #define BVN_PLUGIN_CHEATSHEET_HPP
 
+#include "CheatSheetIndex.hpp"
 #include "DeactivatablePlugin.hpp"
+#include "../../util/PersistentCache.hpp"
 
 namespace bvn
 {
@@ -32,15 +34,25 @@ class CheatSheet final: public DeactivatablePlugin
 {
   public:
     /** \brief Constructor.
+     *
+     * \param cache  cache for responses of cheat.sh; nullptr means that
+     *               responses are not cached
+     * \param directory  directory with local cheat sheets; an empty string
+     *                   means that all cheat sheets are requested from cheat.sh
+     * \param reloadInterval  minimum time between two scans of the directory
+     *                        for changes; zero disables the reload
+     * \remarks The cache must outlive the plugin.
      */
-    CheatSheet() = default;
+    explicit CheatSheet(PersistentCache* cache = nullptr,
+                        const std::string& directory = std::string(),
+                        const std::chrono::seconds& reloadInterval = std::chrono::seconds::zero());
 
 
     /** \brief Gets a list of commands that are provided by this plugin.
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    std::vector<std::string> commands() const override;
+    const std::vector<std::string>& commands() const override;
 
 
     /** \brief Reacts to a given command.
@@ -71,6 +83,22 @@ class CheatSheet final: public DeactivatablePlugin
      * \return Returns a Message containing a longer help text for the command.
      */
     Message helpExtended(const std::string_view& command, const std::string_view& prefix) const override;
+
+
+    /** \brief time that a cheat sheet is cached
+     */
+    static const std::chrono::hours cache_ttl;
+  private:
+    /** \brief Creates the reply message for a cheat sheet.
+     *
+     * \param sheet         the cheat sheet as returned by cheat.sh
+     * \param encodedTopic  the URL-encoded topic
+     * \return Returns the message containing the cheat sheet.
+     */
+    static Message cheatSheetMessage(const std::string& sheet, const std::string& encodedTopic);
+
+    PersistentCache* mCache; /**< cache for responses, may be nullptr */
+    CheatSheetIndex mIndex; /**< local cheat sheets */
 }; // class
 
 } // namespace
@@ -0,0 +1,261 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "CheatSheetIndex.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace bvn
+{
+
+CheatSheetIndex::CheatSheetIndex(const std::string& directory, const std::chrono::seconds& reloadInterval)
+: mDirectory(directory),
+  mReloadInterval(reloadInterval),
+  mLastScan(std::chrono::steady_clock::now()),
+  mScanning(false),
+  mSheets(),
+  mMutex()
+{
+  if (mDirectory.empty())
+  {
+    return;
+  }
+  mSheets = scan(mDirectory);
+  if (mSheets.empty())
+  {
+    std::clog << "Warning: No cheat sheets were found in " << mDirectory
+              << ", cheat sheets will be requested from cheat.sh." << std::endl;
+  }
+  else
+  {
+    std::clog << "Info: Found " << mSheets.size() << " cheat sheets in "
+              << mDirectory << "." << std::endl;
+  }
+}
+
+std::size_t CheatSheetIndex::size() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mSheets.size();
+}
+
+std::string CheatSheetIndex::normalizeTopic(const std::string_view& topic)
+{
+  // tldr pages use dashes instead of spaces, e. g. git-commit.md.
+  std::string result;
+  bool space = false;
+  for (const char c: topic)
+  {
+    if ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r'))
+    {
+      space = true;
+      continue;
+    }
+    if (space && !result.empty())
+    {
+      result.push_back('-');
+    }
+    space = false;
+    result.push_back(((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c);
+  }
+  return result;
+}
+
+CheatSheetIndex::Sheets CheatSheetIndex::scan(const std::string& directory)
+{
+  namespace fs = std::filesystem;
+
+  std::error_code error;
+  std::vector<fs::path> files;
+  fs::recursive_directory_iterator iter(directory, fs::directory_options::skip_permission_denied, error);
+  const fs::recursive_directory_iterator end;
+  while (!error && (iter != end))
+  {
+    const std::string name = iter->path().filename().string();
+    if (iter->is_directory(error))
+    {
+      // Skip .git and translations of tldr pages like pages.de.
+      if (name.find('.') != std::string::npos)
+      {
+        iter.disable_recursion_pending();
+      }
+    }
+    else if (iter->is_regular_file(error) && !name.empty() && (name[0] != '.'))
+    {
+      files.push_back(iter->path());
+    }
+    iter.increment(error);
+  }
+  if (error)
+  {
+    std::cerr << "Error: Could not scan the cheat sheet directory " << directory
+              << ": " << error.message() << "\n";
+  }
+  // If a topic exists in more than one place, e. g. in pages/common and in
+  // pages/linux, the first path in alphabetical order wins.
+  std::sort(files.begin(), files.end());
+
+  Sheets sheets;
+  for (const auto& path: files)
+  {
+    std::string topic = path.filename().string();
+    if ((topic.size() > 3) && (topic.compare(topic.size() - 3, 3, ".md") == 0))
+    {
+      topic.erase(topic.size() - 3);
+    }
+    // Names like README.md or LICENSE are not cheat sheets. Neither are
+    // files with other extensions.
+    const auto notTopic = [](const char c) { return (c == '.') || ((c >= 'A') && (c <= 'Z')); };
+    if (topic.empty() || std::any_of(topic.begin(), topic.end(), notTopic))
+    {
+      continue;
+    }
+    const auto modified = fs::last_write_time(path, error);
+    if (error)
+    {
+      continue;
+    }
+    const auto size = fs::file_size(path, error);
+    if (error)
+    {
+      continue;
+    }
+    sheets.emplace(topic, Sheet{ path, modified, size, std::nullopt });
+  }
+  return sheets;
+}
+
+void CheatSheetIndex::reload()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mScanning)
+    {
+      return;
+    }
+    mScanning = true;
+    mLastScan = std::chrono::steady_clock::now();
+  }
+
+  // Scanning may take a while, so lookups use the old index meanwhile.
+  Sheets sheets = scan(mDirectory);
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  // Keep the content of files that were already read, if they did not change.
+  for (auto& [topic, sheet]: sheets)
+  {
+    const auto old = mSheets.find(topic);
+    if ((old != mSheets.end()) && (old->second.path == sheet.path)
+        && (old->second.modified == sheet.modified)
+        && (old->second.size == sheet.size))
+    {
+      sheet.text = std::move(old->second.text);
+    }
+  }
+  mSheets = std::move(sheets);
+  mScanning = false;
+}
+
+void CheatSheetIndex::reloadIfDue()
+{
+  if (mReloadInterval == std::chrono::seconds::zero())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mScanning || (std::chrono::steady_clock::now() - mLastScan < mReloadInterval))
+    {
+      return;
+    }
+  }
+  reload();
+}
+
+std::optional<std::string> CheatSheetIndex::find(const std::string_view& topic)
+{
+  if (mDirectory.empty())
+  {
+    return std::nullopt;
+  }
+  reloadIfDue();
+
+  const std::string key = normalizeTopic(topic);
+  std::lock_guard<std::mutex> lock(mMutex);
+  const auto iter = mSheets.find(key);
+  if (iter == mSheets.end())
+  {
+    return std::nullopt;
+  }
+  Sheet& sheet = iter->second;
+  // The file may have been changed in place since it was read. Edits within
+  // the resolution of the modification time still change the size, most of
+  // the time.
+  std::error_code error;
+  const auto modified = std::filesystem::last_write_time(sheet.path, error);
+  std::uintmax_t size = 0;
+  if (!error)
+  {
+    size = std::filesystem::file_size(sheet.path, error);
+  }
+  if (error)
+  {
+    // File was removed after the last scan.
+    mSheets.erase(iter);
+    return std::nullopt;
+  }
+  if ((modified != sheet.modified) || (size != sheet.size))
+  {
+    sheet.text.reset();
+    sheet.modified = modified;
+    sheet.size = size;
+  }
+  if (!sheet.text.has_value())
+  {
+    // Cheat sheets are small, so they are read completely instead of being
+    // mapped into memory. A mapping would crash the bot with SIGBUS, if the
+    // file was truncated while it is read.
+    std::ifstream stream(sheet.path, std::ios::in | std::ios::binary);
+    if (!stream.good())
+    {
+      return std::nullopt;
+    }
+    std::string content;
+    char buffer[4096];
+    while (stream.read(buffer, sizeof(buffer)) || (stream.gcount() > 0))
+    {
+      content.append(buffer, static_cast<std::size_t>(stream.gcount()));
+    }
+    if (stream.bad())
+    {
+      return std::nullopt;
+    }
+    sheet.text = std::move(content);
+  }
+  if (sheet.text.value().empty())
+  {
+    return std::nullopt;
+  }
+  return sheet.text;
+}
+
+} // namespace
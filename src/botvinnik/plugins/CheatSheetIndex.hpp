@@ -0,0 +1,126 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_PLUGIN_CHEATSHEETINDEX_HPP
+#define BVN_PLUGIN_CHEATSHEETINDEX_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace bvn
+{
+
+/** \brief Index of a local directory with cheat sheets.
+ *
+ * The directory can be a checkout of the cheat sheets used by cheat.sh
+ * (one file per topic, named like the topic) or of the tldr pages (Markdown
+ * files like pages/common/tar.md). The index maps topics to files, the files
+ * themselves are only read when they are requested.
+ */
+class CheatSheetIndex
+{
+  public:
+    /** \brief Constructor. Scans the directory for cheat sheets.
+     *
+     * \param directory        directory that contains the cheat sheets; an
+     *                         empty string disables the index
+     * \param reloadInterval   minimum time between two scans for new or
+     *                         removed files; zero disables the reload
+     */
+    CheatSheetIndex(const std::string& directory, const std::chrono::seconds& reloadInterval);
+
+
+    CheatSheetIndex(const CheatSheetIndex& other) = delete;
+    CheatSheetIndex& operator=(const CheatSheetIndex& other) = delete;
+
+
+    /** \brief Gets the number of topics in the index.
+     *
+     * \return Returns the number of known topics.
+     */
+    std::size_t size() const;
+
+
+    /** \brief Gets the cheat sheet for a topic.
+     *
+     * \param topic   the topic, e. g. "tar" or "git commit"
+     * \return Returns an optional containing the cheat sheet.
+     *         Returns an empty optional, if there is no local cheat sheet for
+     *         the topic.
+     * \remarks If reloads are enabled, the directory is scanned again when
+     *          the reload interval has passed. Files whose size or time of
+     *          last modification changed since they were read are always
+     *          read again.
+     */
+    std::optional<std::string> find(const std::string_view& topic);
+
+
+    /** \brief Scans the directory for cheat sheets again.
+     */
+    void reload();
+
+
+    /** \brief Transforms a topic into the name that is used in the index.
+     *
+     * \param topic   the topic, e. g. "Git Commit"
+     * \return Returns the normalized topic, e. g. "git-commit".
+     */
+    static std::string normalizeTopic(const std::string_view& topic);
+  private:
+    /** \brief a cheat sheet file
+     */
+    struct Sheet
+    {
+      std::filesystem::path path; /**< path of the file */
+      std::filesystem::file_time_type modified; /**< time of last modification */
+      std::uintmax_t size; /**< size of the file in bytes */
+      std::optional<std::string> text; /**< content of the file, empty until first use */
+    }; // struct
+
+    using Sheets = std::unordered_map<std::string, Sheet>;
+
+    /** \brief Finds all cheat sheet files in a directory.
+     *
+     * \param directory   the directory
+     * \return Returns the cheat sheets by normalized topic.
+     */
+    static Sheets scan(const std::string& directory);
+
+    /** \brief Scans the directory again, if the reload interval has passed.
+     */
+    void reloadIfDue();
+
+    std::string mDirectory; /**< directory that contains the cheat sheets */
+    std::chrono::seconds mReloadInterval; /**< minimum time between two scans */
+    std::chrono::steady_clock::time_point mLastScan; /**< time of the last scan */
+    bool mScanning; /**< whether a scan is running */
+    Sheets mSheets; /**< cheat sheets by normalized topic */
+    mutable std::mutex mMutex; /**< protects all members except mDirectory and mReloadInterval */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_CHEATSHEETINDEX_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2022  Dirk Stolle
+    Copyright (C) 2022, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -29,7 +29,7 @@ bool DeactivatablePlugin::allowDeactivation(const std::string_view& command) con
   // If a command is in the plugin's command list, it can be deactivated.
   // We could just return true here, but that would also allow "deactivation"
   // of commands that do not even exist, and that could cause confusion.
-  const auto cmds = commands();
+  const auto& cmds = commands();
   return std::find(cmds.begin(), cmds.end(), command) != cmds.end();
 }
 
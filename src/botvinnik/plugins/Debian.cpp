@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2023, 2024, 2025  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2024, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,17 +21,26 @@
 #include "Debian.hpp"
 #include <iostream>
 #include "../../../third-party/simdjson/simdjson.h"
+#include "../../net/CircuitBreaker.hpp"
 #include "../../net/Curly.hpp"
+#include "../../net/HttpCache.hpp"
 #include "../../net/htmlspecialchars.hpp"
 #include "../../net/url_encode.hpp"
+#include "../../util/Arguments.hpp"
 #include "../../util/Strings.hpp"
 
 namespace bvn
 {
 
-std::vector<std::string> Debian::commands() const
+Debian::Debian(DebianSources* sources)
+: mSources(sources)
 {
-  return { "deb", "deb14", "deb13", "deb12", "deb11", "deb10", "deb9", "deb8" };
+}
+
+const std::vector<std::string>& Debian::commands() const
+{
+  static const std::vector<std::string> cmds = { "deb", "deb14", "deb13", "deb12", "deb11", "deb10", "deb9", "deb8" };
+  return cmds;
 }
 
 void Debian::getVersion(Packages::nameVersion& pack, const std::string& suite)
@@ -48,6 +57,9 @@ void Debian::getVersion(Packages::nameVersion& pack, const std::string& suite)
   }
 
   Curly curl;
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+  curl.setHttpCache(&HttpCache::upstreams());
+  curl.coalesceRequests(true);
   // URL is something like https://sources.debian.org/api/src/mc/?suite=buster, e. g. for package "mc".
   curl.setURL("https://sources.debian.org/api/src/" + encodedPackageName + "/?suite=" + suite);
   std::string response;
@@ -78,30 +90,47 @@ void Debian::getVersion(Packages::nameVersion& pack, const std::string& suite)
   pack.second = v.get<std::string_view>().value();
 }
 
-void Debian::getVersions(Packages& packs, const std::string& suite)
+void Debian::getVersions(Packages& packs, const std::string& suite, ThreadPool& pool)
 {
+  // All version requests are independent of each other, so run them at the
+  // same time instead of one after another.
+  std::vector<std::future<void>> requests;
   if (!packs.exact.first.empty())
-    getVersion(packs.exact, suite);
+  {
+    requests.push_back(pool.submit([&packs, &suite]() { getVersion(packs.exact, suite); }));
+  }
 
   const std::size_t limit = std::min(static_cast<std::size_t>(3), packs.others.size());
   for (std::size_t i = 0; i < limit; ++i)
   {
-    getVersion(packs.others[i], suite);
+    requests.push_back(pool.submit([&packs, &suite, i]() { getVersion(packs.others[i], suite); }));
+  }
+
+  for (auto& request: requests)
+  {
+    pool.await(request);
   }
 }
 
-Message Debian::packageSearch(const std::string_view& command, const std::string_view& message, const std::string& suite)
+Message Debian::packageSearch(const std::string_view& command, const std::string_view& message, const std::string& suite, ThreadPool& pool)
 {
-  std::string packageName(message.substr(command.size() + 1));
-  trim(packageName);
-  if (packageName.size() < 2)
+  const std::string_view name = Arguments(message, command).rest();
+  if (name.size() < 2)
   {
     return Message("Debian package name to search for must be at least two characters long!");
   }
 
   // Debian packages always use lower case letters, so transform any upper case
   // characters to lower case.
-  packageName = toLowerString(packageName);
+  const std::string packageName = toLowerString(std::string(name));
+
+  // A local table of the suite already has all names and versions, so no
+  // request is necessary.
+  const auto table = (mSources != nullptr) ? mSources->table(suite) : nullptr;
+  if (table != nullptr)
+  {
+    return formatResult(localSearch(*table, packageName), suite, packageName);
+  }
 
   std::string encodedPackageName;
   try
@@ -115,12 +144,19 @@ Message Debian::packageSearch(const std::string_view& command, const std::string
   }
 
   Curly curl;
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+  curl.setHttpCache(&HttpCache::upstreams());
+  curl.coalesceRequests(true);
   // URL is something like https://sources.debian.org/api/search/mc/?suite=stretch, e. g. for package "mc".
   curl.setURL(std::string("https://sources.debian.org/api/search/")
               .append(encodedPackageName).append("/?suite=").append(suite));
   std::string response;
   if (!curl.perform(response) || curl.getResponseCode() != 200)
   {
+    if (curl.circuitOpen())
+    {
+      return Message("The Debian package API is currently unavailable. Please try again later.");
+    }
     std::cerr << "Error: Request to Debian package search API failed!\n"
               << "URL: " << curl.getURL() << '\n'
               << "HTTP status code: " << curl.getResponseCode() << '\n'
@@ -184,11 +220,28 @@ Message Debian::packageSearch(const std::string_view& command, const std::string
     packs.others.emplace_back(std::pair(itemName.get<std::string_view>().value(), std::string()));
   }
 
-  getVersions(packs, suite);
+  getVersions(packs, suite, pool);
 
   return formatResult(packs, suite, packageName);
 }
 
+Debian::Packages Debian::localSearch(const DebianSourcesTable& table, const std::string& packageName)
+{
+  Packages packs;
+  for (const auto& [packName, version]: table.search(packageName))
+  {
+    if (packName == packageName)
+    {
+      packs.exact = std::pair(std::string(packName), std::string(version));
+    }
+    else
+    {
+      packs.others.emplace_back(std::string(packName), std::string(version));
+    }
+  }
+  return packs;
+}
+
 Message Debian::formatResult(const Packages& packs, const std::string& suite, const std::string_view& packageName)
 {
   if (packs.exact.first.empty() && packs.others.empty())
@@ -269,49 +322,60 @@ Message Debian::formatResult(const Packages& packs, const std::string& suite, co
   return result;
 }
 
-Message Debian::handleCommand(const std::string_view& command, const std::string_view& message,
-                              const std::string_view& userId,
-                              [[maybe_unused]] const std::string_view& roomId,
-                              [[maybe_unused]] const std::chrono::milliseconds& server_ts)
+std::string Debian::suiteOf(const std::string_view& command)
 {
-  if (message.size() <= command.size() + 1)
-  {
-    return Message(std::string(userId)
-        .append(": You have to give a package name (or part of a package name) after the '")
-        .append(command).append("' command."));
-  }
-
   if (command == "deb14")
   {
-    return packageSearch(command, message, "forky");
+    return "forky";
   }
   if (command == "deb" || command == "deb13")
   {
-    return packageSearch(command, message, "trixie");
+    return "trixie";
   }
   if (command == "deb12")
   {
-    return packageSearch(command, message, "bookworm");
+    return "bookworm";
   }
   if (command == "deb11")
   {
-    return packageSearch(command, message, "bullseye");
+    return "bullseye";
   }
   if (command == "deb10")
   {
-    return packageSearch(command, message, "buster");
+    return "buster";
   }
   if (command == "deb9")
   {
-    return packageSearch(command, message, "stretch");
+    return "stretch";
   }
   if (command == "deb8")
   {
-    return packageSearch(command, message, "jessie");
+    return "jessie";
   }
 
   // unknown command
-  return Message();
+  return std::string();
+}
+
+std::future<Message> Debian::handleCommandAsync(Invocation inv, ThreadPool& pool)
+{
+  std::string suite = suiteOf(inv.command);
+  if (suite.empty())
+  {
+    // unknown command
+    return readyAnswer(Message());
+  }
+  if (Arguments(inv.message, inv.command).empty())
+  {
+    return readyAnswer(Message(std::string(inv.userId)
+        .append(": You have to give a package name (or part of a package name) after the '")
+        .append(inv.command).append("' command.")));
+  }
+
+  return pool.submit([this, inv = std::move(inv), suite = std::move(suite), &pool]()
+  {
+    return packageSearch(inv.command, inv.message, suite, pool);
+  });
 }
 
 std::string Debian::helpOneLine(const std::string_view& command) const
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -22,34 +22,42 @@
 #define BVN_PLUGIN_DEBIAN_HPP
 
 #include <utility>
-#include "DeactivatablePlugin.hpp"
+#include "AsyncPlugin.hpp"
+#include "DebianSources.hpp"
 
 namespace bvn
 {
 
 /** \brief Replies with a list of available Debian packages.
  */
-class Debian final: public DeactivatablePlugin
+class Debian final: public AsyncPlugin
 {
   public:
+    /** \brief Constructor.
+     *
+     * \param sources  local tables of Debian source packages; nullptr means
+     *                 that all searches use sources.debian.org
+     * \remarks The tables must outlive the plugin. Suites without a local
+     *          table are searched via sources.debian.org.
+     */
+    explicit Debian(DebianSources* sources = nullptr);
+
+
     /** \brief Gets a list of commands that are provided by this plugin.
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    std::vector<std::string> commands() const override;
+    const std::vector<std::string>& commands() const override;
 
 
-    /** \brief Reacts to a given command.
+    /** \brief Starts handling a command.
      *
-     * \param command   name of the command to handle
-     * \param message   complete text message that triggered the command
-     * \param userId    id of the user that sent the message
-     * \param roomId    id of the room that contains the message
-     * \param server_ts timestamp when the message reached the server
-     * \return Returns a message to send as reply to the command.
-     *         If the return value is empty, no message will be sent.
+     * \param inv   the command invocation
+     * \param pool  the thread pool to execute the jobs of the command with
+     * \return Returns a future that gets the message to send as reply to the
+     *         command. If the message is empty, no message will be sent.
      */
-    Message handleCommand(const std::string_view& command, const std::string_view& message, const std::string_view& userId, const std::string_view& roomId, const std::chrono::milliseconds& server_ts) override;
+    std::future<Message> handleCommandAsync(Invocation inv, ThreadPool& pool) override;
 
 
     /** \brief Gets a short, one line help text for a command.
@@ -79,18 +87,38 @@ class Debian final: public DeactivatablePlugin
     }; // struct
 
 
+    /** \brief Gets the name of the Debian suite for a command.
+     *
+     * \param command   name of the command
+     * \return Returns the suite name, e. g. "trixie".
+     *         Returns an empty string for unknown commands.
+     */
+    static std::string suiteOf(const std::string_view& command);
+
+
     /** \brief Searches for packages with the given name.
      *
      * \param command   name of the command to handle
      * \param message   complete text message that triggered the command
      * \param suite     name of the package suite to search
+     * \param pool      thread pool for the version requests
      * \return Returns a message containing information about the found packages.
      */
-    Message packageSearch(const std::string_view& command, const std::string_view& message, const std::string& suite);
+    Message packageSearch(const std::string_view& command, const std::string_view& message, const std::string& suite, ThreadPool& pool);
+
+    /** \brief Searches for packages in a local table.
+     *
+     * \param table         the table of the suite
+     * \param packageName   name of the package to search for
+     * \return Returns the matching packages and their versions.
+     */
+    static Packages localSearch(const DebianSourcesTable& table, const std::string& packageName);
 
     static void getVersion(Packages::nameVersion& pack, const std::string& suite);
-    static void getVersions(Packages& packs, const std::string& suite);
+    static void getVersions(Packages& packs, const std::string& suite, ThreadPool& pool);
     Message formatResult(const Packages& packs, const std::string& suite, const std::string_view& packageName);
+
+    DebianSources* mSources; /**< local tables of source packages, may be nullptr */
 }; // class
 
 } // namespace
@@ -0,0 +1,133 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "DebianSources.hpp"
+#include <iostream>
+
+namespace bvn
+{
+
+DebianSources::DebianSources(const std::map<std::string, std::vector<std::string>>& files, const std::chrono::minutes& interval)
+: mFiles(files),
+  mInterval(interval),
+  mModified(),
+  mRefreshing(),
+  mTables(),
+  mTablesMutex(),
+  stopping(false),
+  mutex(),
+  wakeUp(),
+  worker()
+{
+}
+
+DebianSources::~DebianSources()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wakeUp.notify_one();
+  if (worker.joinable())
+  {
+    worker.join();
+  }
+}
+
+void DebianSources::start()
+{
+  if (mFiles.empty() || worker.joinable())
+  {
+    return;
+  }
+  worker = std::thread(&DebianSources::refreshLoop, this);
+}
+
+std::size_t DebianSources::refresh()
+{
+  std::lock_guard<std::mutex> refreshLock(mRefreshing);
+  std::size_t rebuilt = 0;
+  for (const auto& [suite, files]: mFiles)
+  {
+    std::vector<std::filesystem::file_time_type> modified;
+    std::error_code error;
+    for (const auto& file: files)
+    {
+      modified.push_back(std::filesystem::last_write_time(file, error));
+      if (error)
+      {
+        break;
+      }
+    }
+    if (error)
+    {
+      std::cerr << "Error: Could not read the Sources files for Debian "
+                << suite << ": " << error.message() << "\n";
+      continue;
+    }
+    const auto known = mModified.find(suite);
+    if ((known != mModified.end()) && (known->second == modified))
+    {
+      continue;
+    }
+
+    auto table = DebianSourcesTable::build(files);
+    if (!table.has_value())
+    {
+      std::cerr << "Error: Could not read the Sources files for Debian "
+                << suite << "!\n";
+      continue;
+    }
+    std::clog << "Info: Loaded " << table.value().size()
+              << " source packages for Debian " << suite << "." << std::endl;
+    {
+      std::lock_guard<std::mutex> lock(mTablesMutex);
+      mTables[suite] = std::make_shared<const DebianSourcesTable>(std::move(table.value()));
+    }
+    mModified[suite] = std::move(modified);
+    ++rebuilt;
+  }
+  return rebuilt;
+}
+
+std::shared_ptr<const DebianSourcesTable> DebianSources::table(const std::string& suite) const
+{
+  std::lock_guard<std::mutex> lock(mTablesMutex);
+  const auto iter = mTables.find(suite);
+  if (iter == mTables.end())
+  {
+    return nullptr;
+  }
+  return iter->second;
+}
+
+void DebianSources::refreshLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping)
+  {
+    lock.unlock();
+    refresh();
+    lock.lock();
+    wakeUp.wait_for(lock, mInterval, [this]() { return stopping; });
+  }
+}
+
+} // namespace
@@ -0,0 +1,112 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_PLUGIN_DEBIANSOURCES_HPP
+#define BVN_PLUGIN_DEBIANSOURCES_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DebianSourcesTable.hpp"
+
+namespace bvn
+{
+
+/** \brief Keeps tables of the source packages of several Debian suites.
+ *
+ * A background thread checks the Sources files of each suite in regular
+ * intervals and rebuilds the table of a suite when its files have changed.
+ * Lookups always use the last complete table, so they never wait for a
+ * rebuild.
+ */
+class DebianSources
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param files      names of the Sources files for each suite, e. g.
+     *                   "trixie"
+     * \param interval   time between two checks for changed files
+     * \remarks No table is built before refresh() or start() is called.
+     */
+    DebianSources(const std::map<std::string, std::vector<std::string>>& files, const std::chrono::minutes& interval);
+
+
+    DebianSources(const DebianSources& other) = delete;
+    DebianSources& operator=(const DebianSources& other) = delete;
+
+
+    /** \brief Destructor. Stops the background thread.
+     */
+    ~DebianSources();
+
+
+    /** \brief Starts the background thread.
+     *
+     * \remarks Does nothing, if there are no files or if the thread is
+     *          already running.
+     */
+    void start();
+
+
+    /** \brief Rebuilds the tables of all suites whose files have changed.
+     *
+     * \return Returns the number of suites that were rebuilt.
+     * \remarks This is called by the background thread, but it can also be
+     *          called directly. If a file cannot be read, the previous table
+     *          of the suite is kept and the next call tries again.
+     */
+    std::size_t refresh();
+
+
+    /** \brief Gets the table of a suite.
+     *
+     * \param suite   name of the suite, e. g. "trixie"
+     * \return Returns the current table of the suite.
+     *         Returns nullptr, if the suite has no files or if its table has
+     *         not been built yet.
+     */
+    std::shared_ptr<const DebianSourcesTable> table(const std::string& suite) const;
+  private:
+    /** \brief Loop of the background thread.
+     */
+    void refreshLoop();
+
+    std::map<std::string, std::vector<std::string>> mFiles; /**< Sources files of each suite */
+    std::chrono::minutes mInterval; /**< time between two checks for changed files */
+    std::map<std::string, std::vector<std::filesystem::file_time_type>> mModified; /**< modification times of the files of the current tables */
+    std::mutex mRefreshing; /**< serializes calls of refresh() */
+    std::map<std::string, std::shared_ptr<const DebianSourcesTable>> mTables; /**< current table of each suite */
+    mutable std::mutex mTablesMutex; /**< protects mTables */
+    bool stopping; /**< whether the background thread shall stop */
+    std::mutex mutex; /**< protects stopping */
+    std::condition_variable wakeUp; /**< signals the background thread */
+    std::thread worker; /**< background thread */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_DEBIANSOURCES_HPP
@@ -0,0 +1,270 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "DebianSourcesTable.hpp"
+#include <algorithm>
+#include <iostream>
+#include "../../util/MappedFile.hpp"
+
+namespace bvn
+{
+
+/** \brief Gets the trigram at a position of a text as integer.
+ *
+ * \param text   the text
+ * \param pos    position of the first character of the trigram
+ * \return Returns the three characters packed into an integer.
+ */
+uint32_t trigramAt(const std::string_view& text, const std::size_t pos)
+{
+  return (static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) << 16)
+       | (static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8)
+       | static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+}
+
+DebianSourcesTable::DebianSourcesTable()
+: mText(),
+  mEntries(),
+  mTrigrams()
+{
+}
+
+void DebianSourcesTable::parse(const std::string_view& content, std::vector<std::pair<std::string, std::string>>& packages)
+{
+  std::string_view name;
+  std::string_view version;
+  bool extraSourceOnly = false;
+  std::size_t start = 0;
+  while (start <= content.size())
+  {
+    auto end = content.find('\n', start);
+    if (end == std::string_view::npos)
+    {
+      end = content.size();
+    }
+    std::string_view line = content.substr(start, end - start);
+    if (!line.empty() && (line.back() == '\r'))
+    {
+      line.remove_suffix(1);
+    }
+    start = end + 1;
+
+    if (line.empty())
+    {
+      // A blank line ends the paragraph of a package. Extra source packages
+      // are older versions that are only kept because of Built-Using.
+      if (!name.empty() && !version.empty() && !extraSourceOnly)
+      {
+        packages.emplace_back(name, version);
+      }
+      name = std::string_view();
+      version = std::string_view();
+      extraSourceOnly = false;
+      continue;
+    }
+
+    const auto colon = line.find(':');
+    if ((colon == std::string_view::npos) || (line[0] == ' ') || (line[0] == '\t'))
+    {
+      // continuation line of a multi-line field
+      continue;
+    }
+    const std::string_view field = line.substr(0, colon);
+    std::string_view value = line.substr(colon + 1);
+    while (!value.empty() && ((value.front() == ' ') || (value.front() == '\t')))
+    {
+      value.remove_prefix(1);
+    }
+    while (!value.empty() && ((value.back() == ' ') || (value.back() == '\t')))
+    {
+      value.remove_suffix(1);
+    }
+    if (field == "Package")
+    {
+      name = value;
+    }
+    else if (field == "Version")
+    {
+      version = value;
+    }
+    else if (field == "Extra-Source-Only")
+    {
+      extraSourceOnly = value == "yes";
+    }
+  }
+  // last paragraph without blank line after it
+  if (!name.empty() && !version.empty() && !extraSourceOnly)
+  {
+    packages.emplace_back(name, version);
+  }
+}
+
+std::optional<DebianSourcesTable> DebianSourcesTable::build(const std::vector<std::string>& files)
+{
+  std::vector<std::pair<std::string, std::string>> packages;
+  for (const auto& fileName: files)
+  {
+    MappedFile file;
+    if (!file.open(fileName))
+    {
+      return std::nullopt;
+    }
+    parse(file.content(), packages);
+  }
+
+  // Stable sort keeps the order of the files, so the first one wins.
+  std::stable_sort(packages.begin(), packages.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+  const auto last = std::unique(packages.begin(), packages.end(),
+                                [](const auto& a, const auto& b) { return a.first == b.first; });
+  packages.erase(last, packages.end());
+
+  DebianSourcesTable table;
+  std::size_t textSize = 0;
+  for (const auto& [name, version]: packages)
+  {
+    textSize += name.size() + version.size();
+  }
+  // Offsets are stored as 32 bit integers.
+  if (textSize > UINT32_MAX)
+  {
+    std::cerr << "Error: The Sources files contain too many packages!\n";
+    return std::nullopt;
+  }
+  table.mText.reserve(textSize);
+  table.mEntries.reserve(packages.size());
+  for (const auto& [name, version]: packages)
+  {
+    const auto index = static_cast<uint32_t>(table.mEntries.size());
+    Entry entry;
+    entry.name = static_cast<uint32_t>(table.mText.size());
+    entry.nameLength = static_cast<uint32_t>(name.size());
+    table.mText.append(name);
+    entry.version = static_cast<uint32_t>(table.mText.size());
+    entry.versionLength = static_cast<uint32_t>(version.size());
+    table.mText.append(version);
+    table.mEntries.push_back(entry);
+
+    for (std::size_t i = 0; i + 3 <= name.size(); ++i)
+    {
+      table.mTrigrams.emplace_back(trigramAt(name, i), index);
+    }
+  }
+  // Sorting by trigram and then by entry keeps the entries of each trigram
+  // in alphabetical order.
+  std::sort(table.mTrigrams.begin(), table.mTrigrams.end());
+  table.mTrigrams.erase(std::unique(table.mTrigrams.begin(), table.mTrigrams.end()),
+                        table.mTrigrams.end());
+  table.mTrigrams.shrink_to_fit();
+  return table;
+}
+
+std::size_t DebianSourcesTable::size() const
+{
+  return mEntries.size();
+}
+
+std::string_view DebianSourcesTable::nameOf(const uint32_t index) const
+{
+  const Entry& entry = mEntries[index];
+  return std::string_view(mText).substr(entry.name, entry.nameLength);
+}
+
+std::string_view DebianSourcesTable::versionOf(const uint32_t index) const
+{
+  const Entry& entry = mEntries[index];
+  return std::string_view(mText).substr(entry.version, entry.versionLength);
+}
+
+std::optional<std::string_view> DebianSourcesTable::version(const std::string_view& name) const
+{
+  const auto iter = std::lower_bound(mEntries.begin(), mEntries.end(), name,
+      [this](const Entry& entry, const std::string_view& value)
+      {
+        return std::string_view(mText).substr(entry.name, entry.nameLength) < value;
+      });
+  if (iter == mEntries.end())
+  {
+    return std::nullopt;
+  }
+  const auto index = static_cast<uint32_t>(iter - mEntries.begin());
+  if (nameOf(index) != name)
+  {
+    return std::nullopt;
+  }
+  return versionOf(index);
+}
+
+std::vector<DebianSourcesTable::NameVersion> DebianSourcesTable::search(const std::string_view& part) const
+{
+  std::vector<NameVersion> result;
+  if (part.empty())
+  {
+    return result;
+  }
+
+  if (part.size() < 3)
+  {
+    // Too short for a trigram, so every name has to be checked.
+    for (uint32_t i = 0; i < mEntries.size(); ++i)
+    {
+      if (nameOf(i).find(part) != std::string_view::npos)
+      {
+        result.emplace_back(nameOf(i), versionOf(i));
+      }
+    }
+    return result;
+  }
+
+  // Every match contains all trigrams of the text, so checking the entries
+  // of the rarest trigram is enough.
+  const auto byTrigram = [](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b)
+  {
+    return a.first < b.first;
+  };
+  auto best = std::make_pair(mTrigrams.end(), mTrigrams.end());
+  std::size_t bestCount = mTrigrams.size() + 1;
+  for (std::size_t i = 0; i + 3 <= part.size(); ++i)
+  {
+    const auto range = std::equal_range(mTrigrams.begin(), mTrigrams.end(),
+                                        std::make_pair(trigramAt(part, i), uint32_t(0)), byTrigram);
+    const auto count = static_cast<std::size_t>(range.second - range.first);
+    if (count < bestCount)
+    {
+      best = range;
+      bestCount = count;
+    }
+    if (count == 0)
+    {
+      return result;
+    }
+  }
+
+  for (auto iter = best.first; iter != best.second; ++iter)
+  {
+    if (nameOf(iter->second).find(part) != std::string_view::npos)
+    {
+      result.emplace_back(nameOf(iter->second), versionOf(iter->second));
+    }
+  }
+  return result;
+}
+
+} // namespace
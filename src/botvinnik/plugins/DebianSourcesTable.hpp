@@ -0,0 +1,128 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_PLUGIN_DEBIANSOURCESTABLE_HPP
+#define BVN_PLUGIN_DEBIANSOURCESTABLE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bvn
+{
+
+/** \brief Table of the source packages of a Debian suite and their versions.
+ *
+ * The table is built from Sources files as they are found in a Debian mirror
+ * (after decompression) or in /var/lib/apt/lists. Names are kept in sorted
+ * order, and a trigram index allows to find all names that contain a given
+ * text without looking at every name.
+ */
+class DebianSourcesTable
+{
+  public:
+    /** \brief name and version of a source package
+     */
+    using NameVersion = std::pair<std::string_view, std::string_view>;
+
+
+    /** \brief Creates an empty table.
+     */
+    DebianSourcesTable();
+
+
+    /** \brief Builds a table from Sources files.
+     *
+     * \param files   names of the uncompressed Sources files
+     * \return Returns an optional containing the table.
+     *         Returns an empty optional, if a file could not be read.
+     * \remarks If a package occurs in more than one file, then the version
+     *          of the first file is used.
+     */
+    static std::optional<DebianSourcesTable> build(const std::vector<std::string>& files);
+
+
+    /** \brief Gets the number of source packages in the table.
+     *
+     * \return Returns the number of packages.
+     */
+    std::size_t size() const;
+
+
+    /** \brief Gets the version of a package.
+     *
+     * \param name   the exact name of the package
+     * \return Returns an optional containing the version of the package.
+     *         Returns an empty optional, if there is no such package.
+     */
+    std::optional<std::string_view> version(const std::string_view& name) const;
+
+
+    /** \brief Finds all packages whose name contains a text.
+     *
+     * \param part   the text to search for
+     * \return Returns names and versions of all matching packages in
+     *         alphabetical order. This includes an exact match.
+     * \remarks The returned views are valid as long as the table exists.
+     */
+    std::vector<NameVersion> search(const std::string_view& part) const;
+  private:
+    /** \brief location of name and version of a package in mText
+     */
+    struct Entry
+    {
+      uint32_t name; /**< offset of the name */
+      uint32_t nameLength; /**< length of the name */
+      uint32_t version; /**< offset of the version */
+      uint32_t versionLength; /**< length of the version */
+    }; // struct
+
+    /** \brief Adds the packages of a Sources file.
+     *
+     * \param content    content of the Sources file
+     * \param packages   vector that receives names and versions
+     */
+    static void parse(const std::string_view& content, std::vector<std::pair<std::string, std::string>>& packages);
+
+    /** \brief Gets the name of an entry.
+     *
+     * \param index   index of the entry
+     * \return Returns the name of the package.
+     */
+    std::string_view nameOf(const uint32_t index) const;
+
+    /** \brief Gets the version of an entry.
+     *
+     * \param index   index of the entry
+     * \return Returns the version of the package.
+     */
+    std::string_view versionOf(const uint32_t index) const;
+
+    std::string mText; /**< names and versions of all packages */
+    std::vector<Entry> mEntries; /**< packages, sorted by name */
+    std::vector<std::pair<uint32_t, uint32_t>> mTrigrams; /**< trigrams and the entries that contain them, sorted */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_DEBIANSOURCESTABLE_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2021, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,82 +19,128 @@
 */
 
 #include "Fortune.hpp"
-#include <array>
-#include <cstdio>
-#include <filesystem>
+#include <algorithm>
 #include <iostream>
-#include <memory>
-#include <optional>
 #include "../../net/htmlspecialchars.hpp"
+#include "../../util/Arguments.hpp"
 
 namespace bvn
 {
 
-std::optional<std::string> executeCommand(const char* noArgsCommand)
+Fortune::Fortune()
+: Fortune(FortuneDatabase::defaultDirectories())
 {
-  std::array<char, 512> buffer;
-  std::string result;
-  std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(noArgsCommand, "r"), pclose);
-  if (!pipe)
+}
+
+Fortune::Fortune(const std::vector<std::string>& directories)
+: database()
+{
+  std::size_t files = 0;
+  for (const auto& directory: directories)
   {
-    std::cerr << "Error: popen() failed! Maybe the required binary is not installed?" << std::endl;
-    return std::optional<std::string>();
+    files += database.loadDirectory(directory);
   }
-  while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
+  if (database.size() == 0)
   {
-    result += buffer.data();
+    std::clog << "Warning: No fortune files were found, the fortune command "
+              << "will not work." << std::endl;
   }
-  return std::optional<std::string>(result);
-}
-
-std::string Fortune::executableLocation()
-{
-  std::error_code ec;
-  // Debian and Debian-based distributions use /usr/games/fortune as path.
-  if (std::filesystem::exists("/usr/games/fortune", ec))
+  else
   {
-    return "/usr/games/fortune";
+    std::clog << "Info: Loaded " << database.size() << " fortune cookies from "
+              << files << " files." << std::endl;
   }
-  // RHEL-based distributions use /usr/bin/fortune as path, so use that if the
-  // path above does not exist.
-  return "/usr/bin/fortune";
 }
 
-std::vector<std::string> Fortune::commands() const
+const std::vector<std::string>& Fortune::commands() const
 {
-  return { "fortune", "fortunes" };
+  static const std::vector<std::string> cmds = { "fortune", "fortunes" };
+  return cmds;
 }
 
 Message Fortune::handleCommand(const std::string_view& command,
-                               [[maybe_unused]] const std::string_view& message,
+                               const std::string_view& message,
                                [[maybe_unused]] const std::string_view& userId,
                                [[maybe_unused]] const std::string_view& roomId,
                                [[maybe_unused]] const std::chrono::milliseconds& server_ts)
 {
-  if ((command == "fortune") || (command == "fortunes"))
+  if ((command != "fortune") && (command != "fortunes"))
   {
-    // fortune only works when installed.
-    const auto text = executeCommand(executableLocation().c_str());
-    if (text.has_value() && !text.value().empty())
-    {
-      return Message(text.value(), std::string("<pre>").append(htmlspecialchars(text.value())).append("</pre>"));
-    }
+    // unknown command
+    return Message();
+  }
 
-    // fortune may not be installed. Warn user.
-    return Message(std::string("Error: Failed to generate fortune. fortune ")
-                   + "binary may not be installed. If you are the administrator"
+  if (database.size() == 0)
+  {
+    // fortune files may not be installed. Warn user.
+    return Message(std::string("Error: Failed to generate fortune. The fortune ")
+                   + "files may not be installed. If you are the administrator"
                    + " of the server where the bot runs, then try something like\n\n"
-                   + "    apt-get install fortune-mod\n\nor similar to install it.",
+                   + "    apt-get install fortunes-min\n\nor similar to install them.",
                    std::string("<strong>Error: Failed to generate fortune. ")
-                   + "fortune binary may not be installed.</strong> If you are"
+                   + "The fortune files may not be installed.</strong> If you are"
                    + " the administrator of the server where the bot runs, then"
                    + " try something like<br />\n<br />\n<code>"
-                   + "apt-get install fortune-mod</code><br />\n<br />\nor "
-                   + "similar to install it.");
+                   + "apt-get install fortunes-min</code><br />\n<br />\nor "
+                   + "similar to install them.");
+  }
+
+  // Options are similar to the ones of the fortune program.
+  std::size_t maxLength = 0;
+  std::string file;
+  Arguments args(message, command);
+  while (!args.empty())
+  {
+    const std::string_view option = args.next().value();
+    if (option == "-s")
+    {
+      maxLength = FortuneDatabase::short_length;
+    }
+    else if (option == "-n")
+    {
+      const auto length = args.nextNumber<std::size_t>();
+      if (!length.has_value() || (length.value() == 0))
+      {
+        return Message("Error: The option -n needs a positive number as maximum length.");
+      }
+      maxLength = length.value();
+    }
+    else if (option == "-f")
+    {
+      std::string list;
+      for (const auto& name: database.files())
+      {
+        list.append(list.empty() ? "" : ", ").append(name);
+      }
+      return Message("Available fortune files: " + list);
+    }
+    else if (file.empty())
+    {
+      file = option;
+    }
+    else
+    {
+      return Message("Error: Only one fortune file can be given.");
+    }
+  }
+
+  if (!file.empty())
+  {
+    const auto names = database.files();
+    if (std::find(names.begin(), names.end(), file) == names.end())
+    {
+      return Message("Error: There is no fortune file named '" + file
+                     + "'. Use the option -f to list the available files.");
+    }
   }
 
-  // unknown command
-  return Message();
+  const auto text = database.random(file, maxLength);
+  if (!text.has_value())
+  {
+    return Message("There is no fortune with at most " + std::to_string(maxLength)
+                   + " characters" + (file.empty() ? "" : " in " + file) + ".");
+  }
+  return Message(text.value(), std::string("<pre>").append(htmlspecialchars(text.value())).append("</pre>"));
 }
 
 std::string Fortune::helpOneLine(const std::string_view& command) const
@@ -112,10 +158,24 @@ std::string Fortune::helpOneLine(const std::string_view& command) const
 }
 
 Message Fortune::helpExtended(const std::string_view& command,
-             [[maybe_unused]] const std::string_view& prefix) const
+             const std::string_view& prefix) const
 {
   const auto text = helpOneLine(command);
-  return Message(text, text);
+  if (text.empty())
+  {
+    return Message();
+  }
+  const std::string cmd = std::string(prefix).append(command);
+  return Message(text + ". The name of a fortune file after the command picks "
+                 + "a quote from that file only, e. g. `" + cmd + " science`. "
+                 + "The option -s only picks short quotes, and -n followed by "
+                 + "a number picks quotes with at most that many characters, "
+                 + "e. g. `" + cmd + " -n 80`. The option -f lists the available files.",
+                 text + ". The name of a fortune file after the command picks "
+                 + "a quote from that file only, e. g. <code>" + cmd + " science</code>. "
+                 + "The option -s only picks short quotes, and -n followed by "
+                 + "a number picks quotes with at most that many characters, "
+                 + "e. g. <code>" + cmd + " -n 80</code>. The option -f lists the available files.");
 }
 
 } // namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -22,6 +22,7 @@
 #define BVN_PLUGIN_FORTUNE_HPP
 
 #include "DeactivatablePlugin.hpp"
+#include "FortuneDatabase.hpp"
 
 namespace bvn
 {
@@ -31,11 +32,24 @@ namespace bvn
 class Fortune final: public DeactivatablePlugin
 {
   public:
+    /** \brief Constructor. Loads the fortune files from the directories where
+     *         they are usually installed.
+     */
+    Fortune();
+
+
+    /** \brief Constructor. Loads the fortune files from the given directories.
+     *
+     * \param directories  directories that contain fortune files
+     */
+    explicit Fortune(const std::vector<std::string>& directories);
+
+
     /** \brief Gets a list of commands that are provided by this plugin.
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    std::vector<std::string> commands() const override;
+    const std::vector<std::string>& commands() const override;
 
 
     /** \brief Reacts to a given command.
@@ -66,14 +80,8 @@ class Fortune final: public DeactivatablePlugin
      * \return Returns a Message containing a longer help text for the command.
      */
     Message helpExtended(const std::string_view& command, const std::string_view& prefix) const override;
-
-
-    /** \brief Gets the location of the fortune executable.
-     *
-     * \return Returns a possible location of the fortune executable.
-     * \remarks If fortune is not installed, then this path is not correct.
-     */
-    static std::string executableLocation();
+  private:
+    FortuneDatabase database; /**< loaded fortune cookies */
 }; // class
 
 } // namespace
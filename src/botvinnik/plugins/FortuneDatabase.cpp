@@ -0,0 +1,332 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "FortuneDatabase.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+namespace bvn
+{
+
+// fortune uses 160 characters as limit for short cookies.
+const std::size_t FortuneDatabase::short_length = 160;
+
+/** \brief Reads an unsigned 32 bit integer in network byte order.
+ *
+ * \param data  pointer to the first of the four bytes
+ * \return Returns the integer.
+ */
+uint32_t readBigEndian32(const char* data)
+{
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+  return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16)
+       | (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+/** \brief Removes the trailing delimiter line and line breaks of a cookie.
+ *
+ * \param region  text from the start of the cookie up to the next cookie
+ * \param delim   delimiter character, usually '%'
+ * \return Returns the text of the cookie.
+ */
+std::string_view cookieText(std::string_view region, const char delim)
+{
+  const auto trimEnd = [](std::string_view& view)
+  {
+    while (!view.empty() && ((view.back() == '\n') || (view.back() == '\r')))
+    {
+      view.remove_suffix(1);
+    }
+  };
+  trimEnd(region);
+  if (!region.empty() && (region.back() == delim)
+      && ((region.size() == 1) || (region[region.size() - 2] == '\n')))
+  {
+    region.remove_suffix(1);
+    trimEnd(region);
+  }
+  return region;
+}
+
+/** \brief Finds the end of a cookie, i. e. the next delimiter line.
+ *
+ * \param text   content of the text file
+ * \param start  offset of the start of the cookie
+ * \param delim  delimiter character, usually '%'
+ * \return Returns the offset of the delimiter line after the cookie, or the
+ *         size of the text, if there is none.
+ */
+std::size_t cookieEnd(const std::string_view& text, std::size_t start, const char delim)
+{
+  while (start < text.size())
+  {
+    auto lineEnd = text.find('\n', start);
+    if (lineEnd == std::string_view::npos)
+    {
+      lineEnd = text.size();
+    }
+    const auto line = text.substr(start, lineEnd - start);
+    if (((line.size() == 1) || ((line.size() == 2) && (line[1] == '\r'))) && (line[0] == delim))
+    {
+      return start;
+    }
+    start = lineEnd + 1;
+  }
+  return text.size();
+}
+
+FortuneDatabase::FortuneDatabase()
+: mFiles(),
+  mAll()
+{
+}
+
+std::vector<std::string> FortuneDatabase::defaultDirectories()
+{
+  return {
+      // Debian and Debian-based distributions
+      "/usr/share/games/fortunes",
+      // RHEL-based distributions
+      "/usr/share/games/fortune",
+      // Arch Linux
+      "/usr/share/fortune",
+      // Alpine Linux
+      "/usr/share/fortunes"
+  };
+}
+
+std::size_t FortuneDatabase::loadDirectory(const std::string& directory)
+{
+  namespace fs = std::filesystem;
+
+  std::error_code error;
+  if (!fs::is_directory(directory, error))
+  {
+    return 0;
+  }
+  std::vector<std::string> fileNames;
+  for (const auto& entry: fs::directory_iterator(directory, error))
+  {
+    const std::string name = entry.path().filename().string();
+    if ((name.find('.') == std::string::npos) && entry.is_regular_file(error))
+    {
+      fileNames.push_back(entry.path().string());
+    }
+  }
+  // Load files in a fixed order, independent of the file system.
+  std::sort(fileNames.begin(), fileNames.end());
+
+  std::size_t loaded = 0;
+  for (const auto& fileName: fileNames)
+  {
+    if (loadFile(fileName))
+    {
+      ++loaded;
+    }
+  }
+  return loaded;
+}
+
+bool FortuneDatabase::loadFile(const std::string& fileName)
+{
+  File file;
+  file.name = std::filesystem::path(fileName).filename().string();
+  file.rotated = false;
+  const auto sameName = [&file](const File& other) { return other.name == file.name; };
+  if (file.name.empty() || std::any_of(mFiles.begin(), mFiles.end(), sameName))
+  {
+    return false;
+  }
+  file.text = std::make_unique<MappedFile>();
+  if (!file.text->open(fileName))
+  {
+    return false;
+  }
+  const std::string_view text = file.text->content();
+  // Offsets are stored as 32 bit integers, so larger files cannot be used.
+  if (text.size() > UINT32_MAX)
+  {
+    std::cerr << "Error: Fortune file " << fileName << " is too large!\n";
+    return false;
+  }
+
+  const auto index = static_cast<uint32_t>(mFiles.size());
+  MappedFile dat;
+  std::error_code error;
+  if (!std::filesystem::exists(fileName + ".dat", error) || !dat.open(fileName + ".dat")
+      || !readTable(dat.content(), text, index, file.cookies, file.rotated))
+  {
+    file.cookies.clear();
+    file.rotated = false;
+    scan(text, index, file.cookies);
+  }
+  if (file.cookies.empty())
+  {
+    return false;
+  }
+
+  const auto byLength = [](const Cookie& a, const Cookie& b) { return a.length < b.length; };
+  std::sort(file.cookies.begin(), file.cookies.end(), byLength);
+  const auto middle = mAll.insert(mAll.end(), file.cookies.begin(), file.cookies.end());
+  std::inplace_merge(mAll.begin(), middle, mAll.end(), byLength);
+  mFiles.push_back(std::move(file));
+  return true;
+}
+
+bool FortuneDatabase::readTable(const std::string_view& dat, const std::string_view& text, const uint32_t file, std::vector<Cookie>& cookies, bool& rotated)
+{
+  // The header of strfile consists of five 32 bit integers (version, number
+  // of strings, longest and shortest length, flags) and four characters, of
+  // which the first one is the delimiter.
+  const std::size_t header_size = 24;
+  const uint32_t flag_random = 0x1;
+  const uint32_t flag_ordered = 0x2;
+  const uint32_t flag_rotated = 0x4;
+  if (dat.size() < header_size)
+  {
+    return false;
+  }
+  const uint32_t version = readBigEndian32(dat.data());
+  const uint32_t count = readBigEndian32(dat.data() + 4);
+  const uint32_t flags = readBigEndian32(dat.data() + 16);
+  const char delim = dat[20];
+  // The table has one more offset than strings, it points to the end.
+  if (((version != 1) && (version != 2)) || (count == 0)
+      || ((dat.size() - header_size) / 4 < static_cast<std::size_t>(count) + 1))
+  {
+    return false;
+  }
+  rotated = (flags & flag_rotated) != 0;
+  // Shuffled or sorted tables do not tell where a cookie ends.
+  const bool sequential = (flags & (flag_random | flag_ordered)) == 0;
+
+  cookies.reserve(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const uint32_t start = readBigEndian32(dat.data() + header_size + 4 * i);
+    std::size_t end = sequential ? readBigEndian32(dat.data() + header_size + 4 * (i + 1))
+                                 : cookieEnd(text, start, delim);
+    if ((start > end) || (end > text.size()))
+    {
+      return false;
+    }
+    const auto cookie = cookieText(text.substr(start, end - start), delim);
+    if (!cookie.empty())
+    {
+      cookies.push_back(Cookie{ file, start, static_cast<uint32_t>(cookie.size()) });
+    }
+  }
+  return true;
+}
+
+void FortuneDatabase::scan(const std::string_view& text, const uint32_t file, std::vector<Cookie>& cookies)
+{
+  std::size_t start = 0;
+  while (start < text.size())
+  {
+    const std::size_t end = cookieEnd(text, start, '%');
+    const auto cookie = cookieText(text.substr(start, end - start), '%');
+    if (!cookie.empty())
+    {
+      cookies.push_back(Cookie{ file, static_cast<uint32_t>(start), static_cast<uint32_t>(cookie.size()) });
+    }
+    // Skip the delimiter line.
+    const auto next = text.find('\n', end);
+    if (next == std::string_view::npos)
+    {
+      break;
+    }
+    start = next + 1;
+  }
+}
+
+std::size_t FortuneDatabase::size() const
+{
+  return mAll.size();
+}
+
+std::vector<std::string> FortuneDatabase::files() const
+{
+  std::vector<std::string> names;
+  for (const auto& file: mFiles)
+  {
+    names.push_back(file.name);
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+std::optional<std::string> FortuneDatabase::random(const std::string_view& file, const std::size_t maxLength) const
+{
+  if (file.empty())
+  {
+    return pick(mAll, maxLength);
+  }
+  for (const auto& f: mFiles)
+  {
+    if (f.name == file)
+    {
+      return pick(f.cookies, maxLength);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> FortuneDatabase::pick(const std::vector<Cookie>& cookies, const std::size_t maxLength) const
+{
+  auto last = cookies.end();
+  if (maxLength > 0)
+  {
+    last = std::upper_bound(cookies.begin(), cookies.end(), maxLength,
+                            [](const std::size_t length, const Cookie& c) { return length < c.length; });
+  }
+  const auto count = static_cast<std::size_t>(last - cookies.begin());
+  if (count == 0)
+  {
+    return std::nullopt;
+  }
+
+  std::random_device randDev;
+  std::mt19937 generator(randDev());
+  std::uniform_int_distribution<std::size_t> distribution(0, count - 1);
+  const Cookie& cookie = cookies[distribution(generator)];
+
+  const File& file = mFiles[cookie.file];
+  std::string text(file.text->content().substr(cookie.offset, cookie.length));
+  if (file.rotated)
+  {
+    for (char& c: text)
+    {
+      if ((c >= 'a') && (c <= 'z'))
+      {
+        c = static_cast<char>('a' + (c - 'a' + 13) % 26);
+      }
+      else if ((c >= 'A') && (c <= 'Z'))
+      {
+        c = static_cast<char>('A' + (c - 'A' + 13) % 26);
+      }
+    }
+  }
+  return text;
+}
+
+} // namespace
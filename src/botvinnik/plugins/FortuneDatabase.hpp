@@ -0,0 +1,169 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_PLUGIN_FORTUNEDATABASE_HPP
+#define BVN_PLUGIN_FORTUNEDATABASE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../util/MappedFile.hpp"
+
+namespace bvn
+{
+
+/** \brief Reads fortune cookies from the data files of the fortune program.
+ *
+ * The text files are mapped into memory. Where a file has a matching .dat
+ * file created by strfile, its offset table is used to find the cookies.
+ * Otherwise the text file is scanned once for the delimiter lines. Cookies
+ * of each file are sorted by length, so that random cookies with a maximum
+ * length can be picked without looking at all cookies.
+ */
+class FortuneDatabase
+{
+  public:
+    /** \brief Creates an empty database.
+     */
+    FortuneDatabase();
+
+
+    FortuneDatabase(const FortuneDatabase& other) = delete;
+    FortuneDatabase& operator=(const FortuneDatabase& other) = delete;
+
+
+    /** \brief Gets the directories where fortune files are usually installed.
+     *
+     * \return Returns the directories used by common Linux distributions.
+     */
+    static std::vector<std::string> defaultDirectories();
+
+
+    /** \brief Loads all fortune files of a directory.
+     *
+     * \param directory   the directory that contains the fortune files
+     * \return Returns the number of files that were loaded.
+     * \remarks Files with a dot in their name (like .dat files) and
+     *          subdirectories (like the one for offensive fortunes) are
+     *          skipped.
+     */
+    std::size_t loadDirectory(const std::string& directory);
+
+
+    /** \brief Loads a single fortune file.
+     *
+     * \param fileName   path of the text file with the fortune cookies
+     * \return Returns true, if the file was loaded and contains cookies.
+     *         Returns false otherwise.
+     * \remarks The name of the file without directory is used as its name
+     *          for random(). Files with a name that is already loaded are
+     *          skipped.
+     */
+    bool loadFile(const std::string& fileName);
+
+
+    /** \brief Gets the total number of loaded cookies.
+     *
+     * \return Returns the number of cookies in all loaded files.
+     */
+    std::size_t size() const;
+
+
+    /** \brief Gets the names of the loaded files.
+     *
+     * \return Returns the names of the loaded files in alphabetical order.
+     */
+    std::vector<std::string> files() const;
+
+
+    /** \brief Picks a random cookie.
+     *
+     * \param file        name of the file to pick from; an empty name picks
+     *                    from all files
+     * \param maxLength   maximum length of the cookie in bytes; zero means
+     *                    no limit
+     * \return Returns an optional containing the text of the cookie. Every
+     *         matching cookie has the same probability.
+     *         Returns an empty optional, if no cookie matches.
+     */
+    std::optional<std::string> random(const std::string_view& file, const std::size_t maxLength) const;
+
+
+    /** \brief maximum length of a short cookie, the same as for "fortune -s"
+     */
+    static const std::size_t short_length;
+  private:
+    /** \brief location of a cookie within a mapped file
+     */
+    struct Cookie
+    {
+      uint32_t file;   /**< index of the file in mFiles */
+      uint32_t offset; /**< offset of the text in the file */
+      uint32_t length; /**< length of the text in bytes */
+    }; // struct
+
+    /** \brief a loaded fortune file
+     */
+    struct File
+    {
+      std::string name; /**< name of the file without directory */
+      std::unique_ptr<MappedFile> text; /**< mapped text of the file */
+      bool rotated; /**< whether the text is encoded with ROT13 */
+      std::vector<Cookie> cookies; /**< cookies of the file, sorted by length */
+    }; // struct
+
+    /** \brief Gets the cookies of a text file from its strfile table.
+     *
+     * \param dat      content of the .dat file
+     * \param text     content of the text file
+     * \param file     index of the file
+     * \param cookies  vector that receives the cookies
+     * \param rotated  variable that receives whether the text uses ROT13
+     * \return Returns true, if the table is valid. Returns false otherwise.
+     */
+    static bool readTable(const std::string_view& dat, const std::string_view& text, const uint32_t file, std::vector<Cookie>& cookies, bool& rotated);
+
+    /** \brief Gets the cookies of a text file by looking for delimiter lines.
+     *
+     * \param text     content of the text file
+     * \param file     index of the file
+     * \param cookies  vector that receives the cookies
+     */
+    static void scan(const std::string_view& text, const uint32_t file, std::vector<Cookie>& cookies);
+
+    /** \brief Picks a random cookie of a vector that is sorted by length.
+     *
+     * \param cookies     the cookies, sorted by length
+     * \param maxLength   maximum length of the cookie, zero means no limit
+     * \return Returns an optional containing the text of the cookie.
+     *         Returns an empty optional, if no cookie is short enough.
+     */
+    std::optional<std::string> pick(const std::vector<Cookie>& cookies, const std::size_t maxLength) const;
+
+    std::vector<File> mFiles; /**< loaded files */
+    std::vector<Cookie> mAll; /**< cookies of all files, sorted by length */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_FORTUNEDATABASE_HPP
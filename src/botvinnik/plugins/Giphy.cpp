@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2023  Dirk Stolle
+    Copyright (C) 2020, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,23 +23,39 @@
 #include <random>
 #include "../../../third-party/nonstd/expected.hpp"
 #include "../../../third-party/simdjson/simdjson.h"
+#include "../../net/CircuitBreaker.hpp"
 #include "../../net/Curly.hpp"
 #include "../../net/url_encode.hpp"
+#include "../../util/Arguments.hpp"
 #include "../../util/Strings.hpp"
 
 namespace bvn
 {
 
-Giphy::Giphy(const std::string& gifApiKey, Matrix& mat)
+Giphy::Giphy(const std::string& gifApiKey, Matrix& mat, const GiphyPool::Settings& poolSettings)
 : apiKey(gifApiKey),
-  theMatrix(mat)
+  theMatrix(mat),
+  pool(poolSettings, [this](const std::string& keyword) -> std::optional<GiphyPool::Entry>
+  {
+    const auto image = fetchImage(keyword);
+    if (!image.has_value())
+    {
+      return std::nullopt;
+    }
+    return image.value();
+  })
 {
   trim(this->apiKey);
+  if (!apiKey.empty())
+  {
+    pool.start();
+  }
 }
 
-std::vector<std::string> Giphy::commands() const
+const std::vector<std::string>& Giphy::commands() const
 {
-  return { "giphy" };
+  static const std::vector<std::string> cmds = { "giphy" };
+  return cmds;
 }
 
 Message Giphy::handleCommand(const std::string_view& command, const std::string_view& message,
@@ -49,8 +65,7 @@ Message Giphy::handleCommand(const std::string_view& command, const std::string_
 {
   if (command == "giphy")
   {
-    std::string query(message.substr(command.size()));
-    trim(query);
+    const std::string_view query = Arguments(message, command).rest();
     if (query.empty())
     {
       return Message(std::string("Please enter a keyword for the search after '").append(command).append("'."));
@@ -92,13 +107,31 @@ Message Giphy::helpExtended(const std::string_view& command, const std::string_v
   return Message();
 }
 
-struct GiphyImageData
+/** \brief Gets a dimension or the size of an image from Giphy's JSON data.
+ *
+ * \param image  JSON object of the rendition
+ * \param name   name of the property, e. g. "width"
+ * \return Returns the value. Returns zero, if it is missing or invalid.
+ */
+int extract_giphy_number(const simdjson::dom::element& image, const char* name)
 {
-  std::string url; /**< URL of image in CDN server */
-  ImageInfo info;  /**< metadata for the image */
-};
+  // Despite being an integer value, the API returns a string containing the
+  // value (e. g. "400") instead of the real value (e. g. 400).
+  simdjson::dom::element element;
+  const auto error = image[name].get(element);
+  if (error || !element.is_string())
+  {
+    return 0;
+  }
+  int value = 0;
+  if (!stringToInt(element.get<std::string_view>().value(), value) || (value < 0))
+  {
+    return 0;
+  }
+  return value;
+}
 
-nonstd::expected<std::vector<GiphyImageData>, Message> extract_images_from_json(const std::string& json)
+nonstd::expected<std::vector<std::vector<Giphy::Rendition>>, Message> extract_images_from_json(const std::string& json)
 {
   simdjson::dom::parser parser;
   simdjson::dom::element doc;
@@ -118,80 +151,75 @@ nonstd::expected<std::vector<GiphyImageData>, Message> extract_images_from_json(
     return nonstd::make_unexpected(Message("The request to get images from Giphy failed. Giphy server returned unexpected JSON format."));
   }
 
-  std::vector<GiphyImageData> result;
+  // GIF renditions, see https://developers.giphy.com/docs/optional-settings/#rendition-guide
+  const std::vector<const char*> rendition_names = {
+      "original", "downsized_large", "downsized_medium", "downsized",
+      "fixed_width", "fixed_height"
+  };
+
+  std::vector<std::vector<Giphy::Rendition>> result;
 
   for (const auto & item : data)
   {
-    simdjson::dom::element item_element;
-    auto error = item.at_pointer("/images/original/url").get(item_element);
-    if (error || item_element.type() != simdjson::dom::element_type::STRING)
-    {
-      std::cerr << "Error: JSON response from Giphy does not contain '/images/original/url' element!\n"
-                << "Response is: " << json << std::endl;
-      return nonstd::make_unexpected(Message("The request to get images from Giphy failed. Giphy server returned unexpected JSON format."));
-    }
-    GiphyImageData current_data;
-    current_data.url = std::string(item_element.get<std::string_view>().value());
-    // It's always GIF for the default image.
-    current_data.info.mimeType = "image/gif";
-
-    error = item.at_pointer("/images/original/width").get(item_element);
-    // Despite being an integer value, the API returns a string containing the
-    // width value (e. g. "400") instead of the real value (e. g. 400).
-    if (error || !item_element.is_string())
+    std::vector<Giphy::Rendition> renditions;
+    for (const char* name: rendition_names)
     {
-      std::clog << "Error: JSON response from Giphy does not contain '/images/original/width' element!\n"
-                << "Response is: " << json << std::endl;
-    }
-    else
-    {
-      const auto string = item_element.get<std::string_view>().value();
-      int value = 0;
-      if (stringToInt(std::string(string), value))
+      simdjson::dom::element image;
+      simdjson::dom::element url;
+      if (item["images"][name].get(image) || image["url"].get(url) || !url.is_string())
       {
-        current_data.info.width = value;
+        continue;
       }
+      Giphy::Rendition rendition;
+      rendition.url = std::string(url.get<std::string_view>().value());
+      // It's always GIF for these renditions.
+      rendition.info.mimeType = "image/gif";
+      rendition.info.width = extract_giphy_number(image, "width");
+      rendition.info.height = extract_giphy_number(image, "height");
+      rendition.info.size = extract_giphy_number(image, "size");
+      renditions.emplace_back(rendition);
     }
-
-    error = item.at_pointer("/images/original/height").get(item_element);
-    if (error || !item_element.is_string())
+    if (renditions.empty())
     {
-      std::clog << "Error: JSON response from Giphy does not contain '/images/original/width' element!\n"
+      std::cerr << "Error: JSON response from Giphy does not contain '/images/original/url' element!\n"
                 << "Response is: " << json << std::endl;
+      return nonstd::make_unexpected(Message("The request to get images from Giphy failed. Giphy server returned unexpected JSON format."));
     }
-    else
-    {
-      const auto string = item_element.get<std::string_view>().value();
-      int value = 0;
-      if (stringToInt(std::string(string), value))
-      {
-        current_data.info.height = value;
-      }
-    }
 
-    error = item.at_pointer("/images/original/size").get(item_element);
-    if (error || !item_element.is_string())
+    result.emplace_back(renditions);
+  }
+
+  return result;
+}
+
+std::optional<Giphy::Rendition> Giphy::selectRendition(const std::vector<Rendition>& renditions, const int64_t uploadLimit)
+{
+  if (renditions.empty())
+  {
+    return std::nullopt;
+  }
+  if (uploadLimit <= 0)
+  {
+    return renditions.front();
+  }
+
+  std::optional<Rendition> best;
+  for (const auto& rendition: renditions)
+  {
+    // Renditions of unknown size could be too large, so skip them.
+    if ((rendition.info.size == 0) || (rendition.info.size > uploadLimit))
     {
-      std::clog << "Error: JSON response from Giphy does not contain '/images/original/width' element!\n"
-                << "Response is: " << json << std::endl;
+      continue;
     }
-    else
+    if (!best.has_value() || (rendition.info.size > best.value().info.size))
     {
-      const auto string = item_element.get<std::string_view>().value();
-      int value = 0;
-      if (stringToInt(std::string(string), value))
-      {
-        current_data.info.size = value;
-      }
+      best = rendition;
     }
-
-    result.emplace_back(current_data);
   }
-
-  return result;
+  return best;
 }
 
-Message Giphy::performQuery(const std::string& query, const std::string_view& roomId)
+nonstd::expected<GiphyPool::Entry, Message> Giphy::fetchImage(const std::string_view& query)
 {
   std::string encodedQuery;
   std::string encodedKey;
@@ -203,29 +231,34 @@ Message Giphy::performQuery(const std::string& query, const std::string_view& ro
   catch (const std::exception& ex)
   {
     std::cerr << "Error: Failed to URL-encode Giphy query!\n" << ex.what() << '\n';
-    return Message("Could not request image from Giphy.");
+    return nonstd::make_unexpected(Message("Could not request image from Giphy."));
   }
 
   Curly curl;
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
   curl.setURL("https://api.giphy.com/v1/gifs/search?api_key=" + encodedKey + "&q=" + encodedQuery + "&limit=25&offset=0&rating=G&lang=en");
   std::string response;
   if (!curl.perform(response) || curl.getResponseCode() != 200)
   {
+    if (curl.circuitOpen())
+    {
+      return nonstd::make_unexpected(Message("Giphy is currently unavailable. Please try again later."));
+    }
     std::cerr << "Error: Request to Giphy API failed!\n"
               << "HTTP status code: " << curl.getResponseCode() << '\n'
               << "Response: " << response << std::endl;
-    return Message("The API request to get information from Giphy failed.");
+    return nonstd::make_unexpected(Message("The API request to get information from Giphy failed."));
   }
 
   const auto maybe_images = extract_images_from_json(response);
   if (!maybe_images.has_value())
   {
-    return maybe_images.error();
+    return nonstd::make_unexpected(maybe_images.error());
   }
   const auto& images = maybe_images.value();
   if (images.empty())
   {
-    return Message("The search request returned no matching GIFs.");
+    return nonstd::make_unexpected(Message("The search request returned no matching GIFs."));
   }
 
   std::random_device randDev;
@@ -233,14 +266,39 @@ Message Giphy::performQuery(const std::string& query, const std::string_view& ro
   std::uniform_int_distribution<unsigned int> distribution(0, images.size() - 1);
   const unsigned int num = distribution(generator);
 
+  const auto limit = theMatrix.getUploadLimit();
+  const auto image = selectRendition(images[num], limit.value_or(-1));
+  if (!image.has_value())
+  {
+    return nonstd::make_unexpected(Message("The selected GIF is too large for the Matrix homeserver."));
+  }
 
-  const auto mxcUri = theMatrix.uploadImage(images[num].url);
+  const auto mxcUri = theMatrix.uploadImage(image.value().url, image.value().info.size);
   if (!mxcUri.has_value())
   {
-    return Message("Failed to upload GIF to Matrix homeserver.");
+    return nonstd::make_unexpected(Message("Failed to upload GIF to Matrix homeserver."));
+  }
+
+  return GiphyPool::Entry{ mxcUri.value(), image.value().info };
+}
+
+Message Giphy::performQuery(const std::string_view& query, const std::string_view& roomId)
+{
+  // Popular keywords may have a GIF that is already uploaded.
+  const std::string keyword = GiphyPool::normalize(query);
+  pool.recordUse(keyword);
+  auto gifEntry = pool.take(keyword);
+  if (!gifEntry.has_value())
+  {
+    auto fetched = fetchImage(query);
+    if (!fetched.has_value())
+    {
+      return fetched.error();
+    }
+    gifEntry = std::move(fetched.value());
   }
 
-  if (!theMatrix.sendImage(std::string(roomId), mxcUri.value(), "giphy.gif", images[num].info))
+  if (!theMatrix.sendImage(std::string(roomId), gifEntry.value().mxcUri, "giphy.gif", gifEntry.value().info))
   {
     return Message("Could not send GIF to Matrix server.");
   }
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,8 +21,12 @@
 #ifndef BVN_PLUGIN_GIPHY_HPP
 #define BVN_PLUGIN_GIPHY_HPP
 
+#include <optional>
+#include <vector>
 #include "DeactivatablePlugin.hpp"
+#include "GiphyPool.hpp"
 #include "../../matrix/Matrix.hpp"
+#include "../../../third-party/nonstd/expected.hpp"
 
 namespace bvn
 {
@@ -36,15 +40,17 @@ class Giphy final: public DeactivatablePlugin
      *
      * \param apiKey  key for the Giphy API
      * \param mat  logged in matrix instance
+     * \param poolSettings  settings for the pool of prefetched GIFs; the
+     *                      default settings disable the pool
      */
-    Giphy(const std::string& apiKey, Matrix& mat);
+    Giphy(const std::string& apiKey, Matrix& mat, const GiphyPool::Settings& poolSettings = GiphyPool::Settings());
 
 
     /** \brief Gets a list of commands that are provided by this plugin.
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    std::vector<std::string> commands() const override;
+    const std::vector<std::string>& commands() const override;
 
 
     /** \brief Reacts to a given command.
@@ -75,11 +81,40 @@ class Giphy final: public DeactivatablePlugin
      * \return Returns a Message containing a longer help text for the command.
      */
     Message helpExtended(const std::string_view& command, const std::string_view& prefix) const override;
+
+
+    /** \brief one rendition of a GIF, e. g. the original or a downsized version
+     */
+    struct Rendition
+    {
+      std::string url; /**< URL of image in CDN server */
+      ImageInfo info;  /**< metadata for the image */
+    }; // struct
+
+
+    /** \brief Selects the largest rendition of a GIF that can be uploaded.
+     *
+     * \param renditions   available renditions, the original one first
+     * \param uploadLimit  upload size limit of the server in bytes; zero or
+     *                     negative values mean that the limit is unknown
+     * \return Returns the largest rendition whose size does not exceed the
+     *         limit. If the limit is unknown, the first rendition is returned.
+     *         Returns an empty optional, if no rendition fits.
+     */
+    static std::optional<Rendition> selectRendition(const std::vector<Rendition>& renditions, const int64_t uploadLimit);
   private:
-    Message performQuery(const std::string& query, const std::string_view& roomId);
+    Message performQuery(const std::string_view& query, const std::string_view& roomId);
+
+    /** \brief Searches a random GIF and uploads it to the Matrix server.
+     *
+     * \param query  the search query
+     * \return Returns the uploaded GIF, or a message describing the error.
+     */
+    nonstd::expected<GiphyPool::Entry, Message> fetchImage(const std::string_view& query);
 
     std::string apiKey; /**< Giphy API key */
     Matrix& theMatrix;  /**< reference to the Matrix instance */
+    GiphyPool pool;     /**< prefetched GIFs for popular keywords */
 }; // class
 
 } // namespace
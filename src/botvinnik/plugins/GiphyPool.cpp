@@ -0,0 +1,257 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "GiphyPool.hpp"
+#include <algorithm>
+#include <iostream>
+#include "../../util/Deadline.hpp"
+#include "../../util/Strings.hpp"
+
+namespace bvn
+{
+
+// Keywords that are no longer requested lose their pool after a while.
+const double GiphyPool::score_decay = 0.9;
+
+// A keyword has to be requested at least twice recently to get a pool, so
+// that the budget is not spent on keywords that are only used once.
+const double GiphyPool::min_score = 1.5;
+
+GiphyPool::GiphyPool(const Settings& poolSettings, Fetcher fetch)
+: settings(poolSettings),
+  fetcher(std::move(fetch)),
+  scores(),
+  pools(),
+  fetches(),
+  refillRequested(false),
+  stopping(false),
+  mutex(),
+  wakeUp(),
+  worker()
+{
+}
+
+GiphyPool::~GiphyPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wakeUp.notify_one();
+  if (worker.joinable())
+  {
+    worker.join();
+  }
+}
+
+void GiphyPool::start()
+{
+  if ((settings.poolSize == 0) || !fetcher || worker.joinable())
+  {
+    return;
+  }
+  worker = std::thread(&GiphyPool::refillLoop, this);
+}
+
+std::string GiphyPool::normalize(const std::string_view& query)
+{
+  std::string result;
+  for (const std::string& word: split(toLowerString(std::string(query)), ' '))
+  {
+    const auto part = trimmed(word);
+    if (part.empty())
+    {
+      continue;
+    }
+    if (!result.empty())
+    {
+      result.push_back(' ');
+    }
+    result.append(part);
+  }
+  return result;
+}
+
+void GiphyPool::recordUse(const std::string& keyword)
+{
+  if (keyword.empty())
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  scores[keyword] += 1.0;
+}
+
+std::optional<GiphyPool::Entry> GiphyPool::take(const std::string& keyword)
+{
+  std::optional<Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto iter = pools.find(keyword);
+    if ((iter == pools.end()) || iter->second.empty())
+    {
+      return std::nullopt;
+    }
+    entry = std::move(iter->second.front());
+    iter->second.pop_front();
+    refillRequested = true;
+  }
+  wakeUp.notify_one();
+  return entry;
+}
+
+std::size_t GiphyPool::available(const std::string& keyword) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto iter = pools.find(keyword);
+  return (iter == pools.end()) ? 0 : iter->second.size();
+}
+
+std::vector<std::string> GiphyPool::topKeywords() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return rankKeywords();
+}
+
+std::vector<std::string> GiphyPool::rankKeywords() const
+{
+  std::vector<std::pair<std::string, double>> ranking(scores.begin(), scores.end());
+  std::sort(ranking.begin(), ranking.end(), [](const auto& a, const auto& b)
+  {
+    // ties are broken by name, so the result does not depend on hashing
+    return (a.second > b.second) || ((a.second == b.second) && (a.first < b.first));
+  });
+  if (ranking.size() > settings.keywords)
+  {
+    ranking.resize(settings.keywords);
+  }
+  std::vector<std::string> result;
+  for (const auto& [keyword, score]: ranking)
+  {
+    if (score >= min_score)
+    {
+      result.push_back(keyword);
+    }
+  }
+  return result;
+}
+
+bool GiphyPool::consumeBudget()
+{
+  const auto now = std::chrono::steady_clock::now();
+  while (!fetches.empty() && (now - fetches.front() >= std::chrono::hours(1)))
+  {
+    fetches.pop_front();
+  }
+  if (fetches.size() >= settings.uploadsPerHour)
+  {
+    return false;
+  }
+  fetches.push_back(now);
+  return true;
+}
+
+void GiphyPool::refill()
+{
+  std::vector<std::string> top;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    refillRequested = false;
+    top = rankKeywords();
+    // Pools of keywords that dropped out of the top are no longer needed.
+    for (auto iter = pools.begin(); iter != pools.end(); )
+    {
+      if (std::find(top.begin(), top.end(), iter->first) == top.end())
+      {
+        iter = pools.erase(iter);
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+  }
+
+  for (const auto& keyword: top)
+  {
+    while (true)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping || (pools[keyword].size() >= settings.poolSize) || !consumeBudget())
+        {
+          break;
+        }
+      }
+      // Fetch without holding the lock, requests may take a while.
+      const Deadline deadline(std::chrono::seconds(60));
+      Deadline::Scope scope(deadline);
+      auto entry = fetcher(keyword);
+      if (!entry.has_value())
+      {
+        std::clog << "Warning: Could not prefetch a GIF for '" << keyword
+                  << "' from Giphy." << std::endl;
+        break;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      pools[keyword].push_back(std::move(entry.value()));
+    }
+  }
+}
+
+void GiphyPool::decayScores()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto iter = scores.begin(); iter != scores.end(); )
+  {
+    iter->second *= score_decay;
+    if (iter->second < 0.01)
+    {
+      iter = scores.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+}
+
+void GiphyPool::refillLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping)
+  {
+    const bool requested = wakeUp.wait_for(lock, settings.refresh, [this]() { return stopping || refillRequested; });
+    if (stopping)
+    {
+      break;
+    }
+    lock.unlock();
+    // Scores only decay once per refresh interval, not on every taken GIF.
+    if (!requested)
+    {
+      decayScores();
+    }
+    refill();
+    lock.lock();
+  }
+}
+
+} // namespace
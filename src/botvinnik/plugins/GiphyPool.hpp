@@ -0,0 +1,200 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_PLUGIN_GIPHYPOOL_HPP
+#define BVN_PLUGIN_GIPHYPOOL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../../matrix/ImageInfo.hpp"
+
+namespace bvn
+{
+
+/** \brief Keeps already uploaded GIFs for the most popular Giphy keywords.
+ *
+ * The pool counts how often each keyword is requested. For the most popular
+ * keywords, a background thread searches and uploads a few GIFs in advance,
+ * so that requests for them only need to send the image to the room.
+ */
+class GiphyPool
+{
+  public:
+    /** \brief settings of the pool
+     */
+    struct Settings
+    {
+      std::size_t poolSize = 0; /**< GIFs kept per keyword; zero disables the pool */
+      std::size_t keywords = 10; /**< number of most popular keywords that get a pool */
+      std::chrono::minutes refresh = std::chrono::minutes(10); /**< time between two refills */
+      std::size_t uploadsPerHour = 30; /**< maximum number of GIFs fetched per hour */
+    }; // struct
+
+
+    /** \brief an uploaded GIF
+     */
+    struct Entry
+    {
+      std::string mxcUri; /**< Matrix Content URI of the GIF */
+      ImageInfo info; /**< metadata of the GIF */
+    }; // struct
+
+
+    /** \brief function that searches and uploads a GIF for a keyword
+     */
+    using Fetcher = std::function<std::optional<Entry>(const std::string& keyword)>;
+
+
+    /** \brief Constructor.
+     *
+     * \param settings  settings of the pool
+     * \param fetch     function that searches and uploads a GIF
+     * \remarks The background thread is not started before start() is called.
+     */
+    GiphyPool(const Settings& settings, Fetcher fetch);
+
+
+    GiphyPool(const GiphyPool& other) = delete;
+    GiphyPool& operator=(const GiphyPool& other) = delete;
+
+
+    /** \brief Destructor. Stops the background thread.
+     */
+    ~GiphyPool();
+
+
+    /** \brief Starts the background thread that refills the pool.
+     *
+     * \remarks Does nothing, if the pool is disabled or already started.
+     */
+    void start();
+
+
+    /** \brief Brings a search query into the form that is used as keyword.
+     *
+     * \param query  the search query
+     * \return Returns the query in lower case, without leading or trailing
+     *         whitespace and with single spaces between words.
+     */
+    static std::string normalize(const std::string_view& query);
+
+
+    /** \brief Counts a request for a keyword.
+     *
+     * \param keyword  the normalized keyword
+     */
+    void recordUse(const std::string& keyword);
+
+
+    /** \brief Takes a GIF for a keyword out of the pool.
+     *
+     * \param keyword  the normalized keyword
+     * \return Returns an optional containing the GIF.
+     *         Returns an empty optional, if there is no GIF for the keyword.
+     * \remarks Each GIF is only returned once. Taking a GIF wakes up the
+     *          background thread to get a new one.
+     */
+    std::optional<Entry> take(const std::string& keyword);
+
+
+    /** \brief Gets the number of GIFs in the pool for a keyword.
+     *
+     * \param keyword  the normalized keyword
+     * \return Returns the number of GIFs that are available for the keyword.
+     */
+    std::size_t available(const std::string& keyword) const;
+
+
+    /** \brief Gets the most popular keywords.
+     *
+     * \return Returns up to Settings::keywords keywords, most popular first.
+     *         Keywords below min_score are not included.
+     */
+    std::vector<std::string> topKeywords() const;
+
+
+    /** \brief Fills the pools of the most popular keywords, as far as the
+     *         hourly budget allows, and drops the pools of other keywords.
+     *
+     * \remarks This is called by the background thread, but it can also be
+     *          called directly.
+     */
+    void refill();
+
+
+    /** \brief Reduces the usage counts, so that recent requests count more
+     *         than old ones.
+     *
+     * \remarks This is called by the background thread once per refresh
+     *          interval.
+     */
+    void decayScores();
+
+
+    /** \brief factor that is applied to the usage counts by decayScores()
+     */
+    static const double score_decay;
+
+
+    /** \brief minimum usage count of a keyword to get a pool
+     */
+    static const double min_score;
+  private:
+    /** \brief Gets the most popular keywords, mutex must be locked.
+     *
+     * \return Returns up to Settings::keywords keywords, most popular first.
+     *         Keywords below min_score are not included.
+     */
+    std::vector<std::string> rankKeywords() const;
+
+    /** \brief Uses one fetch of the hourly budget, if it is not exhausted.
+     *
+     * \return Returns true, if another GIF may be fetched.
+     */
+    bool consumeBudget();
+
+    /** \brief Loop of the background thread.
+     */
+    void refillLoop();
+
+    Settings settings; /**< settings of the pool */
+    Fetcher fetcher; /**< searches and uploads GIFs */
+    std::unordered_map<std::string, double> scores; /**< decaying usage count per keyword */
+    std::unordered_map<std::string, std::deque<Entry>> pools; /**< uploaded GIFs per keyword */
+    std::deque<std::chrono::steady_clock::time_point> fetches; /**< times of the fetches in the last hour */
+    bool refillRequested; /**< whether a GIF was taken since the last refill */
+    bool stopping; /**< whether the background thread shall stop */
+    mutable std::mutex mutex; /**< protects all members above */
+    std::condition_variable wakeUp; /**< signals the background thread */
+    std::thread worker; /**< background thread that refills the pool */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_GIPHYPOOL_HPP
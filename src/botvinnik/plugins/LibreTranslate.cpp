@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2022, 2023  Dirk Stolle
+    Copyright (C) 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,7 +21,10 @@
 #include "LibreTranslate.hpp"
 #include <iostream>
 #include "../../../third-party/simdjson/simdjson.h"
+#include "../../net/CircuitBreaker.hpp"
 #include "../../net/Curly.hpp"
+#include "../../net/HttpCache.hpp"
+#include "../../util/Arguments.hpp"
 #include "../../util/Strings.hpp"
 
 namespace bvn
@@ -46,9 +49,10 @@ LibreTranslate::LibreTranslate(const std::string_view server, const std::string_
   }
 }
 
-std::vector<std::string> LibreTranslate::commands() const
+const std::vector<std::string>& LibreTranslate::commands() const
 {
-  return { "tr", "tr-lang" };
+  static const std::vector<std::string> cmds = { "tr", "tr-lang" };
+  return cmds;
 }
 
 Message LibreTranslate::handleCommand(const std::string_view& command, const std::string_view& message,
@@ -91,11 +95,17 @@ Message LibreTranslate::handleCommand(const std::string_view& command, const std
 Message LibreTranslate::getLanguages() const
 {
   Curly curl;
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+  curl.setHttpCache(&HttpCache::upstreams());
   curl.setURL(url + "/languages");
   curl.addHeader("Accept: application/json");
   std::string response;
   if (!curl.perform(response) || curl.getResponseCode() != 200)
   {
+    if (curl.circuitOpen())
+    {
+      return Message("The translation server is currently unavailable. Please try again later.");
+    }
     std::cerr << "Error: Request to " + url + " failed!\n"
               << "HTTP status code: " << curl.getResponseCode() << '\n'
               << "Response: " << response << std::endl;
@@ -145,27 +155,32 @@ Message LibreTranslate::getLanguages() const
 
 Message LibreTranslate::getTranslation(const std::string_view& command, const std::string_view& message) const
 {
-  std::string input(message.substr(command.size()));
-  trim(input);
-  if ((input.size() < 7) || (input[2] != ' ') || (input[5] != ' '))
+  Arguments args(message, command);
+  const auto source = args.next();
+  const auto destination = args.next();
+  const std::string_view text = args.rest();
+  if (!source.has_value() || (source.value().size() != 2)
+      || !destination.has_value() || (destination.value().size() != 2)
+      || text.empty())
   {
     return Message(std::string("Command ").append(command)
       .append(" must be followed by two language codes before the text to translate, e. g. `")
       .append(command).append(" en de Hello world!`."));
   }
-  const auto source_language = toLowerString(input.substr(0, 2));
-  const auto destination_language = toLowerString(input.substr(3, 2));
+  const auto source_language = toLowerString(std::string(source.value()));
+  const auto destination_language = toLowerString(std::string(destination.value()));
   if (source_language == destination_language)
   {
     return Message("Hint: Source language and destination language of a translation must be different.");
   }
 
   Curly curl;
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
   curl.addHeader("Accept: application/json");
   curl.setURL(url + "/translate");
   if (!curl.addPostField("source", source_language)
     || !curl.addPostField("target", destination_language)
-    || !curl.addPostField("q", input.substr(6)))
+    || !curl.addPostField("q", std::string(text)))
   {
     std::cerr << "Error: Could not add POST fields to Curly request for "
               << "LibreTranslate!" << std::endl;
@@ -183,6 +198,10 @@ Message LibreTranslate::getTranslation(const std::string_view& command, const st
   std::string response;
   if (!curl.perform(response))
   {
+    if (curl.circuitOpen())
+    {
+      return Message("The translation server is currently unavailable. Please try again later.");
+    }
     std::cerr << "Error: Request to " + url + " failed!\n"
               << "HTTP status code: " << curl.getResponseCode() << std::endl
               << "Response: " << response << std::endl;
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2022, 2023  Dirk Stolle
+    Copyright (C) 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -45,7 +45,7 @@ class LibreTranslate final: public DeactivatablePlugin
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    std::vector<std::string> commands() const override;
+    const std::vector<std::string>& commands() const override;
 
 
     /** \brief Reacts to a given command.
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -28,9 +28,10 @@ Ping::Ping(const std::chrono::milliseconds& bot_sync_delay)
 {
 }
 
-std::vector<std::string> Ping::commands() const
+const std::vector<std::string>& Ping::commands() const
 {
-  return { "ping" };
+  static const std::vector<std::string> cmds = { "ping" };
+  return cmds;
 }
 
 std::string humanReadableDuration(const std::chrono::milliseconds& diff)
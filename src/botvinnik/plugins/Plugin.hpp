@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -43,7 +43,7 @@ class Plugin
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    virtual std::vector<std::string> commands() const = 0;
+    virtual const std::vector<std::string>& commands() const = 0;
 
 
     /** \brief Reacts to a given command.
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2023, 2024, 2025  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2024, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,6 +23,7 @@
 #include <iostream>
 #include "../../../third-party/simdjson/simdjson.h"
 #include "../../Version.hpp"
+#include "../../net/CircuitBreaker.hpp"
 #include "../../net/Curly.hpp"
 #include "../../net/url_encode.hpp"
 
@@ -48,26 +49,35 @@ const std::unordered_map<std::string, std::string> Wikipedia::languages = {
     { "wikizh", "Chinese" }
 };
 
-std::vector<std::string> Wikipedia::commands() const
+// Introductions of articles change slowly, but a day-old extract is still good.
+const std::chrono::hours Wikipedia::cache_ttl = std::chrono::hours(24);
+
+Wikipedia::Wikipedia(PersistentCache* cache)
+: mCache(cache)
+{
+}
+
+const std::vector<std::string>& Wikipedia::commands() const
 {
-  return { "wiki",
-           "wikics", // Czech
-           "wikicy", // Welsh
-           "wikide", // German
-           "wikiel", // Greek
-           "wikien", // English
-           "wikies", // Spanish
-           "wikifr", // French
-           "wikiit", // Italian
-           "wikija", // Japanese
-           "wikinl", // Dutch
-           "wikipl", // Polish
-           "wikipt", // Portuguese
-           "wikiru", // Russian
-           "wikitr", // Turkish
-           "wikiuk", // Ukrainian
-           "wikizh", // Chinese
-         };
+  static const std::vector<std::string> cmds = { "wiki",
+                                                 "wikics", // Czech
+                                                 "wikicy", // Welsh
+                                                 "wikide", // German
+                                                 "wikiel", // Greek
+                                                 "wikien", // English
+                                                 "wikies", // Spanish
+                                                 "wikifr", // French
+                                                 "wikiit", // Italian
+                                                 "wikija", // Japanese
+                                                 "wikinl", // Dutch
+                                                 "wikipl", // Polish
+                                                 "wikipt", // Portuguese
+                                                 "wikiru", // Russian
+                                                 "wikitr", // Turkish
+                                                 "wikiuk", // Ukrainian
+                                                 "wikizh", // Chinese
+                                               };
+  return cmds;
 }
 
 Message Wikipedia::handleCommand(const std::string_view& command, const std::string_view& message,
@@ -79,8 +89,8 @@ Message Wikipedia::handleCommand(const std::string_view& command, const std::str
   {
     return extract("en", command, message);
   }
-  const auto all = commands();
-  if (std::find(all.begin(), all.end(), std::string(command)) != all.end())
+  const auto& all = commands();
+  if (std::find(all.begin(), all.end(), command) != all.end())
   {
     return extract(std::string(command.substr(4)), command, message);
   }
@@ -172,18 +182,39 @@ Message Wikipedia::extract(const std::string& lang, const std::string_view& comm
     return Message("The request for Wikipedia article contains invalid characters in it's title.");
   }
 
-  Curly curl;
-  // URL is something like https://de.wikipedia.org/w/api.php?format=json&redirects=true&action=query&prop=extracts&exintro=true&exchars=1200&titles=Einstein.
-  curl.setURL("https://" + lang + ".wikipedia.org/w/api.php?format=json&redirects=true&action=query&prop=extracts&exintro=true&exchars=1200&titles=" + escapedTitle);
-  // Wikipedia demands User-Agent header when a lot of requests are made.
-  curl.addHeader("User-Agent: " + bvn::userAgent + " (https://github.com/striezel/botvinnik)");
+  const std::string cacheKey = lang + "/" + escapedTitle;
+  std::optional<std::string> cached;
+  if (mCache != nullptr)
+  {
+    cached = mCache->get("wikipedia", cacheKey);
+  }
   std::string response;
-  if (!curl.perform(response))
+  if (cached.has_value())
   {
-    std::cerr << "Error: Request to MediaWiki API failed!\n"
-              << "HTTP status code: " << curl.getResponseCode() << '\n'
-              << "Response: " << response << std::endl;
-    return Message("The request to get information from Wikipedia failed. Wikipedia server returned unexpected response.");
+    response = std::move(cached.value());
+  }
+  else
+  {
+    Curly curl;
+    curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+    // The plugin caches the response itself, so it does not use the HTTP
+    // cache of Curly as well.
+    curl.coalesceRequests(true);
+    // URL is something like https://de.wikipedia.org/w/api.php?format=json&redirects=true&action=query&prop=extracts&exintro=true&exchars=1200&titles=Einstein.
+    curl.setURL("https://" + lang + ".wikipedia.org/w/api.php?format=json&redirects=true&action=query&prop=extracts&exintro=true&exchars=1200&titles=" + escapedTitle);
+    // Wikipedia demands User-Agent header when a lot of requests are made.
+    curl.addHeader("User-Agent: " + bvn::userAgent + " (https://github.com/striezel/botvinnik)");
+    if (!curl.perform(response))
+    {
+      if (curl.circuitOpen())
+      {
+        return Message("Wikipedia is currently unavailable. Please try again later.");
+      }
+      std::cerr << "Error: Request to MediaWiki API failed!\n"
+                << "HTTP status code: " << curl.getResponseCode() << '\n'
+                << "Response: " << response << std::endl;
+      return Message("The request to get information from Wikipedia failed. Wikipedia server returned unexpected response.");
+    }
   }
 
   simdjson::dom::parser parser;
@@ -195,6 +226,10 @@ Message Wikipedia::extract(const std::string& lang, const std::string_view& comm
               << "Response is: " << response << std::endl;
     return Message("The request to get information from Wikipedia failed. Wikipedia server returned invalid JSON.");
   }
+  if (!cached.has_value() && (mCache != nullptr))
+  {
+    mCache->put("wikipedia", cacheKey, response, cache_ttl);
+  }
   simdjson::dom::element pages;
   const auto pagesError = doc.at_pointer("/query/pages").get(pages);
   if (pagesError || pages.type() != simdjson::dom::element_type::OBJECT)
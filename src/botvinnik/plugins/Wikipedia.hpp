@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -26,6 +26,7 @@
 #include <unordered_map>
 #include <vector>
 #include "DeactivatablePlugin.hpp"
+#include "../../util/PersistentCache.hpp"
 
 namespace bvn
 {
@@ -35,11 +36,20 @@ namespace bvn
 class Wikipedia final: public DeactivatablePlugin
 {
   public:
+    /** \brief Constructor.
+     *
+     * \param cache  cache for responses of the MediaWiki API; nullptr means
+     *               that responses are not cached
+     * \remarks The cache must outlive the plugin.
+     */
+    explicit Wikipedia(PersistentCache* cache = nullptr);
+
+
     /** \brief Gets a list of commands that are provided by this plugin.
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    std::vector<std::string> commands() const override;
+    const std::vector<std::string>& commands() const override;
 
 
     /** \brief Reacts to a given command.
@@ -70,6 +80,11 @@ class Wikipedia final: public DeactivatablePlugin
      * \return Returns a Message containing a longer help text for the command.
      */
     Message helpExtended(const std::string_view& command, const std::string_view& prefix) const override;
+
+
+    /** \brief time that an extract is cached
+     */
+    static const std::chrono::hours cache_ttl;
   private:
     /** \brief Gets extract of a Wikipedia article.
      *
@@ -83,6 +98,8 @@ class Wikipedia final: public DeactivatablePlugin
 
     /// maps command names (=keys) to language names (=values)
     static const std::unordered_map<std::string, std::string> languages;
+
+    PersistentCache* mCache; /**< cache for responses, may be nullptr */
 }; // class
 
 } // namespace
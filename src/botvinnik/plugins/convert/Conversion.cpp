@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -25,9 +25,10 @@
 namespace bvn
 {
 
-std::vector<std::string> Conversion::commands() const
+const std::vector<std::string>& Conversion::commands() const
 {
-  return { "bin2dec", "bin2hex", "dec2bin", "dec2hex", "hex2bin", "hex2dec" };
+  static const std::vector<std::string> cmds = { "bin2dec", "bin2hex", "dec2bin", "dec2hex", "hex2bin", "hex2dec" };
+  return cmds;
 }
 
 Message Conversion::handleCommand(const std::string_view& command, const std::string_view& message,
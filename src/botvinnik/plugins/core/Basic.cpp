@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -34,9 +34,10 @@ Basic::Basic(Bot& b)
 {
 }
 
-std::vector<std::string> Basic::commands() const
+const std::vector<std::string>& Basic::commands() const
 {
-  return { "stop", "version", "whoami" };
+  static const std::vector<std::string> cmds = { "stop", "version", "whoami" };
+  return cmds;
 }
 
 Message Basic::handleCommand(const std::string_view& command,
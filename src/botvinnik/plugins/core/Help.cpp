@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -30,9 +30,10 @@ Help::Help(Bot& b)
 {
 }
 
-std::vector<std::string> Help::commands() const
+const std::vector<std::string>& Help::commands() const
 {
-  return { "help" };
+  static const std::vector<std::string> cmds = { "help" };
+  return cmds;
 }
 
 Message Help::handleCommand(const std::string_view& command,
@@ -123,8 +124,8 @@ Message Help::extendedHelp(const std::string_view requested_command) const
 {
   using namespace std::string_literals;
 
-  const auto iter = theBot.commands.find(std::string(requested_command));
-  if (iter == theBot.commands.end())
+  const Plugin* plugin = theBot.commands.find(requested_command);
+  if (plugin == nullptr)
   {
     // Command not found.
     return Message("The bot does not have a command by the name `"s
@@ -134,7 +135,7 @@ Message Help::extendedHelp(const std::string_view requested_command) const
   }
 
   const std::string& prefix = theBot.matrix().configuration().prefix();
-  auto msg = iter->second.get().helpExtended(requested_command, prefix);
+  auto msg = plugin->helpExtended(requested_command, prefix);
   if (msg.body.empty())
   {
      return Message("The bot does not have extended help information for the command `"s
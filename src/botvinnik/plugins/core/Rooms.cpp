@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -29,9 +29,10 @@ Rooms::Rooms(Matrix& matrix)
 {
 }
 
-std::vector<std::string> Rooms::commands() const
+const std::vector<std::string>& Rooms::commands() const
 {
-  return { "rooms", "leave" };
+  static const std::vector<std::string> cmds = { "rooms", "leave" };
+  return cmds;
 }
 
 Message Rooms::handleCommand(const std::string_view& command, const std::string_view& message,
@@ -0,0 +1,133 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "ForecastBatcher.hpp"
+#include <algorithm>
+#include <exception>
+#include "../../../util/Deadline.hpp"
+
+namespace bvn
+{
+
+const std::chrono::milliseconds ForecastBatcher::batch_window = std::chrono::milliseconds(50);
+
+// Keeps the URL of the request at a reasonable length.
+const std::size_t ForecastBatcher::max_batch_size = 20;
+
+ForecastBatcher::ForecastBatcher(BatchFetcher fetchFunction, const std::chrono::milliseconds batchWindow, const std::size_t maxSize)
+: fetcher(std::move(fetchFunction)),
+  window(batchWindow),
+  limit(maxSize),
+  current(nullptr),
+  mutex(),
+  closed()
+{
+}
+
+ForecastBatcher::Result ForecastBatcher::get(const Location& location)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  const bool leader = current == nullptr;
+  if (leader)
+  {
+    current = std::make_shared<Batch>();
+  }
+  const std::shared_ptr<Batch> batch = current;
+  const Deadline own = Deadline::current();
+  if (own.limited())
+  {
+    batch->end = std::max(batch->end, std::chrono::steady_clock::now() + own.remaining());
+  }
+  else
+  {
+    batch->limited = false;
+  }
+  batch->locations.push_back(location);
+  batch->results.emplace_back();
+  std::future<Result> result = batch->results.back().get_future();
+  if (batch->locations.size() >= limit)
+  {
+    current = nullptr;
+    closed.notify_all();
+  }
+
+  if (!leader)
+  {
+    lock.unlock();
+    while (result.wait_for(std::chrono::milliseconds(5)) != std::future_status::ready)
+    {
+      const Deadline deadline = Deadline::current();
+      if (deadline.expired() || deadline.cancelled())
+      {
+        return nonstd::make_unexpected("The request for weather data timed out.");
+      }
+    }
+    return result.get();
+  }
+
+  closed.wait_for(lock, window, [this, &batch]() { return current != batch; });
+  if (current == batch)
+  {
+    current = nullptr;
+  }
+  lock.unlock();
+
+  // No other thread accesses the batch after it was closed.
+  // The request is made on behalf of all callers, so it gets the latest of
+  // their deadlines instead of the deadline of the first caller.
+  const Deadline deadline = batch->limited
+      ? Deadline(std::chrono::duration_cast<std::chrono::milliseconds>(batch->end - std::chrono::steady_clock::now()))
+      : Deadline();
+  Deadline::Scope scope(deadline);
+  nonstd::expected<std::vector<WeatherData>, std::string> weather;
+  try
+  {
+    weather = fetcher(batch->locations);
+  }
+  catch (...)
+  {
+    // Pass the exception to all callers, or they would only get a broken
+    // promise.
+    for (auto& promise: batch->results)
+    {
+      promise.set_exception(std::current_exception());
+    }
+    throw;
+  }
+  for (std::size_t i = 0; i < batch->results.size(); ++i)
+  {
+    if (!weather.has_value())
+    {
+      batch->results[i].set_value(nonstd::make_unexpected(weather.error()));
+    }
+    else if (i < weather.value().size())
+    {
+      batch->results[i].set_value(weather.value()[i]);
+    }
+    else
+    {
+      batch->results[i].set_value(nonstd::make_unexpected("The weather service returned too few results."));
+    }
+  }
+  return result.get();
+}
+
+} // namespace
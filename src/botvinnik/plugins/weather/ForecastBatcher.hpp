@@ -0,0 +1,119 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_PLUGIN_WEATHER_FORECAST_BATCHER_HPP
+#define BVN_PLUGIN_WEATHER_FORECAST_BATCHER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../../../../third-party/nonstd/expected.hpp"
+#include "Location.hpp"
+#include "WeatherData.hpp"
+
+namespace bvn
+{
+
+/** \brief Groups weather requests for different locations that arrive within
+ *         a short time window into one request to the weather service.
+ */
+class ForecastBatcher
+{
+  public:
+    /** \brief result type of weather requests for a single location
+     */
+    using Result = nonstd::expected<WeatherData, std::string>;
+
+    /** \brief type of the function that gets weather data for several locations
+     */
+    using BatchFetcher = std::function<nonstd::expected<std::vector<WeatherData>, std::string>(const std::vector<Location>&)>;
+
+
+    /** \brief Constructor.
+     *
+     * \param fetchFunction  function that gets the weather data for several
+     *                       locations with one request
+     * \param batchWindow    time to wait for further locations after the
+     *                       first location of a batch
+     * \param maxSize        maximum number of locations in one batch
+     */
+    explicit ForecastBatcher(BatchFetcher fetchFunction,
+                             const std::chrono::milliseconds batchWindow = batch_window,
+                             const std::size_t maxSize = max_batch_size);
+
+
+    ForecastBatcher(const ForecastBatcher& other) = delete;
+    ForecastBatcher& operator=(const ForecastBatcher& other) = delete;
+
+
+    /** \brief Gets the weather data for a location.
+     *
+     * The first caller of a batch waits for the batch window to end or for
+     * the batch to be full, and then performs the request for all locations
+     * of the batch. Other callers wait for the result of that request. The
+     * request uses the latest deadline of all callers in the batch, so that
+     * it does not fail just because the deadline of the first caller is
+     * over.
+     *
+     * \param location  the location to get the weather data for
+     * \return Returns the weather data for the location in case of success.
+     *         Returns a string containing an error message in case of failure.
+     * \remarks If the fetch function throws an exception, that exception is
+     *          thrown to all callers of the batch.
+     */
+    Result get(const Location& location);
+
+
+    /** \brief default time to wait for further locations
+     */
+    static const std::chrono::milliseconds batch_window;
+
+
+    /** \brief default maximum number of locations in one request
+     */
+    static const std::size_t max_batch_size;
+  private:
+    /** \brief locations that are requested together
+     */
+    struct Batch
+    {
+      std::vector<Location> locations; /**< requested locations */
+      std::vector<std::promise<Result>> results; /**< results for each location */
+      std::chrono::steady_clock::time_point end; /**< latest deadline of the callers */
+      bool limited = true; /**< whether all callers have a time limit */
+    }; // struct
+
+    BatchFetcher fetcher; /**< function that gets weather data */
+    std::chrono::milliseconds window; /**< time to wait for further locations */
+    std::size_t limit; /**< maximum number of locations in one batch */
+    std::shared_ptr<Batch> current; /**< batch that still accepts locations, may be nullptr */
+    std::mutex mutex; /**< protects current */
+    std::condition_variable closed; /**< signals that the current batch is full */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_WEATHER_FORECAST_BATCHER_HPP
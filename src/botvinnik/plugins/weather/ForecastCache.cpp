@@ -0,0 +1,248 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "ForecastCache.hpp"
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include "../../../util/Deadline.hpp"
+
+namespace bvn
+{
+
+// Open-Meteo updates the current weather data every 15 minutes.
+const std::chrono::seconds ForecastCache::update_interval = std::chrono::minutes(15);
+
+const std::chrono::seconds ForecastCache::stale_period = std::chrono::minutes(60);
+
+const std::chrono::milliseconds ForecastCache::refresh_timeout = std::chrono::seconds(15);
+
+ForecastCache::ForecastCache(Fetcher fetchFunction, const std::chrono::seconds updateInterval, const std::chrono::seconds stalePeriod)
+: fetcher(std::move(fetchFunction)),
+  interval(updateInterval),
+  stale(stalePeriod),
+  entries(),
+  pending(),
+  refreshes(0),
+  mutex(),
+  refreshDone()
+{
+}
+
+ForecastCache::~ForecastCache()
+{
+  // Queued refreshes still access the cache, so wait for them.
+  std::unique_lock<std::mutex> lock(mutex);
+  refreshDone.wait(lock, [this]() { return refreshes == 0; });
+}
+
+ForecastCache::Key ForecastCache::gridKey(const Location& location)
+{
+  return Key(static_cast<int>(std::lround(location.latitude * 10.0)),
+             static_cast<int>(std::lround(location.longitude * 10.0)));
+}
+
+Location ForecastCache::gridPoint(const Location& location)
+{
+  Location point = location;
+  const Key key = gridKey(location);
+  point.latitude = key.first / 10.0;
+  point.longitude = key.second / 10.0;
+  return point;
+}
+
+std::chrono::system_clock::time_point ForecastCache::nextUpdate() const
+{
+  const auto now = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  return std::chrono::system_clock::time_point((now / interval + 1) * interval);
+}
+
+ForecastCache::Result ForecastCache::get(const Location& location, ThreadPool& pool)
+{
+  if (std::isnan(location.latitude) || std::isnan(location.longitude))
+  {
+    return nonstd::make_unexpected("Location has no latitude and longitude!");
+  }
+
+  const Key key = gridKey(location);
+  const Location point = gridPoint(location);
+  std::shared_future<Result> request;
+  std::promise<Result> promise;
+  std::optional<WeatherData> staleData;
+  bool startRefresh = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto now = std::chrono::system_clock::now();
+    auto iter = entries.find(key);
+    if (iter != entries.end())
+    {
+      Entry& entry = iter->second;
+      if (now < entry.fresh_until)
+      {
+        return entry.data;
+      }
+      if (now < entry.fresh_until + stale)
+      {
+        startRefresh = !entry.refreshing;
+        if (startRefresh)
+        {
+          entry.refreshing = true;
+          ++refreshes;
+        }
+        staleData = entry.data;
+      }
+    }
+
+    if (!staleData.has_value())
+    {
+      const auto running = pending.find(key);
+      if (running != pending.end())
+      {
+        request = running->second;
+      }
+      else
+      {
+        pending[key] = promise.get_future().share();
+      }
+    }
+  }
+
+  if (staleData.has_value())
+  {
+    // The refresh is submitted without holding the lock, because a pool
+    // without threads executes it right away, and it needs the lock, too.
+    if (startRefresh)
+    {
+      pool.submit([this, key, point]() { refresh(key, point); });
+    }
+    return staleData.value();
+  }
+
+  if (request.valid())
+  {
+    // Another request for the same cell is running, wait for its result.
+    while (request.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      const Deadline deadline = Deadline::current();
+      if (deadline.expired() || deadline.cancelled())
+      {
+        return nonstd::make_unexpected("The request for weather data timed out.");
+      }
+      if (!pool.runPendingJob())
+      {
+        request.wait_for(std::chrono::milliseconds(5));
+      }
+    }
+    return request.get();
+  }
+
+  std::optional<Result> result;
+  try
+  {
+    result = fetcher(point);
+  }
+  catch (...)
+  {
+    // Waiting requests get the exception, too, and the next request for
+    // the cell tries again.
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending.erase(key);
+    }
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (result.value().has_value())
+    {
+      store(key, result.value().value());
+    }
+    pending.erase(key);
+  }
+  promise.set_value(result.value());
+  return result.value();
+}
+
+void ForecastCache::refresh(const Key& key, const Location& point)
+{
+  // The refresh does not belong to the command that triggered it, so it
+  // gets its own time limit.
+  const Deadline deadline(refresh_timeout);
+  Deadline::Scope scope(deadline);
+  std::optional<Result> result;
+  try
+  {
+    result = fetcher(point);
+  }
+  catch (const std::exception& ex)
+  {
+    // The stale data stays in use, and a later request tries again.
+    std::cerr << "Error: Refresh of weather data failed: " << ex.what() << std::endl;
+  }
+  catch (...)
+  {
+    std::cerr << "Error: Refresh of weather data failed with an unknown exception." << std::endl;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (result.has_value() && result.value().has_value())
+    {
+      store(key, result.value().value());
+    }
+    auto iter = entries.find(key);
+    if (iter != entries.end())
+    {
+      iter->second.refreshing = false;
+    }
+    --refreshes;
+  }
+  refreshDone.notify_all();
+}
+
+void ForecastCache::store(const Key& key, const WeatherData& data)
+{
+  const auto now = std::chrono::system_clock::now();
+  for (auto iter = entries.begin(); iter != entries.end(); )
+  {
+    if (!iter->second.refreshing && (iter->second.fresh_until + stale <= now))
+    {
+      iter = entries.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+
+  Entry& entry = entries[key];
+  entry.data = data;
+  entry.fresh_until = nextUpdate();
+}
+
+std::size_t ForecastCache::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+} // namespace
@@ -0,0 +1,182 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_PLUGIN_WEATHER_FORECAST_CACHE_HPP
+#define BVN_PLUGIN_WEATHER_FORECAST_CACHE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include "../../../../third-party/nonstd/expected.hpp"
+#include "../../../util/ThreadPool.hpp"
+#include "Location.hpp"
+#include "WeatherData.hpp"
+
+namespace bvn
+{
+
+/** \brief Caches weather data for locations, so that several requests for the
+ *         same place cost only one request to the weather service.
+ *
+ * Locations are rounded to a grid of 0.1 degrees, which is about as fine as
+ * the grids of the global weather models. Weather data is fresh until the next
+ * update interval of the weather service starts. After that, stale data is
+ * still returned for a while, but it gets refreshed in the background.
+ * Concurrent requests for a location that is not in the cache share a single
+ * request to the weather service.
+ */
+class ForecastCache
+{
+  public:
+    /** \brief result type of weather requests
+     */
+    using Result = nonstd::expected<WeatherData, std::string>;
+
+    /** \brief type of the function that gets weather data from the weather
+     *         service
+     */
+    using Fetcher = std::function<Result(const Location&)>;
+
+
+    /** \brief Creates an empty cache.
+     *
+     * \param fetchFunction   function that gets the weather data for a location
+     * \param updateInterval  interval in which the weather service updates its data
+     * \param stalePeriod     time after the end of the interval during which
+     *                        stale data is still used while it is refreshed
+     */
+    explicit ForecastCache(Fetcher fetchFunction,
+                           const std::chrono::seconds updateInterval = update_interval,
+                           const std::chrono::seconds stalePeriod = stale_period);
+
+
+    ForecastCache(const ForecastCache& other) = delete;
+    ForecastCache& operator=(const ForecastCache& other) = delete;
+
+
+    /** \brief Destructor, waits for running background refreshes.
+     */
+    ~ForecastCache();
+
+
+    /** \brief Gets the weather data for a location.
+     *
+     * \param location  the location to get the weather data for
+     * \param pool      thread pool for background refreshes of stale data
+     * \return Returns the weather data for the location in case of success.
+     *         Returns a string containing an error message in case of failure.
+     * \remarks Exceptions of the fetch function are passed on to the caller
+     *          and to all requests that wait for the same fetch. Exceptions
+     *          during background refreshes are only logged.
+     */
+    Result get(const Location& location, ThreadPool& pool);
+
+
+    /** \brief Rounds the coordinates of a location to the cache's grid.
+     *
+     * \param location  the location
+     * \return Returns the location with rounded latitude and longitude.
+     */
+    static Location gridPoint(const Location& location);
+
+
+    /** \brief Gets the number of cached locations.
+     *
+     * \return Returns the number of locations in the cache, including stale
+     *         locations.
+     */
+    std::size_t size() const;
+
+
+    /** \brief update interval of the data of Open-Meteo
+     */
+    static const std::chrono::seconds update_interval;
+
+
+    /** \brief time during which stale data is still used while it is refreshed
+     */
+    static const std::chrono::seconds stale_period;
+
+
+    /** \brief time limit for background refreshes
+     */
+    static const std::chrono::milliseconds refresh_timeout;
+  private:
+    /** \brief grid cell, latitude and longitude in tenths of a degree
+     */
+    using Key = std::pair<int, int>;
+
+    /** \brief a single cache entry
+     */
+    struct Entry
+    {
+      WeatherData data; /**< the cached weather data */
+      std::chrono::system_clock::time_point fresh_until; /**< end of freshness */
+      bool refreshing; /**< whether a background refresh is running */
+    }; // struct
+
+    /** \brief Gets the grid cell of a location.
+     *
+     * \param location  the location
+     * \return Returns the key of the location's grid cell.
+     */
+    static Key gridKey(const Location& location);
+
+    /** \brief Gets the time when the current update interval ends.
+     *
+     * \return Returns the time when data fetched now becomes stale.
+     */
+    std::chrono::system_clock::time_point nextUpdate() const;
+
+    /** \brief Refreshes stale data of a cached grid cell.
+     *
+     * \param key    the grid cell
+     * \param point  the grid point of the cell
+     */
+    void refresh(const Key& key, const Location& point);
+
+    /** \brief Stores fresh data and removes entries that are too old to be used.
+     *
+     * \param key   the grid cell
+     * \param data  the weather data for the cell
+     * \remarks The mutex must be held by the caller.
+     */
+    void store(const Key& key, const WeatherData& data);
+
+    Fetcher fetcher; /**< function that gets weather data */
+    std::chrono::seconds interval; /**< update interval of the weather service */
+    std::chrono::seconds stale; /**< time that stale data may be used */
+    std::map<Key, Entry> entries; /**< cached data by grid cell */
+    std::map<Key, std::shared_future<Result>> pending; /**< running requests for cells without data */
+    unsigned int refreshes; /**< number of running background refreshes */
+    mutable std::mutex mutex; /**< protects all of the above */
+    std::condition_variable refreshDone; /**< signals the end of a refresh */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_WEATHER_FORECAST_CACHE_HPP
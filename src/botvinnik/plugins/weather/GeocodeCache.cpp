@@ -0,0 +1,299 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "GeocodeCache.hpp"
+#include <cctype>
+#include <iostream>
+#include "../../../util/Directories.hpp"
+#include "LocationLookup.hpp"
+
+namespace bvn
+{
+
+// Places do not move, but names may be assigned differently over time.
+const std::chrono::hours GeocodeCache::ttl = std::chrono::hours(24 * 30);
+
+// Typos are usually not repeated for long, and the geocoding services may
+// learn about new names, so unknown names are kept for a day only.
+const std::chrono::hours GeocodeCache::negative_ttl = std::chrono::hours(24);
+
+// Expired entries are harmless until then, they just occupy some space.
+const std::chrono::minutes GeocodeCache::purge_interval = std::chrono::minutes(60);
+
+GeocodeCache::GeocodeCache(const std::string& fileName, const std::size_t capacity)
+: recent(capacity),
+  maxEntries(capacity),
+  nextPurge(std::chrono::system_clock::now() + purge_interval),
+  db(fileName),
+  dbReady(false),
+  mutex()
+{
+  if (fileName.empty())
+  {
+    return;
+  }
+  if (!db.isOpen())
+  {
+    std::clog << "Warning: Failed to open or create database " << fileName
+              << ", locations will only be cached in memory." << std::endl;
+    return;
+  }
+  dbReady = loadDatabase();
+}
+
+std::string GeocodeCache::defaultFileName()
+{
+  return filesystem::getDataFileName("weather.db");
+}
+
+std::string GeocodeCache::normalize(const std::string_view& query)
+{
+  std::string result;
+  result.reserve(query.size());
+  bool pendingSpace = false;
+  for (const char c: query)
+  {
+    if (std::isspace(static_cast<unsigned char>(c)))
+    {
+      pendingSpace = !result.empty();
+      continue;
+    }
+    if (pendingSpace)
+    {
+      result.push_back(' ');
+      pendingSpace = false;
+    }
+    // Only ASCII characters are changed, any UTF-8 sequences stay intact.
+    result.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+  }
+  return result;
+}
+
+std::optional<GeocodeCache::Result> GeocodeCache::get(const std::string_view& query)
+{
+  const std::string key = normalize(query);
+  std::lock_guard<std::mutex> lock(mutex);
+  const Entry* entry = recent.find(key);
+  if ((entry == nullptr) || (entry->expires <= std::chrono::system_clock::now()))
+  {
+    return std::nullopt;
+  }
+  if (!entry->location.has_value())
+  {
+    return Result(nonstd::make_unexpected(LocationLookup::not_found));
+  }
+  return Result(entry->location.value());
+}
+
+void GeocodeCache::put(const std::string_view& query, const Result& result)
+{
+  const auto now = std::chrono::system_clock::now();
+  Entry entry;
+  if (result.has_value())
+  {
+    entry.location = result.value();
+    entry.expires = now + ttl;
+  }
+  else if (result.error() == LocationLookup::not_found)
+  {
+    entry.expires = now + negative_ttl;
+  }
+  else
+  {
+    // Do not cache temporary errors.
+    return;
+  }
+
+  const std::string key = normalize(query);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (now >= nextPurge)
+  {
+    purge(now);
+    nextPurge = now + purge_interval;
+  }
+  store(key, entry);
+  // Every entry counts the same, so the capacity is the number of entries.
+  erase(recent.insert(key, entry, 1));
+}
+
+std::size_t GeocodeCache::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return recent.size();
+}
+
+void GeocodeCache::purge(const std::chrono::system_clock::time_point& now)
+{
+  recent.eraseIf([&now](const Entry& entry) { return entry.expires <= now; });
+
+  if (!dbReady)
+  {
+    return;
+  }
+  auto handle = db.lock();
+  sql::statement& remove = handle.prepared("DELETE FROM geocode WHERE expires <= @now;");
+  const int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+  if (!remove || !sql::bind(remove, 1, seconds))
+  {
+    std::cerr << "Error: Could not prepare statement to remove expired locations!\n";
+    return;
+  }
+  const auto ret = sqlite3_step(remove.get());
+  if ((ret != SQLITE_OK) && (ret != SQLITE_DONE))
+  {
+    std::cerr << "Error: Could not remove expired locations from database!\n";
+  }
+}
+
+bool GeocodeCache::loadDatabase()
+{
+  auto handle = db.lock();
+  sql::database& database = handle.db();
+  const std::string statement = R"SQL(
+        CREATE TABLE IF NOT EXISTS geocode (
+          query TEXT PRIMARY KEY NOT NULL,
+          found INTEGER NOT NULL,
+          latitude REAL NOT NULL,
+          longitude REAL NOT NULL,
+          name TEXT NOT NULL,
+          displayName TEXT NOT NULL,
+          expires INTEGER NOT NULL
+        );
+        )SQL";
+  if (!sql::exec(database, statement))
+  {
+    std::cerr << "Error: Could not create table in SQLite 3 database for locations!" << std::endl;
+    return false;
+  }
+
+  const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  // Remove expired entries first, they will never be used again. If there
+  // are more entries than allowed, keep those that expire last.
+  if (!sql::exec(database, "DELETE FROM geocode WHERE expires <= " + std::to_string(now) + ";")
+      || !sql::exec(database, "DELETE FROM geocode WHERE query NOT IN (SELECT query FROM geocode ORDER BY expires DESC LIMIT "
+                              + std::to_string(maxEntries) + ");"))
+  {
+    return false;
+  }
+
+  // Entries that expire last are added last, so they count as most recently used.
+  sql::statement stmt = sql::prepare(database, "SELECT query, found, latitude, longitude, name, displayName, expires FROM geocode ORDER BY expires ASC;");
+  if (!stmt)
+  {
+    std::cerr << "Error: Failed to prepare select statement for locations!\n";
+    return false;
+  }
+  int rc = SQLITE_ERROR;
+  while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW)
+  {
+    Entry entry;
+    if (sqlite3_column_int(stmt.get(), 1) != 0)
+    {
+      Location location;
+      location.latitude = sqlite3_column_double(stmt.get(), 2);
+      location.longitude = sqlite3_column_double(stmt.get(), 3);
+      location.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 4));
+      location.display_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 5));
+      entry.location = std::move(location);
+    }
+    entry.expires = std::chrono::system_clock::time_point(std::chrono::seconds(sqlite3_column_int64(stmt.get(), 6)));
+    recent.insert(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0)), entry, 1);
+  }
+  if (rc != SQLITE_DONE)
+  {
+    std::cerr << "Error: Could not load locations from database!\n"
+              << sqlite3_errmsg(database.get()) << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+void GeocodeCache::store(const std::string& key, const Entry& entry)
+{
+  if (!dbReady)
+  {
+    return;
+  }
+  auto handle = db.lock();
+  sql::statement& insert = handle.prepared("INSERT OR REPLACE INTO geocode (query, found, latitude, longitude, name, displayName, expires) VALUES (@query, @found, @lat, @lon, @name, @display, @expires);");
+  if (!insert)
+  {
+    std::cerr << "Error: Could not prepare insert statement for location!\n";
+    return;
+  }
+  Location location = entry.location.value_or(Location());
+  if (!entry.location.has_value())
+  {
+    // SQLite stores NaN as NULL, so use zero for entries without location.
+    location.latitude = 0.0;
+    location.longitude = 0.0;
+  }
+  const int64_t expires = std::chrono::duration_cast<std::chrono::seconds>(entry.expires.time_since_epoch()).count();
+  if (!sql::bind(insert, 1, key) || !sql::bind(insert, 2, static_cast<int64_t>(entry.location.has_value() ? 1 : 0))
+      || (sqlite3_bind_double(insert.get(), 3, location.latitude) != SQLITE_OK)
+      || (sqlite3_bind_double(insert.get(), 4, location.longitude) != SQLITE_OK)
+      || !sql::bind(insert, 5, location.name) || !sql::bind(insert, 6, location.display_name)
+      || !sql::bind(insert, 7, expires))
+  {
+    std::cerr << "Error: Could not bind values to prepared statement!\n";
+    return;
+  }
+  const auto ret = sqlite3_step(insert.get());
+  if ((ret != SQLITE_OK) && (ret != SQLITE_DONE))
+  {
+    std::cerr << "Error: Could not insert location for '" << key
+              << "' into database!\n";
+  }
+}
+
+void GeocodeCache::erase(const std::vector<std::string>& keys)
+{
+  if (!dbReady || keys.empty())
+  {
+    return;
+  }
+  auto handle = db.lock();
+  sql::statement& remove = handle.prepared("DELETE FROM geocode WHERE query = @query;");
+  if (!remove)
+  {
+    std::cerr << "Error: Could not prepare delete statement for location!\n";
+    return;
+  }
+  for (const auto& key: keys)
+  {
+    sqlite3_reset(remove.get());
+    if (!sql::bind(remove, 1, key))
+    {
+      std::cerr << "Error: Could not bind values to prepared statement!\n";
+      return;
+    }
+    const auto ret = sqlite3_step(remove.get());
+    if ((ret != SQLITE_OK) && (ret != SQLITE_DONE))
+    {
+      std::cerr << "Error: Could not remove location for '" << key
+                << "' from database!\n";
+    }
+  }
+}
+
+} // namespace
@@ -0,0 +1,176 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_PLUGIN_WEATHER_GEOCODE_CACHE_HPP
+#define BVN_PLUGIN_WEATHER_GEOCODE_CACHE_HPP
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../../../third-party/nonstd/expected.hpp"
+#include "../../../util/LruList.hpp"
+#include "../../../util/sqlite3.hpp"
+#include "Location.hpp"
+
+namespace bvn
+{
+
+/** \brief Caches the results of location lookups in memory and in an SQLite
+ *         database, so they survive a restart of the bot.
+ *
+ * Both found locations and names without a matching location are cached,
+ * but the latter expire much sooner. The number of entries is limited, the
+ * entries that were used least recently are evicted first. Expired entries
+ * are removed from time to time.
+ */
+class GeocodeCache
+{
+  public:
+    /** \brief result type of location lookups
+     */
+    using Result = nonstd::expected<Location, std::string>;
+
+
+    /** \brief Creates the cache and loads all entries that are not expired
+     *         from the database.
+     *
+     * \param fileName  file name of the SQLite database; an empty file name
+     *                  means that the cache is kept in memory only
+     * \param capacity  maximum number of cached entries
+     */
+    explicit GeocodeCache(const std::string& fileName, const std::size_t capacity = default_max_entries);
+
+
+    GeocodeCache(const GeocodeCache& other) = delete;
+    GeocodeCache& operator=(const GeocodeCache& other) = delete;
+
+
+    /** \brief Gets the default file name of the cache database.
+     *
+     * \return Returns the default file name of the cache database.
+     */
+    static std::string defaultFileName();
+
+
+    /** \brief Normalizes a location query, so that different spellings of the
+     *         same query share a cache entry.
+     *
+     * \param query  the location query, e. g. "  New   York "
+     * \return Returns the normalized query, e. g. "new york".
+     */
+    static std::string normalize(const std::string_view& query);
+
+
+    /** \brief Gets the cached result for a location query.
+     *
+     * \param query  the location query
+     * \return Returns an optional containing the cached result, if there is
+     *         one that has not expired yet. Returns an empty optional
+     *         otherwise.
+     */
+    std::optional<Result> get(const std::string_view& query);
+
+
+    /** \brief Puts the result of a location lookup into the cache.
+     *
+     * \param query   the location query
+     * \param result  the result of the lookup
+     * \remarks Failed lookups are only cached, if they failed because there
+     *          is no matching location. Other errors, e. g. network errors,
+     *          are not cached.
+     */
+    void put(const std::string_view& query, const Result& result);
+
+
+    /** \brief Gets the number of entries in the cache.
+     *
+     * \return Returns the number of entries, including expired entries.
+     */
+    std::size_t size() const;
+
+
+    /** \brief time that a found location is kept in the cache
+     */
+    static const std::chrono::hours ttl;
+
+
+    /** \brief time that a query without matching location is kept in the cache
+     */
+    static const std::chrono::hours negative_ttl;
+
+
+    /** \brief time between two removals of expired entries
+     */
+    static const std::chrono::minutes purge_interval;
+
+
+    /** \brief default maximum number of cached entries
+     */
+    static constexpr std::size_t default_max_entries = 10000;
+  private:
+    /** \brief a single cache entry
+     */
+    struct Entry
+    {
+      std::optional<Location> location; /**< the location, if one was found */
+      std::chrono::system_clock::time_point expires; /**< expiration time */
+    }; // struct
+
+    /** \brief Removes all expired entries from memory and from the database.
+     *
+     * \param now  the current time
+     */
+    void purge(const std::chrono::system_clock::time_point& now);
+
+    /** \brief Creates the database table, if it does not exist, and loads
+     *         all entries that have not expired.
+     *
+     * \return Returns true, if the database is ready for use.
+     */
+    bool loadDatabase();
+
+    /** \brief Writes an entry to the database.
+     *
+     * \param key    normalized query
+     * \param entry  the entry to write
+     */
+    void store(const std::string& key, const Entry& entry);
+
+    /** \brief Deletes entries from the database.
+     *
+     * \param keys  normalized queries of the entries to delete
+     */
+    void erase(const std::vector<std::string>& keys);
+
+    LruList<Entry> recent; /**< cached entries by normalized query */
+    std::size_t maxEntries; /**< maximum number of entries */
+    std::chrono::system_clock::time_point nextPurge; /**< time of the next removal of expired entries */
+    sql::Connection db; /**< database connection */
+    bool dbReady; /**< whether db is open and has the required table */
+    mutable std::mutex mutex; /**< protects recent and nextPurge */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_WEATHER_GEOCODE_CACHE_HPP
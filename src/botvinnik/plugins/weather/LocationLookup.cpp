@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,22 +19,109 @@
 */
 
 #include "LocationLookup.hpp"
+#include <optional>
+#include <thread>
 #include "LocationLookupOpenMeteo.hpp"
 #include "LocationLookupOpenStreetMap.hpp"
+#include "../../../net/CircuitBreaker.hpp"
 
 namespace bvn
 {
 
+// A successful lookup usually takes a few hundred milliseconds, so a rather
+// short grace period is enough to give OpenStreetMap a fair chance.
+const std::chrono::milliseconds LocationLookup::grace_period = std::chrono::milliseconds(250);
+
+const std::string LocationLookup::not_found = "No matching location was found.";
+
 nonstd::expected<Location, std::string> LocationLookup::find_location(const std::string_view location_name)
 {
-  auto location = LocationLookupOpenStreetMap::find_location(location_name);
-  if (!location.has_value())
+  // Skip OpenStreetMap while it is known to be down, instead of waiting for
+  // yet another failing request.
+  if (CircuitBreaker::upstreams().available(LocationLookupOpenStreetMap::host))
+  {
+    auto location = LocationLookupOpenStreetMap::find_location(location_name);
+    if (location.has_value())
+    {
+      return location;
+    }
+  }
+
+  // Fall back to Open-Meteo geo-coding API.
+  return LocationLookupOpenMeteo::find_location(location_name);
+}
+
+nonstd::expected<Location, std::string> LocationLookup::find_location(const std::string_view location_name, ThreadPool& pool)
+{
+  using Result = nonstd::expected<Location, std::string>;
+
+  // No race is necessary, while OpenStreetMap is known to be down.
+  if (!CircuitBreaker::upstreams().available(LocationLookupOpenStreetMap::host))
   {
-    // Fall back to Open-Meteo geo-coding API.
-    location = LocationLookupOpenMeteo::find_location(location_name);
+    return LocationLookupOpenMeteo::find_location(location_name);
   }
 
-  return location;
+  // Each request gets its own deadline, so that the slower one can be
+  // cancelled without affecting the other one. Curly does not count such a
+  // cancelled request as a failure of the host, so the loser of the race
+  // stays available.
+  const Deadline parent = Deadline::current();
+  Deadline osmDeadline = parent.child();
+  Deadline meteoDeadline = parent.child();
+  std::future<Result> osmFuture;
+  std::future<Result> meteoFuture;
+  {
+    Deadline::Scope scope(osmDeadline);
+    osmFuture = pool.submit([name = std::string(location_name)]()
+    {
+      return LocationLookupOpenStreetMap::find_location(name);
+    });
+  }
+  {
+    Deadline::Scope scope(meteoDeadline);
+    meteoFuture = pool.submit([name = std::string(location_name)]()
+    {
+      return LocationLookupOpenMeteo::find_location(name);
+    });
+  }
+
+  const auto is_ready = [](const std::future<Result>& future)
+  {
+    return future.valid() && (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+  };
+  std::optional<Result> osm;
+  std::optional<Result> meteo;
+  std::chrono::steady_clock::time_point grace_end;
+  while (true)
+  {
+    if (!osm.has_value() && is_ready(osmFuture))
+    {
+      osm = osmFuture.get();
+      if (osm.value().has_value())
+      {
+        meteoDeadline.cancel();
+        return osm.value();
+      }
+    }
+    if (!meteo.has_value() && is_ready(meteoFuture))
+    {
+      meteo = meteoFuture.get();
+      grace_end = std::chrono::steady_clock::now() + grace_period;
+    }
+    if (meteo.has_value())
+    {
+      // OpenStreetMap failed, or it took too long after Open-Meteo answered.
+      if (osm.has_value() || (meteo.value().has_value() && std::chrono::steady_clock::now() >= grace_end))
+      {
+        osmDeadline.cancel();
+        return meteo.value();
+      }
+    }
+    if (!pool.runPendingJob())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
 }
 
 } // namespace
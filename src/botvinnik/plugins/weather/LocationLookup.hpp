@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,8 +21,10 @@
 #ifndef BVN_PLUGIN_WEATHER_LOCATION_LOOKUP_HPP
 #define BVN_PLUGIN_WEATHER_LOCATION_LOOKUP_HPP
 
+#include <chrono>
 #include <string>
 #include "../../../../third-party/nonstd/expected.hpp"
+#include "../../../util/ThreadPool.hpp"
 #include "Location.hpp"
 
 namespace bvn
@@ -40,6 +42,31 @@ class LocationLookup
      *         Returns a string containing an error message in case of failure.
      */
     static nonstd::expected<Location, std::string> find_location(const std::string_view location_name);
+
+
+    /** \brief Tries to find a location by its name, asking OpenStreetMap and
+     *         Open-Meteo at the same time.
+     *
+     * The answer of OpenStreetMap is preferred, if it arrives within the grace
+     * period after a good answer from Open-Meteo. Otherwise the first good
+     * answer is used, and the other request is cancelled.
+     *
+     * \param location_name   name of the location to find, e. g. "Berlin"
+     * \param pool   the thread pool that executes both requests
+     * \return Returns the data for the location in case of success.
+     *         Returns a string containing an error message in case of failure.
+     */
+    static nonstd::expected<Location, std::string> find_location(const std::string_view location_name, ThreadPool& pool);
+
+
+    /** \brief time to wait for OpenStreetMap after Open-Meteo has answered
+     */
+    static const std::chrono::milliseconds grace_period;
+
+
+    /** \brief error message for names without a matching location
+     */
+    static const std::string not_found;
 }; // class
 
 } // namespace
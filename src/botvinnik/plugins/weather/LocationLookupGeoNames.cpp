@@ -0,0 +1,254 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "LocationLookupGeoNames.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <iostream>
+#include <limits>
+#include "GeocodeCache.hpp"
+#include "LocationLookup.hpp"
+
+namespace bvn
+{
+
+namespace
+{
+
+// Columns of the GeoNames dump that are used here.
+const std::size_t column_name = 1;
+const std::size_t column_ascii_name = 2;
+const std::size_t column_alternate_names = 3;
+const std::size_t column_latitude = 4;
+const std::size_t column_longitude = 5;
+const std::size_t column_country = 8;
+const std::size_t column_population = 14;
+const std::size_t column_count = 15;
+
+/** \brief Splits the first columns of a line of the GeoNames dump.
+ *
+ * \param line     the line
+ * \param columns  array that will receive the columns
+ * \return Returns true, if the line has enough columns.
+ */
+bool splitColumns(std::string_view line, std::array<std::string_view, column_count>& columns)
+{
+  for (std::size_t i = 0; i < column_count; ++i)
+  {
+    const auto tab = line.find('\t');
+    columns[i] = line.substr(0, tab);
+    if (tab == std::string_view::npos)
+    {
+      return i + 1 == column_count;
+    }
+    line.remove_prefix(tab + 1);
+  }
+  return true;
+}
+
+/** \brief Parses a coordinate from a column of the GeoNames dump.
+ *
+ * \param column  the column
+ * \param value   variable that will receive the coordinate
+ * \return Returns true, if the whole column is a valid number.
+ * \remarks Unlike std::strtod(), this does not depend on the locale.
+ */
+bool parseCoordinate(const std::string_view column, double& value)
+{
+  if (column.empty())
+  {
+    return false;
+  }
+  const char* last = column.data() + column.size();
+  const auto [ptr, ec] = std::from_chars(column.data(), last, value);
+  return (ec == std::errc()) && (ptr == last);
+}
+
+/** \brief Calls a function for each distinct normalized name of a place.
+ *
+ * \param columns  the columns of the place's line
+ * \param func     function that gets each normalized name
+ */
+template<typename F>
+void forEachName(const std::array<std::string_view, column_count>& columns, F&& func)
+{
+  std::vector<std::string> seen;
+  const auto visit = [&seen, &func](const std::string_view& name)
+  {
+    std::string normalized = GeocodeCache::normalize(name);
+    if (normalized.empty() || (std::find(seen.begin(), seen.end(), normalized) != seen.end()))
+    {
+      return;
+    }
+    func(normalized);
+    seen.push_back(std::move(normalized));
+  };
+  visit(columns[column_name]);
+  visit(columns[column_ascii_name]);
+  std::string_view alternates = columns[column_alternate_names];
+  while (!alternates.empty())
+  {
+    const auto comma = alternates.find(',');
+    visit(alternates.substr(0, comma));
+    if (comma == std::string_view::npos)
+    {
+      break;
+    }
+    alternates.remove_prefix(comma + 1);
+  }
+}
+
+} // namespace
+
+LocationLookupGeoNames::LocationLookupGeoNames()
+: file(),
+  index()
+{
+}
+
+uint64_t LocationLookupGeoNames::hash(const std::string_view& name)
+{
+  // 64 bit FNV-1a
+  uint64_t result = 14695981039346656037u;
+  for (const char c: name)
+  {
+    result ^= static_cast<unsigned char>(c);
+    result *= 1099511628211u;
+  }
+  return result;
+}
+
+bool LocationLookupGeoNames::load(const std::string& fileName)
+{
+  index.clear();
+  if (!file.open(fileName))
+  {
+    return false;
+  }
+  const std::string_view content = file.content();
+  if (content.size() > std::numeric_limits<uint32_t>::max())
+  {
+    std::cerr << "Error: GeoNames file " << fileName << " is too large!\n"
+              << "Use one of the smaller files like cities500.txt instead.\n";
+    file.close();
+    return false;
+  }
+
+  std::array<std::string_view, column_count> columns;
+  std::size_t start = 0;
+  while (start < content.size())
+  {
+    std::size_t end = content.find('\n', start);
+    if (end == std::string_view::npos)
+    {
+      end = content.size();
+    }
+    if (splitColumns(line(static_cast<uint32_t>(start)), columns))
+    {
+      uint64_t population = 0;
+      const auto& pop = columns[column_population];
+      std::from_chars(pop.data(), pop.data() + pop.size(), population);
+      const uint32_t clamped = static_cast<uint32_t>(std::min<uint64_t>(population, std::numeric_limits<uint32_t>::max()));
+      forEachName(columns, [this, start, clamped](const std::string& name)
+      {
+        index.push_back(Entry{ hash(name), static_cast<uint32_t>(start), clamped });
+      });
+    }
+    start = end + 1;
+  }
+
+  index.shrink_to_fit();
+  std::sort(index.begin(), index.end(), [](const Entry& a, const Entry& b)
+  {
+    if (a.hash != b.hash)
+    {
+      return a.hash < b.hash;
+    }
+    return a.population > b.population;
+  });
+  return true;
+}
+
+std::string_view LocationLookupGeoNames::line(const uint32_t offset) const
+{
+  std::string_view result = file.content().substr(offset);
+  result = result.substr(0, result.find('\n'));
+  if (!result.empty() && (result.back() == '\r'))
+  {
+    result.remove_suffix(1);
+  }
+  return result;
+}
+
+nonstd::expected<Location, std::string> LocationLookupGeoNames::find_location(const std::string_view location_name) const
+{
+  const std::string normalized = GeocodeCache::normalize(location_name);
+  const uint64_t key = hash(normalized);
+  auto iter = std::lower_bound(index.begin(), index.end(), key,
+      [](const Entry& entry, const uint64_t value) { return entry.hash < value; });
+  std::array<std::string_view, column_count> columns;
+  for (; (iter != index.end()) && (iter->hash == key); ++iter)
+  {
+    if (!splitColumns(line(iter->offset), columns))
+    {
+      continue;
+    }
+    // Different names may have the same hash, so check the names.
+    bool match = false;
+    forEachName(columns, [&match, &normalized](const std::string& name)
+    {
+      match = match || (name == normalized);
+    });
+    if (!match)
+    {
+      continue;
+    }
+
+    Location location;
+    // Skip broken lines instead of returning wrong coordinates.
+    if (!parseCoordinate(columns[column_latitude], location.latitude)
+        || !parseCoordinate(columns[column_longitude], location.longitude))
+    {
+      continue;
+    }
+    location.name = std::string(columns[column_name]);
+    location.display_name = location.name;
+    if (!columns[column_country].empty())
+    {
+      location.display_name.append(", ").append(columns[column_country]);
+    }
+    if (!location.has_data())
+    {
+      return nonstd::make_unexpected("GeoNames data for the location is incomplete.");
+    }
+    return location;
+  }
+
+  return nonstd::make_unexpected(LocationLookup::not_found);
+}
+
+std::size_t LocationLookupGeoNames::size() const
+{
+  return index.size();
+}
+
+} // namespace
@@ -0,0 +1,110 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_PLUGIN_WEATHER_LOCATION_LOOKUP_GEONAMES_HPP
+#define BVN_PLUGIN_WEATHER_LOCATION_LOOKUP_GEONAMES_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../../../../third-party/nonstd/expected.hpp"
+#include "../../../util/MappedFile.hpp"
+#include "Location.hpp"
+
+namespace bvn
+{
+
+/** \brief Finds a location by name in a local copy of a GeoNames dump, e. g.
+ *         cities15000.txt from <https://download.geonames.org/export/dump/>.
+ *
+ * The dump is mapped into memory. The index only contains the hashes of the
+ * names and alternate names of each place, the position of the place in the
+ * dump and its population, so it needs 16 bytes per name.
+ */
+class LocationLookupGeoNames
+{
+  public:
+    /** \brief Creates an empty index.
+     */
+    LocationLookupGeoNames();
+
+
+    LocationLookupGeoNames(const LocationLookupGeoNames& other) = delete;
+    LocationLookupGeoNames& operator=(const LocationLookupGeoNames& other) = delete;
+
+
+    /** \brief Loads a GeoNames dump and builds the index for it.
+     *
+     * \param fileName   name of the GeoNames file, e. g. "cities15000.txt"
+     * \return Returns true, if the file was loaded successfully.
+     *         Returns false otherwise.
+     */
+    bool load(const std::string& fileName);
+
+
+    /** \brief Tries to find a location by its name.
+     *
+     * \param location_name   name of the location to find, e. g. "Berlin"
+     * \return Returns the data for the location in case of success. If
+     *         several places have that name, the place with the largest
+     *         population is returned.
+     *         Returns a string containing an error message in case of failure.
+     */
+    nonstd::expected<Location, std::string> find_location(const std::string_view location_name) const;
+
+
+    /** \brief Gets the number of names in the index.
+     *
+     * \return Returns the number of indexed names, including alternate names.
+     */
+    std::size_t size() const;
+  private:
+    /** \brief entry of the index
+     */
+    struct Entry
+    {
+      uint64_t hash; /**< hash of the normalized name */
+      uint32_t offset; /**< position of the line of the place in the dump */
+      uint32_t population; /**< population of the place */
+    }; // struct
+
+    /** \brief Calculates the hash of a normalized name.
+     *
+     * \param name  the normalized name
+     * \return Returns the hash of the name.
+     */
+    static uint64_t hash(const std::string_view& name);
+
+    /** \brief Gets the line of the place at a given position in the dump.
+     *
+     * \param offset  position of the line in the dump
+     * \return Returns the line, without the line break.
+     */
+    std::string_view line(const uint32_t offset) const;
+
+    MappedFile file; /**< the mapped GeoNames dump */
+    std::vector<Entry> index; /**< entries, sorted by hash and descending population */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_WEATHER_LOCATION_LOOKUP_GEONAMES_HPP
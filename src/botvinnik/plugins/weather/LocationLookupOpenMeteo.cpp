@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,12 +21,16 @@
 #include "LocationLookupOpenMeteo.hpp"
 #include <iostream>
 #include "../../../../third-party/simdjson/simdjson.h"
+#include "../../../net/CircuitBreaker.hpp"
 #include "../../../net/Curly.hpp"
 #include "../../../net/url_encode.hpp"
+#include "LocationLookup.hpp"
 
 namespace bvn
 {
 
+const std::string LocationLookupOpenMeteo::host = "geocoding-api.open-meteo.com";
+
 nonstd::expected<Location, std::string> LocationLookupOpenMeteo::find_location(const std::string_view location_name)
 {
   std::string encoded_location;
@@ -40,11 +44,16 @@ nonstd::expected<Location, std::string> LocationLookupOpenMeteo::find_location(c
   }
 
   Curly curl;
-  curl.setURL("https://geocoding-api.open-meteo.com/v1/search?name=" + encoded_location
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+  curl.setURL("https://" + host + "/v1/search?name=" + encoded_location
               + "&count=1&language=en&format=json");
   std::string response;
   if (!curl.perform(response))
   {
+    if (curl.circuitOpen())
+    {
+      return nonstd::make_unexpected("The location service is currently unavailable. Please try again later.");
+    }
     std::cerr << "Error: Request to Open-Meteo failed!\n"
               << "HTTP status code: " << curl.getResponseCode() << std::endl
               << "Response: " << response << std::endl;
@@ -77,7 +86,7 @@ nonstd::expected<Location, std::string> LocationLookupOpenMeteo::parse_response(
   {
     // If no match was found, then the Open-Meteor geocoding API does not
     // generate a results element.
-    return nonstd::make_unexpected("No matching location was found.");
+    return nonstd::make_unexpected(LocationLookup::not_found);
   }
   if (results.type() != simdjson::dom::element_type::ARRAY)
   {
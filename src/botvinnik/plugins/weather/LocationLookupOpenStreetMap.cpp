@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,13 +21,17 @@
 #include "LocationLookupOpenStreetMap.hpp"
 #include <iostream>
 #include "../../../../third-party/simdjson/simdjson.h"
+#include "../../../net/CircuitBreaker.hpp"
 #include "../../../net/Curly.hpp"
 #include "../../../net/url_encode.hpp"
+#include "LocationLookup.hpp"
 #include "../../../Version.hpp"
 
 namespace bvn
 {
 
+const std::string LocationLookupOpenStreetMap::host = "nominatim.openstreetmap.org";
+
 nonstd::expected<Location, std::string> LocationLookupOpenStreetMap::find_location(const std::string_view location_name)
 {
   std::string encoded_location;
@@ -41,12 +45,17 @@ nonstd::expected<Location, std::string> LocationLookupOpenStreetMap::find_locati
   }
 
   Curly curl;
-  curl.setURL("https://nominatim.openstreetmap.org/search?q=" + encoded_location
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+  curl.setURL("https://" + host + "/search?q=" + encoded_location
               + "&accept-language=en&limit=1&format=geojson");
   curl.addHeader("User-Agent: " + bvn::userAgent);
   std::string response;
   if (!curl.perform(response))
   {
+    if (curl.circuitOpen())
+    {
+      return nonstd::make_unexpected("The location service is currently unavailable. Please try again later.");
+    }
     std::cerr << "Error: Request to OSM failed!\n"
               << "HTTP status code: " << curl.getResponseCode() << std::endl
               << "Response: " << response << std::endl;
@@ -82,7 +91,7 @@ nonstd::expected<Location, std::string> LocationLookupOpenStreetMap::parse_respo
 
   if (features.get_array().value().size() == 0)
   {
-    return nonstd::make_unexpected("No matching location was found.");
+    return nonstd::make_unexpected(LocationLookup::not_found);
   }
 
   simdjson::dom::element element;
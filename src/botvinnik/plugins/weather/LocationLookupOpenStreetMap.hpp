@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -33,6 +33,11 @@ namespace bvn
 class LocationLookupOpenStreetMap
 {
   public:
+    /** \brief name of the host that provides the API
+     */
+    static const std::string host;
+
+
     /** \brief Tries to find a location by its name.
      *
      * \param location_name   name of the location to find, e. g. "Berlin"
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,7 +21,9 @@
 #include "OpenMeteo.hpp"
 #include <cmath>
 #include <iostream>
+#include "../../../net/CircuitBreaker.hpp"
 #include "../../../net/Curly.hpp"
+#include "../../../util/JsonBinding.hpp"
 #include "../../../util/Strings.hpp"
 
 namespace bvn
@@ -29,27 +31,62 @@ namespace bvn
 
 nonstd::expected<WeatherData, std::string> OpenMeteo::get_weather(const Location& location)
 {
-  if (std::isnan(location.latitude) || std::isnan(location.longitude))
+  auto weather = get_weather(std::vector<Location>{ location });
+  if (!weather.has_value())
   {
-    return nonstd::make_unexpected("Location has no latitude and longitude!");
+    return nonstd::make_unexpected(weather.error());
   }
+  return std::move(weather.value()[0]);
+}
+
+nonstd::expected<std::vector<WeatherData>, std::string> OpenMeteo::get_weather(const std::vector<Location>& locations)
+{
+  if (locations.empty())
+  {
+    return std::vector<WeatherData>();
+  }
+  std::string latitudes;
+  std::string longitudes;
+  std::string timezones;
+  for (const Location& location: locations)
+  {
+    if (std::isnan(location.latitude) || std::isnan(location.longitude))
+    {
+      return nonstd::make_unexpected("Location has no latitude and longitude!");
+    }
+    if (!latitudes.empty())
+    {
+      latitudes.append(",");
+      longitudes.append(",");
+      timezones.append(",");
+    }
+    latitudes.append(doubleToString(location.latitude));
+    longitudes.append(doubleToString(location.longitude));
+    timezones.append("auto");
+  }
+
   Curly curl;
-  curl.setURL("https://api.open-meteo.com/v1/forecast?latitude=" + doubleToString(location.latitude)
-      + "&longitude=" + doubleToString(location.longitude)
+  curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+  curl.setURL("https://api.open-meteo.com/v1/forecast?latitude=" + latitudes
+      + "&longitude=" + longitudes
       + "&current=temperature_2m,relative_humidity_2m,apparent_temperature,"
       + "precipitation,weather_code,surface_pressure,wind_speed_10m,wind_direction_10m"
       + "&daily=weather_code,temperature_2m_max,temperature_2m_min"
-      + "&timezone=auto");
+      + "&timezone=" + timezones);
   std::string response;
   if (!curl.perform(response))
   {
+    if (curl.circuitOpen())
+    {
+      return nonstd::make_unexpected("The weather service is currently unavailable. Please try again later.");
+    }
     std::cerr << "Error: Request to Open-Meteo failed!\n"
               << "HTTP status code: " << curl.getResponseCode() << std::endl
               << "Response: " << response << std::endl;
     return nonstd::make_unexpected("Failed to look up the requested location!");
   }
 
-  return parse_response(response);
+  return parse_batch_response(response, locations.size());
 }
 
 nonstd::expected<WeatherData, std::string> OpenMeteo::parse_response(const std::string& response)
@@ -69,197 +106,129 @@ nonstd::expected<WeatherData, std::string> OpenMeteo::parse_response(const std::
     return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: Root element is not an object!");
   }
 
-  auto current = parse_current_data(doc);
-  if (!current.has_value())
-  {
-    return nonstd::make_unexpected(current.error());
-  }
-
-  auto forecast = parse_forecast_data(doc);
-  if (!forecast.has_value())
-  {
-    return nonstd::make_unexpected(forecast.error());
-  }
-
-  WeatherData w;
-  w.current = current.value();
-  w.forecast = forecast.value();
-  return w;
+  return parse_weather_data(doc);
 }
 
-nonstd::expected<CurrentData, std::string> OpenMeteo::parse_current_data(const simdjson::dom::element& doc)
+nonstd::expected<std::vector<WeatherData>, std::string> OpenMeteo::parse_batch_response(const std::string& response, const std::size_t count)
 {
-  simdjson::dom::element current;
-  auto error = doc.at_pointer("/current").get(current);
-  if (error || (current.type() != simdjson::dom::element_type::OBJECT))
+  // Open-Meteo only returns an array, if there is more than one location.
+  if (count == 1)
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: 'current' element is missing or not an object!");
+    auto weather = parse_response(response);
+    if (!weather.has_value())
+    {
+      return nonstd::make_unexpected(weather.error());
+    }
+    return std::vector<WeatherData>{ std::move(weather.value()) };
   }
 
-  simdjson::dom::element element;
-  error = current["temperature_2m"].get(element);
-  if (error || !element.is_double())
+  simdjson::dom::parser parser;
+  simdjson::dom::element doc;
+  const auto error = parser.parse(response).get(doc);
+  if (error)
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: temperature_2m element is missing or not a floating-point number!");
+    std::cerr << "Error while trying to parse JSON response from Open-Meteo!\n"
+              << "Response is: " << response << std::endl;
+    return nonstd::make_unexpected("The weather data request returned invalid JSON.");
   }
-  CurrentData data;
-  data.temperature_celsius = element.get<double>().value();
 
-  error = current["apparent_temperature"].get(element);
-  if (error || !element.is_double())
+  if (doc.type() != simdjson::dom::element_type::ARRAY)
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: apparent_temperature element is missing or not a floating-point number!");
+    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: Root element is not an array!");
   }
-  data.apparent_temperature = element.get<double>().value();
-
-  error = current["relative_humidity_2m"].get(element);
-  if (error || !element.is_double())
+  const simdjson::dom::array elements = doc.get_array().value();
+  if (elements.size() != count)
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: relative_humidity_2m element is missing or not an integer number!");
+    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: Number of elements does not match the number of locations!");
   }
-  data.relative_humidity = element.get<int64_t>().value();
 
-  error = current["weather_code"].get(element);
-  if (error || !element.is_double())
+  std::vector<WeatherData> result;
+  result.reserve(count);
+  for (const simdjson::dom::element element: elements)
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: weather_code element is missing or not an integer number!");
+    if (element.type() != simdjson::dom::element_type::OBJECT)
+    {
+      return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: Array element is not an object!");
+    }
+    auto weather = parse_weather_data(element);
+    if (!weather.has_value())
+    {
+      return nonstd::make_unexpected(weather.error());
+    }
+    result.push_back(std::move(weather.value()));
   }
-  data.weather_code = element.get<int64_t>().value();
 
-  error = current["wind_speed_10m"].get(element);
-  if (error || !element.is_double())
+  return result;
+}
+
+nonstd::expected<WeatherData, std::string> OpenMeteo::parse_weather_data(const simdjson::dom::element& doc)
+{
+  auto current = parse_current_data(doc);
+  if (!current.has_value())
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: wind_speed_10m element is missing or not a floating-point number!");
+    return nonstd::make_unexpected(current.error());
   }
-  data.wind_speed = element.get<double>().value();
 
-  error = current["wind_direction_10m"].get(element);
-  if (error || !element.is_double())
+  auto forecast = parse_forecast_data(doc);
+  if (!forecast.has_value())
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: wind_direction_10m element is missing or not a floating-point number!");
+    return nonstd::make_unexpected(forecast.error());
   }
-  data.wind_direction = element.get<double>().value();
 
-  error = current["surface_pressure"].get(element);
-  if (error || !element.is_double())
+  WeatherData w;
+  w.current = current.value();
+  w.forecast = forecast.value();
+  return w;
+}
+
+nonstd::expected<CurrentData, std::string> OpenMeteo::parse_current_data(const simdjson::dom::element& doc)
+{
+  simdjson::dom::object current;
+  if (doc.at_pointer("/current").get(current))
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: surface_pressure element is missing or not a floating-point number!");
+    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: 'current' element is missing or not an object!");
   }
-  data.pressure = element.get<double>().value();
 
-  error = current["precipitation"].get(element);
-  if (error || !element.is_double())
+  static constexpr auto schema = std::make_tuple(
+      json::field("temperature_2m", &CurrentData::temperature_celsius),
+      json::field("apparent_temperature", &CurrentData::apparent_temperature),
+      json::field("relative_humidity_2m", &CurrentData::relative_humidity),
+      json::field("weather_code", &CurrentData::weather_code),
+      json::field("wind_speed_10m", &CurrentData::wind_speed),
+      json::field("wind_direction_10m", &CurrentData::wind_direction),
+      json::field("surface_pressure", &CurrentData::pressure),
+      json::field("precipitation", &CurrentData::precipitation));
+
+  CurrentData data;
+  const auto error = json::decode(current, schema, data);
+  if (error.has_value())
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: precipitation element is missing or not a floating-point number!");
+    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: " + error.value().message());
   }
-  data.precipitation = element.get<double>().value();
-
   return data;
 }
 
 nonstd::expected<std::vector<ForecastData>, std::string> OpenMeteo::parse_forecast_data(const simdjson::dom::element& doc)
 {
-  simdjson::dom::element daily;
-  auto error = doc.at_pointer("/daily").get(daily);
-  if (error || (daily.type() != simdjson::dom::element_type::OBJECT))
+  simdjson::dom::object daily;
+  if (doc.at_pointer("/daily").get(daily))
   {
     return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: 'daily' element is missing or not an object!");
   }
 
-  simdjson::dom::element element;
-  error = daily["time"].get(element);
-  if (error || !element.is_array())
-  {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: daily.time element is missing or not an array!");
-  }
-  simdjson::dom::array array = element.get_array().value();
-  const auto count = array.size();
-  if (count == 0)
-  {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: daily.time element is an empty array!");
-  }
+  // The first column determines the number of days.
+  static constexpr auto columns = std::make_tuple(
+      json::column("time", &ForecastData::date),
+      json::column("weather_code", &ForecastData::weather_code),
+      json::column("temperature_2m_max", &ForecastData::temperature_max),
+      json::column("temperature_2m_min", &ForecastData::temperature_min));
 
   std::vector<ForecastData> data;
-  for (auto time: array)
-  {
-    if (!time.is_string())
-    {
-      return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: An element of daily.time is not a string!");
-    }
-    ForecastData fc;
-    fc.date = time.get<std::string_view>().value();
-    data.emplace_back(fc);
-  }
-
-  error = daily["weather_code"].get(element);
-  if (error || !element.is_array())
+  const auto error = json::decode_columns(daily, columns, data, "daily");
+  if (error.has_value())
   {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: daily.weather_code element is missing or not an array!");
+    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: " + error.value().message());
   }
-  array = element.get_array().value();
-  if (array.size() != count)
-  {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: daily.weather_code array has an unexpected number of elements!");
-  }
-  {
-    std::size_t idx = 0;
-    for (const auto& code: array)
-    {
-      if (!code.is<int64_t>())
-      {
-        return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: An element of daily.weather_code is not an integer!");
-      }
-      data[idx].weather_code = code.get<int64_t>().value();
-      ++idx;
-    }
-  }
-
-  error = daily["temperature_2m_max"].get(element);
-  if (error || !element.is_array())
-  {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: daily.temperature_2m_max element is missing or not an array!");
-  }
-  array = element.get_array().value();
-  if (array.size() != count)
-  {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: daily.temperature_2m_max array has an unexpected number of elements!");
-  }
-  {
-    std::size_t idx = 0;
-    for (const auto& t_max: array)
-    {
-      if (!t_max.is_double())
-      {
-        return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: An element of daily.temperature_2m_max is not a floating-point number!");
-      }
-      data[idx].temperature_max = t_max.get<double>().value();
-      ++idx;
-    }
-  }
-
-  error = daily["temperature_2m_min"].get(element);
-  if (error || !element.is_array())
-  {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: daily.temperature_2m_min element is missing or not an array!");
-  }
-  array = element.get_array().value();
-  if (array.size() != count)
-  {
-    return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: daily.temperature_2m_min array has an unexpected number of elements!");
-  }
-  {
-    std::size_t idx = 0;
-    for (const auto& t_min: array)
-    {
-      if (!t_min.is_double())
-      {
-        return nonstd::make_unexpected("Open-Meteo request returned invalid JSON: An element of daily.temperature_2m_min is not a floating-point number!");
-      }
-      data[idx].temperature_min = t_min.get<double>().value();
-      ++idx;
-    }
-  }
-
   return data;
 }
 
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -22,6 +22,7 @@
 #define BVN_PLUGIN_WEATHER_OPENMETEO_HPP
 
 #include <string>
+#include <vector>
 #include "../../../../third-party/nonstd/expected.hpp"
 #include "../../../../third-party/simdjson/simdjson.h"
 #include "Location.hpp"
@@ -35,7 +36,7 @@ namespace bvn
 class OpenMeteo
 {
   public:
-    /** \brief Tries to find a location by its name.
+    /** \brief Gets the weather data for a location.
      *
      * \param location   the location for which the weather shall be retrieved
      * \return Returns the weather data for the location in case of success.
@@ -44,6 +45,16 @@ class OpenMeteo
     static nonstd::expected<WeatherData, std::string> get_weather(const Location& location);
 
 
+    /** \brief Gets the weather data for several locations with one request.
+     *
+     * \param locations  the locations for which the weather shall be retrieved
+     * \return Returns the weather data for each location in case of success,
+     *         in the same order as the locations.
+     *         Returns a string containing an error message in case of failure.
+     */
+    static nonstd::expected<std::vector<WeatherData>, std::string> get_weather(const std::vector<Location>& locations);
+
+
     /** \brief Parses the JSON from an API response.
      *
      * \param response    the text of the response (i. e. JSON text)
@@ -53,6 +64,25 @@ class OpenMeteo
     static nonstd::expected<WeatherData, std::string> parse_response(const std::string& response);
 
 
+    /** \brief Parses the JSON from an API response for several locations.
+     *
+     * \param response    the text of the response (i. e. JSON text)
+     * \param count       the number of locations in the request
+     * \return Returns the parsed data for each location in case of success.
+     *         Returns a string containing an error message in case of failure.
+     */
+    static nonstd::expected<std::vector<WeatherData>, std::string> parse_batch_response(const std::string& response, const std::size_t count);
+
+
+    /** \brief Extracts the weather data from the JSON object of a location.
+     *
+     * \param doc    the JSON object containing the data for one location
+     * \return Returns the weather data in case of success.
+     *         Returns a string containing an error message in case of failure.
+     */
+    static nonstd::expected<WeatherData, std::string> parse_weather_data(const simdjson::dom::element& doc);
+
+
     /** \brief Extracts the current weather data from an API response's JSON.
      *
      * \param doc    the root element of the JSON document from the API response
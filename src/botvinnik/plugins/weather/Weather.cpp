@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,6 +20,8 @@
 
 #include "Weather.hpp"
 #include <iostream>
+#include "../../../net/htmlspecialchars.hpp"
+#include "../../../util/Arguments.hpp"
 #include "../../../util/Strings.hpp"
 #include "FreeFunctions.hpp"
 #include "LocationLookup.hpp"
@@ -28,47 +30,188 @@
 namespace bvn
 {
 
-std::vector<std::string> Weather::commands() const
+const std::size_t Weather::max_locations = 5;
+
+Weather::Weather(const std::string& cacheFile, const std::string& geoNamesFile, const bool geoNamesPrimary)
+: locations(cacheFile),
+  offline(nullptr),
+  offlineFirst(geoNamesPrimary),
+  batcher([](const std::vector<Location>& points) { return OpenMeteo::get_weather(points); }),
+  forecasts([this](const Location& point) { return batcher.get(point); })
+{
+  if (!geoNamesFile.empty())
+  {
+    offline = std::make_unique<LocationLookupGeoNames>();
+    if (!offline->load(geoNamesFile))
+    {
+      std::cerr << "Error: Could not load GeoNames file " << geoNamesFile
+                << ", locations will only be looked up online.\n";
+      offline = nullptr;
+    }
+  }
+}
+
+const std::vector<std::string>& Weather::commands() const
 {
-  return { "weather" };
+  static const std::vector<std::string> cmds = { "weather" };
+  return cmds;
 }
 
-Message Weather::handleCommand(const std::string_view& command, const std::string_view& message,
-                             [[maybe_unused]] const std::string_view& userId,
-                             [[maybe_unused]] const std::string_view& roomId,
-                             [[maybe_unused]] const std::chrono::milliseconds& server_ts)
+std::future<Message> Weather::handleCommandAsync(Invocation inv, ThreadPool& pool)
 {
-  if (command != "weather")
+  if (inv.command != "weather")
   {
     // unknown command
-    return Message();
+    return readyAnswer(Message());
+  }
+
+  const std::vector<std::string> places = splitLocations(Arguments(inv.message, inv.command).rest());
+  if (places.empty())
+  {
+    return readyAnswer(Message(std::string("Please enter a location to get the weather for after the '").append(inv.command).append("' command.")));
+  }
+  if (places.size() > max_locations)
+  {
+    return readyAnswer(Message("Please enter at most " + std::to_string(max_locations)
+                       + " locations, separated by semicolons."));
+  }
+  if (places.size() > 1)
+  {
+    // Each location is handled by its own job, so the weather requests can
+    // be batched into a single request to Open-Meteo.
+    return pool.submit([places, &pool, this]()
+    {
+      std::vector<std::future<Message>> parts;
+      for (const auto& place: places)
+      {
+        parts.push_back(pool.submit([place, &pool, this]()
+        {
+          const auto location = findLocation(place, pool);
+          if (!location.has_value())
+          {
+            return notFoundMessage(place);
+          }
+          return weatherMessage(location.value(), forecasts.get(location.value(), pool));
+        }));
+      }
+      Message msg;
+      for (auto& part: parts)
+      {
+        const Message partMsg = pool.await(part);
+        if (!msg.body.empty())
+        {
+          msg.body.append("\n\n");
+          msg.formatted_body.append("<br />\n<br />\n");
+        }
+        msg.body.append(partMsg.body);
+        msg.formatted_body.append(partMsg.formatted_body.empty() ? htmlspecialchars(partMsg.body) : partMsg.formatted_body);
+      }
+      return msg;
+    });
+  }
+
+  std::string query = places[0];
+  const auto cached = locations.get(query);
+  if (cached.has_value() && !cached.value().has_value())
+  {
+    // Known to have no match, no need to ask again.
+    return readyAnswer(notFoundMessage(query));
   }
 
-  std::string query(message.substr(command.size()));
-  trim(query);
-  if (query.empty())
+  auto answer = std::make_shared<std::promise<Message>>();
+  std::future<Message> result = answer->get_future();
+  if (cached.has_value())
   {
-    return Message(std::string("Please enter a location to get the weather for after the '").append(command).append("' command."));
+    pool.submit([location = cached.value().value(), answer, &pool, this]()
+    {
+      answer->set_value(weatherMessage(location, forecasts.get(location, pool)));
+    });
+    return result;
+  }
+
+  // The location lookup and the weather request are queued as separate jobs,
+  // so no thread is blocked between the two requests.
+  pool.submit([query = std::move(query), answer, &pool, this]()
+  {
+    auto location = findLocation(query, pool);
+    if (!location.has_value())
+    {
+      answer->set_value(notFoundMessage(query));
+      return;
+    }
+    pool.submit([location = std::move(location.value()), answer, &pool, this]()
+    {
+      answer->set_value(weatherMessage(location, forecasts.get(location, pool)));
+    });
+  });
+  return result;
+}
+
+std::vector<std::string> Weather::splitLocations(const std::string_view& query)
+{
+  std::vector<std::string> places;
+  for (const auto& part: split(query, ';'))
+  {
+    const std::string_view place = trimmed(part);
+    if (!place.empty())
+    {
+      places.emplace_back(place);
+    }
+  }
+  return places;
+}
+
+nonstd::expected<Location, std::string> Weather::findLocation(const std::string& query, ThreadPool& pool)
+{
+  const auto cached = locations.get(query);
+  if (cached.has_value())
+  {
+    return cached.value();
+  }
+  nonstd::expected<Location, std::string> location = nonstd::make_unexpected(LocationLookup::not_found);
+  if ((offline != nullptr) && offlineFirst)
+  {
+    location = offline->find_location(query);
   }
-  const auto location = LocationLookup::find_location(query);
+  if (!location.has_value())
+  {
+    location = LocationLookup::find_location(query, pool);
+  }
+  if (!location.has_value() && (offline != nullptr) && !offlineFirst)
+  {
+    auto fallback = offline->find_location(query);
+    if (fallback.has_value())
+    {
+      location = std::move(fallback);
+    }
+  }
+  locations.put(query, location);
   if (!location.has_value())
   {
     std::cerr << "Location lookup for weather plugin failed!\n"
               << location.error() << "\n";
-    return Message("Could not find a geographical location named '" + query
+  }
+  return location;
+}
+
+Message Weather::notFoundMessage(const std::string& query)
+{
+  return Message("Could not find a geographical location named '" + query
                  + "'. The weather command expects the name of a city, e. g. "
                  + "Berlin for the city of Berlin in Germany, or something similar.");
-  }
-  const auto weather = OpenMeteo::get_weather(location.value());
+}
+
+Message Weather::weatherMessage(const Location& location, const ForecastCache::Result& weather)
+{
   if (!weather.has_value())
   {
     std::cerr << "Failed to get weather data!\n" << weather.error() << "\n";
-    return Message("Could get weather data for '" + location.value().name + "'.");
+    return Message("Could get weather data for '" + location.name + "'.");
   }
 
   // add current weather data
   const CurrentData& data = weather.value().current;
-  Message msg = Message("Weather for " + location.value().display_name + "\n"
+  Message msg = Message("Weather for " + location.display_name + "\n"
       + weather::wmo_code_to_icon(data.weather_code) + " "
       + weather::wmo_code_to_text(data.weather_code) + ", "
       + doubleToString(data.temperature_celsius) + " °C, feels like "
@@ -80,7 +223,7 @@ Message Weather::handleCommand(const std::string_view& command, const std::strin
       + "Pressure: " + doubleToString(data.pressure) + " hPa\n"
       + "Precipitation: " + doubleToString(data.precipitation) + " mm\n\n"
       + "Forecast:",
-      "<strong>Weather for " + location.value().display_name + "</strong><br />\n"
+      "<strong>Weather for " + location.display_name + "</strong><br />\n"
       + weather::wmo_code_to_icon(data.weather_code) + " "
       + weather::wmo_code_to_text(data.weather_code) + ", "
       + doubleToString(data.temperature_celsius) + " °C, feels like "
@@ -129,10 +272,14 @@ Message Weather::helpExtended(const std::string_view& command, const std::string
   {
     return Message("displays weather data for a given location. For example, `"s
         .append(prefix) + "weather Berlin` will show the current weather in "
-        + "Berlin, Germany, as well as a forecast for the next few days.",
+        + "Berlin, Germany, as well as a forecast for the next few days. "
+        + "Several locations can be separated by semicolons, e. g. `"
+        + std::string(prefix) + "weather Berlin; Paris; Rome`.",
         "displays weather data for a given location. For example, <code>"s
         .append(prefix) + "weather Berlin</code> will show the current weather"
-        + " in Berlin, Germany, as well as a forecast for the next few days.");
+        + " in Berlin, Germany, as well as a forecast for the next few days. "
+        + "Several locations can be separated by semicolons, e. g. <code>"
+        + std::string(prefix) + "weather Berlin; Paris; Rome</code>.");
   }
 
   return Message();
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,34 +21,53 @@
 #ifndef BVN_PLUGIN_WEATHER_HPP
 #define BVN_PLUGIN_WEATHER_HPP
 
-#include "../DeactivatablePlugin.hpp"
+#include "../AsyncPlugin.hpp"
+#include "ForecastBatcher.hpp"
+#include "ForecastCache.hpp"
+#include <memory>
+#include "GeocodeCache.hpp"
+#include "Location.hpp"
+#include "LocationLookupGeoNames.hpp"
 
 namespace bvn
 {
 
 /** \brief Gets weather data for a given location.
  */
-class Weather final: public DeactivatablePlugin
+class Weather final: public AsyncPlugin
 {
   public:
+    /** \brief Constructor.
+     *
+     * \param cacheFile  file name of the database that caches the results of
+     *                   location lookups; an empty file name means that the
+     *                   results are only cached in memory
+     * \param geoNamesFile  file name of a GeoNames dump for offline location
+     *                      lookups; an empty file name means no GeoNames dump
+     * \param geoNamesPrimary  whether the GeoNames dump is asked before the
+     *                         online services (true) or only after they failed
+     *                         (false)
+     */
+    explicit Weather(const std::string& cacheFile = GeocodeCache::defaultFileName(),
+                     const std::string& geoNamesFile = "",
+                     const bool geoNamesPrimary = false);
+
+
     /** \brief Gets a list of commands that are provided by this plugin.
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    std::vector<std::string> commands() const override;
+    const std::vector<std::string>& commands() const override;
 
 
-    /** \brief Reacts to a given command.
+    /** \brief Starts handling a command.
      *
-     * \param command   name of the command to handle
-     * \param message   complete text message that triggered the command
-     * \param userId    id of the user that sent the message
-     * \param roomId    id of the room that contains the message
-     * \param server_ts timestamp when the message reached the server
-     * \return Returns a message to send as reply to the command.
-     *         If the return value is empty, no message will be sent.
+     * \param inv   the command invocation
+     * \param pool  the thread pool to execute the jobs of the command with
+     * \return Returns a future that gets the message to send as reply to the
+     *         command. If the message is empty, no message will be sent.
      */
-    Message handleCommand(const std::string_view& command, const std::string_view& message, const std::string_view& userId, const std::string_view& roomId, const std::chrono::milliseconds& server_ts) override;
+    std::future<Message> handleCommandAsync(Invocation inv, ThreadPool& pool) override;
 
 
     /** \brief Gets a short, one line help text for a command
@@ -66,6 +85,50 @@ class Weather final: public DeactivatablePlugin
      * \return Returns a Message containing a longer help text for the command.
      */
     Message helpExtended(const std::string_view& command, const std::string_view& prefix) const override;
+
+
+    /** \brief Splits the query of a weather command into single locations.
+     *
+     * \param query  the query, e. g. "Berlin; Paris; Rome"
+     * \return Returns the names of the locations without surrounding
+     *         whitespace. Empty names are skipped.
+     */
+    static std::vector<std::string> splitLocations(const std::string_view& query);
+
+
+    /** \brief maximum number of locations in one weather command
+     */
+    static const std::size_t max_locations;
+  private:
+    /** \brief Finds a location by its name, using the cache if possible.
+     *
+     * \param query  name of the location
+     * \param pool   the thread pool that executes the lookup requests
+     * \return Returns the location in case of success.
+     *         Returns a string containing an error message in case of failure.
+     */
+    nonstd::expected<Location, std::string> findLocation(const std::string& query, ThreadPool& pool);
+
+    /** \brief Formats the weather data for a location.
+     *
+     * \param location  the location to get the weather for
+     * \param weather   the weather data for the location or an error message
+     * \return Returns a message containing the weather data for the location.
+     */
+    static Message weatherMessage(const Location& location, const ForecastCache::Result& weather);
+
+    /** \brief Gets the message for a location that could not be found.
+     *
+     * \param query  the name of the location
+     * \return Returns a message telling that the location was not found.
+     */
+    static Message notFoundMessage(const std::string& query);
+
+    GeocodeCache locations; /**< cache for results of location lookups */
+    std::unique_ptr<LocationLookupGeoNames> offline; /**< offline location lookup, may be nullptr */
+    bool offlineFirst; /**< whether the offline lookup is used first */
+    ForecastBatcher batcher; /**< groups weather requests for different locations */
+    ForecastCache forecasts; /**< cache for weather data */
 }; // class
 
 } // namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,34 +21,67 @@
 #include "Xkcd.hpp"
 #include <iostream>
 #include <random>
-#include "XkcdDb.hpp"
 #include "../../../net/htmlspecialchars.hpp"
-#include "../../../util/Strings.hpp"
+#include "../../../util/ActivityMeter.hpp"
+#include "../../../util/Arguments.hpp"
 
 namespace bvn
 {
 
-Xkcd::Xkcd(Matrix& mat)
-: mLatestNum(2924),
-  mLastUpdate(std::chrono::steady_clock::now() - std::chrono::hours(24)),
-  theMatrix(mat)
+Xkcd::Xkcd(Matrix& mat, const std::string& dbFileName, const unsigned int preUploadsPerHour)
+: theMatrix(mat),
+  mDb(dbFileName),
+  mDbReady(XkcdDb::prepareDatabase(mDb)),
+  mSearchReady(mDbReady && XkcdDb::prepareSearchIndex(mDb)),
+  mCrawler(mDb, [](const unsigned int num) { return XkcdData::get(num, false); }, XkcdCrawler::Settings()),
+  mUploads(),
+  mWarmer(mDb, [this](const XkcdData& data) { return uploadComic(data).has_value(); },
+          [](const std::chrono::milliseconds& quiet) { return ActivityMeter::commands().idle(quiet); },
+          XkcdWarmer::Settings{ preUploadsPerHour, std::chrono::seconds(30) })
 {
-  updateLatestNum();
+  if (!dbFileName.empty() && !mDbReady)
+  {
+    std::clog << "Warning: Failed to open or create database " << dbFileName
+              << ", comics will be uploaded every time." << std::endl;
+  }
 }
 
-void Xkcd::updateLatestNum()
+void Xkcd::start()
 {
-  const auto latest = XkcdData::get(0);
-  if (latest.has_value())
+  // The crawler also keeps track of the latest comic, even without database.
+  mCrawler.start();
+  if (mDbReady)
   {
-    mLatestNum = std::max(latest.value().num, mLatestNum);
-    mLastUpdate = std::chrono::steady_clock::now();
+    mWarmer.start();
   }
 }
 
-std::vector<std::string> Xkcd::commands() const
+unsigned int Xkcd::latestNum() const
 {
-  return { "xkcd" };
+  const unsigned int latest = mCrawler.latest();
+  // Use the latest comic at the time of writing until the crawler knows
+  // better.
+  return (latest != 0) ? latest : 2924;
+}
+
+std::optional<XkcdData> Xkcd::getComic(const unsigned int num)
+{
+  if (mDbReady)
+  {
+    auto data = XkcdDb::getComic(mDb, num);
+    if (data.has_value())
+    {
+      return data;
+    }
+  }
+  // The crawler has not reached this comic yet.
+  return XkcdData::get(num);
+}
+
+const std::vector<std::string>& Xkcd::commands() const
+{
+  static const std::vector<std::string> cmds = { "xkcd" };
+  return cmds;
 }
 
 unsigned int Xkcd::getRandomNumber(const unsigned int latest)
@@ -61,24 +94,10 @@ unsigned int Xkcd::getRandomNumber(const unsigned int latest)
 
 unsigned int Xkcd::determineComicId(const std::string_view& command, const std::string_view& message, const unsigned int latest)
 {
-  if (message.size() > command.size() + 1)
+  const auto value = Arguments::toNumber<unsigned int>(Arguments(message, command).rest());
+  if (value.has_value() && (value.value() > 0) && (value.value() <= latest))
   {
-    std::string number(message.substr(command.size()));
-    trim(number);
-    unsigned long value;
-    std::size_t pos = 0;
-    try
-    {
-      value = std::stoul(number, &pos);
-      if (pos == number.size() && value > 0 && value <= latest)
-      {
-         return value;
-      }
-    }
-    catch (const std::exception& ex)
-    {
-      // Nothing to do here.
-    }
+    return value.value();
   }
 
   return getRandomNumber(latest);
@@ -86,18 +105,26 @@ unsigned int Xkcd::determineComicId(const std::string_view& command, const std::
 
 std::optional<std::string> Xkcd::uploadComic(const XkcdData& data)
 {
-  auto db = XkcdDb::getDatabase();
+  // Without this, two rooms asking for the same comic at once would both
+  // upload it before either one could insert the URI into the database.
+  const auto mxcUri = mUploads.run(std::to_string(data.num),
+                                   [this, &data]() { return findOrUploadComic(data); });
+  return mxcUri.has_value() ? mxcUri.value() : std::optional<std::string>();
+}
+
+std::optional<std::string> Xkcd::findOrUploadComic(const XkcdData& data)
+{
   std::optional<std::string> mxcUri;
-  if (db.has_value())
+  if (mDbReady)
   {
-    mxcUri = XkcdDb::getMxcUri(db.value(), data.num);
+    mxcUri = XkcdDb::getMxcUri(mDb, data.num);
     if (!mxcUri.has_value())
     {
       // No existing media. Upload it and save it in DB.
       mxcUri = theMatrix.uploadImage(data.img);
       if (mxcUri.has_value())
       {
-        if (XkcdDb::insertMxcUri(db.value(), data.num, mxcUri.value()))
+        if (XkcdDb::insertMxcUri(mDb, data.num, mxcUri.value()))
         {
           std::clog << "Info: Inserted MXC URI for comic #" << data.num << " into database." << std::endl;
         }
@@ -128,17 +155,31 @@ Message Xkcd::handleCommand(const std::string_view& command, const std::string_v
     return Message();
   }
 
-  // Check for newer comic id, if it is older than 12 hours.
-  if (mLastUpdate + std::chrono::hours(12) < std::chrono::steady_clock::now())
+  unsigned int num = 0;
+  const std::string_view words = Arguments(message, command).rest();
+  if (words.empty() || Arguments::toNumber<unsigned int>(words).has_value())
   {
-    updateLatestNum();
+    // Get comic id from command or from (pseudo-)random number generator.
+    num = determineComicId(command, message, latestNum());
+  }
+  else
+  {
+    if (!mSearchReady)
+    {
+      return Message("Error: Search for comics is not available. Please use the number of the comic instead.",
+                     std::string("<strong>Error:</strong> Search for comics is not available. Please use the number of the comic instead."));
+    }
+    const auto found = XkcdDb::searchComic(mDb, words);
+    if (!found.has_value())
+    {
+      return Message("No comic matches '" + std::string(words) + "'.",
+                     "No comic matches <em>" + htmlspecialchars(words) + "</em>.");
+    }
+    num = found.value();
   }
 
-  // Get comic id from command or from (pseudo-)random number generator.
-  const unsigned int num = determineComicId(command, message, mLatestNum);
-
-  // XkcdData::get() only works when server can be reached.
-  const auto info = XkcdData::get(num);
+  // Comics that are not in the mirror yet need a request to xkcd.com.
+  const auto info = getComic(num);
   if (!info.has_value() || info.value().img.empty())
   {
     return Message("Error: Could not get comic from xkcd.com!",
@@ -186,7 +227,7 @@ std::string Xkcd::helpOneLine(const std::string_view& command) const
 {
   if (command == "xkcd")
   {
-    return "displays a random comic from xkcd.com";
+    return "displays a random comic from xkcd.com, or a comic matching some words";
   }
 
   return std::string();
@@ -200,10 +241,16 @@ Message Xkcd::helpExtended(const std::string_view& command, const std::string_vi
   {
     return Message("show a random comic from xkcd.com. If you want to get a "s
         + "particular comic, use its number after the command. For example, `"s
-        .append(prefix) + "xkcd 1` will show the very first comic of xkcd.",
+        .append(prefix) + "xkcd 1` will show the very first comic of xkcd. "
+        + "Words after the command show the comic whose title, alt text or "
+        + "transcript matches them best, e. g. `" + std::string(prefix)
+        + "xkcd compiling`.",
         "show a random comic from xkcd.com. If you want to get a "s
         + "particular comic, use its number after the command. For example, <code>"s
-        .append(prefix) + "xkcd 1</code> will show the very first comic of xkcd.");
+        .append(prefix) + "xkcd 1</code> will show the very first comic of xkcd. "
+        + "Words after the command show the comic whose title, alt text or "
+        + "transcript matches them best, e. g. <code>" + std::string(prefix)
+        + "xkcd compiling</code>.");
   }
 
   return Message();
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -24,7 +24,11 @@
 #include <chrono>
 #include "../DeactivatablePlugin.hpp"
 #include "../../../matrix/Matrix.hpp"
+#include "../../../util/SingleFlight.hpp"
+#include "XkcdCrawler.hpp"
 #include "XkcdData.hpp"
+#include "XkcdDb.hpp"
+#include "XkcdWarmer.hpp"
 
 namespace bvn
 {
@@ -36,16 +40,34 @@ class Xkcd final: public DeactivatablePlugin
   public:
     /** \brief Constructor.
      *
-     * \param mat  logged in matrix instance
+     * \param mat         logged in matrix instance
+     * \param dbFileName  file name of the database that stores the MXC URIs
+     *                    of uploaded comics and the mirror of the comic data;
+     *                    an empty file name means that comics are requested
+     *                    from xkcd.com and uploaded every time
+     * \param preUploadsPerHour  maximum number of comics that are uploaded
+     *                    per hour in idle times before anyone asks for them;
+     *                    zero means that comics are only uploaded on request
+     * \remarks Comics are neither mirrored nor uploaded in the background
+     *          before start() is called.
      */
-    Xkcd(Matrix& mat);
+    Xkcd(Matrix& mat, const std::string& dbFileName = XkcdDb::defaultFileName(), const unsigned int preUploadsPerHour = 0);
+
+
+    /** \brief Starts the background threads that mirror the comic data and
+     *         upload comics in idle times.
+     *
+     * \remarks Uploads in idle times are only started, if the database is
+     *          available. Does nothing, if the threads are already running.
+     */
+    void start();
 
 
     /** \brief Gets a list of commands that are provided by this plugin.
      *
      * \return Returns a vector of command names implemented by this plugin.
      */
-    std::vector<std::string> commands() const override;
+    const std::vector<std::string>& commands() const override;
 
 
     /** \brief Reacts to a given command.
@@ -98,16 +120,42 @@ class Xkcd final: public DeactivatablePlugin
      * \param data   data about the comic
      * \return Returns an optional containing the MXC URI, if successful.
      *         Returns an empty optional, if an error occurred.
+     * \remarks If the same comic is requested several times at once, only
+     *          one of the requests uploads it.
      */
     std::optional<std::string> uploadComic(const XkcdData& data);
 
-    /** \brief Updates the last known comic id to the latest available id.
+    /** \brief Gets the MXC URI of the comic image from the database, or
+     *         uploads the image and stores its URI, if it is not there yet.
+     *
+     * \param data   data about the comic
+     * \return Returns an optional containing the MXC URI, if successful.
+     *         Returns an empty optional, if an error occurred.
+     */
+    std::optional<std::string> findOrUploadComic(const XkcdData& data);
+
+    /** \brief Gets the data of a comic from the mirror, or from xkcd.com
+     *         if it is not in the mirror yet.
+     *
+     * \param num   number of the comic
+     * \return Returns data about the comic in case of success.
+     *         Returns empty optional, if data retrieval failed.
+     */
+    std::optional<XkcdData> getComic(const unsigned int num);
+
+    /** \brief Gets the number of the latest comic.
+     *
+     * \return Returns the number of the latest known comic.
      */
-    void updateLatestNum();
+    unsigned int latestNum() const;
 
-    unsigned int mLatestNum; /**< latest known comic number */
-    std::chrono::steady_clock::time_point mLastUpdate; /**< time of last update of mLatestNum */
     Matrix& theMatrix; /**< reference to the Matrix instance */
+    sql::Connection mDb; /**< database of uploaded comics and comic data */
+    bool mDbReady; /**< whether mDb can be used */
+    bool mSearchReady; /**< whether the search index in mDb can be used */
+    XkcdCrawler mCrawler; /**< keeps the mirror of comic data up to date */
+    SingleFlight<std::optional<std::string>> mUploads; /**< running uploads by comic number */
+    XkcdWarmer mWarmer; /**< uploads comics in idle times */
 }; // class
 
 } // namespace
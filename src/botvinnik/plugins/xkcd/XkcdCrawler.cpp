@@ -0,0 +1,149 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "XkcdCrawler.hpp"
+#include <iostream>
+#include "XkcdDb.hpp"
+
+namespace bvn
+{
+
+// A few failures in a row usually mean that xkcd.com cannot be reached, but
+// single missing comics (like #404) must not stop the crawl.
+const unsigned int XkcdCrawler::max_failures = 3;
+
+XkcdCrawler::XkcdCrawler(sql::Connection& db, Fetcher fetch, const Settings& crawlSettings)
+: mDb(db),
+  fetcher(std::move(fetch)),
+  settings(crawlSettings),
+  mLatest(db.isOpen() ? XkcdDb::latestComic(db) : 0),
+  shutdown(),
+  stopping(false),
+  mutex(),
+  wakeUp(),
+  worker()
+{
+}
+
+XkcdCrawler::~XkcdCrawler()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  shutdown.cancel();
+  wakeUp.notify_one();
+  if (worker.joinable())
+  {
+    worker.join();
+  }
+}
+
+void XkcdCrawler::start()
+{
+  if (!fetcher || worker.joinable())
+  {
+    return;
+  }
+  worker = std::thread(&XkcdCrawler::crawlLoop, this);
+}
+
+unsigned int XkcdCrawler::latest() const
+{
+  return mLatest.load();
+}
+
+bool XkcdCrawler::pause()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  return !wakeUp.wait_for(lock, settings.delay, [this]() { return stopping; });
+}
+
+std::size_t XkcdCrawler::crawl()
+{
+  // Requests are aborted, when the crawler is destroyed.
+  Deadline::Scope scope(shutdown);
+
+  const auto newest = fetcher(0);
+  if (!newest.has_value())
+  {
+    return 0;
+  }
+  const XkcdData& data = newest.value();
+  if (data.num > mLatest.load())
+  {
+    mLatest.store(data.num);
+  }
+  if (!mDb.isOpen())
+  {
+    return 0;
+  }
+  const bool isNew = XkcdDb::latestComic(mDb) < data.num;
+  if (!XkcdDb::insertComic(mDb, data))
+  {
+    return 0;
+  }
+
+  std::size_t added = isNew ? 1 : 0;
+  unsigned int failures = 0;
+  for (const unsigned int num: XkcdDb::missingComics(mDb, data.num))
+  {
+    if (!pause())
+    {
+      break;
+    }
+    const auto comic = fetcher(num);
+    if (!comic.has_value() || (comic.value().num != num))
+    {
+      ++failures;
+      if (failures >= max_failures)
+      {
+        std::clog << "Warning: Stopping the update of the xkcd mirror after "
+                  << failures << " failed requests in a row." << std::endl;
+        break;
+      }
+      continue;
+    }
+    failures = 0;
+    if (XkcdDb::insertComic(mDb, comic.value()))
+    {
+      ++added;
+    }
+  }
+  return added;
+}
+
+void XkcdCrawler::crawlLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping)
+  {
+    lock.unlock();
+    const std::size_t added = crawl();
+    if (added > 0)
+    {
+      std::clog << "Info: Added " << added << " comics to the xkcd mirror." << std::endl;
+    }
+    lock.lock();
+    wakeUp.wait_for(lock, settings.interval, [this]() { return stopping; });
+  }
+}
+
+} // namespace
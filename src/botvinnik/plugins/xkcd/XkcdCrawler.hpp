@@ -0,0 +1,134 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_PLUGIN_XKCDCRAWLER_HPP
+#define BVN_PLUGIN_XKCDCRAWLER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "../../../util/Deadline.hpp"
+#include "../../../util/sqlite3.hpp"
+#include "XkcdData.hpp"
+
+namespace bvn
+{
+
+/** \brief Keeps a local mirror of the metadata of all xkcd comics.
+ *
+ * A background thread checks for new comics in regular intervals and adds
+ * every comic that is not in the mirror yet, one request at a time.
+ */
+class XkcdCrawler
+{
+  public:
+    /** \brief settings of the crawler
+     */
+    struct Settings
+    {
+      std::chrono::milliseconds delay = std::chrono::milliseconds(1000); /**< pause between two requests */
+      std::chrono::minutes interval = std::chrono::minutes(60); /**< time between two checks for new comics */
+    }; // struct
+
+
+    /** \brief function that gets the data of a comic, or of the latest comic
+     *         for zero
+     */
+    using Fetcher = std::function<std::optional<XkcdData>(const unsigned int num)>;
+
+
+    /** \brief Constructor.
+     *
+     * \param db        database connection of the mirror; it may be closed,
+     *                  then only the number of the latest comic is tracked
+     * \param fetch     function that gets the data of a comic
+     * \param settings  settings of the crawler
+     * \remarks The background thread is not started before start() is called.
+     */
+    XkcdCrawler(sql::Connection& db, Fetcher fetch, const Settings& settings);
+
+
+    XkcdCrawler(const XkcdCrawler& other) = delete;
+    XkcdCrawler& operator=(const XkcdCrawler& other) = delete;
+
+
+    /** \brief Destructor. Stops the background thread.
+     */
+    ~XkcdCrawler();
+
+
+    /** \brief Starts the background thread.
+     *
+     * \remarks Does nothing, if the thread is already running.
+     */
+    void start();
+
+
+    /** \brief Checks for new comics and adds all missing comics to the mirror.
+     *
+     * \return Returns the number of comics that were added to the mirror.
+     * \remarks This is called by the background thread, but it can also be
+     *          called directly. It stops early after several failed requests
+     *          in a row, the next call continues where it stopped.
+     */
+    std::size_t crawl();
+
+
+    /** \brief Gets the number of the latest known comic.
+     *
+     * \return Returns the number of the latest known comic.
+     *         Returns zero, if no comic is known yet.
+     */
+    unsigned int latest() const;
+
+
+    /** \brief number of failed requests in a row after which crawl() gives up
+     */
+    static const unsigned int max_failures;
+  private:
+    /** \brief Waits for the pause between two requests.
+     *
+     * \return Returns true, if the crawler may continue.
+     *         Returns false, if it shall stop.
+     */
+    bool pause();
+
+    /** \brief Loop of the background thread.
+     */
+    void crawlLoop();
+
+    sql::Connection& mDb; /**< database of the mirror */
+    Fetcher fetcher; /**< gets comic data */
+    Settings settings; /**< settings of the crawler */
+    std::atomic<unsigned int> mLatest; /**< number of the latest known comic */
+    Deadline shutdown; /**< cancelled when the crawler stops, aborts running requests */
+    bool stopping; /**< whether the background thread shall stop */
+    std::mutex mutex; /**< protects stopping */
+    std::condition_variable wakeUp; /**< signals the background thread */
+    std::thread worker; /**< background thread */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_XKCDCRAWLER_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021  Dirk Stolle
+    Copyright (C) 2020, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,7 +21,10 @@
 #include "XkcdData.hpp"
 #include <iostream>
 #include "../../../../third-party/simdjson/simdjson.h"
+#include "../../../net/CircuitBreaker.hpp"
 #include "../../../net/Curly.hpp"
+#include "../../../net/HttpCache.hpp"
+#include "../../../util/JsonBinding.hpp"
 
 namespace bvn
 {
@@ -35,11 +38,27 @@ XkcdData::XkcdData()
 {
 }
 
-std::optional<XkcdData> XkcdData::get(unsigned int num)
+XkcdData::XkcdData(const unsigned int number, const std::string& safeTitle, const std::string& imageUrl,
+                   const std::string& transcribed, const std::string& altText)
+: num(number),
+  title(safeTitle),
+  img(imageUrl),
+  transcript(transcribed),
+  alt(altText)
+{
+}
+
+std::optional<XkcdData> XkcdData::get(unsigned int num, const bool useCache)
 {
   std::string response;
   {
     Curly curl;
+    curl.setCircuitBreaker(&CircuitBreaker::upstreams());
+    if (useCache)
+    {
+      curl.setHttpCache(&HttpCache::upstreams());
+    }
+    curl.coalesceRequests(true);
     if (num != 0)
     {
       curl.setURL("https://xkcd.com/" + std::to_string(num) + "/info.0.json");
@@ -64,54 +83,39 @@ std::optional<XkcdData> XkcdData::get(unsigned int num)
     return std::optional<XkcdData>();
   }
 
-  XkcdData data;
-
-  simdjson::dom::element value;
-  auto error = doc["num"].get(value);
-  if (error || value.type() != simdjson::dom::element_type::INT64)
+  simdjson::dom::object object;
+  if (doc.get(object))
   {
-    std::cerr << "Error while trying to parse JSON response from xkcd.com! JSON data does not contain a 'num' member!\n";
+    std::cerr << "Error while trying to parse JSON response from xkcd.com! Root element is not an object!\n";
     return std::optional<XkcdData>();
   }
-  data.num = value.get<int64_t>();
 
-  doc["safe_title"].tie(value, error);
-  if (!error && value.type() == simdjson::dom::element_type::STRING)
+  static constexpr auto schema = std::make_tuple(
+      json::field("num", &XkcdData::num),
+      json::optional_field("safe_title", &XkcdData::title),
+      json::field("img", &XkcdData::img),
+      json::field("alt", &XkcdData::alt),
+      json::optional_field("transcript", &XkcdData::transcript));
+
+  XkcdData data;
+  const auto error = json::decode(object, schema, data);
+  if (error.has_value())
   {
-    data.title = value.get<std::string_view>().value();
+    std::cerr << "Error while trying to parse JSON response from xkcd.com! "
+              << error.value().message() << "\n";
+    return std::optional<XkcdData>();
   }
+
   // Fall back to "normal" title, if there is no safe_title element.
   if (data.title.empty())
   {
-    doc["title"].tie(value, error);
-    if (error || value.type() != simdjson::dom::element_type::STRING)
+    std::string_view title;
+    if (object["title"].get(title))
     {
       std::cerr << "Error while trying to parse JSON response from xkcd.com! JSON data does not contain a title!\n";
       return std::optional<XkcdData>();
     }
-    data.title = value.get<std::string_view>().value();
-  }
-
-  doc["img"].tie(value, error);
-  if (error || value.type() != simdjson::dom::element_type::STRING)
-  {
-    std::cerr << "Error while trying to parse JSON response from xkcd.com! JSON data does not contain a image URL!\n";
-    return std::optional<XkcdData>();
-  }
-  data.img = value.get<std::string_view>().value();
-
-  doc["alt"].tie(value, error);
-  if (error || value.type() != simdjson::dom::element_type::STRING)
-  {
-    std::cerr << "Error while trying to parse JSON response from xkcd.com! JSON data does not contain an alternative text!\n";
-    return std::optional<XkcdData>();
-  }
-  data.alt = value.get<std::string_view>().value();
-
-  doc["transcript"].tie(value, error);
-  if (!error && value.type() == simdjson::dom::element_type::STRING)
-  {
-    data.transcript = value.get<std::string_view>().value();
+    data.title = title;
   }
 
   return std::optional<XkcdData>(data);
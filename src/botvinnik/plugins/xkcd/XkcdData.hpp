@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021  Dirk Stolle
+    Copyright (C) 2020, 2021, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -36,13 +36,27 @@ struct XkcdData
     XkcdData();
 
   public:
+    /** \brief Constructor with initial values for all members.
+     *
+     * \param number      number of the comic
+     * \param safeTitle   comic title
+     * \param imageUrl    URL for the image
+     * \param transcribed transcribed text of comic, may be empty
+     * \param altText     alt text of image
+     */
+    XkcdData(const unsigned int number, const std::string& safeTitle, const std::string& imageUrl,
+             const std::string& transcribed, const std::string& altText);
+
+
     /** \brief Gets data for a given comic.
      *
-     * \param num   number of the comic
+     * \param num        number of the comic, or zero for the latest comic
+     * \param useCache   whether the HTTP cache for upstream requests may be
+     *                   used for the request
      * \return Returns data about the comic in case of success.
      *         Returns empty optional, if data retrieval failed.
      */
-    static std::optional<XkcdData> get(unsigned int num);
+    static std::optional<XkcdData> get(unsigned int num, const bool useCache = true);
 
     unsigned int num;  /**< number of comic */
     std::string title; /**< comic title */
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022  Dirk Stolle
+    Copyright (C) 2020, 2022, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,62 +19,41 @@
 */
 
 #include "XkcdDb.hpp"
-#include <filesystem>
 #include <iostream>
 #include "../../../util/Directories.hpp"
 
 namespace bvn::XkcdDb
 {
 
-std::optional<sql::database> getDatabase()
+std::string defaultFileName()
 {
-  std::string home;
-  std::string dbFileName = "/tmp/xkcd.db";
-  if (filesystem::getHome(home))
-  {
-    const auto delim = filesystem::pathDelimiter;
-    const std::string directory = home + delim + ".bvn";
-    dbFileName = directory + delim + std::string("xkcd.db");
-    try
-    {
-      // Attempt to create directory and set permissions.
-      std::filesystem::create_directories(directory);
-      std::filesystem::permissions(directory,
-          std::filesystem::perms::owner_all |
-          std::filesystem::perms::group_read |
-          std::filesystem::perms::others_read);
-    }
-    catch (const std::exception& ex)
-    {
-      std::cerr << "Error: Could not create directory " << directory
-                << " and set permissions for it!\nException message: "
-                << ex.what() << std::endl;
-    }
-  }
-  const bool needsCreate = !std::filesystem::exists(dbFileName);
-  auto db = sql::open(dbFileName);
-  if (!db)
-  {
-    std::clog << "Warning: Failed to open or create database " << dbFileName << std::endl;
-    return std::optional<sql::database>();
-  }
-  if (!needsCreate || createDbStructure(db))
-  {
-    return db;
-  }
-  else
+  return filesystem::getDataFileName("xkcd.db");
+}
+
+bool prepareDatabase(sql::Connection& db)
+{
+  if (!db.isOpen())
   {
-    return std::optional<sql::database>();
+    return false;
   }
+  auto handle = db.lock();
+  return createDbStructure(handle.db());
 }
 
 bool createDbStructure(sql::database& db)
 {
   const std::string statement = R"SQL(
-        CREATE TABLE xkcd (
+        CREATE TABLE IF NOT EXISTS xkcd (
           comicId INTEGER PRIMARY KEY NOT NULL,
           mxcUri TEXT NOT NULL
         );
+        CREATE TABLE IF NOT EXISTS comics (
+          comicId INTEGER PRIMARY KEY NOT NULL,
+          title TEXT NOT NULL,
+          img TEXT NOT NULL,
+          alt TEXT NOT NULL,
+          transcript TEXT NOT NULL
+        );
         )SQL";
   if (!sql::exec(db, statement))
   {
@@ -85,9 +64,10 @@ bool createDbStructure(sql::database& db)
   return true;
 }
 
-std::optional<std::string> getMxcUri(sql::database& db, const unsigned int num)
+std::optional<std::string> getMxcUri(sql::Connection& db, const unsigned int num)
 {
-  sql::statement stmt = sql::prepare(db, "SELECT mxcUri FROM xkcd WHERE comicId=@id LIMIT 1;");
+  auto handle = db.lock();
+  sql::statement& stmt = handle.prepared("SELECT mxcUri FROM xkcd WHERE comicId=@id LIMIT 1;");
   if (!stmt)
   {
     std::cerr << "Error: Failed to prepare select statement for comic id!\n";
@@ -110,13 +90,14 @@ std::optional<std::string> getMxcUri(sql::database& db, const unsigned int num)
   }
   // Some other unexpected error code occurred!
   std::cerr << "Error: Could not get result from xkcd database!\n"
-            << sqlite3_errmsg(db.get()) << std::endl;
+            << sqlite3_errmsg(handle.db().get()) << std::endl;
   return std::optional<std::string>();
 }
 
-bool insertMxcUri(sql::database& db, const unsigned int num, const std::string& mxcUri)
+bool insertMxcUri(sql::Connection& db, const unsigned int num, const std::string& mxcUri)
 {
-  auto insert = sql::prepare(db, "INSERT INTO xkcd (comicId, mxcUri) VALUES (@cid, @uri);");
+  auto handle = db.lock();
+  sql::statement& insert = handle.prepared("INSERT INTO xkcd (comicId, mxcUri) VALUES (@cid, @uri);");
   if (!insert)
   {
     std::cerr << "Error: Could not prepare insert statement for MXC URI!\n";
@@ -138,4 +119,296 @@ bool insertMxcUri(sql::database& db, const unsigned int num, const std::string&
   return true;
 }
 
+bool prepareSearchIndex(sql::Connection& db)
+{
+  if (!db.isOpen())
+  {
+    return false;
+  }
+  auto handle = db.lock();
+  sql::statement& exists = handle.prepared("SELECT COUNT(*) FROM sqlite_master WHERE name='comics_fts';");
+  if (!exists || (sqlite3_step(exists.get()) != SQLITE_ROW))
+  {
+    std::cerr << "Error: Could not check for search index of xkcd comics!" << std::endl;
+    return false;
+  }
+  const bool created = sqlite3_column_int64(exists.get(), 0) != 0;
+
+  // The index uses the comics table as external content, so the text is not
+  // stored twice. Triggers keep it in sync with the table.
+  const std::string statement = R"SQL(
+        CREATE VIRTUAL TABLE IF NOT EXISTS comics_fts USING fts5(
+          title, alt, transcript,
+          content='comics', content_rowid='comicId'
+        );
+        CREATE TRIGGER IF NOT EXISTS comics_fts_insert AFTER INSERT ON comics BEGIN
+          INSERT INTO comics_fts (rowid, title, alt, transcript)
+            VALUES (new.comicId, new.title, new.alt, new.transcript);
+        END;
+        CREATE TRIGGER IF NOT EXISTS comics_fts_delete AFTER DELETE ON comics BEGIN
+          INSERT INTO comics_fts (comics_fts, rowid, title, alt, transcript)
+            VALUES ('delete', old.comicId, old.title, old.alt, old.transcript);
+        END;
+        CREATE TRIGGER IF NOT EXISTS comics_fts_update AFTER UPDATE ON comics BEGIN
+          INSERT INTO comics_fts (comics_fts, rowid, title, alt, transcript)
+            VALUES ('delete', old.comicId, old.title, old.alt, old.transcript);
+          INSERT INTO comics_fts (rowid, title, alt, transcript)
+            VALUES (new.comicId, new.title, new.alt, new.transcript);
+        END;
+        )SQL";
+  if (!sql::exec(handle.db(), statement))
+  {
+    std::cerr << "Error: Could not create search index for xkcd comics! "
+              << "Maybe SQLite was built without FTS5." << std::endl;
+    return false;
+  }
+  // Comics that were stored before the index existed need to be indexed.
+  if (!created && !sql::exec(handle.db(), "INSERT INTO comics_fts (comics_fts) VALUES ('rebuild');"))
+  {
+    std::cerr << "Error: Could not build search index for xkcd comics!" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/** \brief Gets a text column of the current result row.
+ *
+ * \param stmt   statement with a result row
+ * \param index  index of the column (first column has index 0)
+ * \return Returns the text of the column. NULL values become empty strings.
+ */
+std::string columnText(sql::statement& stmt, const int index)
+{
+  const unsigned char* text = sqlite3_column_text(stmt.get(), index);
+  return (text == nullptr) ? std::string() : std::string(reinterpret_cast<const char*>(text));
+}
+
+std::optional<XkcdData> getComic(sql::Connection& db, const unsigned int num)
+{
+  auto handle = db.lock();
+  sql::statement& stmt = handle.prepared("SELECT title, img, alt, transcript FROM comics WHERE comicId=@id LIMIT 1;");
+  if (!stmt)
+  {
+    std::cerr << "Error: Failed to prepare select statement for comic data!\n";
+    return std::nullopt;
+  }
+  if (!sql::bind(stmt, 1, num))
+  {
+    std::cerr << "Error: Could not bind value of comic Id to prepared statement!\n";
+    return std::nullopt;
+  }
+  const auto rc = sqlite3_step(stmt.get());
+  if (rc == SQLITE_ROW)
+  {
+    return XkcdData(num, columnText(stmt, 0), columnText(stmt, 1),
+                    columnText(stmt, 3), columnText(stmt, 2));
+  }
+  if (rc != SQLITE_DONE)
+  {
+    std::cerr << "Error: Could not get comic data from xkcd database!\n"
+              << sqlite3_errmsg(handle.db().get()) << std::endl;
+  }
+  return std::nullopt;
+}
+
+bool insertComic(sql::Connection& db, const XkcdData& data)
+{
+  auto handle = db.lock();
+  // The latest comic may still get a transcript later, so existing data is
+  // updated. INSERT OR REPLACE would not fire the delete trigger of the
+  // search index, so an upsert is used instead.
+  sql::statement& insert = handle.prepared(
+      "INSERT INTO comics (comicId, title, img, alt, transcript) VALUES (@cid, @title, @img, @alt, @transcript) "
+      "ON CONFLICT (comicId) DO UPDATE SET title=excluded.title, img=excluded.img, alt=excluded.alt, transcript=excluded.transcript;");
+  if (!insert)
+  {
+    std::cerr << "Error: Could not prepare insert statement for comic data!\n";
+    return false;
+  }
+  if (!sql::bind(insert, 1, data.num) || !sql::bind(insert, 2, data.title)
+      || !sql::bind(insert, 3, data.img) || !sql::bind(insert, 4, data.alt)
+      || !sql::bind(insert, 5, data.transcript))
+  {
+    std::cerr << "Error: Could not bind values to prepared statement!\n";
+    return false;
+  }
+  const auto ret = sqlite3_step(insert.get());
+  if ((ret != SQLITE_OK) && (ret != SQLITE_DONE))
+  {
+    std::cerr << "Error: Could not insert data for comic #" << data.num
+              << " into database!\n";
+    return false;
+  }
+
+  return true;
+}
+
+unsigned int latestComic(sql::Connection& db)
+{
+  auto handle = db.lock();
+  sql::statement& stmt = handle.prepared("SELECT MAX(comicId) FROM comics;");
+  if (!stmt)
+  {
+    std::cerr << "Error: Failed to prepare select statement for latest comic!\n";
+    return 0;
+  }
+  if (sqlite3_step(stmt.get()) != SQLITE_ROW)
+  {
+    std::cerr << "Error: Could not get latest comic from xkcd database!\n"
+              << sqlite3_errmsg(handle.db().get()) << std::endl;
+    return 0;
+  }
+  // MAX() of an empty table is NULL, which becomes zero.
+  return static_cast<unsigned int>(sqlite3_column_int64(stmt.get(), 0));
+}
+
+std::vector<unsigned int> missingComics(sql::Connection& db, const unsigned int latest)
+{
+  auto handle = db.lock();
+  sql::statement& stmt = handle.prepared("SELECT comicId FROM comics WHERE comicId<=@latest ORDER BY comicId DESC;");
+  if (!stmt)
+  {
+    std::cerr << "Error: Failed to prepare select statement for known comics!\n";
+    return {};
+  }
+  if (!sql::bind(stmt, 1, latest))
+  {
+    std::cerr << "Error: Could not bind value of comic Id to prepared statement!\n";
+    return {};
+  }
+  std::vector<unsigned int> missing;
+  unsigned int next = latest;
+  int rc = sqlite3_step(stmt.get());
+  while (rc == SQLITE_ROW)
+  {
+    const auto known = static_cast<unsigned int>(sqlite3_column_int64(stmt.get(), 0));
+    for (; next > known; --next)
+    {
+      missing.push_back(next);
+    }
+    // Skip the known comic.
+    if (next == known)
+    {
+      --next;
+    }
+    rc = sqlite3_step(stmt.get());
+  }
+  if (rc != SQLITE_DONE)
+  {
+    std::cerr << "Error: Could not get known comics from xkcd database!\n"
+              << sqlite3_errmsg(handle.db().get()) << std::endl;
+    return {};
+  }
+  for (; next > 0; --next)
+  {
+    missing.push_back(next);
+  }
+  return missing;
+}
+
+std::optional<XkcdData> comicWithoutUpload(sql::Connection& db, const unsigned int below)
+{
+  auto handle = db.lock();
+  sql::statement& stmt = handle.prepared(
+      "SELECT comics.comicId, title, img, alt, transcript FROM comics "
+      "LEFT JOIN xkcd ON comics.comicId = xkcd.comicId "
+      "WHERE xkcd.comicId IS NULL AND comics.comicId < @below ORDER BY comics.comicId DESC LIMIT 1;");
+  if (!stmt)
+  {
+    std::cerr << "Error: Failed to prepare select statement for comics without upload!\n";
+    return std::nullopt;
+  }
+  if (!sql::bind(stmt, 1, below))
+  {
+    std::cerr << "Error: Could not bind value of comic Id to prepared statement!\n";
+    return std::nullopt;
+  }
+  const auto rc = sqlite3_step(stmt.get());
+  if (rc == SQLITE_ROW)
+  {
+    return XkcdData(static_cast<unsigned int>(sqlite3_column_int64(stmt.get(), 0)),
+                    columnText(stmt, 1), columnText(stmt, 2),
+                    columnText(stmt, 4), columnText(stmt, 3));
+  }
+  if (rc != SQLITE_DONE)
+  {
+    std::cerr << "Error: Could not get comics without upload from xkcd database!\n"
+              << sqlite3_errmsg(handle.db().get()) << std::endl;
+  }
+  return std::nullopt;
+}
+
+std::string matchExpression(const std::string_view& words)
+{
+  std::string expression;
+  std::string_view::size_type pos = 0;
+  while (pos < words.size())
+  {
+    const auto start = words.find_first_not_of(" \t\r\n", pos);
+    if (start == std::string_view::npos)
+    {
+      break;
+    }
+    auto end = words.find_first_of(" \t\r\n", start);
+    if (end == std::string_view::npos)
+    {
+      end = words.size();
+    }
+    if (!expression.empty())
+    {
+      expression.append(" OR ");
+    }
+    expression.push_back('"');
+    for (const char c: words.substr(start, end - start))
+    {
+      // Double quotes inside a string are escaped by doubling them.
+      if (c == '"')
+      {
+        expression.push_back('"');
+      }
+      expression.push_back(c);
+    }
+    expression.push_back('"');
+    pos = end;
+  }
+  return expression;
+}
+
+std::optional<unsigned int> searchComic(sql::Connection& db, const std::string_view& words)
+{
+  const std::string expression = matchExpression(words);
+  if (expression.empty())
+  {
+    return std::nullopt;
+  }
+  auto handle = db.lock();
+  // Lower values of bm25() are better matches. The weights are given in the
+  // order of the columns: title, alt, transcript.
+  sql::statement& stmt = handle.prepared(
+      "SELECT rowid FROM comics_fts WHERE comics_fts MATCH @query "
+      "ORDER BY bm25(comics_fts, 10.0, 3.0, 1.0), rowid DESC LIMIT 1;");
+  if (!stmt)
+  {
+    std::cerr << "Error: Failed to prepare search statement for xkcd comics!\n";
+    return std::nullopt;
+  }
+  if (!sql::bind(stmt, 1, expression))
+  {
+    std::cerr << "Error: Could not bind search query to prepared statement!\n";
+    return std::nullopt;
+  }
+  const auto rc = sqlite3_step(stmt.get());
+  if (rc == SQLITE_ROW)
+  {
+    return static_cast<unsigned int>(sqlite3_column_int64(stmt.get(), 0));
+  }
+  if (rc != SQLITE_DONE)
+  {
+    std::cerr << "Error: Could not search for xkcd comics!\n"
+              << sqlite3_errmsg(handle.db().get()) << std::endl;
+  }
+  return std::nullopt;
+}
+
 } // namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020  Dirk Stolle
+    Copyright (C) 2020, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,28 +23,54 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "../../../util/sqlite3.hpp"
+#include "XkcdData.hpp"
 
 namespace bvn::XkcdDb
 {
 
-/** \brief Gets the database containing the comic information.
+/** \brief Gets the default file name of the database containing the comic
+ *         information.
  *
- * \return Returns an optional containing the database.
- *         Returns an empty optional, if database does not exist and cannot be created.
+ * \return Returns the default file name of the database.
  */
-std::optional<sql::database> getDatabase();
+std::string defaultFileName();
+
+
+/** \brief Prepares an open database connection for use, i. e. creates the
+ *         database structure, if it does not exist yet.
+ *
+ * \param db   database connection
+ * \return Returns true, if the database is ready for use.
+ *         Returns false, if the connection is not open or an error occurred.
+ */
+bool prepareDatabase(sql::Connection& db);
 
 
 /** \brief Creates the database structure required to store information.
  *
  * \param db   open database connection
- * \return Returns true, if structure was created.
+ * \return Returns true, if structure was created or already existed.
  *         Returns false, if an error occurred.
  */
 bool createDbStructure(sql::database& db);
 
 
+/** \brief Prepares the full-text search index for the comic data, i. e.
+ *         creates it, if it does not exist yet.
+ *
+ * \param db   database connection that was prepared with prepareDatabase()
+ * \return Returns true, if the search index is ready for use.
+ *         Returns false, if the connection is not open, SQLite has no FTS5
+ *         support or another error occurred.
+ * \remarks The index is kept up to date by triggers, so that later changes
+ *          to the comic data are indexed automatically.
+ */
+bool prepareSearchIndex(sql::Connection& db);
+
+
 /** \brief  Gets the Matrix Content URI of a comic from the database.
  *
  * \param db   open database connection
@@ -53,7 +79,7 @@ bool createDbStructure(sql::database& db);
  *         Returns an empty optional, if the comic is not in the database
  *         or an error occurred.
  */
-std::optional<std::string> getMxcUri(sql::database& db, const unsigned int num);
+std::optional<std::string> getMxcUri(sql::Connection& db, const unsigned int num);
 
 
 /** \brief  Inserts the Matrix Content URI of a comic into the database.
@@ -64,7 +90,83 @@ std::optional<std::string> getMxcUri(sql::database& db, const unsigned int num);
  * \return Returns true, if insertion was successful.
  *         Returns false, if an error occurred.
  */
-bool insertMxcUri(sql::database& db, const unsigned int num, const std::string& mxcUri);
+bool insertMxcUri(sql::Connection& db, const unsigned int num, const std::string& mxcUri);
+
+
+/** \brief Gets the metadata of a comic from the local mirror.
+ *
+ * \param db   open database connection
+ * \param num  number of the comic
+ * \return Returns an optional containing the comic data, if it was found.
+ *         Returns an empty optional, if the comic is not in the mirror or
+ *         an error occurred.
+ */
+std::optional<XkcdData> getComic(sql::Connection& db, const unsigned int num);
+
+
+/** \brief Inserts or replaces the metadata of a comic in the local mirror.
+ *
+ * \param db    open database connection
+ * \param data  data about the comic
+ * \return Returns true, if the data was stored successfully.
+ *         Returns false, if an error occurred.
+ */
+bool insertComic(sql::Connection& db, const XkcdData& data);
+
+
+/** \brief Gets the number of the latest comic in the local mirror.
+ *
+ * \param db   open database connection
+ * \return Returns the highest comic number in the mirror.
+ *         Returns zero, if the mirror is empty or an error occurred.
+ */
+unsigned int latestComic(sql::Connection& db);
+
+
+/** \brief Gets the numbers of the comics that are not in the local mirror.
+ *
+ * \param db      open database connection
+ * \param latest  number of the latest published comic
+ * \return Returns the numbers from 1 to latest that are not in the mirror,
+ *         newest comic first. Returns an empty vector, if an error occurred.
+ */
+std::vector<unsigned int> missingComics(sql::Connection& db, const unsigned int latest);
+
+
+/** \brief Gets a comic from the local mirror whose image has not been
+ *         uploaded yet, i. e. that has no Matrix Content URI.
+ *
+ * \param db     open database connection
+ * \param below  only comics with a lower number than this are considered
+ * \return Returns an optional containing the newest such comic.
+ *         Returns an empty optional, if all of these comics have been
+ *         uploaded or an error occurred.
+ */
+std::optional<XkcdData> comicWithoutUpload(sql::Connection& db, const unsigned int below);
+
+
+/** \brief Builds an FTS5 query expression from words entered by a user.
+ *
+ * \param words   the words to search for, separated by whitespace
+ * \return Returns an expression that matches any of the words. Each word is
+ *         quoted, so that characters with special meaning in FTS5 queries
+ *         are searched literally. Returns an empty string, if there are no
+ *         words.
+ */
+std::string matchExpression(const std::string_view& words);
+
+
+/** \brief Finds the comic that matches the given words best.
+ *
+ * \param db      open database connection with prepared search index
+ * \param words   the words to search for, separated by whitespace
+ * \return Returns an optional containing the number of the best matching
+ *         comic. Matches in the title weigh more than matches in the alt
+ *         text, which weigh more than matches in the transcript.
+ *         Returns an empty optional, if no comic matches or an error
+ *         occurred.
+ */
+std::optional<unsigned int> searchComic(sql::Connection& db, const std::string_view& words);
 
 } // namespace
 
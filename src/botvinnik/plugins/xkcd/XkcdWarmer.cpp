@@ -0,0 +1,116 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "XkcdWarmer.hpp"
+#include "XkcdDb.hpp"
+
+namespace bvn
+{
+
+XkcdWarmer::XkcdWarmer(sql::Connection& db, Uploader upload, IdleCheck idle, const Settings& warmSettings)
+: mDb(db),
+  uploader(std::move(upload)),
+  isIdle(std::move(idle)),
+  settings(warmSettings),
+  cursor(std::numeric_limits<unsigned int>::max()),
+  shutdown(),
+  stopping(false),
+  mutex(),
+  wakeUp(),
+  worker()
+{
+}
+
+XkcdWarmer::~XkcdWarmer()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  shutdown.cancel();
+  wakeUp.notify_one();
+  if (worker.joinable())
+  {
+    worker.join();
+  }
+}
+
+void XkcdWarmer::start()
+{
+  if ((settings.uploadsPerHour == 0) || !uploader || !mDb.isOpen() || worker.joinable())
+  {
+    return;
+  }
+  worker = std::thread(&XkcdWarmer::warmLoop, this);
+}
+
+bool XkcdWarmer::warmOne()
+{
+  auto comic = XkcdDb::comicWithoutUpload(mDb, cursor);
+  if (!comic.has_value())
+  {
+    // Start a new pass, so that failed uploads and new comics are tried.
+    cursor = std::numeric_limits<unsigned int>::max();
+    comic = XkcdDb::comicWithoutUpload(mDb, cursor);
+    if (!comic.has_value())
+    {
+      return false;
+    }
+  }
+  cursor = comic.value().num;
+
+  // Uploads are aborted, when the warmer is destroyed.
+  Deadline::Scope scope(shutdown);
+  return uploader(comic.value());
+}
+
+std::chrono::milliseconds XkcdWarmer::interval() const
+{
+  if (settings.uploadsPerHour == 0)
+  {
+    return std::chrono::milliseconds::zero();
+  }
+  // Dividing the hour itself would round down to whole hours.
+  return std::chrono::milliseconds(std::chrono::hours(1)) / settings.uploadsPerHour;
+}
+
+void XkcdWarmer::warmLoop()
+{
+  const std::chrono::milliseconds pause = interval();
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping)
+  {
+    wakeUp.wait_for(lock, pause, [this]() { return stopping; });
+    if (stopping)
+    {
+      break;
+    }
+    // Commands of users have priority, try again after the next interval.
+    if (isIdle && !isIdle(settings.quiet))
+    {
+      continue;
+    }
+    lock.unlock();
+    warmOne();
+    lock.lock();
+  }
+}
+
+} // namespace
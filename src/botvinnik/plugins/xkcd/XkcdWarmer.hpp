@@ -0,0 +1,132 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_PLUGIN_XKCDWARMER_HPP
+#define BVN_PLUGIN_XKCDWARMER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include "../../../util/Deadline.hpp"
+#include "../../../util/sqlite3.hpp"
+#include "XkcdData.hpp"
+
+namespace bvn
+{
+
+/** \brief Uploads the images of comics in idle times, so that later
+ *         requests for the comics only need a database lookup.
+ *
+ * A background thread goes through the comics of the local mirror that have
+ * no Matrix Content URI yet, newest first, and uploads them at a low rate.
+ * It waits as long as the bot is busy with commands.
+ */
+class XkcdWarmer
+{
+  public:
+    /** \brief settings of the warmer
+     */
+    struct Settings
+    {
+      unsigned int uploadsPerHour = 0; /**< maximum number of uploads per hour; zero disables the warmer */
+      std::chrono::milliseconds quiet = std::chrono::seconds(30); /**< time without commands before uploads continue */
+    }; // struct
+
+
+    /** \brief function that uploads a comic and stores its URI, returns true on
+     *         success
+     */
+    using Uploader = std::function<bool(const XkcdData& data)>;
+
+
+    /** \brief function that checks whether the bot is idle
+     */
+    using IdleCheck = std::function<bool(const std::chrono::milliseconds& quiet)>;
+
+
+    /** \brief Constructor.
+     *
+     * \param db        database connection with the comic mirror
+     * \param upload    function that uploads a comic
+     * \param idle      function that checks whether the bot is idle
+     * \param settings  settings of the warmer
+     * \remarks The background thread is not started before start() is called.
+     */
+    XkcdWarmer(sql::Connection& db, Uploader upload, IdleCheck idle, const Settings& settings);
+
+
+    XkcdWarmer(const XkcdWarmer& other) = delete;
+    XkcdWarmer& operator=(const XkcdWarmer& other) = delete;
+
+
+    /** \brief Destructor. Stops the background thread.
+     */
+    ~XkcdWarmer();
+
+
+    /** \brief Starts the background thread.
+     *
+     * \remarks Does nothing, if the warmer is disabled, the database is not
+     *          open or the thread is already running.
+     */
+    void start();
+
+
+    /** \brief Uploads the next comic that has not been uploaded yet.
+     *
+     * \return Returns true, if a comic was uploaded successfully.
+     *         Returns false, if there was nothing to upload or the upload
+     *         failed.
+     * \remarks This is called by the background thread, but it can also be
+     *          called directly. Comics whose upload failed are only tried
+     *          again after all other comics have been tried.
+     */
+    bool warmOne();
+
+
+    /** \brief Gets the time between two uploads of the background thread.
+     *
+     * \return Returns the time between two uploads.
+     *         Returns zero, if the warmer is disabled.
+     */
+    std::chrono::milliseconds interval() const;
+  private:
+    /** \brief Loop of the background thread.
+     */
+    void warmLoop();
+
+    sql::Connection& mDb; /**< database with the comic mirror */
+    Uploader uploader; /**< uploads comics */
+    IdleCheck isIdle; /**< checks whether the bot is idle */
+    Settings settings; /**< settings of the warmer */
+    unsigned int cursor; /**< only comics below this number are tried in the current pass */
+    Deadline shutdown; /**< cancelled when the warmer stops, aborts running uploads */
+    bool stopping; /**< whether the background thread shall stop */
+    std::mutex mutex; /**< protects stopping */
+    std::condition_variable wakeUp; /**< signals the background thread */
+    std::thread worker; /**< background thread */
+}; // class
+
+} // namespace
+
+#endif // BVN_PLUGIN_XKCDWARMER_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2023, 2024, 2025  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2024, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,6 +19,7 @@
 */
 
 #include "Configuration.hpp"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -58,6 +59,35 @@ const std::chrono::milliseconds Configuration::default_sync_delay = std::chrono:
 // timely response.
 const std::chrono::milliseconds Configuration::max_sync_delay = std::chrono::milliseconds(30000);
 
+// Even a fast server needs some time to answer, so one second is the minimum.
+const std::chrono::milliseconds Configuration::min_command_timeout = std::chrono::milliseconds(1000);
+
+// Default time limit for commands.
+const std::chrono::milliseconds Configuration::default_command_timeout = std::chrono::milliseconds(15000);
+
+// Nobody waits five minutes for the answer to a chat command.
+const std::chrono::milliseconds Configuration::max_command_timeout = std::chrono::milliseconds(300000);
+
+// Three GIFs per keyword are enough for a few requests in a row.
+const int Configuration::default_giphy_pool_size = 3;
+
+const int Configuration::default_giphy_pool_keywords = 10;
+
+const std::chrono::minutes Configuration::default_giphy_pool_refresh = std::chrono::minutes(10);
+
+// One upload every two minutes keeps the load on Giphy and the homeserver low.
+const int Configuration::default_giphy_pool_uploads_per_hour = 30;
+
+// One comic per minute uploads all comics within about two days.
+const int Configuration::default_xkcd_preuploads_per_hour = 60;
+
+// Scanning a checkout of the tldr pages takes a few milliseconds, so once a
+// minute is cheap enough.
+const std::chrono::seconds Configuration::default_cheat_sheet_reload = std::chrono::seconds(60);
+
+// Debian mirrors update the Sources files up to four times a day.
+const std::chrono::minutes Configuration::default_debian_sources_refresh = std::chrono::minutes(60);
+
 Configuration::Configuration()
 :
   mHomeServer(""),
@@ -68,9 +98,22 @@ Configuration::Configuration()
   mStopUsers(std::unordered_set<std::string>()),
   mAllowedFailsIn64(-1),
   mSyncDelay(std::chrono::milliseconds::zero()),
+  mCommandTimeout(std::chrono::milliseconds::zero()),
+  mCommandTimeouts(),
   mLibreTranslateServer(""),
   mLibreTranslateApiKey(""),
-  mGiphyApiKey("")
+  mGiphyApiKey(""),
+  mGiphyPoolSize(-1),
+  mGiphyPoolKeywords(-1),
+  mGiphyPoolRefreshMinutes(-1),
+  mGiphyPoolUploadsPerHour(-1),
+  mXkcdPreUploadsPerHour(-1),
+  mCheatSheetDirectory(""),
+  mCheatSheetReloadSeconds(-1),
+  mDebianSources(),
+  mDebianSourcesRefreshMinutes(-1),
+  mGeoNamesFile(""),
+  mGeoNamesMode("")
 {
 }
 
@@ -139,6 +182,16 @@ std::chrono::milliseconds Configuration::syncDelay() const
   return mSyncDelay;
 }
 
+std::chrono::milliseconds Configuration::commandTimeout(const std::string_view& command) const
+{
+  const auto iter = mCommandTimeouts.find(command);
+  if (iter != mCommandTimeouts.end())
+  {
+    return iter->second;
+  }
+  return mCommandTimeout;
+}
+
 const std::string& Configuration::translationServer() const
 {
   return mLibreTranslateServer;
@@ -154,6 +207,61 @@ const std::string& Configuration::gifApiKey() const
   return mGiphyApiKey;
 }
 
+int Configuration::giphyPoolSize() const
+{
+  return mGiphyPoolSize;
+}
+
+int Configuration::giphyPoolKeywords() const
+{
+  return mGiphyPoolKeywords;
+}
+
+std::chrono::minutes Configuration::giphyPoolRefresh() const
+{
+  return std::chrono::minutes(mGiphyPoolRefreshMinutes);
+}
+
+int Configuration::giphyPoolUploadsPerHour() const
+{
+  return mGiphyPoolUploadsPerHour;
+}
+
+int Configuration::xkcdPreUploadsPerHour() const
+{
+  return mXkcdPreUploadsPerHour;
+}
+
+const std::string& Configuration::cheatSheetDirectory() const
+{
+  return mCheatSheetDirectory;
+}
+
+std::chrono::seconds Configuration::cheatSheetReload() const
+{
+  return std::chrono::seconds(mCheatSheetReloadSeconds);
+}
+
+const std::map<std::string, std::vector<std::string>>& Configuration::debianSources() const
+{
+  return mDebianSources;
+}
+
+std::chrono::minutes Configuration::debianSourcesRefresh() const
+{
+  return std::chrono::minutes(mDebianSourcesRefreshMinutes);
+}
+
+const std::string& Configuration::geoNamesFile() const
+{
+  return mGeoNamesFile;
+}
+
+bool Configuration::geoNamesPrimary() const
+{
+  return mGeoNamesMode == "primary";
+}
+
 void Configuration::findConfigurationFile(std::string& realName)
 {
   namespace fs = std::filesystem;
@@ -182,6 +290,53 @@ void Configuration::findConfigurationFile(std::string& realName)
   } // if
 }
 
+bool Configuration::parseCommandTimeout(const std::string& value, const std::string& fileName, std::chrono::milliseconds& timeout)
+{
+  int amount_of_ms = 0;
+  if (!stringToInt(value, amount_of_ms) || (amount_of_ms < 0))
+  {
+    std::cerr << "Error: Time limit for commands in file " << fileName
+              << " must be a non-negative integer!\n";
+    return false;
+  }
+  if (amount_of_ms < min_command_timeout.count())
+  {
+    std::clog << "Warning: Time limit for commands in file " << fileName
+              << " is lower than allowed and will be raised to the allowed"
+              << " minimum of " << min_command_timeout.count()
+              << " milliseconds!\n";
+    amount_of_ms = min_command_timeout.count();
+  }
+  else if (amount_of_ms > max_command_timeout.count())
+  {
+    std::clog << "Warning: Time limit for commands in file " << fileName
+              << " is higher than allowed and will be lowered to the allowed"
+              << " maximum of " << max_command_timeout.count()
+              << " milliseconds!" << std::endl;
+    amount_of_ms = max_command_timeout.count();
+  }
+  timeout = std::chrono::milliseconds(amount_of_ms);
+  return true;
+}
+
+bool Configuration::parseRangedInt(const std::string& name, const std::string& value, const std::string& fileName, const int minimum, const int maximum, int& target)
+{
+  if (target >= 0)
+  {
+    std::cerr << "Error: Setting " << name << " is specified more than once"
+              << " in file " << fileName << "!\n";
+    return false;
+  }
+  if (!stringToInt(value, target) || (target < minimum) || (target > maximum))
+  {
+    std::cerr << "Error: Setting " << name << " in file " << fileName
+              << " must be an integer between " << minimum << " and "
+              << maximum << " (inclusive)!\n";
+    return false;
+  }
+  return true;
+}
+
 bool Configuration::loadCoreConfiguration(const std::string& fileName)
 {
   std::ifstream stream(fileName, std::ios_base::in | std::ios_base::binary);
@@ -378,6 +533,42 @@ bool Configuration::loadCoreConfiguration(const std::string& fileName)
       }
       mSyncDelay = std::chrono::milliseconds(amount_of_ms);
     } // if bot.sync.delay_milliseconds
+    else if (name == "command.timeout_milliseconds")
+    {
+      if (mCommandTimeout != std::chrono::milliseconds::zero())
+      {
+        std::cerr << "Error: Time limit for commands is specified more than"
+                  << " once in file " << fileName << "!\n";
+        return false;
+      }
+      if (!parseCommandTimeout(value, fileName, mCommandTimeout))
+      {
+        return false;
+      }
+    } // if command.timeout_milliseconds
+    else if (name.rfind("command.timeout_milliseconds.", 0) == 0)
+    {
+      const std::string command = name.substr(29);
+      if (command.empty())
+      {
+        std::cerr << "Error: Setting " << name << " in file " << fileName
+                  << " does not name a command!\n";
+        return false;
+      }
+      if (mCommandTimeouts.find(command) != mCommandTimeouts.end())
+      {
+        std::cerr << "Error: Time limit for the command '" << command
+                  << "' is specified more than once in file " << fileName
+                  << "!\n";
+        return false;
+      }
+      std::chrono::milliseconds timeout = std::chrono::milliseconds::zero();
+      if (!parseCommandTimeout(value, fileName, timeout))
+      {
+        return false;
+      }
+      mCommandTimeouts[command] = timeout;
+    } // if command.timeout_milliseconds.<command>
     else if (name == "libretranslate.server")
     {
       if (!mLibreTranslateServer.empty())
@@ -408,6 +599,118 @@ bool Configuration::loadCoreConfiguration(const std::string& fileName)
       }
       mGiphyApiKey = value;
     } // if giphy.apikey
+    else if (name == "giphy.pool.size")
+    {
+      if (!parseRangedInt(name, value, fileName, 0, 20, mGiphyPoolSize))
+      {
+        return false;
+      }
+    } // if giphy.pool.size
+    else if (name == "giphy.pool.keywords")
+    {
+      if (!parseRangedInt(name, value, fileName, 1, 100, mGiphyPoolKeywords))
+      {
+        return false;
+      }
+    } // if giphy.pool.keywords
+    else if (name == "giphy.pool.refresh_minutes")
+    {
+      if (!parseRangedInt(name, value, fileName, 1, 1440, mGiphyPoolRefreshMinutes))
+      {
+        return false;
+      }
+    } // if giphy.pool.refresh_minutes
+    else if (name == "giphy.pool.uploads_per_hour")
+    {
+      if (!parseRangedInt(name, value, fileName, 1, 3600, mGiphyPoolUploadsPerHour))
+      {
+        return false;
+      }
+    } // if giphy.pool.uploads_per_hour
+    else if (name == "xkcd.preupload.per_hour")
+    {
+      if (!parseRangedInt(name, value, fileName, 0, 3600, mXkcdPreUploadsPerHour))
+      {
+        return false;
+      }
+    } // if xkcd.preupload.per_hour
+    else if (name == "cheat.directory")
+    {
+      if (!mCheatSheetDirectory.empty())
+      {
+        std::cerr << "Error: Cheat sheet directory is specified more than once in file "
+                  << fileName << "!\n";
+        return false;
+      }
+      mCheatSheetDirectory = value;
+    } // if cheat.directory
+    else if (name == "cheat.reload_seconds")
+    {
+      if (!parseRangedInt(name, value, fileName, 0, 86400, mCheatSheetReloadSeconds))
+      {
+        return false;
+      }
+    } // if cheat.reload_seconds
+    else if (name == "debian.sources.refresh_minutes")
+    {
+      if (!parseRangedInt(name, value, fileName, 1, 1440, mDebianSourcesRefreshMinutes))
+      {
+        return false;
+      }
+    } // if debian.sources.refresh_minutes
+    else if (name.rfind("debian.sources.", 0) == 0)
+    {
+      const std::string suite = name.substr(15);
+      const std::vector<std::string> suites = {
+          "jessie", "stretch", "buster", "bullseye", "bookworm", "trixie", "forky"
+      };
+      if (std::find(suites.begin(), suites.end(), suite) == suites.end())
+      {
+        std::cerr << "Error: Setting " << name << " in file " << fileName
+                  << " does not name a known Debian suite!\n";
+        return false;
+      }
+      if (value.empty())
+      {
+        std::cerr << "Error: Sources file for Debian " << suite << " in file "
+                  << fileName << " must not be empty!\n";
+        return false;
+      }
+      auto& files = mDebianSources[suite];
+      if (std::find(files.begin(), files.end(), value) != files.end())
+      {
+        std::cerr << "Error: Sources file " << value << " for Debian " << suite
+                  << " is specified more than once in file " << fileName << "!\n";
+        return false;
+      }
+      files.push_back(value);
+    } // if debian.sources.<suite>
+    else if (name == "weather.geonames.file")
+    {
+      if (!mGeoNamesFile.empty())
+      {
+        std::cerr << "Error: GeoNames file is specified more than once in file "
+                  << fileName << "!\n";
+        return false;
+      }
+      mGeoNamesFile = value;
+    } // if weather.geonames.file
+    else if (name == "weather.geonames.mode")
+    {
+      if (!mGeoNamesMode.empty())
+      {
+        std::cerr << "Error: Usage of GeoNames file is specified more than once in file "
+                  << fileName << "!\n";
+        return false;
+      }
+      if ((value != "primary") && (value != "fallback"))
+      {
+        std::cerr << "Error: Usage of GeoNames file in file " << fileName
+                  << " must be either 'primary' or 'fallback'!\n";
+        return false;
+      }
+      mGeoNamesMode = value;
+    } // if weather.geonames.mode
     else
     {
       std::cerr << "Error while reading configuration file " << fileName
@@ -463,6 +766,40 @@ bool Configuration::loadCoreConfiguration(const std::string& fileName)
   {
     mSyncDelay = default_sync_delay;
   }
+  // Time limit for commands may be missing. Set it to the default then.
+  if (mCommandTimeout == std::chrono::milliseconds::zero())
+  {
+    mCommandTimeout = default_command_timeout;
+  }
+  // Settings of the Giphy pool may be missing. Use the defaults then.
+  if (mGiphyPoolSize < 0)
+  {
+    mGiphyPoolSize = default_giphy_pool_size;
+  }
+  if (mGiphyPoolKeywords < 0)
+  {
+    mGiphyPoolKeywords = default_giphy_pool_keywords;
+  }
+  if (mGiphyPoolRefreshMinutes < 0)
+  {
+    mGiphyPoolRefreshMinutes = default_giphy_pool_refresh.count();
+  }
+  if (mGiphyPoolUploadsPerHour < 0)
+  {
+    mGiphyPoolUploadsPerHour = default_giphy_pool_uploads_per_hour;
+  }
+  if (mXkcdPreUploadsPerHour < 0)
+  {
+    mXkcdPreUploadsPerHour = default_xkcd_preuploads_per_hour;
+  }
+  if (mCheatSheetReloadSeconds < 0)
+  {
+    mCheatSheetReloadSeconds = default_cheat_sheet_reload.count();
+  }
+  if (mDebianSourcesRefreshMinutes < 0)
+  {
+    mDebianSourcesRefreshMinutes = default_debian_sources_refresh.count();
+  }
 
   // Everything is good, so far.
   return true;
@@ -521,9 +858,22 @@ void Configuration::clear()
   mStopUsers.clear();
   mAllowedFailsIn64 = -1;
   mSyncDelay = std::chrono::milliseconds::zero();
+  mCommandTimeout = std::chrono::milliseconds::zero();
+  mCommandTimeouts.clear();
   mLibreTranslateServer.clear();
   mLibreTranslateApiKey.clear();
   mGiphyApiKey.clear();
+  mGiphyPoolSize = -1;
+  mGiphyPoolKeywords = -1;
+  mGiphyPoolRefreshMinutes = -1;
+  mGiphyPoolUploadsPerHour = -1;
+  mXkcdPreUploadsPerHour = -1;
+  mCheatSheetDirectory.clear();
+  mCheatSheetReloadSeconds = -1;
+  mDebianSources.clear();
+  mDebianSourcesRefreshMinutes = -1;
+  mGeoNamesFile.clear();
+  mGeoNamesMode.clear();
 }
 
 } // namespace
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -24,6 +24,7 @@
 #include <chrono>
 #include <map>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
@@ -139,6 +140,31 @@ class Configuration
     static const std::chrono::milliseconds max_sync_delay;
 
 
+    /** \brief Gets the time limit for the processing of a command.
+     *
+     * \param command  name of the command, without prefix
+     * \return Returns the time limit that was set for the given command. If
+     *         no time limit was set for the command, the general time limit
+     *         for commands is returned.
+     */
+    std::chrono::milliseconds commandTimeout(const std::string_view& command) const;
+
+
+    /** \brief minimal allowed time limit for commands
+     */
+    static const std::chrono::milliseconds min_command_timeout;
+
+
+    /** \brief default time limit for commands
+     */
+    static const std::chrono::milliseconds default_command_timeout;
+
+
+    /** \brief maximal allowed time limit for commands
+     */
+    static const std::chrono::milliseconds max_command_timeout;
+
+
     /** \brief Gets the URL of the translation server.
      *
      * \return Returns the URL of the translation server.
@@ -163,6 +189,132 @@ class Configuration
     const std::string& gifApiKey() const;
 
 
+    /** \brief Gets the number of prefetched GIFs per popular Giphy keyword.
+     *
+     * \return Returns the number of GIFs that are kept per keyword.
+     *         Zero means that no GIFs are prefetched.
+     */
+    int giphyPoolSize() const;
+
+
+    /** \brief default number of prefetched GIFs per popular Giphy keyword
+     */
+    static const int default_giphy_pool_size;
+
+
+    /** \brief Gets the number of popular Giphy keywords that get prefetched
+     *         GIFs.
+     *
+     * \return Returns the number of keywords.
+     */
+    int giphyPoolKeywords() const;
+
+
+    /** \brief default number of popular Giphy keywords with prefetched GIFs
+     */
+    static const int default_giphy_pool_keywords;
+
+
+    /** \brief Gets the time between two refills of the Giphy pool.
+     *
+     * \return Returns the time between two refills.
+     */
+    std::chrono::minutes giphyPoolRefresh() const;
+
+
+    /** \brief default time between two refills of the Giphy pool
+     */
+    static const std::chrono::minutes default_giphy_pool_refresh;
+
+
+    /** \brief Gets the maximum number of GIFs that the Giphy pool may fetch
+     *         per hour.
+     *
+     * \return Returns the maximum number of fetches per hour.
+     */
+    int giphyPoolUploadsPerHour() const;
+
+
+    /** \brief default maximum number of GIFs fetched by the Giphy pool per hour
+     */
+    static const int default_giphy_pool_uploads_per_hour;
+
+
+    /** \brief Gets the maximum number of xkcd comics that are uploaded per
+     *         hour in idle times.
+     *
+     * \return Returns the maximum number of uploads per hour.
+     *         Zero means that comics are only uploaded on request.
+     */
+    int xkcdPreUploadsPerHour() const;
+
+
+    /** \brief default maximum number of xkcd comics uploaded per hour in idle
+     *         times
+     */
+    static const int default_xkcd_preuploads_per_hour;
+
+
+    /** \brief Gets the directory that contains local cheat sheets.
+     *
+     * \return Returns the directory with the cheat sheets.
+     * \remarks This may be empty, if no directory was set.
+     */
+    const std::string& cheatSheetDirectory() const;
+
+
+    /** \brief Gets the minimum time between two scans of the cheat sheet
+     *         directory for changes.
+     *
+     * \return Returns the time between two scans.
+     *         Zero means that the directory is only scanned at start.
+     */
+    std::chrono::seconds cheatSheetReload() const;
+
+
+    /** \brief default time between two scans of the cheat sheet directory
+     */
+    static const std::chrono::seconds default_cheat_sheet_reload;
+
+
+    /** \brief Gets the Sources files for local searches of Debian packages.
+     *
+     * \return Returns the names of the uncompressed Sources files for each
+     *         Debian suite, e. g. "trixie". Suites without files are missing.
+     */
+    const std::map<std::string, std::vector<std::string>>& debianSources() const;
+
+
+    /** \brief Gets the time between two checks for changed Sources files.
+     *
+     * \return Returns the time between two checks.
+     */
+    std::chrono::minutes debianSourcesRefresh() const;
+
+
+    /** \brief default time between two checks for changed Sources files
+     */
+    static const std::chrono::minutes default_debian_sources_refresh;
+
+
+    /** \brief Gets the file name of the GeoNames dump for offline location
+     *         lookups.
+     *
+     * \return Returns the file name of the GeoNames dump.
+     * \remarks This may be empty, if no file was set.
+     */
+    const std::string& geoNamesFile() const;
+
+
+    /** \brief Checks whether the GeoNames dump is used before the online
+     *         location lookup services.
+     *
+     * \return Returns true, if the GeoNames dump is asked first.
+     *         Returns false, if it is only used when the online services fail.
+     */
+    bool geoNamesPrimary() const;
+
+
     /** \brief Loads the configuration from a file.
      *
      * \param  fileName   file name of the configuration file
@@ -190,6 +342,31 @@ class Configuration
      */
     bool loadCoreConfiguration(const std::string& fileName);
 
+
+    /** \brief Parses the value of a command time limit setting.
+     *
+     * \param value     the value of the setting
+     * \param fileName  file name of the configuration file
+     * \param timeout   variable that will receive the parsed time limit
+     * \return Returns true, if the value is valid. Values outside of the
+     *         allowed range are clamped.
+     */
+    static bool parseCommandTimeout(const std::string& value, const std::string& fileName, std::chrono::milliseconds& timeout);
+
+
+    /** \brief Parses the value of an integer setting with a fixed range.
+     *
+     * \param name      name of the setting
+     * \param value     the value of the setting
+     * \param fileName  file name of the configuration file
+     * \param minimum   smallest allowed value
+     * \param maximum   largest allowed value
+     * \param target    variable that will receive the parsed value; it must
+     *                  be negative, if the setting was not parsed before
+     * \return Returns true, if the value is valid and was not set before.
+     */
+    static bool parseRangedInt(const std::string& name, const std::string& value, const std::string& fileName, const int minimum, const int maximum, int& target);
+
     std::string mHomeServer; /**< Matrix homeserver */
     std::string mUserId; /**< Matrix user id used for login */
     std::string mPassword; /**< password used for login */
@@ -198,11 +375,24 @@ class Configuration
     std::unordered_set<std::string> mStopUsers; /**< users that may stop the bot */
     int mAllowedFailsIn64; /**< allowed sync failures in 64 attempts */
     std::chrono::milliseconds mSyncDelay; /**< delay between two consecutive sync requests */
+    std::chrono::milliseconds mCommandTimeout; /**< general time limit for commands */
+    std::map<std::string, std::chrono::milliseconds, std::less<>> mCommandTimeouts; /**< time limits for specific commands */
 
     // plugin-related settings
     std::string mLibreTranslateServer; /**< URL of the LibreTranslate server */
     std::string mLibreTranslateApiKey; /**< API key for the LibreTranslate server */
     std::string mGiphyApiKey;          /**< API key for Giphy */
+    int mGiphyPoolSize;                /**< prefetched GIFs per popular keyword */
+    int mGiphyPoolKeywords;            /**< number of keywords with prefetched GIFs */
+    int mGiphyPoolRefreshMinutes;      /**< minutes between two refills of the GIF pool */
+    int mGiphyPoolUploadsPerHour;      /**< maximum number of prefetched GIFs per hour */
+    int mXkcdPreUploadsPerHour;        /**< maximum number of comics uploaded per hour in idle times */
+    std::string mCheatSheetDirectory;  /**< directory with local cheat sheets */
+    int mCheatSheetReloadSeconds;      /**< seconds between two scans of the cheat sheet directory */
+    std::map<std::string, std::vector<std::string>> mDebianSources; /**< Sources files for each Debian suite */
+    int mDebianSourcesRefreshMinutes;  /**< minutes between two checks for changed Sources files */
+    std::string mGeoNamesFile;         /**< file name of GeoNames dump */
+    std::string mGeoNamesMode;         /**< usage of GeoNames dump: "primary" or "fallback" */
 }; // class
 
 } // namespace
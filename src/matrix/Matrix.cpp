@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2023  Dirk Stolle
+    Copyright (C) 2020, 2021, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,12 +20,16 @@
 
 #include "Matrix.hpp"
 #include <iostream>
+#include <thread>
 #include "../../third-party/nlohmann/json.hpp"
 #include "../../third-party/simdjson/simdjson.h"
 #include "../Version.hpp"
 #include "../net/Curly.hpp"
 #include "../net/url_encode.hpp"
 #include "../util/chrono.hpp"
+#include "../util/Deadline.hpp"
+#include "../util/RingBuffer.hpp"
+#include "../util/Sha256.hpp"
 #include "../util/Strings.hpp"
 #include "json/PowerLevels.hpp"
 #include "json/Sync.hpp"
@@ -33,6 +37,10 @@
 namespace bvn
 {
 
+// A few hundred kilobytes are enough to keep both transfers busy.
+const std::size_t Matrix::relay_buffer_size = 256 * 1024;
+const int64_t Matrix::max_buffered_size = 50 * 1024 * 1024;
+
 #ifdef BVN_USER_AGENT
 void addUserAgent(Curly& curl)
 {
@@ -44,7 +52,10 @@ void addUserAgent(Curly& curl)
 Matrix::Matrix(const Configuration& _conf)
 : conf(_conf),
   accessToken(std::string()),
-  transactionId(0)
+  transactionId(0),
+  media(),
+  uploadLimit(std::nullopt),
+  uploadLimitMutex()
 {
 }
 
@@ -61,6 +72,11 @@ const Configuration& Matrix::configuration() const
   return conf;
 }
 
+MediaCache& Matrix::mediaCache()
+{
+  return media;
+}
+
 bool Matrix::login()
 {
   if (isLoggedIn())
@@ -593,6 +609,12 @@ std::optional<int64_t> Matrix::getUploadLimit()
     return std::optional<int64_t>();
   }
 
+  std::lock_guard<std::mutex> lock(uploadLimitMutex);
+  if (uploadLimit.has_value())
+  {
+    return uploadLimit;
+  }
+
   Curly curl;
   curl.setURL(conf.homeServer() + "/_matrix/media/r0/config");
   curl.addHeader("Authorization: Bearer " + accessToken);
@@ -617,15 +639,17 @@ std::optional<int64_t> Matrix::getUploadLimit()
               << "Response is: " << response << std::endl;
     return std::optional<int64_t>();
   }
-  simdjson::dom::element uploadLimit;
-  const auto jsonError = doc["m.upload.size"].get(uploadLimit);
-  if (jsonError || uploadLimit.type() != simdjson::dom::element_type::INT64)
+  simdjson::dom::element limit;
+  const auto jsonError = doc["m.upload.size"].get(limit);
+  if (jsonError || limit.type() != simdjson::dom::element_type::INT64)
   {
     std::clog << "Warning: Server did not disclose upload size!" << std::endl;
-    return std::optional<int64_t>(-1);
+    uploadLimit = -1;
+    return uploadLimit;
   }
 
-  return uploadLimit.get<int64_t>().value();
+  uploadLimit = limit.get<int64_t>().value();
+  return uploadLimit;
 }
 
 std::optional<std::string> Matrix::getSynapseVersion()
@@ -668,6 +692,32 @@ std::optional<std::string> Matrix::uploadString(const std::string& data, const s
     return std::optional<std::string>();
   }
 
+  const std::string digest = Sha256::hash(data);
+  const auto known = media.byHash(digest);
+  if (known.has_value())
+  {
+    std::clog << "Info: Content of " << fileName << " was already uploaded as "
+              << known.value() << "." << std::endl;
+    return known;
+  }
+
+  Curly curl;
+  if (!curl.setPostBody(data))
+  {
+    std::cerr << "Error: Could not set body for POST request of file upload."
+              << std::endl;
+    return std::optional<std::string>();
+  }
+  const auto mxcUri = upload(curl, contentType, fileName);
+  if (mxcUri.has_value())
+  {
+    media.putHash(digest, mxcUri.value());
+  }
+  return mxcUri;
+}
+
+std::optional<std::string> Matrix::upload(Curly& curl, const std::string& contentType, const std::string& fileName)
+{
   std::string encodedFileName;
   try
   {
@@ -680,19 +730,12 @@ std::optional<std::string> Matrix::uploadString(const std::string& data, const s
     return std::optional<std::string>();
   }
 
-  Curly curl;
   curl.setURL(conf.homeServer() + "/_matrix/media/r0/upload?filename=" + encodedFileName);
   curl.addHeader("Authorization: Bearer " + accessToken);
   curl.addHeader("Content-Type: " + contentType);
   #ifdef BVN_USER_AGENT
   addUserAgent(curl);
   #endif
-  if (!curl.setPostBody(data))
-  {
-    std::cerr << "Error: Could not set body for POST request of file upload."
-              << std::endl;
-    return std::optional<std::string>();
-  }
   std::string response;
   if (!curl.perform(response) || curl.getResponseCode() != 200)
   {
@@ -744,23 +787,27 @@ std::string extract_file_name_from_url(const std::string& url)
   return fileName;
 }
 
-std::optional<std::string> Matrix::uploadImage(const std::string& imgUrl)
+std::optional<std::string> Matrix::uploadImage(const std::string& imgUrl, const int64_t knownSize)
 {
-  std::string imageData;
+  const auto known = media.byUrl(imgUrl);
+  if (known.has_value())
   {
-    Curly curl;
-    curl.setURL(imgUrl);
-    #ifdef BVN_USER_AGENT
-    addUserAgent(curl);
-    #endif
-    std::clog << "Info: Downloading image " << imgUrl << " ..." << std::endl;
-    if (!curl.perform(imageData) || curl.getResponseCode() != 200)
-    {
-      std::cerr << "Error: Could get image from " + imgUrl + "!\n"
-                << "HTTP status code: " << curl.getResponseCode() << '\n'
-                << "Response: " << imageData << std::endl;
-      return std::optional<std::string>();
-    }
+    return known;
+  }
+  if (!isLoggedIn())
+  {
+    return std::optional<std::string>();
+  }
+
+  // Images above the upload limit would only be rejected by the server after
+  // a complete download, so do not even start the download.
+  const int64_t maxSize = getUploadLimit().value_or(-1);
+  if ((maxSize > 0) && (knownSize > maxSize))
+  {
+    std::cerr << "Error: Image " << imgUrl << " has " << knownSize
+              << " bytes, but the upload limit of the server is " << maxSize
+              << " bytes." << std::endl;
+    return std::optional<std::string>();
   }
 
   std::string contentType("application/octet-stream");
@@ -779,10 +826,149 @@ std::optional<std::string> Matrix::uploadImage(const std::string& imgUrl)
 
   const std::string fileName = extract_file_name_from_url(imgUrl);
 
-  std::clog << "Info: Uploading image " << imgUrl << " ("
-            << static_cast<long int>(imageData.size())
-            << " bytes) to Matrix ..." << std::endl;
-  return uploadString(imageData, contentType, fileName);
+  // The download runs in its own thread and writes into a ring buffer that
+  // the upload reads from, so both transfers overlap and at most the size of
+  // the buffer is kept in memory.
+  RingBuffer buffer(relay_buffer_size);
+  std::atomic<long long> expectedSize(-1);
+  long responseCode = 0;
+  bool downloaded = false;
+  bool tooLarge = false;
+  std::clog << "Info: Downloading image " << imgUrl << " ..." << std::endl;
+  std::thread download([&, deadline = Deadline::current()]()
+  {
+    Deadline::Scope scope(deadline);
+    Curly curl;
+    curl.setURL(imgUrl);
+    #ifdef BVN_USER_AGENT
+    addUserAgent(curl);
+    #endif
+    int64_t received = 0;
+    curl.setResponseSink([&buffer, &expectedSize, &curl, &received, &tooLarge, maxSize](const std::string_view& data)
+    {
+      if (curl.getResponseCode() != 200)
+      {
+        return false;
+      }
+      expectedSize = curl.expectedBodySize();
+      received += data.size();
+      if ((maxSize > 0) && ((expectedSize > maxSize) || (received > maxSize)))
+      {
+        tooLarge = true;
+        return false;
+      }
+      // Without a Content-Length the whole image ends up in memory before
+      // the upload, so it needs a bound even if the upload limit is unknown.
+      if ((expectedSize < 0) && (received > max_buffered_size))
+      {
+        tooLarge = true;
+        return false;
+      }
+      return buffer.write(data);
+    });
+    std::string unused;
+    downloaded = curl.perform(unused) && (curl.getResponseCode() == 200);
+    responseCode = curl.getResponseCode();
+    if (downloaded)
+    {
+      buffer.close();
+    }
+    else
+    {
+      buffer.abort();
+    }
+  });
+  buffer.waitUntilFilled();
+
+  std::optional<std::string> mxcUri;
+  bool uploadFailed = false;
+  if (buffer.closed() || (!buffer.aborted() && (expectedSize < 0)))
+  {
+    // The whole image fits into the buffer, or its size is unknown and it
+    // cannot be streamed, because Synapse requires the Content-Length of an
+    // upload in advance. Either way its content can be checked against
+    // previous uploads before anything is uploaded.
+    std::string imageData;
+    std::string chunk(relay_buffer_size, '\0');
+    std::size_t count = 0;
+    while ((count = buffer.read(chunk.data(), chunk.size())) > 0)
+    {
+      imageData.append(chunk, 0, count);
+    }
+    download.join();
+    if (downloaded)
+    {
+      std::clog << "Info: Uploading image " << imgUrl << " ("
+                << static_cast<long int>(imageData.size())
+                << " bytes) to Matrix ..." << std::endl;
+      mxcUri = uploadString(imageData, contentType, fileName);
+    }
+  }
+  else if (!buffer.aborted())
+  {
+    Sha256 sha;
+    Curly curl;
+    curl.setPostSource([&buffer, &sha](char* dest, const std::size_t size) -> std::size_t
+    {
+      const std::size_t count = buffer.read(dest, size);
+      if ((count == 0) && buffer.aborted())
+      {
+        return Curly::source_abort;
+      }
+      sha.update(std::string_view(dest, count));
+      return count;
+    }, expectedSize);
+    std::clog << "Info: Relaying image " << imgUrl << " (" << expectedSize
+              << " bytes) to Matrix ..." << std::endl;
+    mxcUri = upload(curl, contentType, fileName);
+    if (!mxcUri.has_value())
+    {
+      // Stop the download, nobody reads the buffer anymore.
+      uploadFailed = true;
+      buffer.abort();
+    }
+    download.join();
+    if (mxcUri.has_value())
+    {
+      media.putHash(sha.hexDigest(), mxcUri.value());
+    }
+  }
+  else
+  {
+    download.join();
+  }
+
+  if (tooLarge)
+  {
+    std::cerr << "Error: Download of image " << imgUrl << " was aborted, "
+              << "because it exceeds the ";
+    if (maxSize > 0)
+    {
+      std::cerr << "upload limit of " << maxSize;
+    }
+    else
+    {
+      std::cerr << "maximum size of " << max_buffered_size;
+    }
+    std::cerr << " bytes." << std::endl;
+    return std::optional<std::string>();
+  }
+  if (!downloaded)
+  {
+    std::cerr << "Error: Could not get image from " + imgUrl + "!\n"
+              << "HTTP status code: " << responseCode << std::endl;
+    if (uploadFailed)
+    {
+      std::cerr << "The download was stopped, because the upload failed."
+                << std::endl;
+    }
+    return std::optional<std::string>();
+  }
+  if (mxcUri.has_value())
+  {
+    media.putUrl(imgUrl, mxcUri.value());
+  }
+  return mxcUri;
 }
 
 std::optional<std::string> Matrix::encryptionAlgorithm(const std::string& roomId)
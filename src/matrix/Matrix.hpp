@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2021, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,15 +23,19 @@
 
 #include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 #include "../conf/Configuration.hpp"
 #include "ImageInfo.hpp"
+#include "MediaCache.hpp"
 #include "Message.hpp"
 #include "Room.hpp"
 #include "events/PowerLevels.hpp"
 
+class Curly;
+
 namespace bvn
 {
 
@@ -59,6 +63,14 @@ class Matrix
     const Configuration& configuration() const;
 
 
+    /** \brief Gets the cache of uploaded media.
+     *
+     * \return Returns the cache that is used by uploadString() and
+     *         uploadImage() to avoid repeated downloads and uploads.
+     */
+    MediaCache& mediaCache();
+
+
     /** \brief Performs login on the Matrix server.
      *
      * \return Returns whether login was successful.
@@ -171,6 +183,8 @@ class Matrix
      *         If the request failed, the returned optional will be empty.
      *         If the server did not disclose its limit, the returned value is
      *         negative one (-1).
+     * \remarks The limit is only requested once. Later calls return the same
+     *          value without a request.
      */
     std::optional<int64_t> getUploadLimit();
 
@@ -192,6 +206,8 @@ class Matrix
      * \param fileName    name of the file (e. g. "cat.jpeg")
      * \return Returns the Matrix Content URI (MXC URI) for the uploaded file.
      *         Returns an empty optional, if the upload failed.
+     * \remarks If data with the same content was uploaded before, its URI is
+     *          taken from the media cache and nothing is uploaded.
      */
     std::optional<std::string> uploadString(const std::string& data, const std::string& contentType = "application/octet-stream", const std::string& fileName = "file.dat");
 
@@ -199,11 +215,33 @@ class Matrix
     /** \brief Uploads a web image to the matrix content repository.
        *
        * \param imgUrl   web URL of the image
+       * \param knownSize  size of the image in bytes, if it is known in
+       *                   advance; zero or negative values mean unknown size
        * \return Returns an optional containing the Matrix Content URI for the
        *         uploaded image.
        *         Returns an empty optional, if the operation failed.
+       * \remarks If the image from that URL is in the media cache, it is
+       *          neither downloaded nor uploaded again. Images that do not
+       *          fit into a buffer of relay_buffer_size bytes are uploaded
+       *          while they are still downloaded. Images that are larger
+       *          than the upload limit of the server are not downloaded, or
+       *          their download is aborted as soon as the limit is exceeded.
+       *          Images without a known size have to be kept in memory
+       *          completely, so their download is aborted after
+       *          max_buffered_size bytes, if the upload limit is unknown.
        */
-    std::optional<std::string> uploadImage(const std::string& imgUrl);
+    std::optional<std::string> uploadImage(const std::string& imgUrl, const int64_t knownSize = -1);
+
+
+    /** \brief size of the buffer between download and upload in uploadImage()
+     */
+    static const std::size_t relay_buffer_size;
+
+
+    /** \brief maximum size of an image without known size in uploadImage(),
+     *         if the upload limit of the server is unknown
+     */
+    static const int64_t max_buffered_size;
 
 
     /** \brief Gets the encryption algorithm used in a room.
@@ -242,9 +280,22 @@ class Matrix
      */
     bool roomMembershipChange(const std::string& roomId, const std::string& change);
 
+    /** \brief Uploads the body of a prepared request to the content repository.
+     *
+     * \param curl        request whose body is already set
+     * \param contentType content type of the file
+     * \param fileName    name of the file
+     * \return Returns the Matrix Content URI (MXC URI) for the uploaded file.
+     *         Returns an empty optional, if the upload failed.
+     */
+    std::optional<std::string> upload(Curly& curl, const std::string& contentType, const std::string& fileName);
+
     Configuration conf;
     std::string accessToken; /**< the access token for Matrix */
     std::atomic<uint_least32_t> transactionId;/**< id of the transaction */
+    MediaCache media; /**< MXC URIs of uploaded media */
+    std::optional<int64_t> uploadLimit; /**< upload size limit, once it is known */
+    std::mutex uploadLimitMutex; /**< protects uploadLimit */
 }; // class
 
 } // namespace
@@ -0,0 +1,88 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "MediaCache.hpp"
+#include "../util/PersistentCache.hpp"
+
+namespace bvn
+{
+
+namespace
+{
+
+/** \brief namespace of the URIs in the persistent cache
+ */
+const std::string cache_namespace = "media";
+
+} // namespace
+
+// Homeservers may purge old media, so URIs are not kept forever.
+const std::chrono::hours MediaCache::retention = std::chrono::hours(24 * 30);
+
+MediaCache::MediaCache()
+: store(nullptr)
+{
+}
+
+void MediaCache::setStore(PersistentCache* cache)
+{
+  store = cache;
+}
+
+std::optional<std::string> MediaCache::byUrl(const std::string& url)
+{
+  return get("url:" + url);
+}
+
+std::optional<std::string> MediaCache::byHash(const std::string& sha256)
+{
+  return get("sha256:" + sha256);
+}
+
+void MediaCache::putUrl(const std::string& url, const std::string& mxcUri)
+{
+  put("url:" + url, mxcUri);
+}
+
+void MediaCache::putHash(const std::string& sha256, const std::string& mxcUri)
+{
+  put("sha256:" + sha256, mxcUri);
+}
+
+std::optional<std::string> MediaCache::get(const std::string& key)
+{
+  PersistentCache* cache = store;
+  if (cache == nullptr)
+  {
+    return std::nullopt;
+  }
+  return cache->get(cache_namespace, key);
+}
+
+void MediaCache::put(const std::string& key, const std::string& mxcUri)
+{
+  PersistentCache* cache = store;
+  if (cache != nullptr)
+  {
+    cache->put(cache_namespace, key, mxcUri, retention);
+  }
+}
+
+} // namespace
@@ -0,0 +1,123 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_MEDIACACHE_HPP
+#define BVN_MEDIACACHE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+
+namespace bvn
+{
+
+// forward declaration
+class PersistentCache;
+
+/** \brief Remembers the Matrix Content URIs (MXC URIs) of uploaded media.
+ *
+ * Media is found by the URL it was downloaded from, so that a known URL
+ * needs neither download nor upload, and by the SHA-256 digest of its
+ * content, so that the same content from a different URL is not uploaded
+ * again.
+ *
+ * The URIs are kept in the namespace "media" of a persistent cache, so that
+ * they survive a restart. Its memory tier holds the most recently used URIs.
+ */
+class MediaCache
+{
+  public:
+    /** \brief Constructor. Nothing is cached until a store is set.
+     */
+    MediaCache();
+
+
+    MediaCache(const MediaCache& other) = delete;
+    MediaCache& operator=(const MediaCache& other) = delete;
+
+
+    /** \brief Sets the store for the URIs.
+     *
+     * \param cache  the persistent cache that keeps the URIs; nullptr
+     *               disables caching
+     * \remarks The persistent cache has to live as long as it is set.
+     */
+    void setStore(PersistentCache* cache);
+
+
+    /** \brief Gets the MXC URI of media that was downloaded from a URL.
+     *
+     * \param url  the source URL of the media
+     * \return Returns an optional containing the MXC URI, if it is known.
+     *         Returns an empty optional otherwise.
+     */
+    std::optional<std::string> byUrl(const std::string& url);
+
+
+    /** \brief Gets the MXC URI of media with the given content.
+     *
+     * \param sha256  SHA-256 digest of the media as hexadecimal string
+     * \return Returns an optional containing the MXC URI, if it is known.
+     *         Returns an empty optional otherwise.
+     */
+    std::optional<std::string> byHash(const std::string& sha256);
+
+
+    /** \brief Stores the MXC URI of media that was downloaded from a URL.
+     *
+     * \param url     the source URL of the media
+     * \param mxcUri  the MXC URI of the uploaded media
+     */
+    void putUrl(const std::string& url, const std::string& mxcUri);
+
+
+    /** \brief Stores the MXC URI of media with the given content.
+     *
+     * \param sha256  SHA-256 digest of the media as hexadecimal string
+     * \param mxcUri  the MXC URI of the uploaded media
+     */
+    void putHash(const std::string& sha256, const std::string& mxcUri);
+
+
+    /** \brief time that URIs are kept in the store after their last upload
+     */
+    static const std::chrono::hours retention;
+  private:
+    /** \brief Gets an URI from the store.
+     *
+     * \param key  key of the entry, i. e. "url:" or "sha256:" plus the value
+     * \return Returns an optional containing the MXC URI, if it is known.
+     */
+    std::optional<std::string> get(const std::string& key);
+
+    /** \brief Puts an URI into the store.
+     *
+     * \param key     key of the entry
+     * \param mxcUri  the MXC URI
+     */
+    void put(const std::string& key, const std::string& mxcUri);
+
+    std::atomic<PersistentCache*> store; /**< keeps the URIs, may be nullptr */
+}; // class
+
+} // namespace
+
+#endif // BVN_MEDIACACHE_HPP
@@ -0,0 +1,194 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "CircuitBreaker.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+namespace bvn
+{
+
+CircuitBreaker::CircuitBreaker(const unsigned int minimumRequests, const unsigned int failurePercentage,
+                               const std::chrono::milliseconds& openDuration)
+: minRequests(std::clamp(minimumRequests, 1u, N)),
+  percentage(std::clamp(failurePercentage, 1u, 100u)),
+  coolDown(openDuration),
+  circuits(),
+  mutex()
+{
+}
+
+CircuitBreaker& CircuitBreaker::upstreams()
+{
+  // Open after at least half of the last (up to 20) requests failed, but
+  // only if there have been at least four requests. Try again after 30 s.
+  static CircuitBreaker breaker(4, 50, std::chrono::seconds(30));
+  return breaker;
+}
+
+std::string CircuitBreaker::hostOf(const std::string_view& url)
+{
+  std::string_view rest = url;
+  const auto scheme_end = rest.find("://");
+  if (scheme_end != std::string_view::npos)
+  {
+    rest.remove_prefix(scheme_end + 3);
+  }
+  rest = rest.substr(0, rest.find_first_of("/?#"));
+  // Remove user info, if any.
+  const auto at = rest.rfind('@');
+  if (at != std::string_view::npos)
+  {
+    rest.remove_prefix(at + 1);
+  }
+  // Remove port, but keep IPv6 addresses like [::1] intact.
+  const auto colon = rest.rfind(':');
+  if ((colon != std::string_view::npos) && (rest.find(']', colon) == std::string_view::npos))
+  {
+    rest = rest.substr(0, colon);
+  }
+
+  std::string host(rest);
+  std::transform(host.begin(), host.end(), host.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return host;
+}
+
+CircuitBreaker::State CircuitBreaker::stateOf(const Circuit& circuit, const std::chrono::steady_clock::time_point& now) const
+{
+  if (!circuit.open)
+  {
+    return State::closed;
+  }
+  if (circuit.probing || (now - circuit.openedAt >= coolDown))
+  {
+    return State::halfOpen;
+  }
+  return State::open;
+}
+
+CircuitBreaker::Permit CircuitBreaker::allowRequest(const std::string& host)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  Circuit& circuit = circuits[host];
+  Permit permit;
+  permit.generation = circuit.generation;
+  switch (stateOf(circuit, std::chrono::steady_clock::now()))
+  {
+    case State::closed:
+         permit.allowed = true;
+         break;
+    case State::open:
+         break;
+    case State::halfOpen:
+         // Only one test request at a time.
+         if (!circuit.probing)
+         {
+           circuit.probing = true;
+           permit.allowed = true;
+           permit.probe = true;
+         }
+         break;
+  }
+  return permit;
+}
+
+void CircuitBreaker::record(const std::string& host, const Permit& permit, const bool success)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  Circuit& circuit = circuits[host];
+  if (!permit.allowed || (permit.generation != circuit.generation))
+  {
+    // Request started before the circuit opened or closed, so its outcome
+    // says nothing about the current state of the host.
+    return;
+  }
+  if (circuit.open)
+  {
+    if (!permit.probe)
+    {
+      return;
+    }
+    circuit.probing = false;
+    if (success)
+    {
+      std::clog << "Info: " << host << " is reachable again." << std::endl;
+      const uint64_t generation = circuit.generation + 1;
+      circuit = Circuit();
+      circuit.generation = generation;
+    }
+    else
+    {
+      // Test request failed, so wait for another period.
+      circuit.openedAt = std::chrono::steady_clock::now();
+    }
+    return;
+  }
+
+  circuit.failures.set(circuit.offset, !success);
+  circuit.offset = (circuit.offset + 1) % N;
+  if (circuit.requests < N)
+  {
+    ++circuit.requests;
+  }
+  if ((circuit.requests >= minRequests)
+      && (circuit.failures.count() * 100 >= percentage * circuit.requests))
+  {
+    std::cerr << "Error: Too many requests to " << host << " failed. No "
+              << "further requests will be sent to that host for the next "
+              << std::chrono::duration_cast<std::chrono::seconds>(coolDown).count()
+              << " seconds." << std::endl;
+    circuit.open = true;
+    circuit.openedAt = std::chrono::steady_clock::now();
+    ++circuit.generation;
+  }
+}
+
+void CircuitBreaker::release(const std::string& host, const Permit& permit)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto iter = circuits.find(host);
+  if ((iter != circuits.end()) && permit.probe
+      && (permit.generation == iter->second.generation))
+  {
+    // An aborted test request allows the next one.
+    iter->second.probing = false;
+  }
+}
+
+CircuitBreaker::State CircuitBreaker::state(const std::string& host) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto iter = circuits.find(host);
+  if (iter == circuits.end())
+  {
+    return State::closed;
+  }
+  return stateOf(iter->second, std::chrono::steady_clock::now());
+}
+
+bool CircuitBreaker::available(const std::string& host) const
+{
+  return state(host) != State::open;
+}
+
+} // namespace
@@ -0,0 +1,198 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_CIRCUITBREAKER_HPP
+#define BVN_CIRCUITBREAKER_HPP
+
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace bvn
+{
+
+/** \brief Keeps track of failing requests to other servers and blocks
+ *         requests to servers that seem to be down.
+ *
+ * Each host has its own circuit. A circuit starts in the closed state, where
+ * all requests are allowed. If the share of failed requests among the recent
+ * requests to a host exceeds the threshold, the circuit opens and requests to
+ * that host fail immediately. After a cool-down period the circuit becomes
+ * half-open and lets a single request through. Depending on the outcome of
+ * that request, the circuit closes again or stays open for another period.
+ */
+class CircuitBreaker
+{
+  public:
+    /** \brief state of the circuit for a single host */
+    enum class State
+    {
+      closed,   /**< requests are allowed */
+      open,     /**< requests are blocked */
+      halfOpen  /**< a single test request is allowed */
+    };
+
+
+    /** \brief permission to perform a request, as returned by allowRequest()
+     */
+    struct Permit
+    {
+      bool allowed = false; /**< whether the request may be performed */
+      bool probe = false; /**< whether the request is the test request of a half-open circuit */
+      uint64_t generation = 0; /**< generation of the circuit when the request was allowed */
+
+      /** \brief Checks whether the request may be performed.
+       *
+       * \return Returns true, if the request may be performed.
+       */
+      explicit operator bool() const
+      {
+        return allowed;
+      }
+    }; // struct
+
+
+    /** \brief number of recent requests that are taken into account
+     */
+    static constexpr unsigned int N = 20;
+
+
+    /** \brief Constructor.
+     *
+     * \param minimumRequests  minimum number of recent requests to a host
+     *                         before its circuit may open
+     * \param failurePercentage  share of failed requests in percent that
+     *                           opens the circuit
+     * \param openDuration   time that a circuit stays open before a test
+     *                       request is allowed
+     */
+    CircuitBreaker(const unsigned int minimumRequests, const unsigned int failurePercentage,
+                   const std::chrono::milliseconds& openDuration);
+
+
+    CircuitBreaker(const CircuitBreaker& other) = delete;
+    CircuitBreaker& operator=(const CircuitBreaker& other) = delete;
+
+
+    /** \brief Gets the circuit breaker that is used for requests to the
+     *         external APIs of the plugins.
+     *
+     * \return Returns a reference to the shared circuit breaker.
+     */
+    static CircuitBreaker& upstreams();
+
+
+    /** \brief Extracts the host name from a URL.
+     *
+     * \param url  the URL, e. g. "https://example.com:8080/path"
+     * \return Returns the host name in lower case, e. g. "example.com".
+     *         Returns an empty string, if the URL contains no host.
+     */
+    static std::string hostOf(const std::string_view& url);
+
+
+    /** \brief Checks whether a request to a host may be performed and
+     *         registers the request, if so.
+     *
+     * \param host  name of the host
+     * \return Returns a permit that converts to true, if the request may be
+     *         performed. In that case its outcome has to be reported via
+     *         record() or release() afterwards, together with the permit.
+     *         Returns a permit that converts to false, if the circuit of the
+     *         host is open.
+     */
+    Permit allowRequest(const std::string& host);
+
+
+    /** \brief Reports the outcome of a request that was allowed by
+     *         allowRequest().
+     *
+     * \param host     name of the host
+     * \param permit   the permit that allowRequest() returned for the request
+     * \param success  whether the request succeeded
+     * \remarks While the circuit is open, only the outcome of the test
+     *          request may change it. Outcomes of requests that started
+     *          before the circuit opened or closed are ignored.
+     */
+    void record(const std::string& host, const Permit& permit, const bool success);
+
+
+    /** \brief Withdraws a request that was allowed by allowRequest(), but
+     *         was aborted by the bot itself, e. g. because its deadline was
+     *         cancelled. No outcome is recorded for such a request.
+     *
+     * \param host    name of the host
+     * \param permit  the permit that allowRequest() returned for the request
+     */
+    void release(const std::string& host, const Permit& permit);
+
+
+    /** \brief Gets the current state of the circuit of a host.
+     *
+     * \param host  name of the host
+     * \return Returns the state of the circuit. An open circuit whose
+     *         cool-down period is over is reported as half-open.
+     */
+    State state(const std::string& host) const;
+
+
+    /** \brief Checks whether requests to a host are currently possible.
+     *
+     * \param host  name of the host
+     * \return Returns true, if the circuit of the host is not open.
+     * \remarks This does not register a request, i. e. it is only a hint.
+     */
+    bool available(const std::string& host) const;
+  private:
+    /** state of a single host */
+    struct Circuit
+    {
+      std::bitset<N> failures; /**< failure flags of recent requests */
+      unsigned int requests = 0; /**< number of recorded requests, up to N */
+      unsigned int offset = 0; /**< next position in failures */
+      bool open = false; /**< whether the circuit is open or half-open */
+      bool probing = false; /**< whether the test request is running */
+      uint64_t generation = 0; /**< incremented whenever the circuit opens or closes */
+      std::chrono::steady_clock::time_point openedAt; /**< time when the circuit opened */
+    }; // struct
+
+    /** \brief Determines the state of a circuit.
+     *
+     * \param circuit  the circuit
+     * \param now      the current time
+     * \return Returns the state of the circuit.
+     */
+    State stateOf(const Circuit& circuit, const std::chrono::steady_clock::time_point& now) const;
+
+    unsigned int minRequests; /**< minimum number of requests before the circuit may open */
+    unsigned int percentage; /**< share of failures in percent that opens the circuit */
+    std::chrono::milliseconds coolDown; /**< time that a circuit stays open */
+    std::unordered_map<std::string, Circuit> circuits; /**< circuits by host */
+    mutable std::mutex mutex; /**< protects circuits */
+}; // class
+
+} // namespace
+
+#endif // BVN_CIRCUITBREAKER_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2017, 2021, 2022, 2023  Dirk Stolle
+    Copyright (C) 2015, 2016, 2017, 2021, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,12 +20,18 @@
 
 #include "Curly.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <type_traits>
 #include <curl/curl.h>
+#include "../util/Deadline.hpp"
+#include "../util/SingleFlight.hpp"
+#include "CircuitBreaker.hpp"
+#include "HttpCache.hpp"
 
 size_t writeCallbackString(char *ptr, size_t size, size_t nmemb, void *userdata)
 {
@@ -83,6 +89,50 @@ size_t readCallbackString(char *buffer, size_t size, size_t nitems, void *instre
   return chunkSize;
 }
 
+/** \brief read callback that takes the request body from a Curly::BodySource
+ *
+ * \param instream  pointer to the Curly::BodySource
+ * \return Returns the number of bytes copied to buffer, or CURL_READFUNC_ABORT.
+ */
+size_t readCallbackSource(char *buffer, size_t size, size_t nitems, void *instream)
+{
+  const auto maxSize = size * nitems;
+  if (nullptr == instream)
+  {
+    std::cerr << "Error: read callback received null pointer!" << std::endl;
+    return CURL_READFUNC_ABORT;
+  }
+  const Curly::BodySource * source = reinterpret_cast<const Curly::BodySource*>(instream);
+  const std::size_t chunkSize = (*source)(buffer, maxSize);
+  if (chunkSize == Curly::source_abort)
+    return CURL_READFUNC_ABORT;
+  return std::min(chunkSize, maxSize);
+}
+
+/** \brief data that the write callback for a response sink needs */
+struct SinkData
+{
+  CURL * handle; /**< handle of the transfer */
+  Curly * instance; /**< the Curly instance that performs the transfer */
+  bool started; /**< whether data was received already */
+};
+
+/** \brief progress callback that aborts the transfer when the deadline expires
+ *
+ * \param clientp  pointer to the bvn::Deadline of the request
+ * \return Returns zero to continue the transfer, or a non-zero value to abort.
+ */
+int progressCallbackDeadline(void *clientp, curl_off_t /* dltotal */, curl_off_t /* dlnow */,
+                             curl_off_t /* ultotal */, curl_off_t /* ulnow */)
+{
+  const bvn::Deadline * deadline = reinterpret_cast<const bvn::Deadline*>(clientp);
+  if (nullptr == deadline)
+    return 0;
+  return deadline->expired() ? 1 : 0;
+}
+
+const std::size_t Curly::source_abort = std::numeric_limits<std::size_t>::max();
+
 Curly::Curly()
 : m_URL(""),
   m_PostFields(std::unordered_map<std::string, std::string>()),
@@ -96,7 +146,18 @@ Curly::Curly()
   m_followRedirects(false),
   m_maxRedirects(-1),
   m_ResponseHeaders(std::vector<std::string>()),
-  m_MaxUpstreamSpeed(0)
+  m_MaxUpstreamSpeed(0),
+  m_TimedOut(false),
+  m_Breaker(nullptr),
+  m_CircuitOpen(false),
+  m_Cache(nullptr),
+  m_FromCache(false),
+  m_Coalesce(false),
+  m_PostSource(nullptr),
+  m_PostSourceSize(0),
+  m_UsePostSource(false),
+  m_Sink(nullptr),
+  m_ExpectedSize(-1)
 {
 }
 
@@ -116,7 +177,7 @@ bool Curly::addPostField(const std::string& name, const std::string& value)
   /*Perform some checks before adding the post field:
     No empty names, avoid conflict with file field names, and do not set it, if
     we already have a plain post body. */
-  if (!name.empty() && !m_UsePostBody)
+  if (!name.empty() && !m_UsePostBody && !m_UsePostSource)
   {
     m_PostFields[name] = value;
     return true;
@@ -155,7 +216,7 @@ bool Curly::addHeader(const std::string& header)
 bool Curly::setPostBody(const std::string& body)
 {
   // avoid conflicts with post fields (and files, if the code would still support it) and PUT data
-  if (m_PostFields.empty() && !m_UsePutData)
+  if (m_PostFields.empty() && !m_UsePutData && !m_UsePostSource)
   {
     m_PostBody = body;
     /* Checking for non-empty post body would be good enough for most cases, but
@@ -171,7 +232,7 @@ bool Curly::setPostBody(const std::string& body)
 bool Curly::setPutData(const std::string& data)
 {
   // avoid conflicts with post fields (and files, if the code would still support it) and POST body
-  if (m_PostFields.empty() && !m_UsePostBody)
+  if (m_PostFields.empty() && !m_UsePostBody && !m_UsePostSource)
   {
     m_PutData = data;
     /* Checking for non-empty put data would be good enough for most cases, but
@@ -184,6 +245,30 @@ bool Curly::setPutData(const std::string& data)
     return false;
 }
 
+bool Curly::setPostSource(BodySource source, const long long size)
+{
+  // avoid conflicts with post fields, POST body and PUT data
+  if (m_PostFields.empty() && !m_UsePostBody && !m_UsePutData && source && (size >= 0))
+  {
+    m_PostSource = std::move(source);
+    m_PostSourceSize = size;
+    m_UsePostSource = true;
+    return true;
+  }
+  else
+    return false;
+}
+
+void Curly::setResponseSink(BodySink sink)
+{
+  m_Sink = std::move(sink);
+}
+
+long long Curly::expectedBodySize() const
+{
+  return m_ExpectedSize;
+}
+
 bool Curly::limitUpstreamSpeed(const unsigned int maxBytesPerSecond)
 {
   if constexpr(std::numeric_limits<decltype(maxBytesPerSecond)>::max() > std::numeric_limits<curl_off_t>::max())
@@ -218,12 +303,161 @@ void Curly::setMaximumRedirects(const long int maxRedirect)
     m_maxRedirects = -1; //map all negative values to -1
 }
 
+bool Curly::coalescesRequests() const
+{
+  return m_Coalesce;
+}
+
+void Curly::coalesceRequests(const bool coalesce)
+{
+  m_Coalesce = coalesce;
+}
+
+namespace
+{
+
+/** \brief outcome of a request that is shared by coalesced requests */
+struct RequestOutcome
+{
+  bool success = false; /**< return value of perform() */
+  std::string response; /**< response body */
+  long responseCode = 0; /**< response code */
+  std::string contentType; /**< content type */
+  std::vector<std::string> headers; /**< response headers */
+  bool timedOut = false; /**< whether the deadline expired */
+  bool circuitOpen = false; /**< whether the circuit breaker blocked the request */
+  bool fromCache = false; /**< whether the response came from the cache */
+};
+
+/** \brief gets the requests that are currently running with coalescing enabled
+ *
+ * \return Returns the shared set of running requests.
+ */
+bvn::SingleFlight<RequestOutcome>& runningRequests()
+{
+  static bvn::SingleFlight<RequestOutcome> requests;
+  return requests;
+}
+
+} // namespace
+
+std::string Curly::requestKey() const
+{
+  std::string method("GET");
+  std::string body;
+  if (m_UsePutData)
+  {
+    method = "PUT";
+    body = m_PutData;
+  }
+  else if (m_UsePostBody)
+  {
+    method = "POST";
+    body = m_PostBody;
+  }
+  else if (!m_PostFields.empty())
+  {
+    method = "POST";
+    std::vector<std::string> fields;
+    for (const auto& [name, value]: m_PostFields)
+    {
+      fields.push_back(name + "=" + value);
+    }
+    std::sort(fields.begin(), fields.end());
+    for (const auto& field: fields)
+    {
+      body.append(field).append(1, '&');
+    }
+  }
+  std::vector<std::string> headers(m_headers);
+  std::sort(headers.begin(), headers.end());
+  std::string key = method + " " + m_URL + "\n";
+  for (const auto& h: headers)
+  {
+    key.append(h).append(1, '\n');
+  }
+  return key + std::to_string(body.size()) + ":" + std::to_string(std::hash<std::string>{}(body));
+}
+
 bool Curly::perform(std::string& response)
+{
+  //streamed transfers cannot be shared
+  if (!m_Coalesce || m_Sink || m_UsePostSource)
+    return performRequest(response);
+
+  //identical requests that run at the same time share one transfer
+  const auto outcome = runningRequests().run(requestKey(), [this]()
+  {
+    RequestOutcome result;
+    result.success = performRequest(result.response);
+    result.responseCode = m_LastResponseCode;
+    result.contentType = m_LastContentType;
+    result.headers = m_ResponseHeaders;
+    result.timedOut = m_TimedOut;
+    result.circuitOpen = m_CircuitOpen;
+    result.fromCache = m_FromCache;
+    return result;
+  });
+  if (!outcome.has_value())
+  {
+    std::cerr << "Error: Deadline expired while waiting for identical request to "
+              << m_URL << "." << std::endl;
+    m_TimedOut = true;
+    m_CircuitOpen = false;
+    m_FromCache = false;
+    bvn::Deadline::current().cancel();
+    return false;
+  }
+  m_LastResponseCode = outcome.value().responseCode;
+  m_LastContentType = outcome.value().contentType;
+  m_ResponseHeaders = outcome.value().headers;
+  m_TimedOut = outcome.value().timedOut;
+  m_CircuitOpen = outcome.value().circuitOpen;
+  m_FromCache = outcome.value().fromCache;
+  response = outcome.value().response;
+  return outcome.value().success;
+}
+
+bool Curly::performRequest(std::string& response)
 {
   //"minimum" URL should be something like "http://a.bc"
   if (m_URL.size() < 11)
     return false;
 
+  //request must not take longer than the current deadline of the thread
+  m_TimedOut = false;
+  m_CircuitOpen = false;
+  m_FromCache = false;
+  m_ExpectedSize = -1;
+
+  //serve fresh responses to GET requests from the cache
+  const bool cacheable = (m_Cache != nullptr) && m_PostFields.empty() && !m_UsePostBody
+                      && !m_UsePutData && !m_UsePostSource && !m_Sink;
+  const std::string cacheKey = cacheable ? bvn::HttpCache::key(m_URL, m_headers) : std::string();
+  std::optional<bvn::HttpCache::Entry> cached;
+  if (cacheable)
+  {
+    cached = m_Cache->get(cacheKey);
+    if (cached.has_value() && cached.value().fresh(std::chrono::system_clock::now()))
+    {
+      m_LastResponseCode = 200;
+      m_LastContentType = cached.value().contentType;
+      m_FromCache = true;
+      response = std::move(cached.value().body);
+      return true;
+    }
+  }
+
+  bvn::Deadline deadline = bvn::Deadline::current();
+  if (deadline.expired())
+  {
+    std::cerr << "Error: Request to " << m_URL << " was not started, because "
+              << "its deadline has already expired." << std::endl;
+    m_TimedOut = true;
+    deadline.cancel();
+    return false;
+  }
+
   //initialize cURL
   #ifdef DEBUG_MODE
   std::clog << "curl_easy_init()..." << std::endl;
@@ -271,6 +505,41 @@ bool Curly::perform(std::string& response)
     return false;
   }
 
+  //map remaining time of the deadline to cURL timeouts
+  if (deadline.limited())
+  {
+    const long remaining_ms = static_cast<long>(deadline.remaining().count());
+    retCode = curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, remaining_ms);
+    if (retCode != CURLE_OK)
+    {
+      std::cerr << "cURL error: setting timeout failed!" << std::endl;
+      std::cerr << curl_easy_strerror(retCode) << std::endl;
+      curl_easy_cleanup(handle);
+      return false;
+    }
+    retCode = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, remaining_ms);
+    if (retCode != CURLE_OK)
+    {
+      std::cerr << "cURL error: setting connection timeout failed!" << std::endl;
+      std::cerr << curl_easy_strerror(retCode) << std::endl;
+      curl_easy_cleanup(handle);
+      return false;
+    }
+  } //if deadline has a time limit
+  //abort transfer via progress callback, if deadline gets cancelled
+  retCode = curl_easy_setopt(handle, CURLOPT_XFERINFOFUNCTION, progressCallbackDeadline);
+  if (retCode == CURLE_OK)
+    retCode = curl_easy_setopt(handle, CURLOPT_XFERINFODATA, &deadline);
+  if (retCode == CURLE_OK)
+    retCode = curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L);
+  if (retCode != CURLE_OK)
+  {
+    std::cerr << "cURL error: setting progress function failed!" << std::endl;
+    std::cerr << curl_easy_strerror(retCode) << std::endl;
+    curl_easy_cleanup(handle);
+    return false;
+  }
+
   #if CURL_AT_LEAST_VERSION(7, 54, 0)
   // In curl 7.54.0 and later, the CURLOPT_SSLVERSION option can be used to set
   // the minimal SSL / TLS version to use. CURLOPT_SSLVERSION has been available
@@ -327,14 +596,22 @@ bool Curly::perform(std::string& response)
     } //if redirect limit is given
   } //if redirects are followed
 
-  //add custom headers
+  //add custom headers, and validators of a stale cached response
+  std::vector<std::string> requestHeaders(m_headers);
+  if (cached.has_value())
+  {
+    if (!cached.value().etag.empty())
+      requestHeaders.push_back("If-None-Match: " + cached.value().etag);
+    if (!cached.value().lastModified.empty())
+      requestHeaders.push_back("If-Modified-Since: " + cached.value().lastModified);
+  }
   struct curl_slist * header_list = nullptr;
-  if (!m_headers.empty())
+  if (!requestHeaders.empty())
   {
     #ifdef DEBUG_MODE
     std::clog << "adding headers with curl_slist_append() ..." << std::endl;
     #endif // DEBUG_MODE
-    for(auto const & h: m_headers)
+    for(auto const & h: requestHeaders)
     {
       header_list = curl_slist_append(header_list, h.c_str());
       if (nullptr == header_list)
@@ -492,8 +769,32 @@ bool Curly::perform(std::string& response)
     }
   } // if PUT data
 
+  //set post body source - but only if other POST stuff is empty
+  if (m_UsePostSource && m_PostFields.empty())
+  {
+    retCode = curl_easy_setopt(handle, CURLOPT_POST, 1L);
+    if (retCode == CURLE_OK)
+      retCode = curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(m_PostSourceSize));
+    if (retCode == CURLE_OK)
+      retCode = curl_easy_setopt(handle, CURLOPT_READFUNCTION, readCallbackSource);
+    if (retCode == CURLE_OK)
+      retCode = curl_easy_setopt(handle, CURLOPT_READDATA, (void *) &m_PostSource);
+    if (retCode != CURLE_OK)
+    {
+      std::cerr << "cURL error: setting POST body source for Curly::perform failed! Error: "
+                << curl_easy_strerror(retCode) << std::endl;
+      curl_slist_free_all(header_list);
+      header_list = nullptr;
+      curl_easy_cleanup(handle);
+      return false;
+    }
+  } //if post body source
+
   //set write callback
-  retCode = curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeCallbackString);
+  if (m_Sink)
+    retCode = curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, Curly::sinkCallback);
+  else
+    retCode = curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeCallbackString);
   if (retCode != CURLE_OK)
   {
     std::cerr << "curl_easy_setopt() of Curly::perform could not set write function! Error: "
@@ -503,9 +804,13 @@ bool Curly::perform(std::string& response)
     curl_easy_cleanup(handle);
     return false;
   }
-  //provide string stream for the data
+  //provide string stream for the data, or pass it to the sink
   std::string string_data("");
-  retCode = curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void *)&string_data);
+  SinkData sinkData = { handle, this, false };
+  if (m_Sink)
+    retCode = curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void *)&sinkData);
+  else
+    retCode = curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void *)&string_data);
   if (retCode != CURLE_OK)
   {
     std::cerr << "curl_easy_setopt() of Curly::perform could not set write data! Error: "
@@ -520,9 +825,50 @@ bool Curly::perform(std::string& response)
   #ifdef DEBUG_MODE
   std::clog << "calling cURL easy perform..." << std::endl;
   #endif
+  const std::string host = (m_Breaker != nullptr) ? bvn::CircuitBreaker::hostOf(m_URL) : std::string();
+  bvn::CircuitBreaker::Permit permit;
+  if (m_Breaker != nullptr)
+    permit = m_Breaker->allowRequest(host);
+  if ((m_Breaker != nullptr) && !permit)
+  {
+    std::cerr << "Error: Request to " << host << " was not performed, "
+              << "because the host seems to be unavailable." << std::endl;
+    m_CircuitOpen = true;
+    curl_slist_free_all(header_list);
+    header_list = nullptr;
+    curl_easy_cleanup(handle);
+    return false;
+  }
   retCode = curl_easy_perform(handle);
+  if (m_Breaker != nullptr)
+  {
+    //Transfers that were aborted locally, i. e. by a cancelled or expired
+    //deadline or by a response sink that refused the data, say nothing about
+    //the health of the host. The same goes for timeouts, if they were derived
+    //from the remaining time of the deadline.
+    if ((retCode == CURLE_ABORTED_BY_CALLBACK) || (retCode == CURLE_WRITE_ERROR)
+        || ((retCode == CURLE_OPERATION_TIMEDOUT) && deadline.limited()))
+    {
+      m_Breaker->release(host, permit);
+    }
+    else
+    {
+      long code = 0;
+      if (retCode == CURLE_OK)
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &code);
+      //server errors and rate limits count as failures, too
+      m_Breaker->record(host, permit, (retCode == CURLE_OK) && (code < 500) && (code != 429));
+    }
+  }
   if (retCode != CURLE_OK)
   {
+    m_TimedOut = ((retCode == CURLE_OPERATION_TIMEDOUT) && deadline.limited())
+              || ((retCode == CURLE_ABORTED_BY_CALLBACK) && deadline.expired());
+    if (m_TimedOut)
+    {
+      // Signal the timeout to everyone who shares the deadline.
+      deadline.cancel();
+    }
     std::cerr << "curl_easy_perform() of Curly::perform failed! Error: "
               << curl_easy_strerror(retCode) << std::endl;
     curl_slist_free_all(header_list);
@@ -565,13 +911,60 @@ bool Curly::perform(std::string& response)
   if (contType == nullptr)
     m_LastContentType.erase();
   else
-    m_LastContentType = std::string(m_LastContentType);
+    m_LastContentType = std::string(contType);
 
   curl_easy_cleanup(handle);
+
+  if (cacheable)
+  {
+    const auto now = std::chrono::system_clock::now();
+    if ((m_LastResponseCode == 304) && cached.has_value())
+    {
+      //server confirmed that the cached response is still valid
+      bvn::HttpCache::revalidated(cached.value(), m_ResponseHeaders, now);
+      m_Cache->put(cacheKey, cached.value());
+      m_LastResponseCode = 200;
+      m_LastContentType = cached.value().contentType;
+      m_FromCache = true;
+      string_data = std::move(cached.value().body);
+    }
+    else if (m_LastResponseCode == 200)
+    {
+      const auto entry = bvn::HttpCache::fromResponse(string_data, m_LastContentType, m_ResponseHeaders, now);
+      if (entry.has_value())
+        m_Cache->put(cacheKey, entry.value());
+    }
+  } //if response may be cached
+
   response = std::move(string_data);
   return true;
 }
 
+bool Curly::timedOut() const
+{
+  return m_TimedOut;
+}
+
+void Curly::setCircuitBreaker(bvn::CircuitBreaker* breaker)
+{
+  m_Breaker = breaker;
+}
+
+bool Curly::circuitOpen() const
+{
+  return m_CircuitOpen;
+}
+
+void Curly::setHttpCache(bvn::HttpCache* cache)
+{
+  m_Cache = cache;
+}
+
+bool Curly::fromCache() const
+{
+  return m_FromCache;
+}
+
 long Curly::getResponseCode() const
 {
   return m_LastResponseCode;
@@ -660,6 +1053,35 @@ size_t Curly::headerCallback(char* buffer, size_t size, size_t nitems, void* use
   return actualSize;
 }
 
+size_t Curly::sinkCallback(char* ptr, size_t size, size_t nmemb, void* userdata)
+{
+  const size_t actualSize = size * nmemb;
+  if (nullptr == userdata)
+  {
+    std::cerr << "Error: write callback received null pointer!" << std::endl;
+    return 0;
+  }
+  SinkData * sd = reinterpret_cast<SinkData*>(userdata);
+  if (!sd->started)
+  {
+    //make status and size of the response available to the sink
+    sd->started = true;
+    curl_easy_getinfo(sd->handle, CURLINFO_RESPONSE_CODE, &sd->instance->m_LastResponseCode);
+    #if CURL_AT_LEAST_VERSION(7, 55, 0)
+    curl_off_t length = -1;
+    if (curl_easy_getinfo(sd->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) == CURLE_OK)
+      sd->instance->m_ExpectedSize = length;
+    #else
+    double length = -1.0;
+    if (curl_easy_getinfo(sd->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length) == CURLE_OK)
+      sd->instance->m_ExpectedSize = static_cast<long long>(length);
+    #endif
+  }
+  if (!sd->instance->m_Sink(std::string_view(ptr, actualSize)))
+    return 0;
+  return actualSize;
+}
+
 void Curly::addResponseHeader(std::string respHeader)
 {
   //erase leading whitespaces
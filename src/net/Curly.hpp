@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of scan-tool.
-    Copyright (C) 2015, 2016, 2017  Dirk Stolle
+    Copyright (C) 2015, 2016, 2017, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -21,10 +21,18 @@
 #ifndef SCANTOOL_CURLY_HPP
 #define SCANTOOL_CURLY_HPP
 
+#include <functional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+namespace bvn
+{
+  class CircuitBreaker;
+  class HttpCache;
+}
+
 extern "C"
 {
   /** \brief write callback for cURL functions
@@ -39,6 +47,30 @@ extern "C"
 class Curly
 {
   public:
+    /** \brief function that receives the response body in pieces while it is
+     *         downloaded
+     *
+     * \remarks The function returns true to continue the transfer, or false to
+     *          abort it.
+     */
+    using BodySink = std::function<bool(const std::string_view& data)>;
+
+
+    /** \brief function that provides the request body in pieces while it is
+     *         uploaded
+     *
+     * \remarks The function copies at most size bytes to buffer and returns
+     *          the number of copied bytes. Zero means that the body is
+     *          complete, source_abort aborts the transfer.
+     */
+    using BodySource = std::function<std::size_t(char* buffer, const std::size_t size)>;
+
+
+    /** \brief return value of a BodySource that aborts the transfer
+     */
+    static const std::size_t source_abort;
+
+
     ///default constructor
     Curly();
 
@@ -114,6 +146,45 @@ class Curly
     bool setPutData(const std::string& data);
 
 
+    /** \brief Define a function that provides the body of a HTTP POST request
+     *         while it is sent.
+     *
+     * \param source  function that provides the body
+     * \param size    total size of the body in bytes
+     * \remarks This will only work, if no post fields, no POST body and no
+     * PUT data have been set. Use this instead of setPostBody(), if the body
+     * is not completely available when the request starts, e. g. because it
+     * is still downloaded from somewhere else.
+     * \return Returns true, if the body source was set.
+     *         Returns false, if the body source could not be set.
+     */
+    bool setPostSource(BodySource source, const long long size);
+
+
+    /** \brief Define a function that receives the response body while it is
+     *         downloaded.
+     *
+     * \param sink  function that receives the body; an empty function means
+     *              that perform() returns the body in its parameter (default)
+     * \remarks If a sink is set, the response parameter of perform() stays
+     *          empty, and neither the HTTP cache nor request coalescing are
+     *          used. When the sink is called, getResponseCode() and
+     *          expectedBodySize() already return the values of the current
+     *          response.
+     */
+    void setResponseSink(BodySink sink);
+
+
+    /** \brief gets the size of the response body as announced by the server
+     *
+     * \return Returns the value of the Content-Length header of the response.
+     *         Returns -1, if it is unknown.
+     * \remarks This value is only set while a response sink receives data,
+     *          see setResponseSink().
+     */
+    long long expectedBodySize() const;
+
+
     /** \brief limits the speed of an upload operation
      *
      * \param maxBytesPerSecond  limit in bytes per second
@@ -166,6 +237,29 @@ class Curly
     void setMaximumRedirects(const long int maxRedirect);
 
 
+    /** \brief checks whether Curly shares identical concurrent requests
+     *
+     * \return Returns true, if perform() coalesces identical requests.
+     * \remarks Default behaviour is not to coalesce requests.
+     */
+    bool coalescesRequests() const;
+
+
+    /** \brief changes whether identical requests that run at the same time
+     *         share one transfer
+     *
+     * \param coalesce  Set this to true, if Curly shall coalesce requests.
+     *                  False (default) means that every call of perform()
+     *                  makes its own request.
+     * \remarks Requests are identical, if method, URL, headers and body are
+     *          the same. If such a request of another Curly instance with
+     *          coalescing enabled is already running, perform() waits for
+     *          its result instead of making a new request. Only use this for
+     *          requests that do not change anything on the server.
+     */
+    void coalesceRequests(const bool coalesce);
+
+
     /** \brief performs the (POST) request
      *
      * \param response  reference to a string that will be filled with the
@@ -197,6 +291,57 @@ class Curly
     const std::string& getContentType() const;
 
 
+    /** \brief checks whether the last request failed due to a deadline
+     *
+     * \return Returns true, if the last request was aborted or not even
+     *         started, because the current deadline of the calling thread
+     *         expired or was cancelled. Returns false otherwise.
+     * \remarks perform() limits the duration of each request by the current
+     *          deadline of the calling thread, see bvn::Deadline::current().
+     *          If a request runs into that limit, the deadline is cancelled.
+     */
+    bool timedOut() const;
+
+
+    /** \brief sets the circuit breaker that guards requests of this instance
+     *
+     * \param breaker  pointer to the circuit breaker to use; nullptr (default)
+     *                 means that no circuit breaker is used
+     * \remarks The circuit breaker must outlive the Curly instance.
+     */
+    void setCircuitBreaker(bvn::CircuitBreaker* breaker);
+
+
+    /** \brief checks whether the last request was blocked by the circuit breaker
+     *
+     * \return Returns true, if the last request was not performed, because
+     *         the circuit breaker considers the host to be unavailable.
+     *         Returns false otherwise.
+     */
+    bool circuitOpen() const;
+
+
+    /** \brief sets the HTTP cache that is used for GET requests of this instance
+     *
+     * \param cache  pointer to the cache to use; nullptr (default) means that
+     *               no cache is used
+     * \remarks The cache must outlive the Curly instance. Only GET requests,
+     *          i. e. requests without POST fields, POST body or PUT data, are
+     *          cached.
+     */
+    void setHttpCache(bvn::HttpCache* cache);
+
+
+    /** \brief checks whether the response of the last request came from the cache
+     *
+     * \return Returns true, if the last request was answered from the HTTP
+     *         cache, either because the cached response was fresh or because
+     *         the server confirmed it with 304 Not Modified.
+     *         Returns false otherwise.
+     */
+    bool fromCache() const;
+
+
     /** \brief structure to hold version information about the underlying cURL
      *         library
      */
@@ -235,6 +380,22 @@ class Curly
      */
     const std::vector<std::string>& responseHeaders() const;
   private:
+    /** \brief performs the request without coalescing
+     *
+     * \param response  reference to a string that will be filled with the
+     *                  request's response
+     * \return Returns true, if the request could be performed.
+     *         Returns false, if the request was not performed properly.
+     */
+    bool performRequest(std::string& response);
+
+    /** \brief gets a key that identifies the request for coalescing
+     *
+     * \return Returns a key consisting of method, URL, headers and a hash of
+     *         the request body.
+     */
+    std::string requestKey() const;
+
     /** \brief callback for response headers
      *
      * \param buffer   data of header (might not be NUL-terminated)
@@ -245,6 +406,16 @@ class Curly
      */
     static size_t headerCallback(char* buffer, size_t size, size_t nitems, void* userdata);
 
+    /** \brief write callback that passes the response body to the sink
+     *
+     * \param ptr      the received data (not NUL-terminated)
+     * \param size     size of an item
+     * \param nmemb    number of items
+     * \param userdata pointer to the transfer data of the request
+     * \return Returns the size of the processed data.
+     */
+    static size_t sinkCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
+
     /** \brief adds a new header to the list of response headers
      *
      * \param respHeader   the new header line
@@ -264,6 +435,17 @@ class Curly
     long int m_maxRedirects; /**< maximum number of redirects that Curly will follow */
     std::vector<std::string> m_ResponseHeaders; /**< response headers returned by the last request */
     unsigned int m_MaxUpstreamSpeed; /**< limit for upstream / upload in bytes per second */
+    bool m_TimedOut; /**< whether the last request failed due to the deadline */
+    bvn::CircuitBreaker* m_Breaker; /**< circuit breaker for requests, may be nullptr */
+    bool m_CircuitOpen; /**< whether the last request was blocked by the circuit breaker */
+    bvn::HttpCache* m_Cache; /**< HTTP cache for GET requests, may be nullptr */
+    bool m_FromCache; /**< whether the last response came from the cache */
+    bool m_Coalesce; /**< whether identical concurrent requests are coalesced */
+    BodySource m_PostSource; /**< function that provides the post body */
+    long long m_PostSourceSize; /**< size of the body from m_PostSource */
+    bool m_UsePostSource; /**< whether to use the post body source */
+    BodySink m_Sink; /**< function that receives the response body, may be empty */
+    long long m_ExpectedSize; /**< announced size of the response body, or -1 */
 }; //class Curly
 
 #endif // SCANTOOL_CURLY_HPP
@@ -0,0 +1,453 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "HttpCache.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include "../util/PersistentCache.hpp"
+
+namespace bvn
+{
+
+namespace
+{
+
+/** \brief namespace of the responses in the persistent cache
+ */
+const std::string cache_namespace = "http";
+
+/** \brief Converts a string to lower case.
+ *
+ * \param text  the string
+ * \return Returns the string in lower case (ASCII only).
+ */
+std::string lower(const std::string_view& text)
+{
+  std::string result(text);
+  std::transform(result.begin(), result.end(), result.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return result;
+}
+
+/** \brief Removes leading and trailing whitespace.
+ *
+ * \param text  the string
+ * \return Returns the string without leading and trailing whitespace.
+ */
+std::string_view trim(std::string_view text)
+{
+  while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+  {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+  {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+/** \brief Gets the header fields of the final response from a list of
+ *         header lines.
+ *
+ * \param lines  header lines, including status lines of redirects
+ * \return Returns a map of lower case header names to values. Repeated
+ *         headers are combined with commas.
+ */
+std::unordered_map<std::string, std::string> headerFields(const std::vector<std::string>& lines)
+{
+  auto start = lines.begin();
+  for (auto iter = lines.begin(); iter != lines.end(); ++iter)
+  {
+    if (iter->compare(0, 5, "HTTP/") == 0)
+    {
+      start = std::next(iter);
+    }
+  }
+
+  std::unordered_map<std::string, std::string> fields;
+  for (auto iter = start; iter != lines.end(); ++iter)
+  {
+    const auto colon = iter->find(':');
+    if ((colon == std::string::npos) || (colon == 0))
+    {
+      continue;
+    }
+    const std::string name = lower(trim(std::string_view(*iter).substr(0, colon)));
+    const std::string_view value = trim(std::string_view(*iter).substr(colon + 1));
+    auto& field = fields[name];
+    if (!field.empty())
+    {
+      field.append(", ");
+    }
+    field.append(value);
+  }
+  return fields;
+}
+
+/** \brief relevant directives of a Cache-Control header
+ */
+struct CacheControl
+{
+  bool present = false; /**< whether there was a Cache-Control header */
+  bool noStore = false; /**< no-store directive */
+  bool noCache = false; /**< no-cache directive */
+  std::optional<long long int> maxAge; /**< value of max-age directive */
+}; // struct
+
+/** \brief Parses the Cache-Control header.
+ *
+ * \param fields  header fields, see headerFields()
+ * \return Returns the directives of the header.
+ */
+CacheControl cacheControl(const std::unordered_map<std::string, std::string>& fields)
+{
+  CacheControl result;
+  const auto header = fields.find("cache-control");
+  if (header == fields.end())
+  {
+    return result;
+  }
+  result.present = true;
+  std::string_view rest = header->second;
+  while (!rest.empty())
+  {
+    const auto comma = rest.find(',');
+    const std::string_view directive = trim(rest.substr(0, comma));
+    rest = (comma == std::string_view::npos) ? std::string_view() : rest.substr(comma + 1);
+
+    const auto equals = directive.find('=');
+    const std::string name = lower(trim(directive.substr(0, equals)));
+    std::string value;
+    if (equals != std::string_view::npos)
+    {
+      value = trim(directive.substr(equals + 1));
+      value.erase(std::remove(value.begin(), value.end(), '"'), value.end());
+    }
+    if (name == "no-store")
+    {
+      result.noStore = true;
+    }
+    else if (name == "no-cache")
+    {
+      result.noCache = true;
+    }
+    else if ((name == "max-age") && !value.empty()
+             && std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); }))
+    {
+      // Values that do not fit are treated as a very long time.
+      result.maxAge = (value.size() > 9) ? 999999999 : std::atoll(value.c_str());
+    }
+  }
+  return result;
+}
+
+/** \brief Gets the value of a header field.
+ *
+ * \param fields  header fields, see headerFields()
+ * \param name    lower case name of the header
+ * \return Returns the value, or an empty string if the header is missing.
+ */
+std::string field(const std::unordered_map<std::string, std::string>& fields, const std::string& name)
+{
+  const auto iter = fields.find(name);
+  return (iter != fields.end()) ? iter->second : std::string();
+}
+
+/** \brief Calculates the time when a response becomes stale.
+ *
+ * \param fields        header fields of the response, see headerFields()
+ * \param control       directives of the Cache-Control header
+ * \param lastModified  value of the Last-Modified header, may be empty
+ * \param now           time when the response was received
+ * \return Returns the time when the response becomes stale.
+ */
+std::chrono::system_clock::time_point staleAt(const std::unordered_map<std::string, std::string>& fields,
+                                              const CacheControl& control, const std::string& lastModified,
+                                              const std::chrono::system_clock::time_point& now)
+{
+  using namespace std::chrono;
+
+  const auto date = HttpCache::parseDate(field(fields, "date")).value_or(now);
+
+  // freshness lifetime, see RFC 9111, section 4.2.1
+  seconds lifetime(0);
+  if (control.maxAge.has_value())
+  {
+    lifetime = seconds(control.maxAge.value());
+  }
+  else if (fields.find("expires") != fields.end())
+  {
+    // Invalid dates like "0" mean that the response is already expired.
+    const auto expires = HttpCache::parseDate(field(fields, "expires"));
+    if (expires.has_value())
+    {
+      lifetime = duration_cast<seconds>(expires.value() - date);
+    }
+  }
+  else
+  {
+    // heuristic freshness, see RFC 9111, section 4.2.2
+    const auto modified = HttpCache::parseDate(lastModified);
+    if (modified.has_value() && (modified.value() < date))
+    {
+      lifetime = std::min(duration_cast<seconds>(date - modified.value()) / 10, seconds(hours(24)));
+    }
+  }
+
+  // age of the response, see RFC 9111, section 4.2.3
+  seconds age = std::max(duration_cast<seconds>(now - date), seconds(0));
+  const std::string ageValue = field(fields, "age");
+  if (!ageValue.empty() && (ageValue.size() < 10)
+      && std::all_of(ageValue.begin(), ageValue.end(), [](unsigned char c) { return std::isdigit(c); }))
+  {
+    age = std::max(age, seconds(std::atoll(ageValue.c_str())));
+  }
+
+  return now + lifetime - age;
+}
+
+} // namespace
+
+const std::chrono::hours HttpCache::stale_retention = std::chrono::hours(24 * 7);
+
+bool HttpCache::Entry::fresh(const std::chrono::system_clock::time_point& now) const
+{
+  return !noCache && (now < expires);
+}
+
+bool HttpCache::Entry::validatable() const
+{
+  return !etag.empty() || !lastModified.empty();
+}
+
+HttpCache::HttpCache()
+: store(nullptr)
+{
+}
+
+HttpCache& HttpCache::upstreams()
+{
+  static HttpCache cache;
+  return cache;
+}
+
+void HttpCache::setStore(PersistentCache* cache)
+{
+  store = cache;
+}
+
+std::string HttpCache::key(const std::string& url, const std::vector<std::string>& headers)
+{
+  // Request headers like Accept or API keys may change the response.
+  std::vector<std::string> sorted(headers);
+  std::sort(sorted.begin(), sorted.end());
+  std::string result(url);
+  for (const auto& header: sorted)
+  {
+    result.append(1, '\n').append(header);
+  }
+  return result;
+}
+
+std::optional<HttpCache::Entry> HttpCache::get(const std::string& cacheKey)
+{
+  PersistentCache* cache = store;
+  if (cache == nullptr)
+  {
+    return std::nullopt;
+  }
+  const auto data = cache->get(cache_namespace, cacheKey);
+  if (!data.has_value())
+  {
+    return std::nullopt;
+  }
+  return deserialize(data.value());
+}
+
+void HttpCache::put(const std::string& cacheKey, const Entry& entry)
+{
+  PersistentCache* cache = store;
+  if (cache == nullptr)
+  {
+    return;
+  }
+  using namespace std::chrono;
+  seconds ttl = std::max(duration_cast<seconds>(entry.expires - system_clock::now()), seconds(0));
+  if (entry.validatable())
+  {
+    ttl += stale_retention;
+  }
+  if (ttl > seconds(0))
+  {
+    cache->put(cache_namespace, cacheKey, serialize(entry), ttl);
+  }
+}
+
+std::optional<HttpCache::Entry> HttpCache::fromResponse(const std::string& body, const std::string& contentType,
+                                                        const std::vector<std::string>& headers,
+                                                        const std::chrono::system_clock::time_point& now)
+{
+  const auto fields = headerFields(headers);
+  const CacheControl control = cacheControl(fields);
+  if (control.noStore || (trim(field(fields, "vary")) == "*"))
+  {
+    return std::nullopt;
+  }
+
+  Entry entry;
+  entry.body = body;
+  entry.contentType = contentType;
+  entry.etag = field(fields, "etag");
+  entry.lastModified = field(fields, "last-modified");
+  entry.noCache = control.noCache;
+  entry.expires = staleAt(fields, control, entry.lastModified, now);
+
+  // A response that is stale right away is only useful with a validator.
+  if (!entry.fresh(now) && !entry.validatable())
+  {
+    return std::nullopt;
+  }
+  return entry;
+}
+
+void HttpCache::revalidated(Entry& entry, const std::vector<std::string>& headers,
+                            const std::chrono::system_clock::time_point& now)
+{
+  const auto fields = headerFields(headers);
+  const CacheControl control = cacheControl(fields);
+  const std::string etag = field(fields, "etag");
+  if (!etag.empty())
+  {
+    entry.etag = etag;
+  }
+  const std::string lastModified = field(fields, "last-modified");
+  if (!lastModified.empty())
+  {
+    entry.lastModified = lastModified;
+  }
+  if (control.present)
+  {
+    entry.noCache = control.noCache;
+  }
+  entry.expires = staleAt(fields, control, entry.lastModified, now);
+}
+
+std::optional<std::chrono::system_clock::time_point> HttpCache::parseDate(const std::string_view& date)
+{
+  // IMF-fixdate, e. g. "Sun, 06 Nov 1994 08:49:37 GMT", see RFC 9110, 5.6.7
+  const auto comma = date.find(", ");
+  if (comma == std::string_view::npos)
+  {
+    return std::nullopt;
+  }
+  const std::string_view rest = trim(date.substr(comma + 2));
+  if ((rest.size() != 24) || (rest.substr(20) != " GMT") || (rest[2] != ' ')
+      || (rest[6] != ' ') || (rest[11] != ' ') || (rest[14] != ':') || (rest[17] != ':'))
+  {
+    return std::nullopt;
+  }
+  const auto number = [&rest](const std::size_t pos, const std::size_t length) -> int
+  {
+    int value = 0;
+    for (std::size_t i = pos; i < pos + length; ++i)
+    {
+      if (!std::isdigit(static_cast<unsigned char>(rest[i])))
+      {
+        return -1;
+      }
+      value = value * 10 + (rest[i] - '0');
+    }
+    return value;
+  };
+  static const std::string_view months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  const auto monthPos = months.find(rest.substr(3, 3));
+  if ((monthPos == std::string_view::npos) || (monthPos % 3 != 0))
+  {
+    return std::nullopt;
+  }
+  const int day = number(0, 2);
+  const int month = static_cast<int>(monthPos / 3) + 1;
+  int year = number(7, 4);
+  const int hour = number(12, 2);
+  const int minute = number(15, 2);
+  const int second = number(18, 2);
+  if ((day < 1) || (day > 31) || (year < 1970) || (hour < 0) || (hour > 23)
+      || (minute < 0) || (minute > 59) || (second < 0) || (second > 60))
+  {
+    return std::nullopt;
+  }
+
+  // days since 1970-01-01, algorithm by Howard Hinnant
+  year -= (month <= 2) ? 1 : 0;
+  const long long int era = year / 400;
+  const long long int yearOfEra = year - era * 400;
+  const long long int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const long long int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  const long long int days = era * 146097 + dayOfEra - 719468;
+
+  return std::chrono::system_clock::time_point(std::chrono::seconds(
+      days * 86400 + hour * 3600 + minute * 60 + second));
+}
+
+std::string HttpCache::serialize(const Entry& entry)
+{
+  const auto expires = std::chrono::duration_cast<std::chrono::seconds>(entry.expires.time_since_epoch()).count();
+  return std::string("1\n").append(entry.etag).append(1, '\n')
+      .append(entry.lastModified).append(1, '\n')
+      .append(entry.contentType).append(1, '\n')
+      .append(std::to_string(expires)).append(1, '\n')
+      .append(entry.noCache ? "1" : "0").append(1, '\n')
+      .append(entry.body);
+}
+
+std::optional<HttpCache::Entry> HttpCache::deserialize(const std::string_view& data)
+{
+  std::string_view fields[6];
+  std::string_view rest = data;
+  for (auto& f: fields)
+  {
+    const auto newline = rest.find('\n');
+    if (newline == std::string_view::npos)
+    {
+      return std::nullopt;
+    }
+    f = rest.substr(0, newline);
+    rest.remove_prefix(newline + 1);
+  }
+  if ((fields[0] != "1") || fields[4].empty() || (fields[4].size() > 18)
+      || !std::all_of(fields[4].begin(), fields[4].end(), [](unsigned char c) { return std::isdigit(c); }))
+  {
+    return std::nullopt;
+  }
+
+  Entry entry;
+  entry.etag = fields[1];
+  entry.lastModified = fields[2];
+  entry.contentType = fields[3];
+  entry.expires = std::chrono::system_clock::time_point(std::chrono::seconds(std::atoll(std::string(fields[4]).c_str())));
+  entry.noCache = fields[5] == "1";
+  entry.body = rest;
+  return entry;
+}
+
+} // namespace
@@ -0,0 +1,196 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_HTTPCACHE_HPP
+#define BVN_HTTPCACHE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bvn
+{
+
+// forward declaration
+class PersistentCache;
+
+/** \brief Private HTTP cache for GET requests that follows the rules of
+ *         RFC 9111 for freshness and validation.
+ *
+ * Fresh responses are served without any request. Stale responses that have
+ * a validator (ETag or Last-Modified) are validated with a conditional
+ * request; if the server answers with 304 Not Modified, the cached body is
+ * used again.
+ *
+ * Responses are kept in the namespace "http" of a persistent cache, so that
+ * they survive a restart. Its memory tier serves repeated requests without a
+ * database access, so there is no separate memory tier here.
+ */
+class HttpCache
+{
+  public:
+    /** \brief a cached response
+     */
+    struct Entry
+    {
+      std::string body; /**< body of the response */
+      std::string contentType; /**< value of the Content-Type header */
+      std::string etag; /**< value of the ETag header, may be empty */
+      std::string lastModified; /**< value of the Last-Modified header, may be empty */
+      std::chrono::system_clock::time_point expires; /**< time when the response becomes stale */
+      bool noCache = false; /**< whether the response must always be validated */
+
+      /** \brief Checks whether the response may be used without validation.
+       *
+       * \param now  the current time
+       * \return Returns true, if the response is fresh.
+       */
+      bool fresh(const std::chrono::system_clock::time_point& now) const;
+
+      /** \brief Checks whether the response can be validated.
+       *
+       * \return Returns true, if the response has an ETag or a Last-Modified
+       *         header.
+       */
+      bool validatable() const;
+    }; // struct
+
+
+    /** \brief Constructor. Nothing is cached until a store is set.
+     */
+    HttpCache();
+
+
+    HttpCache(const HttpCache& other) = delete;
+    HttpCache& operator=(const HttpCache& other) = delete;
+
+
+    /** \brief Gets the cache that is used for requests to the external APIs
+     *         of the plugins.
+     *
+     * \return Returns a reference to the shared cache.
+     */
+    static HttpCache& upstreams();
+
+
+    /** \brief Sets the store for responses.
+     *
+     * \param cache  the persistent cache that keeps the responses; nullptr
+     *               disables caching
+     * \remarks The persistent cache has to live as long as it is set.
+     */
+    void setStore(PersistentCache* cache);
+
+
+    /** \brief Builds the cache key of a request.
+     *
+     * \param url      URL of the request
+     * \param headers  additional request headers
+     * \return Returns the key for the request.
+     */
+    static std::string key(const std::string& url, const std::vector<std::string>& headers);
+
+
+    /** \brief Gets a cached response, regardless of whether it is fresh.
+     *
+     * \param cacheKey  key of the request, see key()
+     * \return Returns an optional containing the response, if one is cached.
+     *         Returns an empty optional otherwise.
+     */
+    std::optional<Entry> get(const std::string& cacheKey);
+
+
+    /** \brief Stores a response in the cache.
+     *
+     * \param cacheKey  key of the request, see key()
+     * \param entry     the response
+     */
+    void put(const std::string& cacheKey, const Entry& entry);
+
+
+    /** \brief Creates a cache entry from a response.
+     *
+     * \param body         body of the response
+     * \param contentType  content type of the response
+     * \param headers      header lines of the response, including the status
+     *                     line; only the headers after the last status line
+     *                     are used
+     * \param now          time when the response was received
+     * \return Returns an optional containing the entry, if the response may
+     *         be stored. Returns an empty optional otherwise.
+     * \remarks The caller has to check the status code, only responses with
+     *          status 200 should be stored.
+     */
+    static std::optional<Entry> fromResponse(const std::string& body, const std::string& contentType,
+                                             const std::vector<std::string>& headers,
+                                             const std::chrono::system_clock::time_point& now);
+
+
+    /** \brief Updates a cache entry with the headers of a 304 response.
+     *
+     * \param entry    the entry that was validated
+     * \param headers  header lines of the 304 response, see fromResponse()
+     * \param now      time when the response was received
+     */
+    static void revalidated(Entry& entry, const std::vector<std::string>& headers,
+                            const std::chrono::system_clock::time_point& now);
+
+
+    /** \brief Parses a date in the format used by HTTP, e. g.
+     *         "Sun, 06 Nov 1994 08:49:37 GMT".
+     *
+     * \param date  the date
+     * \return Returns an optional containing the parsed time.
+     *         Returns an empty optional, if the date is invalid.
+     */
+    static std::optional<std::chrono::system_clock::time_point> parseDate(const std::string_view& date);
+
+
+    /** \brief Converts an entry to a string for the store.
+     *
+     * \param entry  the entry
+     * \return Returns the serialized entry.
+     */
+    static std::string serialize(const Entry& entry);
+
+
+    /** \brief Converts a string from the store to an entry.
+     *
+     * \param data  the serialized entry, see serialize()
+     * \return Returns an optional containing the entry.
+     *         Returns an empty optional, if the data is invalid.
+     */
+    static std::optional<Entry> deserialize(const std::string_view& data);
+
+
+    /** \brief time that stale responses with a validator are kept
+     */
+    static const std::chrono::hours stale_retention;
+  private:
+    std::atomic<PersistentCache*> store; /**< keeps the responses, may be nullptr */
+}; // class
+
+} // namespace
+
+#endif // BVN_HTTPCACHE_HPP
@@ -0,0 +1,68 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "ActivityMeter.hpp"
+
+namespace bvn
+{
+
+ActivityMeter::ActivityMeter()
+: running(0),
+  lastBegin(),
+  mutex()
+{
+}
+
+ActivityMeter& ActivityMeter::commands()
+{
+  static ActivityMeter meter;
+  return meter;
+}
+
+void ActivityMeter::begin()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  ++running;
+  lastBegin = std::chrono::steady_clock::now();
+}
+
+void ActivityMeter::end()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (running > 0)
+  {
+    --running;
+  }
+}
+
+std::size_t ActivityMeter::active() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return running;
+}
+
+bool ActivityMeter::idle(const std::chrono::milliseconds& quiet) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  // lastBegin is the epoch of the steady clock, if nothing has started yet.
+  return (running == 0) && (std::chrono::steady_clock::now() - lastBegin >= quiet);
+}
+
+} // namespace
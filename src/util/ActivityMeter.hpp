@@ -0,0 +1,87 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_ACTIVITYMETER_HPP
+#define BVN_ACTIVITYMETER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace bvn
+{
+
+/** \brief Keeps track of running operations, so that background work can
+ *         wait for idle times.
+ */
+class ActivityMeter
+{
+  public:
+    /** \brief Constructor. Starts without any running operation.
+     */
+    ActivityMeter();
+
+
+    ActivityMeter(const ActivityMeter& other) = delete;
+    ActivityMeter& operator=(const ActivityMeter& other) = delete;
+
+
+    /** \brief Gets the meter for the commands that are handled by the bot.
+     *
+     * \return Returns a reference to the shared meter.
+     */
+    static ActivityMeter& commands();
+
+
+    /** \brief Notes the start of an operation.
+     */
+    void begin();
+
+
+    /** \brief Notes the end of an operation that was started with begin().
+     */
+    void end();
+
+
+    /** \brief Gets the number of running operations.
+     *
+     * \return Returns the number of operations that have begun, but not
+     *         ended yet.
+     */
+    std::size_t active() const;
+
+
+    /** \brief Checks whether there has been no activity for a while.
+     *
+     * \param quiet  time without a new operation that counts as idle
+     * \return Returns true, if no operation is running and no operation
+     *         was started within the given time.
+     */
+    bool idle(const std::chrono::milliseconds& quiet) const;
+  private:
+    std::size_t running; /**< number of running operations */
+    std::chrono::steady_clock::time_point lastBegin; /**< time when the latest operation started */
+    mutable std::mutex mutex; /**< protects running and lastBegin */
+}; // class
+
+} // namespace
+
+#endif // BVN_ACTIVITYMETER_HPP
@@ -0,0 +1,82 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "Arguments.hpp"
+#include "Strings.hpp"
+
+namespace bvn
+{
+
+Arguments::Arguments(const std::string_view& message, const std::string_view& command)
+: remaining(message.size() > command.size() ? trimmed(message.substr(command.size())) : std::string_view())
+{
+}
+
+Arguments::Arguments(const std::string_view& text)
+: remaining(trimmed(text))
+{
+}
+
+std::string_view Arguments::rest() const
+{
+  return remaining;
+}
+
+bool Arguments::empty() const
+{
+  return remaining.empty();
+}
+
+std::optional<std::string_view> Arguments::next()
+{
+  if (remaining.empty())
+  {
+    return std::nullopt;
+  }
+
+  std::string_view token;
+  const char first = remaining[0];
+  if ((first == '"') || (first == '\''))
+  {
+    const auto closing = remaining.find(first, 1);
+    if (closing != std::string_view::npos)
+    {
+      token = remaining.substr(1, closing - 1);
+      remaining = trimmed(remaining.substr(closing + 1));
+      return token;
+    }
+    // Unbalanced quote: treat it like any other character.
+  }
+
+  const auto end = remaining.find_first_of(" \t");
+  if (end == std::string_view::npos)
+  {
+    token = remaining;
+    remaining = std::string_view();
+  }
+  else
+  {
+    token = remaining.substr(0, end);
+    remaining = trimmed(remaining.substr(end));
+  }
+  return token;
+}
+
+} // namespace
@@ -0,0 +1,132 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_ARGUMENTS_HPP
+#define BVN_ARGUMENTS_HPP
+
+#include <charconv>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace bvn
+{
+
+/** \brief Non-owning view on the arguments that follow a bot command.
+ *
+ * No part of the message is ever copied. All string views returned by this
+ * class point into the original message, so the message has to outlive the
+ * Arguments instance and all views obtained from it.
+ */
+class Arguments
+{
+  public:
+    /** \brief Creates the arguments of a command message.
+     *
+     * \param message  the message without the command prefix, e. g. "deb mc"
+     * \param command  the command the message starts with, e. g. "deb"
+     */
+    Arguments(const std::string_view& message, const std::string_view& command);
+
+
+    /** \brief Creates the arguments from plain argument text.
+     *
+     * \param text   the text containing the arguments, e. g. "en de Hello"
+     */
+    explicit Arguments(const std::string_view& text);
+
+
+    /** \brief Gets the remaining (not yet consumed) text of the arguments.
+     *
+     * \return Returns the remaining text without leading and trailing
+     *         whitespace. Quotes are kept as they are.
+     */
+    std::string_view rest() const;
+
+
+    /** \brief Checks whether there are any remaining arguments.
+     *
+     * \return Returns true, if there are no more arguments.
+     *         Returns false otherwise.
+     */
+    bool empty() const;
+
+
+    /** \brief Gets the next argument and consumes it.
+     *
+     * \return Returns the next argument, if there is any.
+     *         Returns an empty optional, if all arguments have been consumed.
+     * \remarks Arguments are separated by spaces or tabulators. Text enclosed
+     *          in double quotes or single quotes is treated as one argument,
+     *          the quotes themselves are not part of the returned argument.
+     */
+    std::optional<std::string_view> next();
+
+
+    /** \brief Gets the next argument as integer number and consumes it.
+     *
+     * \return Returns the parsed number, if the next argument is a number that
+     *         fits into type T. Returns an empty optional otherwise.
+     * \remarks The argument is only consumed, if it could be parsed.
+     */
+    template<typename T>
+    std::optional<T> nextNumber()
+    {
+      const std::string_view before = remaining;
+      const auto token = next();
+      if (token.has_value())
+      {
+        const auto number = toNumber<T>(token.value());
+        if (number.has_value())
+        {
+          return number;
+        }
+      }
+      remaining = before;
+      return std::nullopt;
+    }
+
+
+    /** \brief Parses an integer number from a string.
+     *
+     * \param text   the text that contains the number and nothing else
+     * \return Returns the parsed number, if the whole text is a number that
+     *         fits into type T. Returns an empty optional otherwise.
+     */
+    template<typename T>
+    static std::optional<T> toNumber(const std::string_view& text)
+    {
+      static_assert(std::is_integral_v<T>, "T must be an integral type");
+      T value{};
+      const char* last = text.data() + text.size();
+      const auto [ptr, ec] = std::from_chars(text.data(), last, value);
+      if ((ec != std::errc()) || (ptr != last) || text.empty())
+      {
+        return std::nullopt;
+      }
+      return value;
+    }
+  private:
+    std::string_view remaining; /**< remaining, not yet consumed text */
+}; // class
+
+} // namespace
+
+#endif // BVN_ARGUMENTS_HPP
@@ -0,0 +1,117 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "Deadline.hpp"
+
+namespace bvn
+{
+
+// Plain pointer instead of a thread-local object, because thread-local
+// objects with non-trivial destructors are troublesome on some MinGW versions.
+thread_local const Deadline* currentDeadline = nullptr;
+
+Deadline::Deadline()
+: end(std::chrono::steady_clock::time_point::max()),
+  hasLimit(false),
+  cancelFlag(std::make_shared<std::atomic<bool>>(false)),
+  parent(nullptr)
+{
+}
+
+Deadline::Deadline(const std::chrono::milliseconds& budget)
+: end(std::chrono::steady_clock::now() + budget),
+  hasLimit(true),
+  cancelFlag(std::make_shared<std::atomic<bool>>(false)),
+  parent(nullptr)
+{
+}
+
+bool Deadline::limited() const
+{
+  return hasLimit;
+}
+
+std::chrono::milliseconds Deadline::remaining() const
+{
+  if (cancelled())
+  {
+    return std::chrono::milliseconds::zero();
+  }
+  if (!hasLimit)
+  {
+    return std::chrono::milliseconds::max();
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (now >= end)
+  {
+    return std::chrono::milliseconds::zero();
+  }
+  // Round up, so that a deadline which is not expired yet never claims to
+  // have zero milliseconds left.
+  return std::chrono::ceil<std::chrono::milliseconds>(end - now);
+}
+
+bool Deadline::expired() const
+{
+  return cancelled() || (hasLimit && std::chrono::steady_clock::now() >= end);
+}
+
+void Deadline::cancel()
+{
+  cancelFlag->store(true);
+}
+
+bool Deadline::cancelled() const
+{
+  return cancelFlag->load() || ((parent != nullptr) && parent->cancelled());
+}
+
+Deadline Deadline::child() const
+{
+  Deadline result;
+  result.end = end;
+  result.hasLimit = hasLimit;
+  result.parent = std::make_shared<const Deadline>(*this);
+  return result;
+}
+
+Deadline Deadline::current()
+{
+  if (currentDeadline == nullptr)
+  {
+    return Deadline();
+  }
+  return *currentDeadline;
+}
+
+Deadline::Scope::Scope(const Deadline& dl)
+: deadline(dl),
+  previous(currentDeadline)
+{
+  currentDeadline = &deadline;
+}
+
+Deadline::Scope::~Scope()
+{
+  currentDeadline = previous;
+}
+
+} // namespace
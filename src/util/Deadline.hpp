@@ -0,0 +1,157 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_DEADLINE_HPP
+#define BVN_DEADLINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace bvn
+{
+
+/** \brief Point in time after which an operation shall be given up.
+ *
+ * A deadline can also be cancelled before its time is over. Copies of a
+ * deadline share the cancellation state, so a deadline can be passed to other
+ * threads and be cancelled from the thread that created it.
+ *
+ * Each thread has a current deadline, which is set with Deadline::Scope.
+ * Long-running operations like HTTP requests use the current deadline of the
+ * calling thread to limit their duration.
+ */
+class Deadline
+{
+  public:
+    /** \brief Creates a deadline without any time limit.
+     */
+    Deadline();
+
+
+    /** \brief Creates a deadline that expires after the given time budget.
+     *
+     * \param budget  the time budget, counted from now
+     */
+    explicit Deadline(const std::chrono::milliseconds& budget);
+
+
+    /** \brief Checks whether the deadline has a time limit.
+     *
+     * \return Returns true, if the deadline expires at some point in time.
+     *         Returns false, if there is no time limit.
+     */
+    bool limited() const;
+
+
+    /** \brief Gets the remaining time until the deadline expires.
+     *
+     * \return Returns the remaining time. Returns zero, if the deadline has
+     *         already expired or was cancelled. Returns the maximum duration,
+     *         if the deadline has no time limit.
+     */
+    std::chrono::milliseconds remaining() const;
+
+
+    /** \brief Checks whether the deadline has expired or was cancelled.
+     *
+     * \return Returns true, if the time is over or the deadline was cancelled.
+     */
+    bool expired() const;
+
+
+    /** \brief Cancels the deadline, i. e. lets it expire immediately.
+     *
+     * \remarks This also affects all copies of the deadline.
+     */
+    void cancel();
+
+
+    /** \brief Checks whether the deadline was cancelled.
+     *
+     * \return Returns true, if cancel() was called on the deadline or on one
+     *         of its copies.
+     */
+    bool cancelled() const;
+
+
+    /** \brief Creates a child deadline.
+     *
+     * The child expires at the same time as this deadline. It is cancelled,
+     * when this deadline is cancelled, but cancelling the child does not
+     * affect this deadline. That way a part of an operation can be cancelled
+     * separately.
+     *
+     * \return Returns the child deadline.
+     */
+    Deadline child() const;
+
+
+    /** \brief Gets the current deadline of the calling thread.
+     *
+     * \return Returns the deadline of the innermost Scope of the calling
+     *         thread. Returns a deadline without time limit, if there is no
+     *         such scope.
+     */
+    static Deadline current();
+
+
+    /** \brief sets the current deadline of a thread, see below
+     */
+    class Scope;
+  private:
+    std::chrono::steady_clock::time_point end; /**< time when the deadline expires */
+    bool hasLimit; /**< whether there is a time limit */
+    std::shared_ptr<std::atomic<bool>> cancelFlag; /**< shared cancellation flag */
+    std::shared_ptr<const Deadline> parent; /**< parent deadline, if any */
+}; // class
+
+
+/** \brief Sets the current deadline of a thread for its lifetime.
+ *
+ * Scopes may be nested. The previous deadline of the thread is restored
+ * when the scope ends.
+ */
+class Deadline::Scope
+{
+  public:
+    /** \brief Makes the given deadline the current deadline of the thread.
+     *
+     * \param dl  the new current deadline
+     */
+    explicit Scope(const Deadline& dl);
+
+
+    Scope(const Scope& other) = delete;
+    Scope& operator=(const Scope& other) = delete;
+
+
+    /** \brief Restores the previous deadline of the thread.
+     */
+    ~Scope();
+  private:
+    Deadline deadline; /**< deadline of the scope */
+    const Deadline* previous; /**< deadline of the enclosing scope, if any */
+}; // class
+
+} // namespace
+
+#endif // BVN_DEADLINE_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2018, 2020, 2021, 2024  Dirk Stolle
+    Copyright (C) 2018, 2020, 2021, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,6 +20,8 @@
 
 #include "Directories.hpp"
 #include <cstring> // for std::memset()
+#include <filesystem>
+#include <iostream>
 #if defined(_WIN32)
   #include <Windows.h>
   #include <Shlobj.h> // for SHGetFolderPathA()
@@ -77,4 +79,31 @@ bool getHome(std::string& result)
   #endif
 }
 
+std::string getDataFileName(const std::string& fileName)
+{
+  std::string home;
+  if (!getHome(home))
+  {
+    return "/tmp/" + fileName;
+  }
+
+  const std::string directory = home + pathDelimiter + ".bvn";
+  try
+  {
+    // Attempt to create directory and set permissions.
+    std::filesystem::create_directories(directory);
+    std::filesystem::permissions(directory,
+        std::filesystem::perms::owner_all |
+        std::filesystem::perms::group_read |
+        std::filesystem::perms::others_read);
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << "Error: Could not create directory " << directory
+              << " and set permissions for it!\nException message: "
+              << ex.what() << std::endl;
+  }
+  return directory + pathDelimiter + fileName;
+}
+
 } // namespace
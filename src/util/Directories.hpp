@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2018, 2020  Dirk Stolle
+    Copyright (C) 2018, 2020, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -45,6 +45,18 @@ namespace bvn::filesystem
  */
 bool getHome(std::string& result);
 
+
+/** \brief Gets the full path of a file in the data directory of the bot.
+ *
+ * The data directory is the directory .bvn within the home directory of the
+ * current user. It will be created, if it does not exist yet. If the home
+ * directory cannot be determined, the file is placed in /tmp instead.
+ *
+ * \param fileName  name of the file, e. g. "xkcd.db"
+ * \return Returns the full path of the file.
+ */
+std::string getDataFileName(const std::string& fileName);
+
 } // namespace
 
 #endif // BVN_DIRECTORIES_HPP
@@ -0,0 +1,391 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_JSON_BINDING_HPP
+#define BVN_JSON_BINDING_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../../third-party/simdjson/simdjson.h"
+
+/* Declarative binding of JSON objects to C++ structs.
+
+   A struct is described by a tuple of field descriptors, e. g.
+
+       constexpr auto schema = std::make_tuple(
+           json::field("num", &XkcdData::num),
+           json::optional_field("transcript", &XkcdData::transcript));
+
+   and json::decode() fills a struct from a JSON object in a single pass over
+   the members of the object. Objects of equally long arrays, one array per
+   member of a struct, are decoded column by column into a vector of structs
+   by json::decode_columns().
+*/
+namespace bvn::json
+{
+
+/** \brief kinds of errors during decoding
+ */
+enum class ErrorCode
+{
+  missing_or_wrong_type, /**< member is missing or has the wrong type */
+  empty_array,           /**< the first column is an empty array */
+  size_mismatch,         /**< column has a different size than the first column */
+  wrong_element_type     /**< an element of a column has the wrong type */
+};
+
+/** \brief error during decoding
+ */
+struct Error
+{
+  ErrorCode code;   /**< kind of error */
+  std::string field; /**< name of the member, including any prefix */
+  std::string_view expected; /**< description of the expected type */
+
+  /** \brief Gets a human-readable message for the error.
+   *
+   * \return Returns the error message.
+   */
+  std::string message() const
+  {
+    switch (code)
+    {
+      case ErrorCode::missing_or_wrong_type:
+           return field + " element is missing or not " + std::string(expected) + "!";
+      case ErrorCode::empty_array:
+           return field + " element is an empty array!";
+      case ErrorCode::size_mismatch:
+           return field + " array has an unexpected number of elements!";
+      case ErrorCode::wrong_element_type:
+      default:
+           return "An element of " + field + " is not " + std::string(expected) + "!";
+    }
+  }
+}; // struct
+
+/** \brief Conversion of a JSON value to a C++ type.
+ *
+ * Specializations provide a function get() that converts the value, the
+ * description name of the type as a member, and the description
+ * element_name of the type as element of an array.
+ */
+template<typename T>
+struct Value;
+
+template<>
+struct Value<double>
+{
+  static constexpr std::string_view name = "a floating-point number";
+  static constexpr std::string_view element_name = "a floating-point number";
+
+  static bool get(const simdjson::dom::element& element, double& out)
+  {
+    // Integer values are accepted as well, JSON does not distinguish them.
+    return !element.get(out);
+  }
+}; // struct
+
+template<>
+struct Value<int>
+{
+  static constexpr std::string_view name = "an integer number";
+  static constexpr std::string_view element_name = "an integer";
+
+  static bool get(const simdjson::dom::element& element, int& out)
+  {
+    int64_t value = 0;
+    if (element.get(value))
+    {
+      return false;
+    }
+    // Values outside of the range of int are errors, too.
+    if ((value < std::numeric_limits<int>::min())
+        || (value > std::numeric_limits<int>::max()))
+    {
+      return false;
+    }
+    out = static_cast<int>(value);
+    return true;
+  }
+}; // struct
+
+template<>
+struct Value<unsigned int>
+{
+  static constexpr std::string_view name = "a non-negative integer number";
+  static constexpr std::string_view element_name = "a non-negative integer";
+
+  static bool get(const simdjson::dom::element& element, unsigned int& out)
+  {
+    uint64_t value = 0;
+    if (element.get(value))
+    {
+      return false;
+    }
+    // Values outside of the range of unsigned int are errors, too.
+    if (value > std::numeric_limits<unsigned int>::max())
+    {
+      return false;
+    }
+    out = static_cast<unsigned int>(value);
+    return true;
+  }
+}; // struct
+
+template<>
+struct Value<std::string>
+{
+  static constexpr std::string_view name = "a string";
+  static constexpr std::string_view element_name = "a string";
+
+  static bool get(const simdjson::dom::element& element, std::string& out)
+  {
+    std::string_view value;
+    if (element.get(value))
+    {
+      return false;
+    }
+    out = value;
+    return true;
+  }
+}; // struct
+
+/** \brief descriptor for a member of a JSON object that is bound to a struct
+ *         member
+ */
+template<typename S, typename T>
+struct Field
+{
+  std::string_view key; /**< name of the JSON member */
+  T S::* member; /**< the bound struct member */
+  bool required; /**< whether the JSON member must be present */
+}; // struct
+
+/** \brief Creates a descriptor for a required member.
+ *
+ * \param key     name of the member in the JSON object
+ * \param member  pointer to the struct member
+ * \return Returns the field descriptor.
+ */
+template<typename S, typename T>
+constexpr Field<S, T> field(const std::string_view key, T S::* member)
+{
+  return Field<S, T>{ key, member, true };
+}
+
+/** \brief Creates a descriptor for an optional member. If the member is
+ *         missing or has the wrong type, the struct member stays unchanged.
+ *
+ * \param key     name of the member in the JSON object
+ * \param member  pointer to the struct member
+ * \return Returns the field descriptor.
+ */
+template<typename S, typename T>
+constexpr Field<S, T> optional_field(const std::string_view key, T S::* member)
+{
+  return Field<S, T>{ key, member, false };
+}
+
+/** \brief Builds the name of a member for error messages.
+ *
+ * \param prefix  prefix, e. g. "daily", may be empty
+ * \param key     name of the member, e. g. "time"
+ * \return Returns the name for error messages, e. g. "daily.time".
+ */
+inline std::string qualified(const std::string_view prefix, const std::string_view key)
+{
+  if (prefix.empty())
+  {
+    return std::string(key);
+  }
+  return std::string(prefix).append(".").append(key);
+}
+
+/** \brief Finds the values of the described members in a JSON object, using
+ *         a single pass over the members of the object.
+ *
+ * \param object  the JSON object
+ * \param fields  tuple of descriptors, each one with a member key
+ * \return Returns an array with the value of each described member, or an
+ *         empty optional for members that do not exist.
+ * \remarks If a key occurs more than once, the first occurrence is used.
+ */
+template<typename Tuple, std::size_t... I>
+std::array<std::optional<simdjson::dom::element>, sizeof...(I)>
+find_members(const simdjson::dom::object& object, const Tuple& fields, std::index_sequence<I...>)
+{
+  std::array<std::optional<simdjson::dom::element>, sizeof...(I)> values;
+  for (const auto member: object)
+  {
+    // Short-circuit evaluation stops at the first matching descriptor.
+    (void)((!values[I].has_value() && (member.key == std::get<I>(fields).key)
+            && (values[I] = member.value, true)) || ...);
+  }
+  return values;
+}
+
+template<typename S, typename T>
+std::optional<Error> decode_field(const std::optional<simdjson::dom::element>& value,
+                                  const Field<S, T>& desc, S& out, const std::string_view prefix)
+{
+  if (value.has_value())
+  {
+    T result{};
+    if (Value<T>::get(value.value(), result))
+    {
+      out.*desc.member = std::move(result);
+      return std::nullopt;
+    }
+  }
+  if (!desc.required)
+  {
+    return std::nullopt;
+  }
+  return Error{ ErrorCode::missing_or_wrong_type, qualified(prefix, desc.key), Value<T>::name };
+}
+
+template<typename S, typename Tuple, std::size_t... I>
+std::optional<Error> decode_fields(const simdjson::dom::object& object, const Tuple& fields,
+                                   S& out, const std::string_view prefix, std::index_sequence<I...> seq)
+{
+  const auto values = find_members(object, fields, seq);
+  std::optional<Error> error;
+  // Members are converted in the order of the descriptors, so the first
+  // failing descriptor determines the error.
+  (void)((error = decode_field(values[I], std::get<I>(fields), out, prefix), !error.has_value()) && ...);
+  return error;
+}
+
+/** \brief Decodes a JSON object into a struct.
+ *
+ * \param object  the JSON object
+ * \param fields  tuple of field descriptors for the struct
+ * \param out     the struct that receives the values
+ * \param prefix  prefix for member names in error messages, may be empty
+ * \return Returns an empty optional in case of success.
+ *         Returns the error for the first failing descriptor otherwise.
+ */
+template<typename S, typename... T>
+std::optional<Error> decode(const simdjson::dom::object& object,
+                            const std::tuple<Field<S, T>...>& fields,
+                            S& out, const std::string_view prefix = std::string_view())
+{
+  return decode_fields(object, fields, out, prefix, std::index_sequence_for<T...>());
+}
+
+/** \brief descriptor for an array in a JSON object that is bound to a struct
+ *         member
+ */
+template<typename Row, typename T>
+struct Column
+{
+  std::string_view key; /**< name of the JSON member */
+  T Row::* member; /**< the bound struct member */
+}; // struct
+
+/** \brief Creates a descriptor for a column.
+ *
+ * \param key     name of the array in the JSON object
+ * \param member  pointer to the struct member that gets the array elements
+ * \return Returns the column descriptor.
+ */
+template<typename Row, typename T>
+constexpr Column<Row, T> column(const std::string_view key, T Row::* member)
+{
+  return Column<Row, T>{ key, member };
+}
+
+template<typename Row, typename T>
+std::optional<Error> decode_column(const std::optional<simdjson::dom::element>& value,
+                                   const Column<Row, T>& desc, std::vector<Row>& rows,
+                                   const std::string_view prefix, const bool first)
+{
+  simdjson::dom::array array;
+  if (!value.has_value() || value.value().get(array))
+  {
+    return Error{ ErrorCode::missing_or_wrong_type, qualified(prefix, desc.key), "an array" };
+  }
+  if (first)
+  {
+    if (array.size() == 0)
+    {
+      return Error{ ErrorCode::empty_array, qualified(prefix, desc.key), "an array" };
+    }
+    rows.resize(array.size());
+  }
+  else if (array.size() != rows.size())
+  {
+    return Error{ ErrorCode::size_mismatch, qualified(prefix, desc.key), "an array" };
+  }
+
+  std::size_t idx = 0;
+  for (const auto element: array)
+  {
+    if (!Value<T>::get(element, rows[idx].*desc.member))
+    {
+      return Error{ ErrorCode::wrong_element_type, qualified(prefix, desc.key), Value<T>::element_name };
+    }
+    ++idx;
+  }
+  return std::nullopt;
+}
+
+template<typename Row, typename Tuple, std::size_t... I>
+std::optional<Error> decode_columns(const simdjson::dom::object& object, const Tuple& columns,
+                                    std::vector<Row>& rows, const std::string_view prefix,
+                                    std::index_sequence<I...> seq)
+{
+  const auto values = find_members(object, columns, seq);
+  std::optional<Error> error;
+  (void)((error = decode_column(values[I], std::get<I>(columns), rows, prefix, I == 0), !error.has_value()) && ...);
+  return error;
+}
+
+/** \brief Decodes an object of arrays into a vector of structs, column by
+ *         column. All arrays must have the same size.
+ *
+ * \param object   the JSON object containing the arrays
+ * \param columns  tuple of column descriptors; the first column determines
+ *                 the number of rows and must not be empty
+ * \param rows     vector that receives the rows
+ * \param prefix   prefix for member names in error messages, may be empty
+ * \return Returns an empty optional in case of success.
+ *         Returns the error for the first failing column otherwise.
+ */
+template<typename Row, typename... T>
+std::optional<Error> decode_columns(const simdjson::dom::object& object,
+                                    const std::tuple<Column<Row, T>...>& columns,
+                                    std::vector<Row>& rows, const std::string_view prefix = std::string_view())
+{
+  rows.clear();
+  return decode_columns(object, columns, rows, prefix, std::index_sequence_for<T...>());
+}
+
+} // namespace
+
+#endif // BVN_JSON_BINDING_HPP
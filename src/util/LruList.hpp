@@ -0,0 +1,195 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+
+#ifndef BVN_LRULIST_HPP
+#define BVN_LRULIST_HPP
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bvn
+{
+
+/** \brief Entries with string keys that are evicted in least recently used
+ *         order.
+ *
+ * Each entry has a weight, e. g. its size in bytes, or just one to limit the
+ * number of entries. When the total weight exceeds the capacity, the least
+ * recently used entries are evicted.
+ *
+ * \tparam T  type of the values
+ * \remarks The list is not thread-safe, users have to synchronize access.
+ */
+template<typename T>
+class LruList
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param capacity  maximum total weight of all entries
+     */
+    explicit LruList(const std::size_t capacity)
+    : items(),
+      index(),
+      totalWeight(0),
+      maxWeight(capacity)
+    {
+    }
+
+
+    /** \brief Gets an entry and marks it as most recently used.
+     *
+     * \param key  key of the entry
+     * \return Returns a pointer to the value of the entry, if it exists.
+     *         Returns nullptr otherwise. The pointer is valid until the entry
+     *         is removed.
+     */
+    T* find(const std::string& key)
+    {
+      const auto iter = index.find(key);
+      if (iter == index.end())
+      {
+        return nullptr;
+      }
+      items.splice(items.begin(), items, iter->second);
+      return &items.front().value;
+    }
+
+
+    /** \brief Checks whether an entry exists, without marking it as used.
+     *
+     * \param key  key of the entry
+     * \return Returns true, if there is an entry with the given key.
+     */
+    bool contains(const std::string& key) const
+    {
+      return index.find(key) != index.end();
+    }
+
+
+    /** \brief Adds an entry as most recently used entry, replacing any
+     *         existing entry with the same key, and evicts the least
+     *         recently used entries, if the capacity is exceeded.
+     *
+     * \param key     key of the entry
+     * \param value   value of the entry
+     * \param weight  weight of the entry
+     * \return Returns the keys of the evicted entries. If the weight of the
+     *         entry alone exceeds the capacity, the entry is not added and
+     *         its key is returned, too.
+     */
+    std::vector<std::string> insert(const std::string& key, T value, const std::size_t weight)
+    {
+      erase(key);
+      std::vector<std::string> evicted;
+      if (weight > maxWeight)
+      {
+        evicted.push_back(key);
+        return evicted;
+      }
+      items.push_front(Item{ key, std::move(value), weight });
+      index[key] = items.begin();
+      totalWeight += weight;
+      while (totalWeight > maxWeight)
+      {
+        const Item& last = items.back();
+        totalWeight -= last.weight;
+        evicted.push_back(last.key);
+        index.erase(last.key);
+        items.pop_back();
+      }
+      return evicted;
+    }
+
+
+    /** \brief Removes an entry, if it exists.
+     *
+     * \param key  key of the entry
+     */
+    void erase(const std::string& key)
+    {
+      const auto iter = index.find(key);
+      if (iter == index.end())
+      {
+        return;
+      }
+      totalWeight -= iter->second->weight;
+      items.erase(iter->second);
+      index.erase(iter);
+    }
+
+
+    /** \brief Removes all entries whose value satisfies a condition.
+     *
+     * \param predicate  function that gets a value and returns true, if the
+     *                   entry shall be removed
+     */
+    template<typename P>
+    void eraseIf(P&& predicate)
+    {
+      auto iter = items.begin();
+      while (iter != items.end())
+      {
+        if (predicate(static_cast<const T&>(iter->value)))
+        {
+          totalWeight -= iter->weight;
+          index.erase(iter->key);
+          iter = items.erase(iter);
+        }
+        else
+        {
+          ++iter;
+        }
+      }
+    }
+
+
+    /** \brief Gets the number of entries.
+     *
+     * \return Returns the number of entries.
+     */
+    std::size_t size() const
+    {
+      return items.size();
+    }
+  private:
+    /** \brief an entry of the list */
+    struct Item
+    {
+      std::string key; /**< key of the entry */
+      T value; /**< value of the entry */
+      std::size_t weight; /**< weight of the entry */
+    }; // struct
+
+    std::list<Item> items; /**< entries, most recently used entry first */
+    std::unordered_map<std::string, typename std::list<Item>::iterator> index; /**< index of items by key */
+    std::size_t totalWeight; /**< total weight of all entries */
+    std::size_t maxWeight; /**< maximum total weight of all entries */
+}; // class
+
+} // namespace
+
+#endif // BVN_LRULIST_HPP
@@ -0,0 +1,167 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "MappedFile.hpp"
+#include <iostream>
+#if defined(_WIN32)
+  #include <Windows.h>
+#elif defined(__linux__) || defined(linux)
+  #include <fcntl.h> // for open()
+  #include <sys/mman.h> // for mmap() and munmap()
+  #include <sys/stat.h> // for fstat()
+  #include <unistd.h> // for close()
+#endif
+
+namespace bvn
+{
+
+MappedFile::MappedFile()
+: mData(nullptr),
+  mSize(0),
+  mOpen(false)
+  #if defined(_WIN32)
+  , mFile(INVALID_HANDLE_VALUE),
+  mMapping(nullptr)
+  #endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+bool MappedFile::open(const std::string& fileName)
+{
+  close();
+
+  #if defined(_WIN32)
+    mFile = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mFile == INVALID_HANDLE_VALUE)
+    {
+      std::cerr << "Error: Could not open file " << fileName << "!\n";
+      return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mFile, &size))
+    {
+      std::cerr << "Error: Could not get size of file " << fileName << "!\n";
+      close();
+      return false;
+    }
+    mSize = static_cast<std::size_t>(size.QuadPart);
+    if (mSize > 0)
+    {
+      mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mMapping == nullptr)
+      {
+        std::cerr << "Error: Could not create mapping for file " << fileName << "!\n";
+        close();
+        return false;
+      }
+      mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+      if (mData == nullptr)
+      {
+        std::cerr << "Error: Could not map file " << fileName << " into memory!\n";
+        close();
+        return false;
+      }
+    }
+  #elif defined(__linux__) || defined(linux)
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+      std::cerr << "Error: Could not open file " << fileName << "!\n";
+      return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+      std::cerr << "Error: Could not get size of file " << fileName << "!\n";
+      ::close(fd);
+      return false;
+    }
+    mSize = static_cast<std::size_t>(status.st_size);
+    // Empty files cannot be mapped, but there is nothing to map anyway.
+    if (mSize > 0)
+    {
+      void* address = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address == MAP_FAILED)
+      {
+        std::cerr << "Error: Could not map file " << fileName << " into memory!\n";
+        ::close(fd);
+        mSize = 0;
+        return false;
+      }
+      mData = static_cast<const char*>(address);
+    }
+    // The mapping stays valid after the file descriptor is closed.
+    ::close(fd);
+  #endif
+
+  mOpen = true;
+  return true;
+}
+
+void MappedFile::close()
+{
+  #if defined(_WIN32)
+    if (mData != nullptr)
+    {
+      UnmapViewOfFile(mData);
+    }
+    if (mMapping != nullptr)
+    {
+      CloseHandle(mMapping);
+      mMapping = nullptr;
+    }
+    if (mFile != INVALID_HANDLE_VALUE)
+    {
+      CloseHandle(mFile);
+      mFile = INVALID_HANDLE_VALUE;
+    }
+  #elif defined(__linux__) || defined(linux)
+    if (mData != nullptr)
+    {
+      munmap(const_cast<char*>(mData), mSize);
+    }
+  #endif
+  mData = nullptr;
+  mSize = 0;
+  mOpen = false;
+}
+
+bool MappedFile::isOpen() const
+{
+  return mOpen;
+}
+
+std::string_view MappedFile::content() const
+{
+  if (mData == nullptr)
+  {
+    return std::string_view();
+  }
+  return std::string_view(mData, mSize);
+}
+
+} // namespace
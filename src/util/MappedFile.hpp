@@ -0,0 +1,95 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_MAPPED_FILE_HPP
+#define BVN_MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+
+namespace bvn
+{
+
+/** \brief Maps the content of a file into memory for read-only access.
+ *
+ * The operating system loads pages of the file on demand and may share them
+ * between processes, so large data files do not need to be read completely
+ * into the heap.
+ */
+class MappedFile
+{
+  public:
+    /** \brief Creates an instance without any mapped file.
+     */
+    MappedFile();
+
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+
+    /** \brief Destructor, unmaps the file.
+     */
+    ~MappedFile();
+
+
+    /** \brief Maps a file into memory.
+     *
+     * \param fileName   name of the file to map
+     * \return Returns true, if the file was mapped successfully.
+     *         Returns false otherwise.
+     * \remarks Any previously mapped file is unmapped first.
+     */
+    bool open(const std::string& fileName);
+
+
+    /** \brief Unmaps the current file, if any.
+     */
+    void close();
+
+
+    /** \brief Checks whether a file is mapped.
+     *
+     * \return Returns true, if a file is mapped. Returns false otherwise.
+     */
+    bool isOpen() const;
+
+
+    /** \brief Gets the content of the mapped file.
+     *
+     * \return Returns a view of the content of the mapped file.
+     *         Returns an empty view, if no file is mapped.
+     * \remarks The view is only valid as long as the file is mapped.
+     */
+    std::string_view content() const;
+  private:
+    const char* mData; /**< start of mapped memory, may be nullptr */
+    std::size_t mSize; /**< size of the mapped file in bytes */
+    bool mOpen; /**< whether a file is mapped */
+    #if defined(_WIN32)
+    void* mFile; /**< handle of the file */
+    void* mMapping; /**< handle of the file mapping */
+    #endif
+}; // class
+
+} // namespace
+
+#endif // BVN_MAPPED_FILE_HPP
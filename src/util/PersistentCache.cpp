@@ -0,0 +1,423 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "PersistentCache.hpp"
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include "Directories.hpp"
+
+namespace bvn
+{
+
+namespace
+{
+
+/** \brief number of pending changes that triggers a write before the interval
+ *         ends
+ */
+const std::size_t max_pending = 512;
+
+/** \brief Converts a point in time to seconds since the epoch.
+ *
+ * \param time  the point in time
+ * \return Returns the number of seconds since the epoch.
+ */
+int64_t toSeconds(const std::chrono::system_clock::time_point& time)
+{
+  return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+/** \brief Executes a cached statement and resets it for the next use.
+ *
+ * \param stmt  the prepared statement with all parameters bound
+ * \return Returns true, if the statement was executed successfully.
+ */
+bool run(sql::statement& stmt)
+{
+  const int rc = sqlite3_step(stmt.get());
+  sqlite3_reset(stmt.get());
+  return (rc == SQLITE_DONE) || (rc == SQLITE_ROW);
+}
+
+} // namespace
+
+const std::size_t PersistentCache::default_budget = 16 * 1024 * 1024;
+
+const std::size_t PersistentCache::default_memory_budget = 4 * 1024 * 1024;
+
+PersistentCache::PersistentCache(const std::string& fileName, const std::size_t memoryBudget, const std::chrono::milliseconds flushInterval)
+: db(fileName),
+  persistent(false),
+  recent(memoryBudget),
+  pending(),
+  flushing(),
+  budgets(),
+  lastStamp(0),
+  mutex(),
+  flushMutex(),
+  interval(flushInterval),
+  stopping(false),
+  wakeUp(),
+  flusher()
+{
+  if (fileName.empty())
+  {
+    return;
+  }
+  if (!db.isOpen())
+  {
+    std::clog << "Warning: Failed to open or create database " << fileName
+              << ", responses will only be cached in memory." << std::endl;
+    return;
+  }
+
+  const std::string statement = R"SQL(
+        CREATE TABLE IF NOT EXISTS cache (
+          ns TEXT NOT NULL,
+          key TEXT NOT NULL,
+          value BLOB NOT NULL,
+          expires INTEGER NOT NULL,
+          accessed INTEGER NOT NULL,
+          PRIMARY KEY (ns, key)
+        ) WITHOUT ROWID;
+        CREATE INDEX IF NOT EXISTS cache_expires ON cache (expires);
+        )SQL";
+  {
+    auto handle = db.lock();
+    persistent = sql::exec(handle.db(), statement);
+  }
+  if (!persistent)
+  {
+    std::cerr << "Error: Could not create table in SQLite 3 database for cached responses!" << std::endl;
+    return;
+  }
+  flusher = std::thread(&PersistentCache::flushLoop, this);
+}
+
+PersistentCache::~PersistentCache()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wakeUp.notify_one();
+  if (flusher.joinable())
+  {
+    flusher.join();
+  }
+  flush();
+}
+
+std::string PersistentCache::defaultFileName()
+{
+  return filesystem::getDataFileName("cache.db");
+}
+
+std::string PersistentCache::makeKey(const std::string& ns, const std::string& key)
+{
+  // Namespaces are plain names, so they do not contain the separator.
+  return std::string(ns).append(1, '\x1F').append(key);
+}
+
+int64_t PersistentCache::stamp()
+{
+  const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  lastStamp = std::max(now, lastStamp + 1);
+  return lastStamp;
+}
+
+std::optional<std::string> PersistentCache::get(const std::string& ns, const std::string& key)
+{
+  const std::string fullKey = makeKey(ns, key);
+  const auto now = std::chrono::system_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Entry* entry = recent.find(fullKey);
+    if (entry != nullptr)
+    {
+      if (entry->expires <= now)
+      {
+        forget(fullKey);
+        enqueue(fullKey, Pending{ Change::erase, ns, key, std::string(), 0, 0 });
+        return std::nullopt;
+      }
+      enqueue(fullKey, Pending{ Change::touch, ns, key, std::string(), 0, stamp() });
+      return entry->value;
+    }
+
+    // Entries that were evicted from memory may not be written yet.
+    for (const auto* changes: { &pending, &flushing })
+    {
+      const auto change = changes->find(fullKey);
+      if (change == changes->end() || change->second.change == Change::touch)
+      {
+        continue;
+      }
+      if ((change->second.change == Change::erase) || (change->second.expires <= toSeconds(now)))
+      {
+        return std::nullopt;
+      }
+      const std::string value = change->second.value;
+      remember(fullKey, value, std::chrono::system_clock::time_point(std::chrono::seconds(change->second.expires)));
+      enqueue(fullKey, Pending{ Change::touch, ns, key, std::string(), 0, stamp() });
+      return value;
+    }
+
+    if (!persistent)
+    {
+      return std::nullopt;
+    }
+  }
+
+  auto loaded = load(ns, key);
+  if (!loaded.has_value())
+  {
+    return std::nullopt;
+  }
+  const auto expires = std::chrono::system_clock::time_point(std::chrono::seconds(loaded.value().second));
+  if (expires <= now)
+  {
+    // Expired entries are deleted during the next write to the database.
+    return std::nullopt;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    // put() or erase() may have changed the entry while the database was
+    // read. Such a change is newer than the loaded value, so the loaded value
+    // must not replace it in memory.
+    const auto changed = [&fullKey](const std::map<std::string, Pending>& changes)
+    {
+      const auto change = changes.find(fullKey);
+      return (change != changes.end()) && (change->second.change != Change::touch);
+    };
+    if (!recent.contains(fullKey) && !changed(pending) && !changed(flushing))
+    {
+      remember(fullKey, loaded.value().first, expires);
+      enqueue(fullKey, Pending{ Change::touch, ns, key, std::string(), 0, stamp() });
+      return std::move(loaded.value().first);
+    }
+  }
+  // The newer state of the entry is in memory now, so look again.
+  return get(ns, key);
+}
+
+void PersistentCache::put(const std::string& ns, const std::string& key, const std::string& value, const std::chrono::seconds& ttl)
+{
+  const std::string fullKey = makeKey(ns, key);
+  const auto expires = std::chrono::system_clock::now() + ttl;
+  std::lock_guard<std::mutex> lock(mutex);
+  remember(fullKey, value, expires);
+  enqueue(fullKey, Pending{ Change::write, ns, key, value, toSeconds(expires), stamp() });
+}
+
+void PersistentCache::erase(const std::string& ns, const std::string& key)
+{
+  const std::string fullKey = makeKey(ns, key);
+  std::lock_guard<std::mutex> lock(mutex);
+  forget(fullKey);
+  enqueue(fullKey, Pending{ Change::erase, ns, key, std::string(), 0, 0 });
+}
+
+void PersistentCache::setBudget(const std::string& ns, const std::size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  budgets[ns] = bytes;
+}
+
+void PersistentCache::remember(const std::string& fullKey, const std::string& value, const std::chrono::system_clock::time_point& expires)
+{
+  recent.insert(fullKey, Entry{ value, expires }, fullKey.size() + value.size());
+}
+
+void PersistentCache::forget(const std::string& fullKey)
+{
+  recent.erase(fullKey);
+}
+
+void PersistentCache::enqueue(const std::string& fullKey, Pending&& change)
+{
+  if (!persistent)
+  {
+    return;
+  }
+  const auto iter = pending.find(fullKey);
+  if (iter == pending.end())
+  {
+    pending.emplace(fullKey, std::move(change));
+  }
+  else if (change.change != Change::touch)
+  {
+    iter->second = std::move(change);
+  }
+  else if (iter->second.change != Change::erase)
+  {
+    // Keep the pending write, but with the new access time.
+    iter->second.accessed = change.accessed;
+  }
+  if (pending.size() >= max_pending)
+  {
+    wakeUp.notify_one();
+  }
+}
+
+std::optional<std::pair<std::string, int64_t>> PersistentCache::load(const std::string& ns, const std::string& key)
+{
+  auto handle = db.lock();
+  sql::statement& stmt = handle.prepared("SELECT value, expires FROM cache WHERE ns = @ns AND key = @key;");
+  if (!stmt)
+  {
+    std::cerr << "Error: Failed to prepare select statement for cached response!\n";
+    return std::nullopt;
+  }
+  if (!sql::bind(stmt, 1, ns) || !sql::bind(stmt, 2, key))
+  {
+    std::cerr << "Error: Could not bind values to prepared statement!\n";
+    return std::nullopt;
+  }
+  if (sqlite3_step(stmt.get()) != SQLITE_ROW)
+  {
+    return std::nullopt;
+  }
+  const char* data = static_cast<const char*>(sqlite3_column_blob(stmt.get(), 0));
+  const int bytes = sqlite3_column_bytes(stmt.get(), 0);
+  std::string value;
+  if (data != nullptr)
+  {
+    value.assign(data, bytes);
+  }
+  return std::make_pair(std::move(value), static_cast<int64_t>(sqlite3_column_int64(stmt.get(), 1)));
+}
+
+void PersistentCache::flush()
+{
+  if (!persistent)
+  {
+    return;
+  }
+  std::lock_guard<std::mutex> flushLock(flushMutex);
+  std::unordered_map<std::string, std::size_t> currentBudgets;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending.empty())
+    {
+      return;
+    }
+    // Changes stay visible to get() while they are written.
+    flushing.swap(pending);
+    currentBudgets = budgets;
+  }
+  write(flushing, currentBudgets);
+  std::lock_guard<std::mutex> lock(mutex);
+  flushing.clear();
+}
+
+void PersistentCache::write(const std::map<std::string, Pending>& batch, const std::unordered_map<std::string, std::size_t>& nsBudgets)
+{
+  auto handle = db.lock();
+  if (!sql::exec(handle.db(), "BEGIN TRANSACTION;"))
+  {
+    return;
+  }
+
+  std::set<std::string> written;
+  for (const auto& item: batch)
+  {
+    const Pending& change = item.second;
+    bool success = false;
+    switch (change.change)
+    {
+      case Change::write:
+        {
+          auto& stmt = handle.prepared("INSERT OR REPLACE INTO cache (ns, key, value, expires, accessed) VALUES (@ns, @key, @value, @expires, @accessed);");
+          success = stmt && sql::bind(stmt, 1, change.ns) && sql::bind(stmt, 2, change.key)
+              && (sqlite3_bind_blob(stmt.get(), 3, change.value.data(), static_cast<int>(change.value.size()), SQLITE_TRANSIENT) == SQLITE_OK)
+              && sql::bind(stmt, 4, change.expires) && sql::bind(stmt, 5, change.accessed)
+              && run(stmt);
+          written.insert(change.ns);
+        }
+        break;
+      case Change::touch:
+        {
+          auto& stmt = handle.prepared("UPDATE cache SET accessed = @accessed WHERE ns = @ns AND key = @key;");
+          success = stmt && sql::bind(stmt, 1, change.accessed) && sql::bind(stmt, 2, change.ns)
+              && sql::bind(stmt, 3, change.key) && run(stmt);
+        }
+        break;
+      case Change::erase:
+        {
+          auto& stmt = handle.prepared("DELETE FROM cache WHERE ns = @ns AND key = @key;");
+          success = stmt && sql::bind(stmt, 1, change.ns) && sql::bind(stmt, 2, change.key)
+              && run(stmt);
+        }
+        break;
+    }
+    if (!success)
+    {
+      std::cerr << "Error: Could not write cached response for '" << change.key
+                << "' to database!\n" << sqlite3_errmsg(handle.db().get()) << std::endl;
+    }
+  }
+
+  // Only namespaces that got new entries can exceed their budget. The running
+  // total over the most recently used entries determines what is kept.
+  for (const std::string& ns: written)
+  {
+    const auto budget = nsBudgets.find(ns);
+    const int64_t limit = static_cast<int64_t>(budget != nsBudgets.end() ? budget->second : default_budget);
+    auto& stmt = handle.prepared(R"SQL(
+        DELETE FROM cache WHERE ns = ?1 AND key IN (
+          SELECT key FROM (
+            SELECT key, SUM(LENGTH(key) + LENGTH(value)) OVER (ORDER BY accessed DESC, key ROWS UNBOUNDED PRECEDING) AS total
+            FROM cache WHERE ns = ?1
+          ) WHERE total > ?2
+        );
+        )SQL");
+    if (!stmt || !sql::bind(stmt, 1, ns) || !sql::bind(stmt, 2, limit) || !run(stmt))
+    {
+      std::cerr << "Error: Could not evict cached responses of namespace '" << ns
+                << "'!\n" << sqlite3_errmsg(handle.db().get()) << std::endl;
+    }
+  }
+
+  auto& purge = handle.prepared("DELETE FROM cache WHERE expires <= @now;");
+  if (!purge || !sql::bind(purge, 1, toSeconds(std::chrono::system_clock::now())) || !run(purge))
+  {
+    std::cerr << "Error: Could not delete expired responses from database!\n";
+  }
+
+  sql::exec(handle.db(), "COMMIT;");
+}
+
+void PersistentCache::flushLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping)
+  {
+    wakeUp.wait_for(lock, interval, [this]() { return stopping || (pending.size() >= max_pending); });
+    lock.unlock();
+    flush();
+    lock.lock();
+  }
+}
+
+} // namespace
@@ -0,0 +1,233 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_PERSISTENT_CACHE_HPP
+#define BVN_PERSISTENT_CACHE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "LruList.hpp"
+#include "sqlite3.hpp"
+
+namespace bvn
+{
+
+/** \brief Key-value cache with expiration times for responses of upstream
+ *         services, backed by an SQLite database.
+ *
+ * Entries are grouped into namespaces, usually one per plugin. The size of
+ * each namespace in the database is limited by a byte budget; entries that
+ * were used least recently are evicted first.
+ *
+ * Recently used entries are also kept in memory, so that most lookups do
+ * not touch the database at all. Writes are not done immediately, they are
+ * collected and written in a single transaction by a background thread.
+ */
+class PersistentCache
+{
+  public:
+    /** \brief Opens the cache.
+     *
+     * \param fileName       file name of the SQLite database; an empty file
+     *                       name means that entries are kept in memory only
+     * \param memoryBudget   maximum size of the entries kept in memory, in bytes
+     * \param flushInterval  maximum time that writes are delayed
+     */
+    explicit PersistentCache(const std::string& fileName,
+                             const std::size_t memoryBudget = default_memory_budget,
+                             const std::chrono::milliseconds flushInterval = std::chrono::seconds(2));
+
+
+    PersistentCache(const PersistentCache& other) = delete;
+    PersistentCache& operator=(const PersistentCache& other) = delete;
+
+
+    /** \brief Destructor. Writes all pending changes to the database.
+     */
+    ~PersistentCache();
+
+
+    /** \brief Gets the default file name of the cache database.
+     *
+     * \return Returns the default file name of the cache database.
+     */
+    static std::string defaultFileName();
+
+
+    /** \brief Gets a cached value.
+     *
+     * \param ns   namespace of the entry, e. g. the name of the plugin
+     * \param key  key of the entry
+     * \return Returns an optional containing the value, if there is an entry
+     *         that has not expired yet. Returns an empty optional otherwise.
+     */
+    std::optional<std::string> get(const std::string& ns, const std::string& key);
+
+
+    /** \brief Puts a value into the cache, replacing any existing entry with
+     *         the same key.
+     *
+     * \param ns     namespace of the entry, e. g. the name of the plugin
+     * \param key    key of the entry
+     * \param value  the value to cache, may contain binary data
+     * \param ttl    time until the entry expires
+     */
+    void put(const std::string& ns, const std::string& key, const std::string& value, const std::chrono::seconds& ttl);
+
+
+    /** \brief Removes an entry from the cache.
+     *
+     * \param ns   namespace of the entry
+     * \param key  key of the entry
+     */
+    void erase(const std::string& ns, const std::string& key);
+
+
+    /** \brief Sets the maximum size of a namespace in the database.
+     *
+     * \param ns     the namespace
+     * \param bytes  maximum size of keys and values in the namespace, in bytes
+     * \remarks Namespaces without explicit budget use default_budget.
+     */
+    void setBudget(const std::string& ns, const std::size_t bytes);
+
+
+    /** \brief Writes all pending changes to the database immediately.
+     */
+    void flush();
+
+
+    /** \brief default maximum size of a namespace in the database, in bytes
+     */
+    static const std::size_t default_budget;
+
+
+    /** \brief default maximum size of the entries kept in memory, in bytes
+     */
+    static const std::size_t default_memory_budget;
+  private:
+    /** \brief an entry in the memory tier
+     */
+    struct Entry
+    {
+      std::string value; /**< the cached value */
+      std::chrono::system_clock::time_point expires; /**< expiration time */
+    }; // struct
+
+    /** \brief kind of a change that still has to be written to the database
+     */
+    enum class Change { write, touch, erase };
+
+    /** \brief change that still has to be written to the database
+     */
+    struct Pending
+    {
+      Change change; /**< kind of change */
+      std::string ns; /**< namespace of the entry */
+      std::string key; /**< key of the entry */
+      std::string value; /**< value, only used for writes */
+      int64_t expires; /**< expiration time in seconds since epoch, only used for writes */
+      int64_t accessed; /**< time of last use, see stamp() */
+    }; // struct
+
+    /** \brief Combines namespace and key into the key of the memory tier.
+     *
+     * \param ns   the namespace
+     * \param key  the key
+     * \return Returns the combined key.
+     */
+    static std::string makeKey(const std::string& ns, const std::string& key);
+
+    /** \brief Gets a strictly increasing time stamp for the last use of an entry.
+     *
+     * \return Returns the number of milliseconds since the epoch, increased
+     *         as needed to be larger than any previous stamp.
+     */
+    int64_t stamp();
+
+    /** \brief Adds an entry to the memory tier and evicts the least recently
+     *         used entries, if the memory budget is exceeded.
+     *
+     * \param fullKey  combined key, see makeKey()
+     * \param value    the value
+     * \param expires  expiration time
+     */
+    void remember(const std::string& fullKey, const std::string& value, const std::chrono::system_clock::time_point& expires);
+
+    /** \brief Removes an entry from the memory tier, if it exists.
+     *
+     * \param fullKey  combined key, see makeKey()
+     */
+    void forget(const std::string& fullKey);
+
+    /** \brief Queues a change for the database.
+     *
+     * \param fullKey  combined key, see makeKey()
+     * \param change   the change
+     */
+    void enqueue(const std::string& fullKey, Pending&& change);
+
+    /** \brief Looks up an entry in the database.
+     *
+     * \param ns   namespace of the entry
+     * \param key  key of the entry
+     * \return Returns an optional containing the value and the expiration
+     *         time, if the entry exists. Returns an empty optional otherwise.
+     */
+    std::optional<std::pair<std::string, int64_t>> load(const std::string& ns, const std::string& key);
+
+    /** \brief Writes a batch of changes to the database and enforces the
+     *         budgets of the affected namespaces.
+     *
+     * \param batch      the changes to write
+     * \param nsBudgets  budgets of the namespaces
+     */
+    void write(const std::map<std::string, Pending>& batch, const std::unordered_map<std::string, std::size_t>& nsBudgets);
+
+    /** \brief Main function of the background thread that writes changes.
+     */
+    void flushLoop();
+
+    sql::Connection db; /**< database connection */
+    bool persistent; /**< whether db can be used */
+    LruList<Entry> recent; /**< memory tier by combined key, see makeKey() */
+    std::map<std::string, Pending> pending; /**< changes that have not been written yet */
+    std::map<std::string, Pending> flushing; /**< changes that are currently written */
+    std::unordered_map<std::string, std::size_t> budgets; /**< budgets of namespaces */
+    int64_t lastStamp; /**< last value returned by stamp() */
+    std::mutex mutex; /**< protects all members above except db */
+    std::mutex flushMutex; /**< serializes writes to the database */
+    std::chrono::milliseconds interval; /**< maximum delay of writes */
+    bool stopping; /**< whether the background thread shall stop */
+    std::condition_variable wakeUp; /**< signals the background thread */
+    std::thread flusher; /**< background thread that writes changes */
+}; // class
+
+} // namespace
+
+#endif // BVN_PERSISTENT_CACHE_HPP
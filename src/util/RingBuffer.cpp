@@ -0,0 +1,122 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "RingBuffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace bvn
+{
+
+RingBuffer::RingBuffer(const std::size_t capacity)
+: data(std::max(capacity, static_cast<std::size_t>(1))),
+  start(0),
+  used(0),
+  isClosed(false),
+  isAborted(false),
+  mutex(),
+  changed()
+{
+}
+
+bool RingBuffer::write(const std::string_view& input)
+{
+  std::size_t offset = 0;
+  while (offset < input.size())
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return isAborted || isClosed || (used < data.size()); });
+    if (isAborted || isClosed)
+    {
+      return false;
+    }
+    // Copy as much as possible, at most up to the end of the storage.
+    const std::size_t end = (start + used) % data.size();
+    const std::size_t chunk = std::min({ input.size() - offset,
+                                         data.size() - used,
+                                         data.size() - end });
+    std::memcpy(&data[end], input.data() + offset, chunk);
+    used += chunk;
+    offset += chunk;
+    changed.notify_all();
+  }
+  return true;
+}
+
+std::size_t RingBuffer::read(char* buffer, const std::size_t size)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this]() { return isAborted || isClosed || (used > 0); });
+  if (isAborted)
+  {
+    return 0;
+  }
+  std::size_t total = 0;
+  while ((total < size) && (used > 0))
+  {
+    const std::size_t chunk = std::min({ size - total, used, data.size() - start });
+    std::memcpy(buffer + total, &data[start], chunk);
+    start = (start + chunk) % data.size();
+    used -= chunk;
+    total += chunk;
+  }
+  changed.notify_all();
+  return total;
+}
+
+std::size_t RingBuffer::waitUntilFilled()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this]() { return isAborted || isClosed || (used == data.size()); });
+  return used;
+}
+
+void RingBuffer::close()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  isClosed = true;
+  changed.notify_all();
+}
+
+void RingBuffer::abort()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  isAborted = true;
+  changed.notify_all();
+}
+
+bool RingBuffer::closed() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return isClosed;
+}
+
+bool RingBuffer::aborted() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return isAborted;
+}
+
+std::size_t RingBuffer::capacity() const
+{
+  return data.size();
+}
+
+} // namespace
@@ -0,0 +1,122 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_RINGBUFFER_HPP
+#define BVN_RINGBUFFER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace bvn
+{
+
+/** \brief Bounded byte buffer that passes data from one writer thread to one
+ *         reader thread.
+ *
+ * The writer blocks while the buffer is full, the reader blocks while it is
+ * empty, so memory use never exceeds the capacity, no matter how much data
+ * passes through the buffer.
+ */
+class RingBuffer
+{
+  public:
+    /** \brief Constructor.
+     *
+     * \param capacity  maximum number of bytes in the buffer, must not be zero
+     */
+    explicit RingBuffer(const std::size_t capacity);
+
+
+    RingBuffer(const RingBuffer& other) = delete;
+    RingBuffer& operator=(const RingBuffer& other) = delete;
+
+
+    /** \brief Adds data to the buffer, waiting for free space if necessary.
+     *
+     * \param input  the data to add
+     * \return Returns true, if all data was added.
+     *         Returns false, if the buffer was aborted or closed.
+     */
+    bool write(const std::string_view& input);
+
+
+    /** \brief Takes data from the buffer, waiting for data if necessary.
+     *
+     * \param buffer  destination of the data
+     * \param size    maximum number of bytes to take
+     * \return Returns the number of bytes copied to buffer.
+     *         Returns zero, if the buffer is closed and all data was read, or
+     *         if the buffer was aborted.
+     */
+    std::size_t read(char* buffer, const std::size_t size);
+
+
+    /** \brief Waits until the buffer is full, closed or aborted.
+     *
+     * \return Returns the number of bytes in the buffer.
+     */
+    std::size_t waitUntilFilled();
+
+
+    /** \brief Signals that the writer has added all data.
+     */
+    void close();
+
+
+    /** \brief Signals that one side failed. Waiting calls on both sides return.
+     */
+    void abort();
+
+
+    /** \brief Checks whether the writer has added all data.
+     *
+     * \return Returns true, if close() was called.
+     */
+    bool closed() const;
+
+
+    /** \brief Checks whether the transfer was aborted.
+     *
+     * \return Returns true, if abort() was called.
+     */
+    bool aborted() const;
+
+
+    /** \brief Gets the maximum number of bytes in the buffer.
+     *
+     * \return Returns the capacity.
+     */
+    std::size_t capacity() const;
+  private:
+    std::vector<char> data; /**< storage of the buffer */
+    std::size_t start; /**< index of the first byte in data */
+    std::size_t used; /**< number of bytes in the buffer */
+    bool isClosed; /**< whether the writer is done */
+    bool isAborted; /**< whether one side failed */
+    mutable std::mutex mutex; /**< protects all members */
+    std::condition_variable changed; /**< signals new data, free space or state changes */
+}; // class
+
+} // namespace
+
+#endif // BVN_RINGBUFFER_HPP
@@ -0,0 +1,83 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_SHA256_HPP
+#define BVN_SHA256_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace bvn
+{
+
+/** \brief Calculates SHA-256 message digests (FIPS 180-4).
+ *
+ * Data can be added in several steps with update(), e. g. while it is
+ * received, before the digest is calculated with hexDigest().
+ */
+class Sha256
+{
+  public:
+    /** \brief Creates a new hash calculation without any data.
+     */
+    Sha256();
+
+
+    /** \brief Adds data to the hash calculation.
+     *
+     * \param data  the data to add
+     */
+    void update(const std::string_view& data);
+
+
+    /** \brief Finishes the hash calculation.
+     *
+     * \return Returns the digest as string of 64 lower case hexadecimal digits.
+     * \remarks After this call, the instance starts a new calculation.
+     */
+    std::string hexDigest();
+
+
+    /** \brief Calculates the digest of the given data.
+     *
+     * \param data  the data
+     * \return Returns the digest as string of 64 lower case hexadecimal digits.
+     */
+    static std::string hash(const std::string_view& data);
+  private:
+    /** \brief Resets the state to the start of a new calculation.
+     */
+    void reset();
+
+    /** \brief Processes the 64 bytes in the block buffer.
+     */
+    void processBlock();
+
+    std::array<uint32_t, 8> state; /**< intermediate hash value */
+    std::array<unsigned char, 64> block; /**< buffer for the current block */
+    std::size_t blockSize; /**< number of bytes in the block buffer */
+    uint64_t totalSize; /**< total number of bytes added so far */
+}; // class
+
+} // namespace
+
+#endif // BVN_SHA256_HPP
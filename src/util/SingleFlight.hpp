@@ -0,0 +1,140 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#ifndef BVN_SINGLEFLIGHT_HPP
+#define BVN_SINGLEFLIGHT_HPP
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include "Deadline.hpp"
+
+namespace bvn
+{
+
+/** \brief Coalesces concurrent calls with the same key into a single call.
+ *
+ * The first caller for a key executes the work. Callers that arrive with
+ * the same key while the work is still running do not execute it again,
+ * they wait for the result of the first caller instead.
+ *
+ * \tparam T  type of the result of the work; it is copied to all callers
+ */
+template<typename T>
+class SingleFlight
+{
+  public:
+    SingleFlight() = default;
+
+    SingleFlight(const SingleFlight& other) = delete;
+    SingleFlight& operator=(const SingleFlight& other) = delete;
+
+
+    /** \brief Executes the work, or waits for the result of a running call
+     *         with the same key.
+     *
+     * \param key   key that identifies the work, e. g. the URL of a request
+     * \param work  function without parameters that returns a T
+     * \return Returns an optional containing the result of the work.
+     *         Returns an empty optional, if the current deadline of the
+     *         calling thread expired or was cancelled while waiting for
+     *         another call. The first caller always gets a result.
+     * \remarks If the work throws an exception, the exception is rethrown in
+     *          all callers.
+     */
+    template<typename F>
+    std::optional<T> run(const std::string& key, F&& work)
+    {
+      std::shared_future<T> running;
+      std::promise<T> promise;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto iter = calls.find(key);
+        if (iter != calls.end())
+        {
+          running = iter->second;
+        }
+        else
+        {
+          calls.emplace(key, promise.get_future().share());
+        }
+      }
+
+      if (running.valid())
+      {
+        const Deadline deadline = Deadline::current();
+        while (running.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready)
+        {
+          if (deadline.expired() || deadline.cancelled())
+          {
+            return std::nullopt;
+          }
+        }
+        return running.get();
+      }
+
+      try
+      {
+        T result = work();
+        finish(key);
+        promise.set_value(result);
+        return result;
+      }
+      catch (...)
+      {
+        finish(key);
+        promise.set_exception(std::current_exception());
+        throw;
+      }
+    }
+
+
+    /** \brief Gets the number of keys whose work is currently running.
+     *
+     * \return Returns the number of running calls.
+     */
+    std::size_t inFlight() const
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      return calls.size();
+    }
+  private:
+    /** \brief Removes a finished call, so that later callers start anew.
+     *
+     * \param key  key of the call
+     */
+    void finish(const std::string& key)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      calls.erase(key);
+    }
+
+    std::unordered_map<std::string, std::shared_future<T>> calls; /**< running calls by key */
+    mutable std::mutex mutex; /**< protects calls */
+}; // class
+
+} // namespace
+
+#endif // BVN_SINGLEFLIGHT_HPP
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2017, 2020, 2023  Dirk Stolle
+    Copyright (C) 2017, 2020, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,23 +19,24 @@
 */
 
 #include "Strings.hpp"
-#include <limits>
+#include <charconv>
 #include <sstream>
 
 namespace bvn
 {
 
-std::vector<std::string> split(std::string line, const char separator)
+std::vector<std::string> split(const std::string_view& line, const char separator)
 {
   std::vector<std::string> result;
-  std::string::size_type pos = line.find(separator);
-  while (pos != std::string::npos)
+  std::string_view::size_type start = 0;
+  std::string_view::size_type pos = line.find(separator);
+  while (pos != std::string_view::npos)
   {
-    result.push_back(line.substr(0, pos));
-    line.erase(0, pos + 1);
-    pos = line.find(separator);
+    result.emplace_back(line.substr(start, pos - start));
+    start = pos + 1;
+    pos = line.find(separator, start);
   }
-  result.push_back(line);
+  result.emplace_back(line.substr(start));
   return result;
 }
 
@@ -130,57 +131,26 @@ void trim(std::string& str1)
   return;
 }
 
-bool stringToInt(const std::string& str, int& value)
+std::string_view trimmed(const std::string_view& str)
 {
-  if (str.empty())
+  const auto first = str.find_first_not_of(" \t");
+  if (first == std::string_view::npos)
   {
-    return false;
+    return std::string_view();
   }
-  value = 0;
-  unsigned int i;
-  constexpr int cTenthLimit = std::numeric_limits<int>::max() / 10;
-  constexpr int cRealLimit = std::numeric_limits<int>::max();
-  bool negative;
-  if (str[0] == '-')
-  {
-    i = 1;
-    negative = true;
-  }
-  else
-  {
-    i = 0;
-    negative = false;
-  }
-  for ( ; i < str.size(); ++i)
-  {
-    if ((str[i] >= '0') && (str[i] <= '9'))
-    {
-      /* If the result of the multiplication in the next line would go out of
-         the type range, then the result is not useful anyway, so quit here. */
-      if (value > cTenthLimit)
-      {
-        return false;
-      }
-      value = value * 10;
-      /* If the result of the addition in the next line would go out of the
-         type's range, then the result is not useful anyway, so quit here. */
-      if (value > cRealLimit - (str[i] - '0'))
-      {
-        return false;
-      }
-      value = value + (str[i] - '0');
-    } // if
-    else
-    {
-      // unknown or invalid character detected
-      return false;
-    }
-  } // for
-  if (negative)
+  const auto last = str.find_last_not_of(" \t");
+  return str.substr(first, last - first + 1);
+}
+
+bool stringToInt(const std::string_view& str, int& value)
+{
+  if (str.empty())
   {
-    value = -value;
+    return false;
   }
-  return true;
+  const char* last = str.data() + str.size();
+  const auto [ptr, ec] = std::from_chars(str.data(), last, value);
+  return (ec == std::errc()) && (ptr == last);
 }
 
 bool endsWith(const std::string& str, const std::string& suffix)
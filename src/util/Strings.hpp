@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2017, 2020, 2023, 2024  Dirk Stolle
+    Copyright (C) 2017, 2020, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -22,6 +22,7 @@
 #define BVN_STRINGS_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace bvn
@@ -33,7 +34,7 @@ namespace bvn
  * \param separator   character that works as separator for parts / substrings
  * \return Returns a vector of strings, containing the split strings.
  */
-std::vector<std::string> split(std::string line, const char separator = ' ');
+std::vector<std::string> split(const std::string_view& line, const char separator = ' ');
 
 /** \brief Returns the lower case version of the given string.
  *
@@ -52,6 +53,15 @@ std::string toLowerString(std::string str);
 void trim(std::string& str1);
 
 
+/** \brief Gets a view on the given string without leading and trailing spaces
+ *  and (horizontal) tabulators.
+ *
+ * \param str  the string view that shall be trimmed
+ * \return Returns the trimmed view. It points into the same memory as str.
+ */
+std::string_view trimmed(const std::string_view& str);
+
+
 /** \brief Tries to convert the string representation of an integer number into an int.
  *
  * \param str   the string that contains the number
@@ -59,7 +69,7 @@ void trim(std::string& str1);
  * \return Returns true on success, false on failure.
  * \remarks If false is returned, the value of parameter value is undefined.
  */
-bool stringToInt(const std::string& str, int& value);
+bool stringToInt(const std::string_view& str, int& value);
 
 
 /** \brief Checks whether a string ends with a given suffix.
@@ -0,0 +1,106 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "ThreadPool.hpp"
+
+namespace bvn
+{
+
+ThreadPool::ThreadPool(const unsigned int threads)
+: workers(),
+  jobs(),
+  mutex(),
+  condition(),
+  stopping(false)
+{
+  workers.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    workers.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  shutdown();
+}
+
+void ThreadPool::shutdown()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+  for (auto& thread: workers)
+  {
+    thread.join();
+  }
+  workers.clear();
+}
+
+unsigned int ThreadPool::size() const
+{
+  return workers.size();
+}
+
+bool ThreadPool::runPendingJob()
+{
+  std::function<void()> job;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (jobs.empty())
+    {
+      return false;
+    }
+    job = std::move(jobs.front().run);
+    jobs.pop_front();
+  }
+  job();
+  return true;
+}
+
+void ThreadPool::work()
+{
+  while (true)
+  {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+      // Queued jobs are still finished when the pool is stopped, unless
+      // nobody waits for their results anymore.
+      if (jobs.empty())
+      {
+        return;
+      }
+      const bool dropped = stopping && jobs.front().deadline.expired();
+      job = std::move(jobs.front().run);
+      jobs.pop_front();
+      if (dropped)
+      {
+        continue;
+      }
+    }
+    job();
+  }
+}
+
+} // namespace
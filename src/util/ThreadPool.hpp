@@ -0,0 +1,169 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef BVN_THREADPOOL_HPP
+#define BVN_THREADPOOL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Deadline.hpp"
+
+namespace bvn
+{
+
+/** \brief Fixed-size pool of worker threads that executes queued jobs.
+ *
+ * A pool without any threads executes every job immediately within the
+ * thread that submits it. That allows code written against the pool to be
+ * used synchronously, too.
+ */
+class ThreadPool
+{
+  public:
+    /** \brief Creates a new thread pool.
+     *
+     * \param threads  number of worker threads; zero means that jobs are
+     *                 executed directly in the submitting thread
+     */
+    explicit ThreadPool(const unsigned int threads);
+
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+
+    /** \brief Destructor. Stops the pool, see shutdown().
+     */
+    ~ThreadPool();
+
+
+    /** \brief Stops the pool and joins the worker threads.
+     *
+     * Queued jobs are still executed, unless their deadline has expired or
+     * was cancelled. Such jobs are dropped, and their futures report a
+     * broken promise. After the shutdown, new jobs are executed directly in
+     * the submitting thread.
+     *
+     * \remarks Must not be called while other threads submit jobs.
+     */
+    void shutdown();
+
+
+    /** \brief Gets the number of worker threads.
+     *
+     * \return Returns the number of worker threads of the pool.
+     */
+    unsigned int size() const;
+
+
+    /** \brief Queues a job for execution.
+     *
+     * The job is executed with the current deadline of the submitting thread.
+     *
+     * \param job   the function to execute
+     * \return Returns a future that gets the result of the job.
+     */
+    template<typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& job)
+    {
+      using R = std::invoke_result_t<F>;
+      auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(job));
+      std::future<R> result = task->get_future();
+      if (workers.empty())
+      {
+        (*task)();
+        return result;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        // The job inherits the current deadline of the submitting thread.
+        const Deadline deadline = Deadline::current();
+        jobs.push_back(Job{ deadline, [task, deadline]()
+        {
+          Deadline::Scope scope(deadline);
+          (*task)();
+        }});
+      }
+      condition.notify_one();
+      return result;
+    }
+
+
+    /** \brief Waits for a future that was returned by submit().
+     *
+     * While the result is not ready yet, the waiting thread executes other
+     * queued jobs. This keeps jobs that wait for other jobs of the same pool
+     * from blocking all worker threads.
+     *
+     * \param future  the future to wait for
+     * \return Returns the result of the future.
+     */
+    template<typename T>
+    T await(std::future<T>& future)
+    {
+      while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      {
+        if (!runPendingJob())
+        {
+          future.wait_for(std::chrono::milliseconds(5));
+        }
+      }
+      return future.get();
+    }
+
+
+    /** \brief Executes one queued job in the current thread, if there is any.
+     *
+     * This allows threads that wait for several jobs to help with the work.
+     *
+     * \return Returns true, if a job was executed.
+     */
+    bool runPendingJob();
+  private:
+    /** \brief a queued job
+     */
+    struct Job
+    {
+      Deadline deadline; /**< deadline of the job */
+      std::function<void()> run; /**< executes the job */
+    }; // struct
+
+    /** \brief Main function of each worker thread.
+     */
+    void work();
+
+    std::vector<std::thread> workers; /**< worker threads */
+    std::deque<Job> jobs; /**< queued jobs */
+    std::mutex mutex; /**< protects jobs and stopping */
+    std::condition_variable condition; /**< signals new jobs or stop */
+    bool stopping; /**< whether the pool is shutting down */
+}; // class
+
+} // namespace
+
+#endif // BVN_THREADPOOL_HPP
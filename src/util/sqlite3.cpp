@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2024  Dirk Stolle
+    Copyright (C) 2020, 2022, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -91,4 +91,89 @@ bool bind(statement& stmt, const int index, const int64_t value)
   return sqlite3_bind_int64(stmt.get(), index, value) == SQLITE_OK;
 }
 
+Connection::Handle::Handle(Connection& conn)
+: lock(conn.mutex),
+  connection(conn),
+  used()
+{
+}
+
+Connection::Handle::~Handle()
+{
+  // Resetting releases the read transaction of a statement that did not run
+  // to completion, otherwise it could hold up checkpoints of the WAL file.
+  for (sqlite3_stmt* stmt: used)
+  {
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+  }
+}
+
+database& Connection::Handle::db()
+{
+  return connection.db;
+}
+
+statement& Connection::Handle::prepared(const std::string& sqlStmt)
+{
+  auto& stmt = connection.statements.try_emplace(sqlStmt, nullptr, sqlite3_finalize).first->second;
+  if (!stmt && connection.db)
+  {
+    stmt = prepare(connection.db, sqlStmt);
+  }
+  if (stmt)
+  {
+    used.push_back(stmt.get());
+  }
+  return stmt;
+}
+
+Connection::Connection(const std::string& fileName)
+: name(fileName),
+  db(nullptr, sqlite3_close),
+  statements(),
+  mutex()
+{
+  if (fileName.empty())
+  {
+    return;
+  }
+  db = open(fileName);
+  if (!db)
+  {
+    return;
+  }
+  // Wait for locks held by other processes instead of failing immediately.
+  sqlite3_busy_timeout(db.get(), 5000);
+  // With write-ahead logging a commit only appends to the log, and NORMAL
+  // synchronisation is safe in that mode. Failure is not fatal, the database
+  // just keeps its rollback journal.
+  if (!exec(db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;"))
+  {
+    std::clog << "Warning: Could not enable write-ahead logging for database "
+              << fileName << "." << std::endl;
+  }
+}
+
+bool Connection::isOpen() const
+{
+  return db != nullptr;
+}
+
+const std::string& Connection::fileName() const
+{
+  return name;
+}
+
+Connection::Handle Connection::lock()
+{
+  return Handle(*this);
+}
+
+std::size_t Connection::cachedStatements()
+{
+  std::lock_guard<std::mutex> guard(mutex);
+  return statements.size();
+}
+
 } // namespace
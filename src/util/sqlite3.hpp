@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the botvinnik Matrix bot.
-    Copyright (C) 2020, 2022, 2025  Dirk Stolle
+    Copyright (C) 2020, 2022, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -23,6 +23,10 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <sqlite3.h>
 
 namespace bvn::sql
@@ -94,6 +98,115 @@ bool bind(statement& stmt, const int index, const std::string& value);
  */
 bool bind(statement& stmt, const int index, const int64_t value);
 
-}
+
+/** \brief Long-lived connection to an SQLite 3 database that caches its
+ *         prepared statements.
+ *
+ * The connection is opened once and uses write-ahead logging, so readers do
+ * not block writers and commits are cheap. All access goes through a Handle,
+ * which holds the lock of the connection for its lifetime. Therefore, one
+ * Connection can be shared between threads.
+ */
+class Connection
+{
+  public:
+    /** \brief Grants exclusive access to the connection while it exists.
+     */
+    class Handle
+    {
+      public:
+        Handle(const Handle& other) = delete;
+        Handle& operator=(const Handle& other) = delete;
+
+
+        /** \brief Resets all statements that were used via this handle.
+         */
+        ~Handle();
+
+
+        /** \brief Gets the underlying database connection.
+         *
+         * \return Returns the database connection.
+         */
+        database& db();
+
+
+        /** \brief Gets a prepared statement from the statement cache, or
+         *         prepares it, if it is not in the cache yet.
+         *
+         * \param sqlStmt  SQL for the prepared statement
+         * \return Returns the prepared statement. All its parameters are
+         *         unbound and it has not been stepped yet.
+         *         If no statement could be prepared, the unique_ptr is not set.
+         * \remarks The statement must not be used after the handle has been
+         *          destroyed.
+         */
+        statement& prepared(const std::string& sqlStmt);
+      private:
+        friend class Connection;
+
+        /** \brief Locks the connection.
+         *
+         * \param conn  the connection to lock
+         */
+        explicit Handle(Connection& conn);
+
+        std::unique_lock<std::mutex> lock; /**< lock of the connection */
+        Connection& connection; /**< the locked connection */
+        std::vector<sqlite3_stmt*> used; /**< statements that need a reset */
+    }; // class
+
+
+    /** \brief Opens the database and switches it to write-ahead logging.
+     *
+     * If a file with the given name already exists, it will be opened.
+     * If no such file exists, it will be created.
+     * \param fileName  name of the database file to open / create; an empty
+     *                  file name creates a connection that is not open
+     */
+    explicit Connection(const std::string& fileName);
+
+
+    Connection(const Connection& other) = delete;
+    Connection& operator=(const Connection& other) = delete;
+
+
+    /** \brief Checks whether the database connection is open.
+     *
+     * \return Returns true, if the connection is open and can be used.
+     */
+    bool isOpen() const;
+
+
+    /** \brief Gets the file name of the database.
+     *
+     * \return Returns the file name that was passed to the constructor.
+     */
+    const std::string& fileName() const;
+
+
+    /** \brief Gets exclusive access to the connection.
+     *
+     * \return Returns a handle that keeps the connection locked until it is
+     *         destroyed.
+     * \remarks Do not acquire a second handle in the same thread while the
+     *          first one still exists, that would dead-lock.
+     */
+    Handle lock();
+
+
+    /** \brief Gets the number of statements in the statement cache.
+     *
+     * \return Returns the number of cached prepared statements.
+     */
+    std::size_t cachedStatements();
+  private:
+    std::string name; /**< file name of the database */
+    database db; /**< the database connection */
+    std::unordered_map<std::string, statement> statements; /**< cache of prepared statements by SQL */
+    std::mutex mutex; /**< protects db and statements */
+}; // class
+
+} // namespace
 
 #endif // BVN_UTIL_SQLITE3_HPP
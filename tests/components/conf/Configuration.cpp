@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2020, 2022, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -43,6 +43,8 @@ TEST_CASE("Configuration")
     REQUIRE( conf.translationServer().empty() );
     REQUIRE( conf.translationApiKey().empty() );
     REQUIRE( conf.gifApiKey().empty() );
+    REQUIRE( conf.geoNamesFile().empty() );
+    REQUIRE_FALSE( conf.geoNamesPrimary() );
   }
 
   SECTION("comment character must be a printable non-space character")
@@ -67,6 +69,13 @@ TEST_CASE("Configuration")
     REQUIRE( Configuration::default_sync_delay < Configuration::max_sync_delay );
   }
 
+  SECTION("command time limits: minimum, default and maximum are ordered")
+  {
+    REQUIRE( Configuration::min_command_timeout > std::chrono::milliseconds::zero() );
+    REQUIRE( Configuration::min_command_timeout < Configuration::default_command_timeout );
+    REQUIRE( Configuration::default_command_timeout < Configuration::max_command_timeout );
+  }
+
   SECTION("potentialFileNames()")
   {
     SECTION("values must not be empty")
@@ -1166,6 +1175,115 @@ TEST_CASE("Configuration")
       REQUIRE( conf.translationApiKey() == "abcdef1234567890" );
     }
 
+    SECTION("missing command time limit becomes default value")
+    {
+      const std::filesystem::path path{"missing-command-timeout.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.commandTimeout("cheat") == Configuration::default_command_timeout );
+    }
+
+    SECTION("command time limits for specific commands")
+    {
+      const std::filesystem::path path{"command-timeouts.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      command.timeout_milliseconds=8000
+      command.timeout_milliseconds.tr=20000
+      command.timeout_milliseconds.weather=100
+      command.timeout_milliseconds.cheat=9000000
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.commandTimeout("deb") == std::chrono::milliseconds(8000) );
+      REQUIRE( conf.commandTimeout("tr") == std::chrono::milliseconds(20000) );
+      REQUIRE( conf.commandTimeout("weather") == Configuration::min_command_timeout );
+      REQUIRE( conf.commandTimeout("cheat") == Configuration::max_command_timeout );
+    }
+
+    SECTION("invalid: multiple general command time limits")
+    {
+      const std::filesystem::path path{"multiple-command-timeouts.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      command.timeout_milliseconds=8000
+      command.timeout_milliseconds=9000
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: multiple time limits for the same command")
+    {
+      const std::filesystem::path path{"multiple-command-timeouts-same-command.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      command.timeout_milliseconds.tr=8000
+      command.timeout_milliseconds.tr=9000
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: command time limit is not an int")
+    {
+      const std::filesystem::path path{"command-timeout-not-an-int.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      command.timeout_milliseconds.tr=soon
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
     SECTION("invalid: multiple LibreTranslate servers")
     {
       const std::filesystem::path path{"multiple-libretranslate-servers.conf"};
@@ -1243,6 +1361,580 @@ TEST_CASE("Configuration")
       REQUIRE_FALSE( conf.load(path.string()) );
     }
 
+    SECTION("missing Giphy pool settings become default values")
+    {
+      const std::filesystem::path path{"missing-giphy-pool.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.giphyPoolSize() == Configuration::default_giphy_pool_size );
+      REQUIRE( conf.giphyPoolKeywords() == Configuration::default_giphy_pool_keywords );
+      REQUIRE( conf.giphyPoolRefresh() == Configuration::default_giphy_pool_refresh );
+      REQUIRE( conf.giphyPoolUploadsPerHour() == Configuration::default_giphy_pool_uploads_per_hour );
+    }
+
+    SECTION("Giphy pool settings")
+    {
+      const std::filesystem::path path{"giphy-pool.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # gif server settings
+      giphy.pool.size=5
+      giphy.pool.keywords=20
+      giphy.pool.refresh_minutes=30
+      giphy.pool.uploads_per_hour=12
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.giphyPoolSize() == 5 );
+      REQUIRE( conf.giphyPoolKeywords() == 20 );
+      REQUIRE( conf.giphyPoolRefresh() == std::chrono::minutes(30) );
+      REQUIRE( conf.giphyPoolUploadsPerHour() == 12 );
+    }
+
+    SECTION("Giphy pool can be disabled")
+    {
+      const std::filesystem::path path{"giphy-pool-disabled.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # gif server settings
+      giphy.pool.size=0
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.giphyPoolSize() == 0 );
+    }
+
+    SECTION("invalid: multiple Giphy pool sizes")
+    {
+      const std::filesystem::path path{"multiple-giphy-pool-sizes.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # gif server settings
+      giphy.pool.size=3
+      giphy.pool.size=4
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: Giphy pool size is not an int")
+    {
+      const std::filesystem::path path{"giphy-pool-size-not-an-int.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # gif server settings
+      giphy.pool.size=three
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: Giphy pool size is above maximum")
+    {
+      const std::filesystem::path path{"giphy-pool-size-too-large.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # gif server settings
+      giphy.pool.size=21
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: Giphy pool without keywords")
+    {
+      const std::filesystem::path path{"giphy-pool-no-keywords.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # gif server settings
+      giphy.pool.keywords=0
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: Giphy pool refresh interval is below one minute")
+    {
+      const std::filesystem::path path{"giphy-pool-refresh-zero.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # gif server settings
+      giphy.pool.refresh_minutes=0
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: Giphy pool upload budget is negative")
+    {
+      const std::filesystem::path path{"giphy-pool-negative-budget.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # gif server settings
+      giphy.pool.uploads_per_hour=-5
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("missing xkcd upload rate becomes default value")
+    {
+      const std::filesystem::path path{"missing-xkcd-preupload.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.xkcdPreUploadsPerHour() == Configuration::default_xkcd_preuploads_per_hour );
+    }
+
+    SECTION("xkcd upload rate")
+    {
+      const std::filesystem::path path{"xkcd-preupload.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # xkcd settings
+      xkcd.preupload.per_hour=0
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.xkcdPreUploadsPerHour() == 0 );
+    }
+
+    SECTION("invalid: multiple xkcd upload rates")
+    {
+      const std::filesystem::path path{"multiple-xkcd-preuploads.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # xkcd settings
+      xkcd.preupload.per_hour=10
+      xkcd.preupload.per_hour=20
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: xkcd upload rate is above maximum")
+    {
+      const std::filesystem::path path{"xkcd-preupload-too-high.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # xkcd settings
+      xkcd.preupload.per_hour=3601
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("missing cheat sheet settings become default values")
+    {
+      const std::filesystem::path path{"missing-cheat-sheet.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.cheatSheetDirectory().empty() );
+      REQUIRE( conf.cheatSheetReload() == Configuration::default_cheat_sheet_reload );
+    }
+
+    SECTION("cheat sheet settings")
+    {
+      const std::filesystem::path path{"cheat-sheet.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # cheat sheet settings
+      cheat.directory=/var/lib/botvinnik/tldr/pages
+      cheat.reload_seconds=0
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.cheatSheetDirectory() == "/var/lib/botvinnik/tldr/pages" );
+      REQUIRE( conf.cheatSheetReload() == std::chrono::seconds::zero() );
+    }
+
+    SECTION("invalid: multiple cheat sheet directories")
+    {
+      const std::filesystem::path path{"multiple-cheat-sheet-directories.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # cheat sheet settings
+      cheat.directory=/var/lib/botvinnik/tldr/pages
+      cheat.directory=/var/lib/botvinnik/cheatsheets
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: cheat sheet reload interval is above maximum")
+    {
+      const std::filesystem::path path{"cheat-sheet-reload-too-high.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # cheat sheet settings
+      cheat.reload_seconds=86401
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("missing Debian Sources settings become default values")
+    {
+      const std::filesystem::path path{"missing-debian-sources.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.debianSources().empty() );
+      REQUIRE( conf.debianSourcesRefresh() == Configuration::default_debian_sources_refresh );
+    }
+
+    SECTION("Debian Sources settings")
+    {
+      const std::filesystem::path path{"debian-sources.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # Debian Sources files
+      debian.sources.trixie=/var/lib/apt/lists/trixie_main_Sources
+      debian.sources.trixie=/var/lib/apt/lists/trixie_contrib_Sources
+      debian.sources.bookworm=/var/lib/apt/lists/bookworm_main_Sources
+      debian.sources.refresh_minutes=240
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.debianSources().size() == 2 );
+      const std::vector<std::string> trixie = { "/var/lib/apt/lists/trixie_main_Sources", "/var/lib/apt/lists/trixie_contrib_Sources" };
+      REQUIRE( conf.debianSources().at("trixie") == trixie );
+      REQUIRE( conf.debianSources().at("bookworm") == std::vector<std::string>{ "/var/lib/apt/lists/bookworm_main_Sources" } );
+      REQUIRE( conf.debianSourcesRefresh() == std::chrono::minutes(240) );
+    }
+
+    SECTION("invalid: Sources file for unknown Debian suite")
+    {
+      const std::filesystem::path path{"debian-sources-unknown-suite.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # Debian Sources files
+      debian.sources.hamm=/var/lib/apt/lists/hamm_main_Sources
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: same Debian Sources file twice")
+    {
+      const std::filesystem::path path{"debian-sources-twice.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # Debian Sources files
+      debian.sources.trixie=/var/lib/apt/lists/trixie_main_Sources
+      debian.sources.trixie=/var/lib/apt/lists/trixie_main_Sources
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: Debian Sources refresh interval is zero")
+    {
+      const std::filesystem::path path{"debian-sources-refresh-zero.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      # Debian Sources files
+      debian.sources.refresh_minutes=0
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("GeoNames settings")
+    {
+      const std::filesystem::path path{"geonames.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      weather.geonames.file=/var/lib/botvinnik/cities15000.txt
+      weather.geonames.mode=primary
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.geoNamesFile() == "/var/lib/botvinnik/cities15000.txt" );
+      REQUIRE( conf.geoNamesPrimary() );
+    }
+
+    SECTION("GeoNames mode defaults to fallback")
+    {
+      const std::filesystem::path path{"geonames-fallback.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      weather.geonames.file=/var/lib/botvinnik/cities15000.txt
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE( conf.load(path.string()) );
+      REQUIRE( conf.geoNamesFile() == "/var/lib/botvinnik/cities15000.txt" );
+      REQUIRE_FALSE( conf.geoNamesPrimary() );
+    }
+
+    SECTION("invalid: multiple GeoNames files")
+    {
+      const std::filesystem::path path{"multiple-geonames-files.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      weather.geonames.file=/var/lib/botvinnik/cities15000.txt
+      weather.geonames.file=/var/lib/botvinnik/cities500.txt
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
+    SECTION("invalid: unknown GeoNames mode")
+    {
+      const std::filesystem::path path{"invalid-geonames-mode.conf"};
+      const std::string content = R"conf(
+      # Matrix server login settings
+      matrix.homeserver=https://matrix.example.tld/
+      matrix.userid=@alice:matrix.example.tld
+      matrix.password=secret, secret, top(!) secret
+      # bot management settings
+      command.prefix=!
+      bot.stop.allowed.userid=@bob:matrix.example.tld
+      weather.geonames.file=/var/lib/botvinnik/cities15000.txt
+      weather.geonames.mode=sometimes
+      )conf";
+      REQUIRE( writeConfiguration(path, content) );
+      FileGuard guard{path};
+
+      Configuration conf;
+      REQUIRE_FALSE( conf.load(path.string()) );
+    }
+
     SECTION("invalid: unknown setting name")
     {
       const std::filesystem::path path{"unknown-setting.conf"};
@@ -0,0 +1,82 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../../locate_catch.hpp"
+#include "../../../src/matrix/MediaCache.hpp"
+#include "../../../src/util/PersistentCache.hpp"
+
+TEST_CASE("MediaCache")
+{
+  using namespace bvn;
+
+  PersistentCache store("");
+
+  SECTION("unknown media")
+  {
+    MediaCache cache;
+    cache.setStore(&store);
+    REQUIRE_FALSE( cache.byUrl("https://example.com/a.png").has_value() );
+    REQUIRE_FALSE( cache.byHash("abc").has_value() );
+  }
+
+  SECTION("lookup by URL and by hash are separate")
+  {
+    MediaCache cache;
+    cache.setStore(&store);
+    cache.putUrl("https://example.com/a.png", "mxc://example.com/a");
+    cache.putHash("abc", "mxc://example.com/b");
+
+    REQUIRE( cache.byUrl("https://example.com/a.png") == "mxc://example.com/a" );
+    REQUIRE( cache.byHash("abc") == "mxc://example.com/b" );
+    REQUIRE_FALSE( cache.byHash("https://example.com/a.png").has_value() );
+    REQUIRE_FALSE( cache.byUrl("abc").has_value() );
+
+    cache.putUrl("https://example.com/a.png", "mxc://example.com/c");
+    REQUIRE( cache.byUrl("https://example.com/a.png") == "mxc://example.com/c" );
+  }
+
+  SECTION("nothing is cached without a store")
+  {
+    MediaCache cache;
+    cache.putUrl("https://example.com/a.png", "mxc://a");
+    REQUIRE_FALSE( cache.byUrl("https://example.com/a.png").has_value() );
+
+    cache.setStore(&store);
+    cache.putUrl("https://example.com/a.png", "mxc://a");
+    cache.setStore(nullptr);
+    REQUIRE_FALSE( cache.byUrl("https://example.com/a.png").has_value() );
+  }
+
+  SECTION("URIs are kept in the store")
+  {
+    MediaCache cache;
+    cache.setStore(&store);
+    cache.putUrl("https://example.com/a.png", "mxc://a");
+    cache.putHash("0123", "mxc://b");
+    REQUIRE( store.get("media", "url:https://example.com/a.png") == "mxc://a" );
+    REQUIRE( store.get("media", "sha256:0123") == "mxc://b" );
+
+    // a new cache instance finds entries of the old one
+    MediaCache other;
+    other.setStore(&store);
+    REQUIRE( other.byHash("0123") == "mxc://b" );
+    REQUIRE_FALSE( other.byHash("4567").has_value() );
+  }
+}
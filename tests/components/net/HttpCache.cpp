@@ -0,0 +1,240 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "../../locate_catch.hpp"
+#include "../../../src/net/HttpCache.hpp"
+#include "../../../src/util/PersistentCache.hpp"
+
+TEST_CASE("HttpCache")
+{
+  using namespace bvn;
+  using namespace std::chrono_literals;
+  using std::chrono::system_clock;
+
+  // Sun, 06 Nov 1994 08:49:37 GMT
+  const system_clock::time_point date(std::chrono::seconds(784111777));
+
+  SECTION("parseDate")
+  {
+    const auto parsed = HttpCache::parseDate("Sun, 06 Nov 1994 08:49:37 GMT");
+    REQUIRE( parsed.has_value() );
+    REQUIRE( parsed.value() == date );
+
+    REQUIRE( HttpCache::parseDate("Thu, 01 Jan 1970 00:00:00 GMT").value() == system_clock::time_point() );
+    REQUIRE( HttpCache::parseDate("Tue, 29 Feb 2028 23:59:59 GMT").value() == system_clock::time_point(std::chrono::seconds(1835481599)) );
+
+    REQUIRE_FALSE( HttpCache::parseDate("").has_value() );
+    REQUIRE_FALSE( HttpCache::parseDate("0").has_value() );
+    REQUIRE_FALSE( HttpCache::parseDate("Sunday, 06-Nov-94 08:49:37 GMT").has_value() );
+    REQUIRE_FALSE( HttpCache::parseDate("Sun, 06 Foo 1994 08:49:37 GMT").has_value() );
+    REQUIRE_FALSE( HttpCache::parseDate("Sun, 06 Nov 1994 25:49:37 GMT").has_value() );
+    REQUIRE_FALSE( HttpCache::parseDate("Sun, 06 Nov 1994 08:49:37 CET").has_value() );
+  }
+
+  SECTION("key")
+  {
+    REQUIRE( HttpCache::key("https://example.com/", {}) == "https://example.com/" );
+    // order of headers does not matter
+    REQUIRE( HttpCache::key("https://example.com/", { "A: 1", "B: 2" })
+             == HttpCache::key("https://example.com/", { "B: 2", "A: 1" }) );
+    REQUIRE( HttpCache::key("https://example.com/", { "A: 1" })
+             != HttpCache::key("https://example.com/", { "A: 2" }) );
+  }
+
+  SECTION("fromResponse: max-age")
+  {
+    const std::vector<std::string> headers = {
+        "HTTP/2 200",
+        "date: Sun, 06 Nov 1994 08:49:37 GMT",
+        "Cache-Control: public, max-age=300",
+        "ETag: \"abc\""
+    };
+    const auto entry = HttpCache::fromResponse("body", "text/plain", headers, date);
+    REQUIRE( entry.has_value() );
+    REQUIRE( entry.value().body == "body" );
+    REQUIRE( entry.value().contentType == "text/plain" );
+    REQUIRE( entry.value().etag == "\"abc\"" );
+    REQUIRE( entry.value().lastModified.empty() );
+    REQUIRE( entry.value().expires == date + 300s );
+    REQUIRE( entry.value().fresh(date + 299s) );
+    REQUIRE_FALSE( entry.value().fresh(date + 300s) );
+    REQUIRE( entry.value().validatable() );
+  }
+
+  SECTION("fromResponse: Age reduces freshness")
+  {
+    const std::vector<std::string> headers = {
+        "HTTP/1.1 200 OK",
+        "Date: Sun, 06 Nov 1994 08:49:37 GMT",
+        "Cache-Control: max-age=300",
+        "Age: 100"
+    };
+    const auto entry = HttpCache::fromResponse("body", "", headers, date);
+    REQUIRE( entry.has_value() );
+    REQUIRE( entry.value().expires == date + 200s );
+    REQUIRE_FALSE( entry.value().validatable() );
+  }
+
+  SECTION("fromResponse: only headers of final response are used")
+  {
+    const std::vector<std::string> headers = {
+        "HTTP/1.1 301 Moved Permanently",
+        "Cache-Control: max-age=3600",
+        "Location: https://example.com/",
+        "HTTP/1.1 200 OK",
+        "Cache-Control: max-age=60"
+    };
+    const auto entry = HttpCache::fromResponse("body", "", headers, date);
+    REQUIRE( entry.has_value() );
+    REQUIRE( entry.value().expires == date + 60s );
+  }
+
+  SECTION("fromResponse: Expires")
+  {
+    const std::vector<std::string> headers = {
+        "HTTP/1.1 200 OK",
+        "Date: Sun, 06 Nov 1994 08:49:37 GMT",
+        "Expires: Sun, 06 Nov 1994 09:49:37 GMT"
+    };
+    const auto entry = HttpCache::fromResponse("body", "", headers, date);
+    REQUIRE( entry.has_value() );
+    REQUIRE( entry.value().expires == date + 1h );
+  }
+
+  SECTION("fromResponse: invalid Expires means stale")
+  {
+    const std::vector<std::string> headers = {
+        "HTTP/1.1 200 OK",
+        "Expires: 0",
+        "Last-Modified: Sat, 05 Nov 1994 08:49:37 GMT"
+    };
+    const auto entry = HttpCache::fromResponse("body", "", headers, date);
+    REQUIRE( entry.has_value() );
+    REQUIRE_FALSE( entry.value().fresh(date) );
+    REQUIRE( entry.value().lastModified == "Sat, 05 Nov 1994 08:49:37 GMT" );
+  }
+
+  SECTION("fromResponse: heuristic freshness")
+  {
+    const std::vector<std::string> headers = {
+        "HTTP/1.1 200 OK",
+        "Date: Sun, 06 Nov 1994 08:49:37 GMT",
+        "Last-Modified: Sun, 06 Nov 1994 06:49:37 GMT"
+    };
+    const auto entry = HttpCache::fromResponse("body", "", headers, date);
+    REQUIRE( entry.has_value() );
+    // ten percent of two hours
+    REQUIRE( entry.value().expires == date + 12min );
+  }
+
+  SECTION("fromResponse: responses that are not stored")
+  {
+    // no-store
+    REQUIRE_FALSE( HttpCache::fromResponse("body", "", { "HTTP/1.1 200 OK", "Cache-Control: no-store, max-age=60" }, date).has_value() );
+    // Vary: *
+    REQUIRE_FALSE( HttpCache::fromResponse("body", "", { "HTTP/1.1 200 OK", "Cache-Control: max-age=60", "Vary: *" }, date).has_value() );
+    // no freshness and no validator
+    REQUIRE_FALSE( HttpCache::fromResponse("body", "", { "HTTP/1.1 200 OK" }, date).has_value() );
+    REQUIRE_FALSE( HttpCache::fromResponse("body", "", { "HTTP/1.1 200 OK", "Cache-Control: private, must-revalidate, max-age=0" }, date).has_value() );
+  }
+
+  SECTION("fromResponse: no-cache")
+  {
+    const auto entry = HttpCache::fromResponse("body", "", { "HTTP/1.1 200 OK", "Cache-Control: no-cache, max-age=60", "ETag: W/\"1\"" }, date);
+    REQUIRE( entry.has_value() );
+    REQUIRE( entry.value().noCache );
+    REQUIRE_FALSE( entry.value().fresh(date) );
+  }
+
+  SECTION("revalidated")
+  {
+    auto entry = HttpCache::fromResponse("body", "", { "HTTP/1.1 200 OK", "Cache-Control: max-age=60", "ETag: \"1\"" }, date);
+    REQUIRE( entry.has_value() );
+    const auto later = date + 1h;
+    REQUIRE_FALSE( entry.value().fresh(later) );
+
+    HttpCache::revalidated(entry.value(), { "HTTP/1.1 304 Not Modified", "Cache-Control: max-age=120", "ETag: \"2\"" }, later);
+    REQUIRE( entry.value().fresh(later) );
+    REQUIRE( entry.value().expires == later + 120s );
+    REQUIRE( entry.value().etag == "\"2\"" );
+    REQUIRE( entry.value().body == "body" );
+  }
+
+  SECTION("serialization")
+  {
+    HttpCache::Entry entry;
+    entry.body = std::string("line 1\nline 2\n\0end", 18);
+    entry.contentType = "application/json";
+    entry.etag = "\"abc\"";
+    entry.lastModified = "Sun, 06 Nov 1994 08:49:37 GMT";
+    entry.expires = date;
+    entry.noCache = true;
+
+    const auto restored = HttpCache::deserialize(HttpCache::serialize(entry));
+    REQUIRE( restored.has_value() );
+    REQUIRE( restored.value().body == entry.body );
+    REQUIRE( restored.value().contentType == entry.contentType );
+    REQUIRE( restored.value().etag == entry.etag );
+    REQUIRE( restored.value().lastModified == entry.lastModified );
+    REQUIRE( restored.value().expires == entry.expires );
+    REQUIRE( restored.value().noCache );
+
+    REQUIRE_FALSE( HttpCache::deserialize("").has_value() );
+    REQUIRE_FALSE( HttpCache::deserialize("2\n\n\n\n0\n0\nbody").has_value() );
+    REQUIRE_FALSE( HttpCache::deserialize("1\n\n\n\nx\n0\nbody").has_value() );
+  }
+
+  SECTION("store")
+  {
+    HttpCache cache;
+    HttpCache::Entry entry;
+    entry.body = "body";
+    entry.etag = "\"1\"";
+    entry.expires = system_clock::now() + 1h;
+
+    // Nothing is cached without a store.
+    cache.put("a", entry);
+    REQUIRE_FALSE( cache.get("a").has_value() );
+
+    PersistentCache store("");
+    cache.setStore(&store);
+    REQUIRE_FALSE( cache.get("a").has_value() );
+    cache.put("a", entry);
+    const auto loaded = cache.get("a");
+    REQUIRE( loaded.has_value() );
+    REQUIRE( loaded.value().body == "body" );
+    REQUIRE( loaded.value().etag == "\"1\"" );
+    // Responses are kept in their own namespace.
+    REQUIRE( store.get("http", "a").has_value() );
+
+    // Stale responses are kept, if they can be validated, ...
+    entry.expires = system_clock::now() - 1h;
+    cache.put("b", entry);
+    REQUIRE( cache.get("b").has_value() );
+    // ... but not otherwise.
+    entry.etag.clear();
+    cache.put("c", entry);
+    REQUIRE_FALSE( cache.get("c").has_value() );
+
+    cache.setStore(nullptr);
+    REQUIRE_FALSE( cache.get("a").has_value() );
+  }
+}
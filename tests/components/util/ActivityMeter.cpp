@@ -0,0 +1,73 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../../locate_catch.hpp"
+#include <thread>
+#include "../../../src/util/ActivityMeter.hpp"
+
+TEST_CASE("ActivityMeter")
+{
+  using namespace bvn;
+  using namespace std::chrono_literals;
+
+  SECTION("new meter is idle")
+  {
+    ActivityMeter meter;
+    REQUIRE( meter.active() == 0 );
+    REQUIRE( meter.idle(1000ms) );
+  }
+
+  SECTION("running operations are counted")
+  {
+    ActivityMeter meter;
+    meter.begin();
+    meter.begin();
+    REQUIRE( meter.active() == 2 );
+    REQUIRE_FALSE( meter.idle(0ms) );
+
+    meter.end();
+    REQUIRE( meter.active() == 1 );
+    meter.end();
+    REQUIRE( meter.active() == 0 );
+  }
+
+  SECTION("end without begin does not underflow")
+  {
+    ActivityMeter meter;
+    meter.end();
+    REQUIRE( meter.active() == 0 );
+  }
+
+  SECTION("meter is only idle after the quiet time")
+  {
+    ActivityMeter meter;
+    meter.begin();
+    meter.end();
+    REQUIRE_FALSE( meter.idle(10000ms) );
+
+    std::this_thread::sleep_for(20ms);
+    REQUIRE( meter.idle(10ms) );
+  }
+
+  SECTION("meter for commands is shared")
+  {
+    REQUIRE( &ActivityMeter::commands() == &ActivityMeter::commands() );
+  }
+}
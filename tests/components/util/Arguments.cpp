@@ -0,0 +1,101 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../../locate_catch.hpp"
+#include "../../../src/util/Arguments.hpp"
+
+TEST_CASE("Arguments")
+{
+  using namespace bvn;
+
+  SECTION("command without arguments")
+  {
+    REQUIRE( Arguments("deb", "deb").empty() );
+    REQUIRE( Arguments("deb  \t ", "deb").empty() );
+    REQUIRE( Arguments("deb", "deb").rest().empty() );
+
+    Arguments args("deb", "deb");
+    REQUIRE_FALSE( args.next().has_value() );
+  }
+
+  SECTION("rest is trimmed")
+  {
+    REQUIRE( Arguments("weather   New York \t", "weather").rest() == "New York" );
+    REQUIRE( Arguments("  foo bar  ").rest() == "foo bar" );
+  }
+
+  SECTION("rest points into original message")
+  {
+    const std::string message = "cheat grep";
+    const auto rest = Arguments(message, "cheat").rest();
+    REQUIRE( rest.data() == message.data() + 6 );
+  }
+
+  SECTION("split arguments")
+  {
+    Arguments args("tr en  de\tHello world!", "tr");
+    REQUIRE( args.next() == "en" );
+    REQUIRE( args.next() == "de" );
+    REQUIRE( args.rest() == "Hello world!" );
+    REQUIRE( args.next() == "Hello" );
+    REQUIRE( args.next() == "world!" );
+    REQUIRE_FALSE( args.next().has_value() );
+    REQUIRE( args.empty() );
+  }
+
+  SECTION("quoted arguments")
+  {
+    Arguments args("\"New York\" 'foo bar' \"\" baz");
+    REQUIRE( args.next() == "New York" );
+    REQUIRE( args.next() == "foo bar" );
+    REQUIRE( args.next() == "" );
+    REQUIRE( args.next() == "baz" );
+    REQUIRE_FALSE( args.next().has_value() );
+  }
+
+  SECTION("unbalanced quotes")
+  {
+    Arguments args("\"foo bar");
+    REQUIRE( args.next() == "\"foo" );
+    REQUIRE( args.next() == "bar" );
+    REQUIRE_FALSE( args.next().has_value() );
+  }
+
+  SECTION("numbers")
+  {
+    Arguments args("xkcd 123 -45 abc", "xkcd");
+    REQUIRE( args.nextNumber<unsigned int>() == 123u );
+    // -45 does not fit into an unsigned type and is not consumed.
+    REQUIRE_FALSE( args.nextNumber<unsigned int>().has_value() );
+    REQUIRE( args.nextNumber<int>() == -45 );
+    REQUIRE_FALSE( args.nextNumber<int>().has_value() );
+    REQUIRE( args.next() == "abc" );
+  }
+
+  SECTION("toNumber")
+  {
+    REQUIRE( Arguments::toNumber<int>("0") == 0 );
+    REQUIRE( Arguments::toNumber<int>("2924") == 2924 );
+    REQUIRE_FALSE( Arguments::toNumber<int>("").has_value() );
+    REQUIRE_FALSE( Arguments::toNumber<int>("12a").has_value() );
+    REQUIRE_FALSE( Arguments::toNumber<int>("+12").has_value() );
+    REQUIRE_FALSE( Arguments::toNumber<unsigned char>("256").has_value() );
+  }
+}
@@ -0,0 +1,116 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "../../locate_catch.hpp"
+#include <thread>
+#include "../../../src/util/Deadline.hpp"
+#include "../../../src/util/ThreadPool.hpp"
+
+TEST_CASE("Deadline")
+{
+  using namespace bvn;
+  using namespace std::chrono_literals;
+
+  SECTION("default deadline has no time limit")
+  {
+    const Deadline deadline;
+    REQUIRE_FALSE( deadline.limited() );
+    REQUIRE_FALSE( deadline.expired() );
+    REQUIRE_FALSE( deadline.cancelled() );
+    REQUIRE( deadline.remaining() == std::chrono::milliseconds::max() );
+  }
+
+  SECTION("deadline with time limit expires")
+  {
+    const Deadline deadline(20ms);
+    REQUIRE( deadline.limited() );
+    REQUIRE_FALSE( deadline.expired() );
+    REQUIRE( deadline.remaining() > 0ms );
+    REQUIRE( deadline.remaining() <= 20ms );
+
+    std::this_thread::sleep_for(30ms);
+    REQUIRE( deadline.expired() );
+    REQUIRE_FALSE( deadline.cancelled() );
+    REQUIRE( deadline.remaining() == 0ms );
+  }
+
+  SECTION("cancellation is shared between copies")
+  {
+    Deadline deadline;
+    const Deadline copy = deadline;
+    deadline.cancel();
+    REQUIRE( copy.cancelled() );
+    REQUIRE( copy.expired() );
+    REQUIRE( copy.remaining() == 0ms );
+  }
+
+  SECTION("child deadlines")
+  {
+    Deadline parent(10s);
+    Deadline first = parent.child();
+    const Deadline second = parent.child();
+    REQUIRE( first.limited() );
+    REQUIRE( first.remaining() <= parent.remaining() );
+
+    // Cancelling a child does not affect parent and siblings.
+    first.cancel();
+    REQUIRE( first.cancelled() );
+    REQUIRE_FALSE( parent.cancelled() );
+    REQUIRE_FALSE( second.cancelled() );
+
+    // Cancelling the parent affects all children.
+    parent.cancel();
+    REQUIRE( second.cancelled() );
+    REQUIRE( second.expired() );
+  }
+
+  SECTION("scopes set the current deadline of the thread")
+  {
+    REQUIRE_FALSE( Deadline::current().limited() );
+    const Deadline outer(10s);
+    {
+      Deadline::Scope outerScope(outer);
+      REQUIRE( Deadline::current().limited() );
+      {
+        Deadline inner;
+        Deadline::Scope innerScope(inner);
+        REQUIRE_FALSE( Deadline::current().limited() );
+        inner.cancel();
+        REQUIRE( Deadline::current().cancelled() );
+      }
+      REQUIRE( Deadline::current().limited() );
+      REQUIRE_FALSE( Deadline::current().cancelled() );
+    }
+    REQUIRE_FALSE( Deadline::current().limited() );
+  }
+
+  SECTION("jobs of a thread pool inherit the deadline of the submitting thread")
+  {
+    ThreadPool pool(2);
+    Deadline deadline(10s);
+    Deadline::Scope scope(deadline);
+    auto future = pool.submit([]() { return Deadline::current(); });
+    Deadline seen = future.get();
+    REQUIRE( seen.limited() );
+    seen.cancel();
+    REQUIRE( deadline.cancelled() );
+  }
+}
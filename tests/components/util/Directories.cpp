@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -19,6 +19,7 @@
 */
 
 #include "../../locate_catch.hpp"
+#include <filesystem>
 #include "../../../src/util/Directories.hpp"
 
 TEST_CASE("bvn::filesystem")
@@ -32,4 +33,13 @@ TEST_CASE("bvn::filesystem")
     REQUIRE( getHome(result) );
     REQUIRE_FALSE( result.empty() );
   }
+
+  SECTION("getDataFileName()")
+  {
+    const std::string result = getDataFileName("foo.db");
+
+    REQUIRE( result.size() > 7 );
+    REQUIRE( result.substr(result.size() - 7) == pathDelimiter + std::string("foo.db") );
+    REQUIRE( std::filesystem::is_directory(std::filesystem::path(result).parent_path()) );
+  }
 }
@@ -0,0 +1,247 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "../../locate_catch.hpp"
+#include "../../../src/util/JsonBinding.hpp"
+
+namespace
+{
+
+struct Item
+{
+  Item()
+  : id(0), count(0), weight(0.0), name(""), note("none")
+  { }
+
+  int id;
+  unsigned int count;
+  double weight;
+  std::string name;
+  std::string note;
+};
+
+struct Row
+{
+  std::string day;
+  int code = 0;
+  double value = 0.0;
+};
+
+} // namespace
+
+TEST_CASE("JSON binding")
+{
+  using namespace bvn;
+
+  static constexpr auto schema = std::make_tuple(
+      json::field("id", &Item::id),
+      json::field("count", &Item::count),
+      json::field("weight", &Item::weight),
+      json::field("name", &Item::name),
+      json::optional_field("note", &Item::note));
+
+  static constexpr auto columns = std::make_tuple(
+      json::column("day", &Row::day),
+      json::column("code", &Row::code),
+      json::column("value", &Row::value));
+
+  simdjson::dom::parser parser;
+
+  SECTION("decode object with all members")
+  {
+    const auto doc = parser.parse(std::string(R"json({ "name": "foo", "weight": 2.5, "id": -5, "count": 12, "note": "bar", "other": [1, 2] })json"));
+    simdjson::dom::object object;
+    REQUIRE_FALSE( doc.get(object) );
+
+    Item item;
+    const auto error = json::decode(object, schema, item);
+    REQUIRE_FALSE( error.has_value() );
+    REQUIRE( item.id == -5 );
+    REQUIRE( item.count == 12 );
+    REQUIRE( item.weight == 2.5 );
+    REQUIRE( item.name == "foo" );
+    REQUIRE( item.note == "bar" );
+  }
+
+  SECTION("integers are accepted as floating-point numbers")
+  {
+    const auto doc = parser.parse(std::string(R"json({ "id": 1, "count": 2, "weight": 3, "name": "foo" })json"));
+    simdjson::dom::object object;
+    REQUIRE_FALSE( doc.get(object) );
+
+    Item item;
+    REQUIRE_FALSE( json::decode(object, schema, item).has_value() );
+    REQUIRE( item.weight == 3.0 );
+    // optional member keeps its value
+    REQUIRE( item.note == "none" );
+  }
+
+  SECTION("first occurrence of a key is used")
+  {
+    const auto doc = parser.parse(std::string(R"json({ "id": 1, "id": 2, "count": 2, "weight": 3, "name": "foo" })json"));
+    simdjson::dom::object object;
+    REQUIRE_FALSE( doc.get(object) );
+
+    Item item;
+    REQUIRE_FALSE( json::decode(object, schema, item).has_value() );
+    REQUIRE( item.id == 1 );
+  }
+
+  SECTION("missing required member")
+  {
+    const auto doc = parser.parse(std::string(R"json({ "id": 1, "weight": 3, "name": "foo" })json"));
+    simdjson::dom::object object;
+    REQUIRE_FALSE( doc.get(object) );
+
+    Item item;
+    const auto error = json::decode(object, schema, item, "item");
+    REQUIRE( error.has_value() );
+    REQUIRE( error.value().code == json::ErrorCode::missing_or_wrong_type );
+    REQUIRE( error.value().field == "item.count" );
+    REQUIRE( error.value().message() == "item.count element is missing or not a non-negative integer number!" );
+  }
+
+  SECTION("member with wrong type")
+  {
+    const auto doc = parser.parse(std::string(R"json({ "id": 1.5, "count": 2, "weight": "heavy", "name": "foo" })json"));
+    simdjson::dom::object object;
+    REQUIRE_FALSE( doc.get(object) );
+
+    Item item;
+    const auto error = json::decode(object, schema, item);
+    REQUIRE( error.has_value() );
+    // The first failing descriptor determines the error.
+    REQUIRE( error.value().message() == "id element is missing or not an integer number!" );
+  }
+
+  SECTION("integers outside of the range of the member")
+  {
+    Item item;
+    simdjson::dom::object object;
+
+    auto doc = parser.parse(std::string(R"json({ "id": 2147483647, "count": 4294967295, "weight": 1, "name": "foo" })json"));
+    REQUIRE_FALSE( doc.get(object) );
+    REQUIRE_FALSE( json::decode(object, schema, item).has_value() );
+    REQUIRE( item.id == 2147483647 );
+    REQUIRE( item.count == 4294967295u );
+
+    doc = parser.parse(std::string(R"json({ "id": -2147483648, "count": 0, "weight": 1, "name": "foo" })json"));
+    REQUIRE_FALSE( doc.get(object) );
+    REQUIRE_FALSE( json::decode(object, schema, item).has_value() );
+    REQUIRE( item.id == -2147483648LL );
+
+    doc = parser.parse(std::string(R"json({ "id": 2147483648, "count": 2, "weight": 1, "name": "foo" })json"));
+    REQUIRE_FALSE( doc.get(object) );
+    auto error = json::decode(object, schema, item);
+    REQUIRE( error.has_value() );
+    REQUIRE( error.value().message() == "id element is missing or not an integer number!" );
+
+    doc = parser.parse(std::string(R"json({ "id": -2147483649, "count": 2, "weight": 1, "name": "foo" })json"));
+    REQUIRE_FALSE( doc.get(object) );
+    error = json::decode(object, schema, item);
+    REQUIRE( error.has_value() );
+    REQUIRE( error.value().field == "id" );
+
+    doc = parser.parse(std::string(R"json({ "id": 1, "count": 4294967296, "weight": 1, "name": "foo" })json"));
+    REQUIRE_FALSE( doc.get(object) );
+    error = json::decode(object, schema, item);
+    REQUIRE( error.has_value() );
+    REQUIRE( error.value().message() == "count element is missing or not a non-negative integer number!" );
+
+    doc = parser.parse(std::string(R"json({ "id": 1, "count": -1, "weight": 1, "name": "foo" })json"));
+    REQUIRE_FALSE( doc.get(object) );
+    error = json::decode(object, schema, item);
+    REQUIRE( error.has_value() );
+    REQUIRE( error.value().field == "count" );
+  }
+
+  SECTION("decode columns")
+  {
+    const auto doc = parser.parse(std::string(R"json({ "value": [1.5, 2.5, 3], "day": ["Mon", "Tue", "Wed"], "code": [3, 2, 1] })json"));
+    simdjson::dom::object object;
+    REQUIRE_FALSE( doc.get(object) );
+
+    std::vector<Row> rows;
+    REQUIRE_FALSE( json::decode_columns(object, columns, rows).has_value() );
+    REQUIRE( rows.size() == 3 );
+    REQUIRE( rows[0].day == "Mon" );
+    REQUIRE( rows[0].code == 3 );
+    REQUIRE( rows[0].value == 1.5 );
+    REQUIRE( rows[2].day == "Wed" );
+    REQUIRE( rows[2].code == 1 );
+    REQUIRE( rows[2].value == 3.0 );
+  }
+
+  SECTION("column errors")
+  {
+    std::vector<Row> rows;
+    simdjson::dom::object object;
+
+    SECTION("first column is empty")
+    {
+      const auto doc = parser.parse(std::string(R"json({ "day": [], "code": [], "value": [] })json"));
+      REQUIRE_FALSE( doc.get(object) );
+      const auto error = json::decode_columns(object, columns, rows, "week");
+      REQUIRE( error.has_value() );
+      REQUIRE( error.value().code == json::ErrorCode::empty_array );
+      REQUIRE( error.value().message() == "week.day element is an empty array!" );
+    }
+
+    SECTION("column is missing")
+    {
+      const auto doc = parser.parse(std::string(R"json({ "day": ["Mon"], "value": [1.0] })json"));
+      REQUIRE_FALSE( doc.get(object) );
+      const auto error = json::decode_columns(object, columns, rows, "week");
+      REQUIRE( error.has_value() );
+      REQUIRE( error.value().message() == "week.code element is missing or not an array!" );
+    }
+
+    SECTION("column has different size")
+    {
+      const auto doc = parser.parse(std::string(R"json({ "day": ["Mon"], "code": [1, 2], "value": [1.0] })json"));
+      REQUIRE_FALSE( doc.get(object) );
+      const auto error = json::decode_columns(object, columns, rows, "week");
+      REQUIRE( error.has_value() );
+      REQUIRE( error.value().code == json::ErrorCode::size_mismatch );
+      REQUIRE( error.value().message() == "week.code array has an unexpected number of elements!" );
+    }
+
+    SECTION("element has wrong type")
+    {
+      const auto doc = parser.parse(std::string(R"json({ "day": ["Mon", "Tue"], "code": [1, 2], "value": [1.0, "x"] })json"));
+      REQUIRE_FALSE( doc.get(object) );
+      const auto error = json::decode_columns(object, columns, rows, "week");
+      REQUIRE( error.has_value() );
+      REQUIRE( error.value().code == json::ErrorCode::wrong_element_type );
+      REQUIRE( error.value().message() == "An element of week.value is not a floating-point number!" );
+    }
+
+    SECTION("element is outside of the range of the member")
+    {
+      const auto doc = parser.parse(std::string(R"json({ "day": ["Mon", "Tue"], "code": [1, 9223372036854775807], "value": [1.0, 2.0] })json"));
+      REQUIRE_FALSE( doc.get(object) );
+      const auto error = json::decode_columns(object, columns, rows, "week");
+      REQUIRE( error.has_value() );
+      REQUIRE( error.value().code == json::ErrorCode::wrong_element_type );
+      REQUIRE( error.value().message() == "An element of week.code is not an integer!" );
+    }
+  }
+}
@@ -0,0 +1,136 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../../locate_catch.hpp"
+#include <string>
+#include "../../../src/util/LruList.hpp"
+
+TEST_CASE("LruList")
+{
+  using namespace bvn;
+
+  SECTION("empty list")
+  {
+    LruList<int> list(10);
+    REQUIRE( list.size() == 0 );
+    REQUIRE( list.find("a") == nullptr );
+    REQUIRE_FALSE( list.contains("a") );
+    // Erasing unknown keys does nothing.
+    list.erase("a");
+    REQUIRE( list.size() == 0 );
+  }
+
+  SECTION("insert, find and replace entries")
+  {
+    LruList<std::string> list(10);
+    REQUIRE( list.insert("a", "one", 1).empty() );
+    REQUIRE( list.insert("b", "two", 1).empty() );
+    REQUIRE( list.size() == 2 );
+    REQUIRE( list.contains("a") );
+    REQUIRE( *list.find("a") == "one" );
+    REQUIRE( *list.find("b") == "two" );
+
+    REQUIRE( list.insert("a", "three", 1).empty() );
+    REQUIRE( list.size() == 2 );
+    REQUIRE( *list.find("a") == "three" );
+
+    list.erase("a");
+    REQUIRE( list.size() == 1 );
+    REQUIRE( list.find("a") == nullptr );
+  }
+
+  SECTION("least recently used entries are evicted")
+  {
+    LruList<int> list(3);
+    list.insert("a", 1, 1);
+    list.insert("b", 2, 1);
+    list.insert("c", 3, 1);
+    // a is used, so b is the least recently used entry now
+    REQUIRE( list.find("a") != nullptr );
+    const auto evicted = list.insert("d", 4, 1);
+    REQUIRE( evicted.size() == 1 );
+    REQUIRE( evicted[0] == "b" );
+    REQUIRE( list.size() == 3 );
+    REQUIRE_FALSE( list.contains("b") );
+    REQUIRE( list.contains("a") );
+  }
+
+  SECTION("contains does not count as use")
+  {
+    LruList<int> list(2);
+    list.insert("a", 1, 1);
+    list.insert("b", 2, 1);
+    REQUIRE( list.contains("a") );
+    const auto evicted = list.insert("c", 3, 1);
+    REQUIRE( evicted.size() == 1 );
+    REQUIRE( evicted[0] == "a" );
+  }
+
+  SECTION("weights")
+  {
+    LruList<int> list(10);
+    list.insert("a", 1, 4);
+    list.insert("b", 2, 4);
+    // Heavy entries may evict more than one entry.
+    const auto evicted = list.insert("c", 3, 8);
+    REQUIRE( evicted.size() == 2 );
+    REQUIRE( list.size() == 1 );
+
+    // Entries that are heavier than the capacity are not added, and an
+    // existing entry with the same key is removed.
+    const auto rejected = list.insert("c", 4, 11);
+    REQUIRE( rejected.size() == 1 );
+    REQUIRE( rejected[0] == "c" );
+    REQUIRE( list.size() == 0 );
+
+    // Removed entries free their weight.
+    list.insert("d", 5, 10);
+    list.erase("d");
+    REQUIRE( list.insert("e", 6, 10).empty() );
+  }
+
+  SECTION("zero capacity")
+  {
+    LruList<int> list(0);
+    const auto evicted = list.insert("a", 1, 1);
+    REQUIRE( evicted.size() == 1 );
+    REQUIRE( list.size() == 0 );
+  }
+
+  SECTION("eraseIf")
+  {
+    LruList<int> list(10);
+    for (int i = 0; i < 6; ++i)
+    {
+      list.insert(std::to_string(i), i, 1);
+    }
+    list.eraseIf([](const int value) { return value % 2 == 1; });
+    REQUIRE( list.size() == 3 );
+    REQUIRE( list.contains("0") );
+    REQUIRE_FALSE( list.contains("1") );
+    REQUIRE( list.contains("4") );
+    REQUIRE_FALSE( list.contains("5") );
+    // The weight of removed entries is free again.
+    for (int i = 6; i < 13; ++i)
+    {
+      REQUIRE( list.insert(std::to_string(i), i, 1).empty() );
+    }
+  }
+}
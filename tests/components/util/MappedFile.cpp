@@ -0,0 +1,82 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "../../locate_catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include "../../FileGuard.hpp"
+#include "../../../src/util/MappedFile.hpp"
+
+TEST_CASE("MappedFile")
+{
+  using namespace bvn;
+
+  SECTION("constructor")
+  {
+    MappedFile file;
+    REQUIRE_FALSE( file.isOpen() );
+    REQUIRE( file.content().empty() );
+  }
+
+  SECTION("file does not exist")
+  {
+    MappedFile file;
+    REQUIRE_FALSE( file.open((std::filesystem::temp_directory_path() / "bvn-test-does-not-exist.txt").string()) );
+    REQUIRE_FALSE( file.isOpen() );
+    REQUIRE( file.content().empty() );
+  }
+
+  SECTION("map file with content")
+  {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "bvn-test-mapped-file.txt";
+    const std::string content = "This is a test.\nSecond line\n";
+    {
+      std::ofstream stream(path, std::ios::out | std::ios::binary);
+      stream.write(content.c_str(), content.size());
+      REQUIRE( stream.good() );
+    }
+    FileGuard guard{path};
+
+    MappedFile file;
+    REQUIRE( file.open(path.string()) );
+    REQUIRE( file.isOpen() );
+    REQUIRE( file.content() == content );
+
+    file.close();
+    REQUIRE_FALSE( file.isOpen() );
+    REQUIRE( file.content().empty() );
+  }
+
+  SECTION("map empty file")
+  {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "bvn-test-mapped-empty.txt";
+    {
+      std::ofstream stream(path, std::ios::out | std::ios::binary);
+      REQUIRE( stream.good() );
+    }
+    FileGuard guard{path};
+
+    MappedFile file;
+    REQUIRE( file.open(path.string()) );
+    REQUIRE( file.isOpen() );
+    REQUIRE( file.content().empty() );
+  }
+}
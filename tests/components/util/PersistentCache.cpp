@@ -0,0 +1,165 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include <filesystem>
+#include "../../locate_catch.hpp"
+#include "../../FileGuard.hpp"
+#include "../../../src/util/PersistentCache.hpp"
+
+TEST_CASE("PersistentCache")
+{
+  using namespace bvn;
+  namespace fs = std::filesystem;
+  using namespace std::chrono_literals;
+
+  SECTION("memory only")
+  {
+    PersistentCache cache("");
+    REQUIRE_FALSE( cache.get("ns", "foo").has_value() );
+
+    cache.put("ns", "foo", "bar", 60s);
+    const auto value = cache.get("ns", "foo");
+    REQUIRE( value.has_value() );
+    REQUIRE( value.value() == "bar" );
+
+    // same key in other namespace is a different entry
+    REQUIRE_FALSE( cache.get("other", "foo").has_value() );
+
+    cache.put("ns", "foo", "baz", 60s);
+    REQUIRE( cache.get("ns", "foo").value() == "baz" );
+
+    cache.erase("ns", "foo");
+    REQUIRE_FALSE( cache.get("ns", "foo").has_value() );
+  }
+
+  SECTION("expired entries are not returned")
+  {
+    PersistentCache cache("");
+    cache.put("ns", "foo", "bar", 0s);
+    REQUIRE_FALSE( cache.get("ns", "foo").has_value() );
+  }
+
+  SECTION("binary values")
+  {
+    PersistentCache cache("");
+    const std::string binary("a\0b\xFF", 4);
+    cache.put("ns", "bin", binary, 60s);
+    cache.put("ns", "empty", "", 60s);
+    REQUIRE( cache.get("ns", "bin").value() == binary );
+    REQUIRE( cache.get("ns", "empty").value().empty() );
+  }
+
+  SECTION("memory budget")
+  {
+    PersistentCache cache("", 30);
+    cache.put("ns", "a", "0123456789", 60s);
+    cache.put("ns", "b", "0123456789", 60s);
+    // Use a, so b is the least recently used entry.
+    REQUIRE( cache.get("ns", "a").has_value() );
+    cache.put("ns", "c", "0123456789", 60s);
+
+    REQUIRE( cache.get("ns", "a").has_value() );
+    REQUIRE_FALSE( cache.get("ns", "b").has_value() );
+    REQUIRE( cache.get("ns", "c").has_value() );
+
+    // Entries larger than the budget are not kept at all.
+    cache.put("ns", "large", std::string(100, 'x'), 60s);
+    REQUIRE_FALSE( cache.get("ns", "large").has_value() );
+  }
+
+  SECTION("entries survive a restart")
+  {
+    const fs::path path{ fs::temp_directory_path() / "bvn_cache_restart.db"};
+    const FileGuard guard{path};
+    {
+      PersistentCache cache(path.string());
+      cache.put("ns", "foo", "bar", 60s);
+      cache.put("ns", "bin", std::string("a\0b", 3), 60s);
+      cache.put("ns", "gone", "soon", 60s);
+      cache.put("ns", "expired", "old", 0s);
+      cache.flush();
+      cache.erase("ns", "gone");
+    }
+    {
+      PersistentCache cache(path.string());
+      const auto value = cache.get("ns", "foo");
+      REQUIRE( value.has_value() );
+      REQUIRE( value.value() == "bar" );
+      REQUIRE( cache.get("ns", "bin").value() == std::string("a\0b", 3) );
+      REQUIRE_FALSE( cache.get("ns", "gone").has_value() );
+      REQUIRE_FALSE( cache.get("ns", "expired").has_value() );
+      REQUIRE_FALSE( cache.get("other", "foo").has_value() );
+    }
+  }
+
+  SECTION("entries evicted from memory are read from database")
+  {
+    const fs::path path{ fs::temp_directory_path() / "bvn_cache_tiers.db"};
+    const FileGuard guard{path};
+    {
+      PersistentCache cache(path.string(), 20);
+      cache.put("ns", "a", "0123456789", 60s);
+      cache.put("ns", "b", "0123456789", 60s);
+      // a is not in memory anymore, but it is still pending.
+      REQUIRE( cache.get("ns", "a").value() == "0123456789" );
+      cache.flush();
+      // b is not in memory anymore, now it has to be loaded.
+      REQUIRE( cache.get("ns", "b").value() == "0123456789" );
+    }
+  }
+
+  SECTION("budget of namespace")
+  {
+    const fs::path path{ fs::temp_directory_path() / "bvn_cache_budget.db"};
+    const FileGuard guard{path};
+    {
+      PersistentCache cache(path.string());
+      cache.setBudget("small", 25);
+      cache.put("small", "a", "0123456789", 60s);
+      cache.put("small", "b", "0123456789", 60s);
+      cache.put("large", "a", "0123456789", 60s);
+      cache.put("large", "b", "0123456789", 60s);
+      cache.flush();
+      // Use a, so b is the least recently used entry.
+      REQUIRE( cache.get("small", "a").has_value() );
+      cache.put("small", "c", "0123456789", 60s);
+      cache.put("large", "c", "0123456789", 60s);
+    }
+    {
+      PersistentCache cache(path.string());
+      REQUIRE( cache.get("small", "a").has_value() );
+      REQUIRE_FALSE( cache.get("small", "b").has_value() );
+      REQUIRE( cache.get("small", "c").has_value() );
+      // default budget is much larger
+      REQUIRE( cache.get("large", "a").has_value() );
+      REQUIRE( cache.get("large", "b").has_value() );
+      REQUIRE( cache.get("large", "c").has_value() );
+    }
+  }
+
+  SECTION("database cannot be opened")
+  {
+    const fs::path path{ fs::temp_directory_path() / "does" / "not" / "exist" / "cache.db"};
+    PersistentCache cache(path.string());
+    cache.put("ns", "foo", "bar", 60s);
+    REQUIRE( cache.get("ns", "foo").value() == "bar" );
+  }
+}
@@ -0,0 +1,111 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../../locate_catch.hpp"
+#include <thread>
+#include "../../../src/util/RingBuffer.hpp"
+
+TEST_CASE("RingBuffer")
+{
+  using namespace bvn;
+
+  SECTION("data passes through in order")
+  {
+    RingBuffer buffer(8);
+    REQUIRE( buffer.capacity() == 8 );
+    REQUIRE( buffer.write("abcde") );
+    char out[16];
+    REQUIRE( buffer.read(out, 3) == 3 );
+    REQUIRE( std::string(out, 3) == "abc" );
+    // wraps around the end of the storage
+    REQUIRE( buffer.write("fghijk") );
+    REQUIRE( buffer.waitUntilFilled() == 8 );
+    REQUIRE( buffer.read(out, sizeof(out)) == 8 );
+    REQUIRE( std::string(out, 8) == "defghijk" );
+  }
+
+  SECTION("closed buffer delivers remaining data, then end of data")
+  {
+    RingBuffer buffer(8);
+    REQUIRE( buffer.write("abc") );
+    buffer.close();
+    REQUIRE( buffer.closed() );
+    REQUIRE( buffer.waitUntilFilled() == 3 );
+    REQUIRE_FALSE( buffer.write("d") );
+    char out[8];
+    REQUIRE( buffer.read(out, sizeof(out)) == 3 );
+    REQUIRE( buffer.read(out, sizeof(out)) == 0 );
+    REQUIRE_FALSE( buffer.aborted() );
+  }
+
+  SECTION("aborted buffer stops both sides")
+  {
+    RingBuffer buffer(8);
+    REQUIRE( buffer.write("abc") );
+    buffer.abort();
+    REQUIRE( buffer.aborted() );
+    char out[8];
+    REQUIRE( buffer.read(out, sizeof(out)) == 0 );
+    REQUIRE_FALSE( buffer.write("d") );
+  }
+
+  SECTION("large data passes through a small buffer between threads")
+  {
+    std::string input;
+    for (int i = 0; i < 100000; ++i)
+    {
+      input.push_back(static_cast<char>('a' + i % 26));
+    }
+    RingBuffer buffer(100);
+    std::thread writer([&buffer, &input]()
+    {
+      for (std::size_t pos = 0; pos < input.size(); pos += 37)
+      {
+        buffer.write(std::string_view(input).substr(pos, 37));
+      }
+      buffer.close();
+    });
+
+    std::string output;
+    char chunk[64];
+    std::size_t count = 0;
+    while ((count = buffer.read(chunk, sizeof(chunk))) > 0)
+    {
+      REQUIRE( count <= sizeof(chunk) );
+      output.append(chunk, count);
+    }
+    writer.join();
+    REQUIRE( output == input );
+  }
+
+  SECTION("abort releases a blocked writer")
+  {
+    RingBuffer buffer(4);
+    bool result = true;
+    std::thread writer([&buffer, &result]()
+    {
+      result = buffer.write("more than four bytes");
+    });
+    REQUIRE( buffer.waitUntilFilled() == 4 );
+    buffer.abort();
+    writer.join();
+    REQUIRE_FALSE( result );
+  }
+}
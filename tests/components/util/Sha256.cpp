@@ -0,0 +1,69 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../../locate_catch.hpp"
+#include "../../../src/util/Sha256.hpp"
+
+TEST_CASE("Sha256")
+{
+  using namespace bvn;
+
+  SECTION("known digests")
+  {
+    REQUIRE( Sha256::hash("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" );
+    REQUIRE( Sha256::hash("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" );
+    REQUIRE( Sha256::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")
+             == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" );
+  }
+
+  SECTION("message of one million characters")
+  {
+    REQUIRE( Sha256::hash(std::string(1000000, 'a'))
+             == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" );
+  }
+
+  SECTION("padding at block boundaries")
+  {
+    // 55 bytes fit into one block with padding, 56 bytes need two blocks.
+    REQUIRE( Sha256::hash(std::string(55, 'a'))
+             == "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318" );
+    REQUIRE( Sha256::hash(std::string(56, 'a'))
+             == "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a" );
+    REQUIRE( Sha256::hash(std::string(64, 'a'))
+             == "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb" );
+  }
+
+  SECTION("incremental updates give the same digest")
+  {
+    const std::string data = "The quick brown fox jumps over the lazy dog";
+    Sha256 sha;
+    for (std::size_t i = 0; i < data.size(); i += 5)
+    {
+      sha.update(std::string_view(data).substr(i, 5));
+    }
+    const auto digest = sha.hexDigest();
+    REQUIRE( digest == "d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592" );
+    REQUIRE( digest == Sha256::hash(data) );
+
+    // instance starts anew after hexDigest()
+    sha.update("abc");
+    REQUIRE( sha.hexDigest() == Sha256::hash("abc") );
+  }
+}
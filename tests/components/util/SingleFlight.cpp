@@ -0,0 +1,138 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../../locate_catch.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../../../src/util/SingleFlight.hpp"
+
+TEST_CASE("SingleFlight")
+{
+  using namespace bvn;
+  using namespace std::chrono_literals;
+
+  SECTION("single caller gets the result of the work")
+  {
+    SingleFlight<int> flight;
+    const auto result = flight.run("key", []() { return 42; });
+    REQUIRE( result.has_value() );
+    REQUIRE( result.value() == 42 );
+    REQUIRE( flight.inFlight() == 0 );
+  }
+
+  SECTION("concurrent callers with the same key share one execution")
+  {
+    SingleFlight<int> flight;
+    std::atomic<int> executions{0};
+    std::atomic<bool> release{false};
+    std::vector<std::optional<int>> results(4);
+
+    std::thread first([&]()
+    {
+      results[0] = flight.run("key", [&]()
+      {
+        ++executions;
+        while (!release)
+        {
+          std::this_thread::sleep_for(1ms);
+        }
+        return 23;
+      });
+    });
+    while (flight.inFlight() == 0)
+    {
+      std::this_thread::sleep_for(1ms);
+    }
+
+    std::vector<std::thread> followers;
+    for (std::size_t i = 1; i < results.size(); ++i)
+    {
+      followers.emplace_back([&, i]()
+      {
+        results[i] = flight.run("key", [&]() { ++executions; return 0; });
+      });
+    }
+    std::this_thread::sleep_for(50ms);
+    release = true;
+    first.join();
+    for (auto& t: followers)
+    {
+      t.join();
+    }
+
+    REQUIRE( executions == 1 );
+    for (const auto& result: results)
+    {
+      REQUIRE( result.has_value() );
+      REQUIRE( result.value() == 23 );
+    }
+    REQUIRE( flight.inFlight() == 0 );
+  }
+
+  SECTION("different keys are executed separately")
+  {
+    SingleFlight<std::string> flight;
+    REQUIRE( flight.run("a", []() { return std::string("A"); }) == "A" );
+    REQUIRE( flight.run("b", []() { return std::string("B"); }) == "B" );
+    // Finished calls do not affect later calls with the same key.
+    REQUIRE( flight.run("a", []() { return std::string("C"); }) == "C" );
+  }
+
+  SECTION("waiting caller gives up when its deadline expires")
+  {
+    SingleFlight<int> flight;
+    std::atomic<bool> release{false};
+    std::thread first([&]()
+    {
+      flight.run("key", [&]()
+      {
+        while (!release)
+        {
+          std::this_thread::sleep_for(1ms);
+        }
+        return 1;
+      });
+    });
+    while (flight.inFlight() == 0)
+    {
+      std::this_thread::sleep_for(1ms);
+    }
+
+    std::optional<int> result;
+    {
+      const Deadline deadline(30ms);
+      Deadline::Scope scope(deadline);
+      result = flight.run("key", []() { return 2; });
+    }
+    release = true;
+    first.join();
+
+    REQUIRE_FALSE( result.has_value() );
+  }
+
+  SECTION("exceptions are passed to all callers")
+  {
+    SingleFlight<int> flight;
+    REQUIRE_THROWS_AS( flight.run("key", []() -> int { throw std::runtime_error("fail"); }), std::runtime_error );
+    REQUIRE( flight.inFlight() == 0 );
+  }
+}
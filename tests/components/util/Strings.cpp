@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2020, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -168,6 +168,55 @@ TEST_CASE("trim")
   }
 }
 
+TEST_CASE("trimmed")
+{
+  using namespace bvn;
+
+  REQUIRE( trimmed("").empty() );
+  REQUIRE( trimmed(" \t \t").empty() );
+  REQUIRE( trimmed("abc") == "abc" );
+  REQUIRE( trimmed("  \t abc") == "abc" );
+  REQUIRE( trimmed("abc \t  ") == "abc" );
+  REQUIRE( trimmed("  \t  foo bar\t\t \t ") == "foo bar" );
+
+  SECTION("view points into original string")
+  {
+    const std::string s = "   foo   ";
+    const std::string_view view = trimmed(s);
+    REQUIRE( view.data() == s.data() + 3 );
+    REQUIRE( view.size() == 3 );
+  }
+}
+
+TEST_CASE("stringToInt")
+{
+  using namespace bvn;
+
+  int value = 0;
+
+  SECTION("valid numbers")
+  {
+    REQUIRE( stringToInt("0", value) );
+    REQUIRE( value == 0 );
+    REQUIRE( stringToInt("42", value) );
+    REQUIRE( value == 42 );
+    REQUIRE( stringToInt("-17", value) );
+    REQUIRE( value == -17 );
+    REQUIRE( stringToInt("2147483647", value) );
+    REQUIRE( value == std::numeric_limits<int>::max() );
+  }
+
+  SECTION("invalid numbers")
+  {
+    REQUIRE_FALSE( stringToInt("", value) );
+    REQUIRE_FALSE( stringToInt("abc", value) );
+    REQUIRE_FALSE( stringToInt("12abc", value) );
+    REQUIRE_FALSE( stringToInt(" 12", value) );
+    REQUIRE_FALSE( stringToInt("1.5", value) );
+    REQUIRE_FALSE( stringToInt("2147483648", value) );
+  }
+}
+
 TEST_CASE("doubleToString")
 {
   using namespace bvn;
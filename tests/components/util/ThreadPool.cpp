@@ -0,0 +1,132 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../../locate_catch.hpp"
+#include <atomic>
+#include <thread>
+#include "../../../src/util/ThreadPool.hpp"
+
+TEST_CASE("ThreadPool")
+{
+  using namespace bvn;
+
+  SECTION("pool without threads runs jobs immediately")
+  {
+    ThreadPool pool(0);
+    REQUIRE( pool.size() == 0 );
+    int value = 0;
+    auto future = pool.submit([&value]() { value = 42; return value + 1; });
+    // Job has already run, even before the future is queried.
+    REQUIRE( value == 42 );
+    REQUIRE( future.get() == 43 );
+  }
+
+  SECTION("jobs are executed by the worker threads")
+  {
+    ThreadPool pool(3);
+    REQUIRE( pool.size() == 3 );
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+    {
+      futures.push_back(pool.submit([i]() { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+      REQUIRE( futures[i].get() == i * i );
+    }
+  }
+
+  SECTION("exceptions are passed to the future")
+  {
+    ThreadPool pool(1);
+    auto future = pool.submit([]() -> int { throw std::runtime_error("fail"); });
+    REQUIRE_THROWS_AS( future.get(), std::runtime_error );
+  }
+
+  SECTION("nested jobs do not block the pool")
+  {
+    // One thread only: the outer job waits for inner jobs of the same pool.
+    ThreadPool pool(1);
+    auto outer = pool.submit([&pool]()
+    {
+      std::vector<std::future<int>> inner;
+      for (int i = 1; i <= 4; ++i)
+      {
+        inner.push_back(pool.submit([i]() { return i; }));
+      }
+      int sum = 0;
+      for (auto& f: inner)
+      {
+        sum += pool.await(f);
+      }
+      return sum;
+    });
+    REQUIRE( outer.get() == 10 );
+  }
+
+  SECTION("destructor finishes queued jobs")
+  {
+    std::atomic<int> count = 0;
+    {
+      ThreadPool pool(2);
+      for (int i = 0; i < 20; ++i)
+      {
+        pool.submit([&count]() { ++count; });
+      }
+    }
+    REQUIRE( count == 20 );
+  }
+
+  SECTION("shutdown drops queued jobs with expired deadline")
+  {
+    std::atomic<int> count = 0;
+    std::atomic<bool> release = false;
+    ThreadPool pool(1);
+    // The first job blocks the only worker, so the other jobs stay queued.
+    pool.submit([&release]() { while (!release) { std::this_thread::yield(); } });
+    Deadline cancelled;
+    {
+      Deadline::Scope scope(cancelled);
+      for (int i = 0; i < 5; ++i)
+      {
+        pool.submit([&count]() { ++count; });
+      }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      pool.submit([&count]() { count += 10; });
+    }
+    cancelled.cancel();
+    std::thread releaser([&release]()
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      release = true;
+    });
+    pool.shutdown();
+    releaser.join();
+    REQUIRE( count == 30 );
+
+    // Jobs run directly in the submitting thread after the shutdown.
+    REQUIRE( pool.size() == 0 );
+    int value = 0;
+    pool.submit([&value]() { value = 1; });
+    REQUIRE( value == 1 );
+  }
+}
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2024  Dirk Stolle
+    Copyright (C) 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -170,4 +170,90 @@ TEST_CASE("bvn::sql")
       REQUIRE_FALSE( bvn::sql::bind(stmt, 5, 12345) );
     }
   }
+
+  SECTION("Connection: empty file name")
+  {
+    Connection conn("");
+    REQUIRE_FALSE( conn.isOpen() );
+    REQUIRE( conn.fileName().empty() );
+    auto handle = conn.lock();
+    REQUIRE( handle.prepared("SELECT 1;").get() == nullptr );
+  }
+
+  SECTION("Connection: open failure")
+  {
+    const fs::path path{ fs::temp_directory_path() / "does" / "not" / "exist" / "conn.db"};
+    Connection conn(path.string());
+    REQUIRE_FALSE( conn.isOpen() );
+  }
+
+  SECTION("Connection: uses write-ahead logging")
+  {
+    const fs::path path{ fs::temp_directory_path() / "sql_conn_wal.db"};
+    const FileGuard guard{path};
+    {
+      Connection conn(path.string());
+      REQUIRE( conn.isOpen() );
+      REQUIRE( conn.fileName() == path.string() );
+      auto handle = conn.lock();
+      auto& stmt = handle.prepared("PRAGMA journal_mode;");
+      REQUIRE( stmt.get() != nullptr );
+      REQUIRE( sqlite3_step(stmt.get()) == SQLITE_ROW );
+      const std::string mode = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+      REQUIRE( mode == "wal" );
+    }
+  }
+
+  SECTION("Connection: statement cache")
+  {
+    const fs::path path{ fs::temp_directory_path() / "sql_conn_cache.db"};
+    const FileGuard guard{path};
+    {
+      Connection conn(path.string());
+      REQUIRE( conn.isOpen() );
+      {
+        auto handle = conn.lock();
+        REQUIRE( exec(handle.db(), "CREATE TABLE t1 (c1 INT, c2 TEXT);") );
+      }
+      REQUIRE( conn.cachedStatements() == 0 );
+
+      const std::string insert = "INSERT INTO t1 (c1, c2) VALUES (:p1, :p2);";
+      sqlite3_stmt* first = nullptr;
+      for (int64_t i = 1; i <= 3; ++i)
+      {
+        auto handle = conn.lock();
+        auto& stmt = handle.prepared(insert);
+        REQUIRE( stmt.get() != nullptr );
+        if (first == nullptr)
+        {
+          first = stmt.get();
+        }
+        // The same statement is used every time, ...
+        REQUIRE( stmt.get() == first );
+        REQUIRE( bvn::sql::bind(stmt, 1, i) );
+        REQUIRE( bvn::sql::bind(stmt, 2, "foo") );
+        // ... and it is reset after the previous handle was destroyed.
+        REQUIRE( sqlite3_step(stmt.get()) == SQLITE_DONE );
+      }
+      REQUIRE( conn.cachedStatements() == 1 );
+
+      auto handle = conn.lock();
+      auto& count = handle.prepared("SELECT COUNT(*) FROM t1;");
+      REQUIRE( count.get() != nullptr );
+      REQUIRE( sqlite3_step(count.get()) == SQLITE_ROW );
+      REQUIRE( sqlite3_column_int64(count.get(), 0) == 3 );
+    }
+  }
+
+  SECTION("Connection: invalid statement")
+  {
+    const fs::path path{ fs::temp_directory_path() / "sql_conn_invalid.db"};
+    const FileGuard guard{path};
+    {
+      Connection conn(path.string());
+      REQUIRE( conn.isOpen() );
+      auto handle = conn.lock();
+      REQUIRE( handle.prepared("SEL ECT foo FROM bar;").get() == nullptr );
+    }
+  }
 }
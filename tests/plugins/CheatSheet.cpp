@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2021, 2022, 2023, 2024  Dirk Stolle
+    Copyright (C) 2021, 2022, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,9 +20,12 @@
 
 #include "../locate_catch.hpp"
 #include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include "../../src/botvinnik/Bot.hpp"
 #include "../../src/conf/Configuration.hpp"
 #include "../../src/botvinnik/plugins/CheatSheet.hpp"
+#include "../FileGuard.hpp"
 
 TEST_CASE("plugin CheatSheet")
 {
@@ -98,6 +101,12 @@ TEST_CASE("plugin CheatSheet")
       const auto message = plugin.handleCommand("cheat", "cheat a", mockUserId, mockRoomId, ts);
       REQUIRE( message.body.find("at least two characters") != std::string::npos );
     }
+
+    SECTION("topic is missing")
+    {
+      const auto message = plugin.handleCommand("cheat", "cheat", mockUserId, mockRoomId, ts);
+      REQUIRE( message.body.find("at least two characters") != std::string::npos );
+    }
   }
 
   SECTION("handler returns empty message for non-existent command")
@@ -111,6 +120,28 @@ TEST_CASE("plugin CheatSheet")
     REQUIRE( plugin.handleCommand("plonk", "plonk", mockUserId, mockRoomId, ts).formatted_body.empty() );
   }
 
+  SECTION("local cheat sheets are used first")
+  {
+    const std::string_view mockUserId = "@alice:bob.charlie.tld";
+    const std::string_view mockRoomId = "!AbcDeFgHiJk345:bob.charlie.tld";
+    const milliseconds ts = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "bvn-test-cheat-plugin";
+    std::filesystem::create_directory(directory);
+    FileGuard directoryGuard{directory};
+    const std::filesystem::path path = directory / "tar";
+    {
+      std::ofstream stream(path);
+      stream << "# Create an archive:\ntar -cf archive.tar <file>\n";
+    }
+    FileGuard guard{path};
+
+    CheatSheet local(nullptr, directory.string(), std::chrono::seconds::zero());
+    const Message message = local.handleCommand("cheat", "cheat tar", mockUserId, mockRoomId, ts);
+    REQUIRE( message.body == "# Create an archive:\ntar -cf archive.tar <file>\n" );
+    REQUIRE( message.formatted_body == "<pre># Create an archive:\ntar -cf archive.tar &lt;file&gt;\n</pre>" );
+  }
+
   SECTION("plugin registration")
   {
     // Plugin registration must be successful.
@@ -0,0 +1,180 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for botvinnik.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include "../../src/botvinnik/plugins/CheatSheetIndex.hpp"
+#include "../FileGuard.hpp"
+
+// writes content to a file, replacing any previous content
+void writeCheatSheet(const std::filesystem::path& path, const std::string& content)
+{
+  std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  stream.write(content.data(), content.size());
+}
+
+TEST_CASE("CheatSheetIndex")
+{
+  using namespace bvn;
+  namespace fs = std::filesystem;
+
+  const fs::path directory = fs::temp_directory_path() / "bvn-test-cheat-sheets";
+  fs::create_directory(directory);
+  FileGuard directoryGuard{directory};
+
+  SECTION("normalizeTopic")
+  {
+    REQUIRE( CheatSheetIndex::normalizeTopic("") == "" );
+    REQUIRE( CheatSheetIndex::normalizeTopic("tar") == "tar" );
+    REQUIRE( CheatSheetIndex::normalizeTopic("Git Commit") == "git-commit" );
+    REQUIRE( CheatSheetIndex::normalizeTopic("  git \t  commit  ") == "git-commit" );
+    REQUIRE( CheatSheetIndex::normalizeTopic("c++") == "c++" );
+  }
+
+  SECTION("empty directory name disables the index")
+  {
+    CheatSheetIndex index("", std::chrono::seconds(60));
+    REQUIRE( index.size() == 0 );
+    REQUIRE_FALSE( index.find("tar").has_value() );
+  }
+
+  SECTION("directory does not exist")
+  {
+    CheatSheetIndex index((directory / "does-not-exist").string(), std::chrono::seconds(60));
+    REQUIRE( index.size() == 0 );
+    REQUIRE_FALSE( index.find("tar").has_value() );
+  }
+
+  SECTION("cheat sheets and tldr pages")
+  {
+    const fs::path pages = directory / "pages";
+    const fs::path common = pages / "common";
+    const fs::path linuxPages = pages / "linux";
+    const fs::path german = directory / "pages.de";
+    fs::create_directory(pages);
+    fs::create_directory(common);
+    fs::create_directory(linuxPages);
+    fs::create_directory(german);
+    FileGuard pagesGuard{pages};
+    FileGuard commonGuard{common};
+    FileGuard linuxGuard{linuxPages};
+    FileGuard germanGuard{german};
+
+    const fs::path grep = directory / "grep";
+    const fs::path tar = common / "tar.md";
+    const fs::path linuxTar = linuxPages / "tar.md";
+    const fs::path gitCommit = common / "git-commit.md";
+    const fs::path germanLs = german / "ls.md";
+    const fs::path readme = directory / "README.md";
+    const fs::path other = directory / "notes.txt";
+    const fs::path empty = directory / "empty";
+    writeCheatSheet(grep, "grep -r foo .\n");
+    writeCheatSheet(tar, "# tar\n\n> Archiving utility.\n");
+    writeCheatSheet(linuxTar, "# tar (Linux)\n");
+    writeCheatSheet(gitCommit, "# git commit\n");
+    writeCheatSheet(germanLs, "# ls\n");
+    writeCheatSheet(readme, "# Cheat sheets\n");
+    writeCheatSheet(other, "notes\n");
+    writeCheatSheet(empty, "");
+    FileGuard grepGuard{grep};
+    FileGuard tarGuard{tar};
+    FileGuard linuxTarGuard{linuxTar};
+    FileGuard gitCommitGuard{gitCommit};
+    FileGuard germanLsGuard{germanLs};
+    FileGuard readmeGuard{readme};
+    FileGuard otherGuard{other};
+    FileGuard emptyGuard{empty};
+
+    CheatSheetIndex index(directory.string(), std::chrono::seconds::zero());
+    // grep, tar, git-commit and empty
+    REQUIRE( index.size() == 4 );
+    REQUIRE( index.find("grep") == "grep -r foo .\n" );
+    REQUIRE( index.find("GREP") == "grep -r foo .\n" );
+    // pages/common comes before pages/linux.
+    REQUIRE( index.find("tar") == "# tar\n\n> Archiving utility.\n" );
+    REQUIRE( index.find("git commit") == "# git commit\n" );
+    // Translations, README.md and other files are not used.
+    REQUIRE_FALSE( index.find("ls").has_value() );
+    REQUIRE_FALSE( index.find("readme").has_value() );
+    REQUIRE_FALSE( index.find("notes").has_value() );
+    REQUIRE_FALSE( index.find("notes.txt").has_value() );
+    // Empty files are treated as missing.
+    REQUIRE_FALSE( index.find("empty").has_value() );
+    REQUIRE_FALSE( index.find("git").has_value() );
+  }
+
+  SECTION("changed files are read again")
+  {
+    const fs::path path = directory / "sed";
+    writeCheatSheet(path, "old\n");
+    FileGuard guard{path};
+
+    CheatSheetIndex index(directory.string(), std::chrono::seconds(3600));
+    REQUIRE( index.find("sed") == "old\n" );
+
+    writeCheatSheet(path, "new content\n");
+    fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(10));
+    REQUIRE( index.find("sed") == "new content\n" );
+  }
+
+  SECTION("changed size is detected without a new modification time")
+  {
+    const fs::path path = directory / "grep";
+    writeCheatSheet(path, "grep -r pattern .\n");
+    FileGuard guard{path};
+    const auto modified = fs::last_write_time(path);
+
+    CheatSheetIndex index(directory.string(), std::chrono::seconds(3600));
+    REQUIRE( index.find("grep") == "grep -r pattern .\n" );
+
+    // truncated in place, within the resolution of the modification time
+    writeCheatSheet(path, "grep\n");
+    fs::last_write_time(path, modified);
+    REQUIRE( index.find("grep") == "grep\n" );
+  }
+
+  SECTION("removed files are not found any more")
+  {
+    const fs::path path = directory / "awk";
+    writeCheatSheet(path, "awk '{print $1}'\n");
+
+    CheatSheetIndex index(directory.string(), std::chrono::seconds(3600));
+    REQUIRE( index.find("awk").has_value() );
+    fs::remove(path);
+    REQUIRE_FALSE( index.find("awk").has_value() );
+    REQUIRE( index.size() == 0 );
+  }
+
+  SECTION("reload finds new files")
+  {
+    CheatSheetIndex index(directory.string(), std::chrono::seconds(3600));
+    REQUIRE( index.size() == 0 );
+
+    const fs::path path = directory / "find";
+    writeCheatSheet(path, "find . -name '*.cpp'\n");
+    FileGuard guard{path};
+    REQUIRE_FALSE( index.find("find").has_value() );
+
+    index.reload();
+    REQUIRE( index.size() == 1 );
+    REQUIRE( index.find("find") == "find . -name '*.cpp'\n" );
+  }
+}
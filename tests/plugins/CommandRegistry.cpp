@@ -0,0 +1,109 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include "../../src/botvinnik/CommandRegistry.hpp"
+#include "../../src/botvinnik/plugins/Wikipedia.hpp"
+#include "../../src/botvinnik/plugins/convert/Conversion.hpp"
+
+TEST_CASE("CommandRegistry")
+{
+  using namespace bvn;
+
+  Conversion conversion;
+  Wikipedia wikipedia;
+
+  CommandRegistry registry;
+  REQUIRE( registry.empty() );
+  REQUIRE_FALSE( registry.frozen() );
+  for (const auto& cmd: conversion.commands())
+  {
+    REQUIRE( registry.add(cmd, conversion) );
+  }
+  for (const auto& cmd: wikipedia.commands())
+  {
+    REQUIRE( registry.add(cmd, wikipedia) );
+  }
+  const std::size_t count = conversion.commands().size() + wikipedia.commands().size();
+  REQUIRE( registry.size() == count );
+
+  SECTION("duplicate commands are rejected")
+  {
+    REQUIRE_FALSE( registry.add("wiki", conversion) );
+    REQUIRE_FALSE( registry.add("bin2dec", wikipedia) );
+    REQUIRE( registry.size() == count );
+  }
+
+  SECTION("lookup before and after freezing")
+  {
+    for (int i = 0; i < 2; ++i)
+    {
+      for (const auto& cmd: conversion.commands())
+      {
+        REQUIRE( registry.find(cmd) == &conversion );
+      }
+      for (const auto& cmd: wikipedia.commands())
+      {
+        REQUIRE( registry.find(cmd) == &wikipedia );
+      }
+      REQUIRE( registry.find("") == nullptr );
+      REQUIRE( registry.find("wik") == nullptr );
+      REQUIRE( registry.find("wikixx") == nullptr );
+      REQUIRE( registry.find("bin2decimal") == nullptr );
+
+      registry.freeze();
+      REQUIRE( registry.frozen() );
+    }
+  }
+
+  SECTION("lookup with string view into larger string")
+  {
+    registry.freeze();
+    const std::string message = "wikide Berlin";
+    const std::string_view command(message.data(), 6);
+    REQUIRE( registry.find(command) == &wikipedia );
+  }
+
+  SECTION("removal thaws the registry")
+  {
+    registry.freeze();
+    REQUIRE( registry.remove("wikide") );
+    REQUIRE_FALSE( registry.frozen() );
+    REQUIRE_FALSE( registry.remove("wikide") );
+    REQUIRE( registry.find("wikide") == nullptr );
+
+    registry.freeze();
+    REQUIRE( registry.frozen() );
+    REQUIRE( registry.size() == count - 1 );
+    REQUIRE( registry.find("wikide") == nullptr );
+    REQUIRE( registry.find("wikien") == &wikipedia );
+  }
+
+  SECTION("iteration yields all commands")
+  {
+    std::size_t n = 0;
+    for (const auto& item: registry)
+    {
+      REQUIRE( registry.find(item.first) == &item.second.get() );
+      ++n;
+    }
+    REQUIRE( n == count );
+  }
+}
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2020, 2022, 2023, 2024, 2025  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2024, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,9 +20,12 @@
 
 #include "../locate_catch.hpp"
 #include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include "../../src/botvinnik/Bot.hpp"
 #include "../../src/conf/Configuration.hpp"
 #include "../../src/botvinnik/plugins/Debian.hpp"
+#include "../FileGuard.hpp"
 
 TEST_CASE("plugin Debian")
 {
@@ -124,6 +127,33 @@ TEST_CASE("plugin Debian")
     }
   }
 
+  SECTION("local Sources file is used instead of sources.debian.org")
+  {
+    const std::string_view mockUserId = "@alice:bob.charlie.tld";
+    const std::string_view mockRoomId = "!AbcDeFgHiJk345:bob.charlie.tld";
+    const milliseconds ts = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "bvn-test-debian-plugin-sources";
+    {
+      std::ofstream stream(path);
+      stream << "Package: mc\nVersion: 3:4.8.30-1\n\n"
+             << "Package: mcrypt\nVersion: 2.6.8-7\n\n"
+             << "Package: grep\nVersion: 3.11-4\n";
+    }
+    FileGuard guard{path};
+    DebianSources sources({ { "trixie", { path.string() } } }, std::chrono::minutes(60));
+    REQUIRE( sources.refresh() == 1 );
+    Debian local(&sources);
+
+    const auto message = local.handleCommand("deb", "deb MC", mockUserId, mockRoomId, ts);
+    REQUIRE( message.body == "Result for package 'mc' in Debian trixie\n\n"
+                           + std::string("Exact match: mc, version 3:4.8.30-1\n")
+                           + "Other, partial matches:\n* mcrypt, version 2.6.8-7" );
+
+    const auto noMatch = local.handleCommand("deb13", "deb13 waaaaargarblah", mockUserId, mockRoomId, ts);
+    REQUIRE( noMatch.body == "Could not find a matching package for 'waaaaargarblah' in Debian trixie." );
+  }
+
   SECTION("plugin registration")
   {
     // Plugin registration must be successful.
@@ -0,0 +1,93 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for botvinnik.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include "../../src/botvinnik/plugins/DebianSources.hpp"
+#include "../FileGuard.hpp"
+
+TEST_CASE("DebianSources")
+{
+  using namespace bvn;
+  namespace fs = std::filesystem;
+
+  const fs::path path = fs::temp_directory_path() / "bvn-test-sources-trixie";
+  {
+    std::ofstream stream(path, std::ios::out | std::ios::trunc);
+    stream << "Package: mc\nVersion: 3:4.8.30-1\n";
+  }
+  FileGuard guard{path};
+
+  SECTION("no tables before refresh")
+  {
+    DebianSources sources({ { "trixie", { path.string() } } }, std::chrono::minutes(60));
+    REQUIRE( sources.table("trixie") == nullptr );
+  }
+
+  SECTION("refresh builds tables")
+  {
+    DebianSources sources({ { "trixie", { path.string() } } }, std::chrono::minutes(60));
+    REQUIRE( sources.refresh() == 1 );
+    const auto table = sources.table("trixie");
+    REQUIRE( table != nullptr );
+    REQUIRE( table->version("mc") == "3:4.8.30-1" );
+    REQUIRE( sources.table("bookworm") == nullptr );
+
+    SECTION("unchanged files are not read again")
+    {
+      REQUIRE( sources.refresh() == 0 );
+      REQUIRE( sources.table("trixie") == table );
+    }
+
+    SECTION("changed files are read again")
+    {
+      {
+        std::ofstream stream(path, std::ios::out | std::ios::trunc);
+        stream << "Package: mc\nVersion: 3:4.8.33-1\n";
+      }
+      fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(10));
+      REQUIRE( sources.refresh() == 1 );
+      REQUIRE( sources.table("trixie")->version("mc") == "3:4.8.33-1" );
+      // The old table is still usable.
+      REQUIRE( table->version("mc") == "3:4.8.30-1" );
+    }
+  }
+
+  SECTION("missing files keep the previous table")
+  {
+    const fs::path missing = fs::temp_directory_path() / "bvn-test-sources-missing";
+    DebianSources sources({ { "trixie", { path.string() } }, { "forky", { missing.string() } } }, std::chrono::minutes(60));
+    REQUIRE( sources.refresh() == 1 );
+    REQUIRE( sources.table("trixie") != nullptr );
+    REQUIRE( sources.table("forky") == nullptr );
+  }
+
+  SECTION("background thread builds tables")
+  {
+    DebianSources sources({ { "trixie", { path.string() } } }, std::chrono::minutes(60));
+    sources.start();
+    for (int i = 0; (i < 500) && (sources.table("trixie") == nullptr); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE( sources.table("trixie") != nullptr );
+  }
+}
@@ -0,0 +1,144 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for botvinnik.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include "../../src/botvinnik/plugins/DebianSourcesTable.hpp"
+#include "../FileGuard.hpp"
+
+// writes content to a file, replacing any previous content
+void writeSourcesFile(const std::filesystem::path& path, const std::string& content)
+{
+  std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  stream.write(content.data(), content.size());
+}
+
+TEST_CASE("DebianSourcesTable")
+{
+  using namespace bvn;
+  namespace fs = std::filesystem;
+
+  const std::string sources = R"(Package: mc
+Binary: mc, mc-data
+Version: 3:4.8.30-1
+Maintainer: Debian MC Packaging Group <pkg-mc-devel@lists.alioth.debian.org>
+Description: midnight commander
+ A multi-line description
+ with Package: and Version: in it.
+
+Package: mcrypt
+Version: 2.6.8-6
+Extra-Source-Only: yes
+
+Package: mcrypt
+Version: 2.6.8-7
+
+Package: libmcrypt
+Version: 2.5.8-7
+
+Package: grep
+Version: 3.11-4
+
+Package:   zmc  
+Version:  1.0-1  
+)";
+
+  SECTION("empty table")
+  {
+    DebianSourcesTable table;
+    REQUIRE( table.size() == 0 );
+    REQUIRE_FALSE( table.version("mc").has_value() );
+    REQUIRE( table.search("mc").empty() );
+  }
+
+  SECTION("missing file")
+  {
+    const auto table = DebianSourcesTable::build({ (fs::temp_directory_path() / "bvn-test-sources-missing").string() });
+    REQUIRE_FALSE( table.has_value() );
+  }
+
+  SECTION("build from file")
+  {
+    const fs::path path = fs::temp_directory_path() / "bvn-test-sources-table";
+    writeSourcesFile(path, sources);
+    FileGuard guard{path};
+
+    const auto table = DebianSourcesTable::build({ path.string() });
+    REQUIRE( table.has_value() );
+    REQUIRE( table.value().size() == 5 );
+
+    SECTION("exact versions")
+    {
+      REQUIRE( table.value().version("mc") == "3:4.8.30-1" );
+      // Extra source packages are skipped.
+      REQUIRE( table.value().version("mcrypt") == "2.6.8-7" );
+      REQUIRE( table.value().version("libmcrypt") == "2.5.8-7" );
+      REQUIRE( table.value().version("grep") == "3.11-4" );
+      // Whitespace around values is removed, and the last paragraph needs
+      // no blank line.
+      REQUIRE( table.value().version("zmc") == "1.0-1" );
+      REQUIRE_FALSE( table.value().version("m").has_value() );
+      REQUIRE_FALSE( table.value().version("mc-data").has_value() );
+      REQUIRE_FALSE( table.value().version("zzz").has_value() );
+    }
+
+    SECTION("short search text")
+    {
+      const auto found = table.value().search("mc");
+      REQUIRE( found.size() == 4 );
+      REQUIRE( found[0] == DebianSourcesTable::NameVersion("libmcrypt", "2.5.8-7") );
+      REQUIRE( found[1] == DebianSourcesTable::NameVersion("mc", "3:4.8.30-1") );
+      REQUIRE( found[2] == DebianSourcesTable::NameVersion("mcrypt", "2.6.8-7") );
+      REQUIRE( found[3] == DebianSourcesTable::NameVersion("zmc", "1.0-1") );
+    }
+
+    SECTION("search via trigrams")
+    {
+      const auto found = table.value().search("mcrypt");
+      REQUIRE( found.size() == 2 );
+      REQUIRE( found[0].first == "libmcrypt" );
+      REQUIRE( found[1].first == "mcrypt" );
+
+      REQUIRE( table.value().search("rep").size() == 1 );
+      REQUIRE( table.value().search("grep").size() == 1 );
+      // All trigrams exist, but not in one name.
+      REQUIRE( table.value().search("grepmc").empty() );
+      REQUIRE( table.value().search("nothing").empty() );
+      REQUIRE( table.value().search("").empty() );
+    }
+  }
+
+  SECTION("first file wins")
+  {
+    const fs::path first = fs::temp_directory_path() / "bvn-test-sources-main";
+    const fs::path second = fs::temp_directory_path() / "bvn-test-sources-contrib";
+    writeSourcesFile(first, "Package: grep\r\nVersion: 3.11-4\r\n");
+    writeSourcesFile(second, "Package: grep\nVersion: 2.0-1\n\nPackage: sed\nVersion: 4.9-2\n");
+    FileGuard firstGuard{first};
+    FileGuard secondGuard{second};
+
+    const auto table = DebianSourcesTable::build({ first.string(), second.string() });
+    REQUIRE( table.has_value() );
+    REQUIRE( table.value().size() == 2 );
+    REQUIRE( table.value().version("grep") == "3.11-4" );
+    REQUIRE( table.value().version("sed") == "4.9-2" );
+  }
+}
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2020, 2022, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -122,8 +122,15 @@ TEST_CASE("plugin Fortune")
     }
   }
 
-  SECTION("executable path must not be empty")
+  SECTION("no fortune files available")
   {
-    REQUIRE_FALSE( plugin.executableLocation().empty() );
+    const std::string_view mockUserId = "@alice:bob.charlie.tld";
+    const std::string_view mockRoomId = "!AbcDeFgHiJk345:bob.charlie.tld";
+    const milliseconds ts = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
+    Fortune empty(std::vector<std::string>{ });
+
+    const Message msg = empty.handleCommand("fortune", "fortune", mockUserId, mockRoomId, ts);
+    REQUIRE( msg.body.find("Error") != std::string::npos );
+    REQUIRE( msg.body.find("fortunes-min") != std::string::npos );
   }
 }
@@ -0,0 +1,239 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for botvinnik.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include <filesystem>
+#include <fstream>
+#include "../../src/botvinnik/plugins/FortuneDatabase.hpp"
+#include "../FileGuard.hpp"
+
+// writes content to a file, replacing any previous content
+void writeFortuneFile(const std::filesystem::path& path, const std::string& content)
+{
+  std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  stream.write(content.data(), content.size());
+}
+
+// creates the content of a .dat file like strfile does
+std::string strfileTable(const uint32_t flags, const std::vector<uint32_t>& offsets)
+{
+  const auto bigEndian = [](const uint32_t value)
+  {
+    std::string bytes;
+    bytes.push_back(static_cast<char>((value >> 24) & 0xFF));
+    bytes.push_back(static_cast<char>((value >> 16) & 0xFF));
+    bytes.push_back(static_cast<char>((value >> 8) & 0xFF));
+    bytes.push_back(static_cast<char>(value & 0xFF));
+    return bytes;
+  };
+  // version, number of strings, longest and shortest length, flags
+  std::string table = bigEndian(2) + bigEndian(offsets.size() - 1) + bigEndian(11)
+                    + bigEndian(1) + bigEndian(flags);
+  // delimiter and padding
+  table.append("%").append(3, '\0');
+  for (const auto offset: offsets)
+  {
+    table.append(bigEndian(offset));
+  }
+  return table;
+}
+
+TEST_CASE("FortuneDatabase")
+{
+  using namespace bvn;
+  namespace fs = std::filesystem;
+
+  // Three cookies, starting at offsets 0, 4 and 12.
+  const std::string text = "A\n%\nBB bb\n%\nCCC ccc ccc\n%\n";
+  const fs::path directory = fs::temp_directory_path() / "bvn-test-fortunes";
+  fs::create_directory(directory);
+  FileGuard directoryGuard{directory};
+
+  SECTION("empty database")
+  {
+    FortuneDatabase db;
+    REQUIRE( db.size() == 0 );
+    REQUIRE( db.files().empty() );
+    REQUIRE_FALSE( db.random("", 0).has_value() );
+  }
+
+  SECTION("default directories are not empty")
+  {
+    REQUIRE_FALSE( FortuneDatabase::defaultDirectories().empty() );
+  }
+
+  SECTION("file does not exist")
+  {
+    FortuneDatabase db;
+    REQUIRE_FALSE( db.loadFile((directory / "does-not-exist").string()) );
+    REQUIRE( db.size() == 0 );
+  }
+
+  SECTION("file without .dat file gets scanned")
+  {
+    const fs::path path = directory / "plain";
+    writeFortuneFile(path, "First one\nwith two lines\n%\nSecond\n%\n%\nThird without end");
+    FileGuard guard{path};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadFile(path.string()) );
+    REQUIRE( db.size() == 3 );
+    REQUIRE( db.files() == std::vector<std::string>{ "plain" } );
+    REQUIRE( db.random("plain", 6) == "Second" );
+    const auto cookie = db.random("", 17);
+    REQUIRE( ((cookie == "Second") || (cookie == "Third without end")) );
+  }
+
+  SECTION("sequential .dat file")
+  {
+    const fs::path path = directory / "sequential";
+    const fs::path dat = directory / "sequential.dat";
+    writeFortuneFile(path, text);
+    writeFortuneFile(dat, strfileTable(0, { 0, 4, 12, 26 }));
+    FileGuard guard{path};
+    FileGuard datGuard{dat};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadFile(path.string()) );
+    REQUIRE( db.size() == 3 );
+    REQUIRE( db.random("", 1) == "A" );
+    REQUIRE( db.random("sequential", 5).has_value() );
+    REQUIRE( db.random("sequential", 5).value().size() <= 5 );
+    REQUIRE( db.random("", 11).has_value() );
+  }
+
+  SECTION(".dat file with random order")
+  {
+    const fs::path path = directory / "shuffled";
+    const fs::path dat = directory / "shuffled.dat";
+    writeFortuneFile(path, text);
+    writeFortuneFile(dat, strfileTable(0x1, { 12, 0, 4, 26 }));
+    FileGuard guard{path};
+    FileGuard datGuard{dat};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadFile(path.string()) );
+    REQUIRE( db.size() == 3 );
+    REQUIRE( db.random("", 1) == "A" );
+    const auto cookie = db.random("", 5);
+    REQUIRE( ((cookie == "A") || (cookie == "BB bb")) );
+  }
+
+  SECTION("rotated .dat file")
+  {
+    const fs::path path = directory / "rotated";
+    const fs::path dat = directory / "rotated.dat";
+    writeFortuneFile(path, "Uryyb, jbeyq!\n%\n");
+    writeFortuneFile(dat, strfileTable(0x4, { 0, 16 }));
+    FileGuard guard{path};
+    FileGuard datGuard{dat};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadFile(path.string()) );
+    REQUIRE( db.random("rotated", 0) == "Hello, world!" );
+  }
+
+  SECTION("invalid .dat file is ignored")
+  {
+    const fs::path path = directory / "invalid";
+    const fs::path dat = directory / "invalid.dat";
+    writeFortuneFile(path, text);
+    writeFortuneFile(dat, "not a table");
+    FileGuard guard{path};
+    FileGuard datGuard{dat};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadFile(path.string()) );
+    REQUIRE( db.size() == 3 );
+    REQUIRE( db.random("", 1) == "A" );
+  }
+
+  SECTION(".dat file with offsets beyond the text is ignored")
+  {
+    const fs::path path = directory / "beyond";
+    const fs::path dat = directory / "beyond.dat";
+    writeFortuneFile(path, text);
+    writeFortuneFile(dat, strfileTable(0, { 0, 4, 12, 2600 }));
+    FileGuard guard{path};
+    FileGuard datGuard{dat};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadFile(path.string()) );
+    REQUIRE( db.size() == 3 );
+    REQUIRE( db.random("", 1) == "A" );
+  }
+
+  SECTION("filter by file and length")
+  {
+    const fs::path first = directory / "first";
+    const fs::path second = directory / "second";
+    writeFortuneFile(first, text);
+    writeFortuneFile(second, "Zz\n%\n");
+    FileGuard firstGuard{first};
+    FileGuard secondGuard{second};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadFile(first.string()) );
+    REQUIRE( db.loadFile(second.string()) );
+    REQUIRE( db.size() == 4 );
+    REQUIRE( db.random("second", 0) == "Zz" );
+    REQUIRE( db.random("first", 2) == "A" );
+    REQUIRE_FALSE( db.random("second", 1).has_value() );
+    REQUIRE_FALSE( db.random("third", 0).has_value() );
+  }
+
+  SECTION("files with the same name are loaded only once")
+  {
+    const fs::path path = directory / "twice";
+    writeFortuneFile(path, text);
+    FileGuard guard{path};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadFile(path.string()) );
+    REQUIRE_FALSE( db.loadFile(path.string()) );
+    REQUIRE( db.size() == 3 );
+  }
+
+  SECTION("load directory")
+  {
+    const fs::path sub = directory / "off";
+    fs::create_directory(sub);
+    FileGuard subGuard{sub};
+    const fs::path hidden = sub / "hidden";
+    const fs::path beta = directory / "beta";
+    const fs::path alpha = directory / "alpha";
+    const fs::path other = directory / "alpha.u8";
+    writeFortuneFile(hidden, text);
+    writeFortuneFile(beta, text);
+    writeFortuneFile(alpha, "Zz\n%\n");
+    writeFortuneFile(other, text);
+    FileGuard hiddenGuard{hidden};
+    FileGuard betaGuard{beta};
+    FileGuard alphaGuard{alpha};
+    FileGuard otherGuard{other};
+
+    FortuneDatabase db;
+    REQUIRE( db.loadDirectory(directory.string()) == 2 );
+    REQUIRE( db.files() == std::vector<std::string>{ "alpha", "beta" } );
+    REQUIRE( db.size() == 4 );
+
+    REQUIRE( db.loadDirectory((directory / "does-not-exist").string()) == 0 );
+  }
+}
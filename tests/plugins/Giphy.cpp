@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2020, 2023, 2024  Dirk Stolle
+    Copyright (C) 2020, 2023, 2024, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -96,6 +96,44 @@ TEST_CASE("plugin Giphy")
     REQUIRE( plugin.handleCommand("plonk", "plonk", mockUserId, mockRoomId, ts).formatted_body.empty() );
   }
 
+  SECTION("selectRendition")
+  {
+    std::vector<Giphy::Rendition> renditions(4);
+    renditions[0].url = "original";
+    renditions[0].info.size = 9000000;
+    renditions[1].url = "downsized_large";
+    renditions[1].info.size = 4000000;
+    renditions[2].url = "downsized";
+    renditions[2].info.size = 1500000;
+    renditions[3].url = "fixed_width";
+    renditions[3].info.size = 0; // unknown size
+
+    SECTION("no renditions")
+    {
+      REQUIRE_FALSE( Giphy::selectRendition({}, 1000).has_value() );
+    }
+
+    SECTION("unknown limit selects the original")
+    {
+      REQUIRE( Giphy::selectRendition(renditions, -1).value().url == "original" );
+      REQUIRE( Giphy::selectRendition(renditions, 0).value().url == "original" );
+    }
+
+    SECTION("largest rendition that fits is selected")
+    {
+      REQUIRE( Giphy::selectRendition(renditions, 10000000).value().url == "original" );
+      REQUIRE( Giphy::selectRendition(renditions, 9000000).value().url == "original" );
+      REQUIRE( Giphy::selectRendition(renditions, 8999999).value().url == "downsized_large" );
+      REQUIRE( Giphy::selectRendition(renditions, 2000000).value().url == "downsized" );
+    }
+
+    SECTION("nothing fits")
+    {
+      // Rendition of unknown size is not used, it might be too large.
+      REQUIRE_FALSE( Giphy::selectRendition(renditions, 1000000).has_value() );
+    }
+  }
+
   SECTION("plugin registration")
   {
     // Plugin registration must be successful.
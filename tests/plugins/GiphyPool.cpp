@@ -0,0 +1,174 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for botvinnik.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include "../../src/botvinnik/plugins/GiphyPool.hpp"
+
+TEST_CASE("GiphyPool")
+{
+  using namespace bvn;
+
+  std::size_t fetchCount = 0;
+  const GiphyPool::Fetcher fetcher = [&fetchCount](const std::string& keyword) -> std::optional<GiphyPool::Entry>
+  {
+    ++fetchCount;
+    GiphyPool::Entry entry;
+    entry.mxcUri = "mxc://example.org/" + keyword + std::to_string(fetchCount);
+    return entry;
+  };
+
+  GiphyPool::Settings settings;
+  settings.poolSize = 2;
+  settings.keywords = 2;
+  settings.uploadsPerHour = 100;
+
+  SECTION("normalize")
+  {
+    REQUIRE( GiphyPool::normalize("cat") == "cat" );
+    REQUIRE( GiphyPool::normalize("Cat") == "cat" );
+    REQUIRE( GiphyPool::normalize("  happy   CAT ") == "happy cat" );
+    REQUIRE( GiphyPool::normalize("") == "" );
+    REQUIRE( GiphyPool::normalize("   ") == "" );
+  }
+
+  SECTION("keywords need a minimum score to get a pool")
+  {
+    GiphyPool pool(settings, fetcher);
+    pool.recordUse("cat");
+    REQUIRE( pool.topKeywords().empty() );
+
+    pool.recordUse("cat");
+    const auto top = pool.topKeywords();
+    REQUIRE( top.size() == 1 );
+    REQUIRE( top[0] == "cat" );
+  }
+
+  SECTION("ranking is limited to the configured number of keywords")
+  {
+    GiphyPool pool(settings, fetcher);
+    for (int i = 0; i < 3; ++i)
+    {
+      pool.recordUse("dog");
+      pool.recordUse("cat");
+      pool.recordUse("cat");
+      pool.recordUse("bird");
+    }
+    pool.recordUse("dog");
+
+    const auto top = pool.topKeywords();
+    REQUIRE( top.size() == 2 );
+    REQUIRE( top[0] == "cat" );
+    REQUIRE( top[1] == "dog" );
+  }
+
+  SECTION("refill fills pools of popular keywords")
+  {
+    GiphyPool pool(settings, fetcher);
+    pool.recordUse("cat");
+    pool.recordUse("cat");
+    pool.recordUse("dog");
+
+    REQUIRE( pool.available("cat") == 0 );
+    pool.refill();
+    REQUIRE( pool.available("cat") == 2 );
+    REQUIRE( pool.available("dog") == 0 );
+    REQUIRE( fetchCount == 2 );
+
+    // full pools are not fetched again
+    pool.refill();
+    REQUIRE( fetchCount == 2 );
+  }
+
+  SECTION("take returns each GIF only once")
+  {
+    GiphyPool pool(settings, fetcher);
+    pool.recordUse("cat");
+    pool.recordUse("cat");
+    pool.refill();
+
+    const auto first = pool.take("cat");
+    REQUIRE( first.has_value() );
+    const auto second = pool.take("cat");
+    REQUIRE( second.has_value() );
+    REQUIRE( first.value().mxcUri != second.value().mxcUri );
+    REQUIRE_FALSE( pool.take("cat").has_value() );
+    REQUIRE_FALSE( pool.take("dog").has_value() );
+  }
+
+  SECTION("refill respects the hourly budget")
+  {
+    settings.uploadsPerHour = 3;
+    GiphyPool pool(settings, fetcher);
+    pool.recordUse("cat");
+    pool.recordUse("cat");
+    pool.recordUse("dog");
+    pool.recordUse("dog");
+
+    pool.refill();
+    REQUIRE( fetchCount == 3 );
+    REQUIRE( pool.available("cat") + pool.available("dog") == 3 );
+
+    REQUIRE( pool.take("cat").has_value() );
+    pool.refill();
+    REQUIRE( fetchCount == 3 );
+  }
+
+  SECTION("failed fetches leave the pool empty")
+  {
+    const GiphyPool::Fetcher failing = [](const std::string&) -> std::optional<GiphyPool::Entry>
+    {
+      return std::nullopt;
+    };
+    GiphyPool pool(settings, failing);
+    pool.recordUse("cat");
+    pool.recordUse("cat");
+    pool.refill();
+    REQUIRE( pool.available("cat") == 0 );
+  }
+
+  SECTION("pools of keywords that are no longer popular are dropped")
+  {
+    GiphyPool pool(settings, fetcher);
+    pool.recordUse("cat");
+    pool.recordUse("cat");
+    pool.refill();
+    REQUIRE( pool.available("cat") == 2 );
+
+    // 2 * 0.9^3 is below the minimum score
+    for (int i = 0; i < 3; ++i)
+    {
+      pool.decayScores();
+    }
+    REQUIRE( pool.topKeywords().empty() );
+    pool.refill();
+    REQUIRE( pool.available("cat") == 0 );
+  }
+
+  SECTION("start does nothing when the pool is disabled")
+  {
+    settings.poolSize = 0;
+    GiphyPool pool(settings, fetcher);
+    pool.start();
+    pool.recordUse("cat");
+    pool.recordUse("cat");
+    REQUIRE_FALSE( pool.take("cat").has_value() );
+    REQUIRE( fetchCount == 0 );
+  }
+}
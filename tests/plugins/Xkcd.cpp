@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2020, 2022, 2023  Dirk Stolle
+    Copyright (C) 2020, 2022, 2023, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -30,7 +30,8 @@ TEST_CASE("plugin Xkcd")
   using namespace std::chrono;
   Configuration conf;
   Bot bot(conf);
-  Xkcd plugin(bot.matrix());
+  // Without database the tests do not touch the real mirror of the bot.
+  Xkcd plugin(bot.matrix(), "");
 
   const auto commands = plugin.commands();
 
@@ -86,6 +87,17 @@ TEST_CASE("plugin Xkcd")
     }
   }
 
+  SECTION("search words return text")
+  {
+    const std::string_view mockUserId = "@alice:bob.charlie.tld";
+    const std::string_view mockRoomId = "!AbcDeFgHiJk345:bob.charlie.tld";
+    const milliseconds ts = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
+
+    const Message msg = plugin.handleCommand("xkcd", "xkcd velociraptor attack", mockUserId, mockRoomId, ts);
+    REQUIRE_FALSE( msg.body.empty() );
+    REQUIRE_FALSE( msg.formatted_body.empty() );
+  }
+
   SECTION("handler returns empty message for non-existent command")
   {
     const std::string_view mockUserId = "@alice:bob.charlie.tld";
@@ -0,0 +1,125 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for botvinnik.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include <map>
+#include "../../src/botvinnik/plugins/xkcd/XkcdCrawler.hpp"
+#include "../../src/botvinnik/plugins/xkcd/XkcdDb.hpp"
+
+TEST_CASE("plugin Xkcd: XkcdCrawler")
+{
+  using namespace bvn;
+
+  sql::Connection db(":memory:");
+  REQUIRE( XkcdDb::prepareDatabase(db) );
+
+  unsigned int newest = 5;
+  std::map<unsigned int, unsigned int> requests;
+  const XkcdCrawler::Fetcher fetcher = [&newest, &requests](const unsigned int num) -> std::optional<XkcdData>
+  {
+    ++requests[num];
+    const unsigned int real = (num == 0) ? newest : num;
+    // There is no comic #4 in this test, just like there is no #404.
+    if ((real == 4) || (real > newest))
+    {
+      return std::nullopt;
+    }
+    return XkcdData(real, "Comic " + std::to_string(real), "https://example.org/" + std::to_string(real) + ".png", "", "alt");
+  };
+
+  XkcdCrawler::Settings settings;
+  settings.delay = std::chrono::milliseconds(0);
+
+  SECTION("latest comic of empty mirror is unknown")
+  {
+    XkcdCrawler crawler(db, fetcher, settings);
+    REQUIRE( crawler.latest() == 0 );
+  }
+
+  SECTION("crawl adds all available comics")
+  {
+    XkcdCrawler crawler(db, fetcher, settings);
+    REQUIRE( crawler.crawl() == 4 );
+    REQUIRE( crawler.latest() == 5 );
+    REQUIRE( XkcdDb::latestComic(db) == 5 );
+    REQUIRE( XkcdDb::getComic(db, 1).has_value() );
+    REQUIRE( XkcdDb::getComic(db, 3).has_value() );
+    REQUIRE_FALSE( XkcdDb::getComic(db, 4).has_value() );
+  }
+
+  SECTION("later crawls only fetch new comics")
+  {
+    XkcdCrawler crawler(db, fetcher, settings);
+    REQUIRE( crawler.crawl() == 4 );
+    requests.clear();
+
+    newest = 7;
+    REQUIRE( crawler.crawl() == 2 );
+    REQUIRE( crawler.latest() == 7 );
+    REQUIRE( requests.count(6) == 1 );
+    REQUIRE( requests.count(5) == 0 );
+    REQUIRE( requests.count(3) == 0 );
+    REQUIRE( XkcdDb::getComic(db, 6).has_value() );
+  }
+
+  SECTION("latest comic is taken from existing mirror")
+  {
+    REQUIRE( XkcdDb::insertComic(db, XkcdData(3, "Comic 3", "https://example.org/3.png", "", "alt")) );
+    XkcdCrawler crawler(db, fetcher, settings);
+    REQUIRE( crawler.latest() == 3 );
+  }
+
+  SECTION("crawl stops after several failures in a row")
+  {
+    const XkcdCrawler::Fetcher onlyLatest = [&requests](const unsigned int num) -> std::optional<XkcdData>
+    {
+      ++requests[num];
+      if (num == 0)
+      {
+        return XkcdData(100, "Comic 100", "https://example.org/100.png", "", "alt");
+      }
+      return std::nullopt;
+    };
+    XkcdCrawler crawler(db, onlyLatest, settings);
+    REQUIRE( crawler.crawl() == 1 );
+    // one request for the latest comic, then the allowed failures
+    REQUIRE( requests.size() == 1 + XkcdCrawler::max_failures );
+  }
+
+  SECTION("failed request for latest comic adds nothing")
+  {
+    const XkcdCrawler::Fetcher failing = [](const unsigned int) -> std::optional<XkcdData>
+    {
+      return std::nullopt;
+    };
+    XkcdCrawler crawler(db, failing, settings);
+    REQUIRE( crawler.crawl() == 0 );
+    REQUIRE( crawler.latest() == 0 );
+  }
+
+  SECTION("without database only the latest comic is tracked")
+  {
+    sql::Connection closed("");
+    XkcdCrawler crawler(closed, fetcher, settings);
+    REQUIRE( crawler.crawl() == 0 );
+    REQUIRE( crawler.latest() == 5 );
+    REQUIRE( requests.size() == 1 );
+  }
+}
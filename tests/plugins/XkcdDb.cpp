@@ -0,0 +1,165 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for botvinnik.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include "../../src/botvinnik/plugins/xkcd/XkcdDb.hpp"
+
+TEST_CASE("plugin Xkcd: mirror of comic data")
+{
+  using namespace bvn;
+
+  sql::Connection db(":memory:");
+  REQUIRE( XkcdDb::prepareDatabase(db) );
+
+  SECTION("empty mirror")
+  {
+    REQUIRE_FALSE( XkcdDb::getComic(db, 42).has_value() );
+    REQUIRE( XkcdDb::latestComic(db) == 0 );
+    const std::vector<unsigned int> expected = { 3, 2, 1 };
+    REQUIRE( XkcdDb::missingComics(db, 3) == expected );
+    REQUIRE( XkcdDb::missingComics(db, 0).empty() );
+  }
+
+  SECTION("insert and get comic")
+  {
+    const XkcdData data(42, "Geico", "https://imgs.xkcd.com/comics/geico.jpg",
+                        "I just saved a bunch of money.", "David did this");
+    REQUIRE( XkcdDb::insertComic(db, data) );
+
+    const auto comic = XkcdDb::getComic(db, 42);
+    REQUIRE( comic.has_value() );
+    REQUIRE( comic.value().num == 42 );
+    REQUIRE( comic.value().title == "Geico" );
+    REQUIRE( comic.value().img == "https://imgs.xkcd.com/comics/geico.jpg" );
+    REQUIRE( comic.value().transcript == "I just saved a bunch of money." );
+    REQUIRE( comic.value().alt == "David did this" );
+    REQUIRE( XkcdDb::latestComic(db) == 42 );
+  }
+
+  SECTION("insert replaces existing data")
+  {
+    REQUIRE( XkcdDb::insertComic(db, XkcdData(7, "Girl sleeping", "https://example.org/7.jpg", "", "alt")) );
+    REQUIRE( XkcdDb::insertComic(db, XkcdData(7, "Girl sleeping", "https://example.org/7.jpg", "transcript", "alt")) );
+
+    const auto comic = XkcdDb::getComic(db, 7);
+    REQUIRE( comic.has_value() );
+    REQUIRE( comic.value().transcript == "transcript" );
+  }
+
+  SECTION("missing comics are listed newest first")
+  {
+    for (const unsigned int num: { 2u, 3u, 5u, 9u })
+    {
+      REQUIRE( XkcdDb::insertComic(db, XkcdData(num, "title", "https://example.org/img.png", "", "alt")) );
+    }
+
+    const std::vector<unsigned int> expected = { 10, 8, 7, 6, 4, 1 };
+    REQUIRE( XkcdDb::missingComics(db, 10) == expected );
+
+    const std::vector<unsigned int> expectedBelow = { 4, 1 };
+    REQUIRE( XkcdDb::missingComics(db, 4) == expectedBelow );
+  }
+
+  SECTION("match expression quotes every word")
+  {
+    REQUIRE( XkcdDb::matchExpression("") == "" );
+    REQUIRE( XkcdDb::matchExpression("  \t ") == "" );
+    REQUIRE( XkcdDb::matchExpression("compiling") == "\"compiling\"" );
+    REQUIRE( XkcdDb::matchExpression(" exploits  of a\tmom ") == "\"exploits\" OR \"of\" OR \"a\" OR \"mom\"" );
+    REQUIRE( XkcdDb::matchExpression("NOT \"a*") == "\"NOT\" OR \"\"\"a*\"" );
+  }
+
+  SECTION("search for comics")
+  {
+    REQUIRE( XkcdDb::prepareSearchIndex(db) );
+    REQUIRE( XkcdDb::insertComic(db, XkcdData(303, "Compiling", "https://example.org/303.png",
+                                 "Two programmers sword-fighting on office chairs.", "'Are you stealing those LCDs?' 'Yeah, but I'm doing it while my code compiles.'")) );
+    REQUIRE( XkcdDb::insertComic(db, XkcdData(327, "Exploits of a Mom", "https://example.org/327.png",
+                                 "Hi, this is your son's school. We're having some computer trouble.", "Her daughter is named Help I'm trapped in a driver's license factory.")) );
+    REQUIRE( XkcdDb::insertComic(db, XkcdData(149, "Sandwich", "https://example.org/149.png",
+                                 "Make me a sandwich. What? Make it yourself. Sudo make me a sandwich. Okay.", "Proper User Policy apparently means Simon Says.")) );
+
+    SECTION("title match")
+    {
+      const auto found = XkcdDb::searchComic(db, "compiling");
+      REQUIRE( found.has_value() );
+      REQUIRE( found.value() == 303 );
+    }
+
+    SECTION("matches are case-insensitive")
+    {
+      const auto found = XkcdDb::searchComic(db, "SANDWICH");
+      REQUIRE( found.has_value() );
+      REQUIRE( found.value() == 149 );
+    }
+
+    SECTION("title matches rank higher than transcript matches")
+    {
+      REQUIRE( XkcdDb::insertComic(db, XkcdData(400, "Lunch", "https://example.org/400.png",
+                                   "A sandwich, a sandwich, another sandwich.", "alt")) );
+      const auto found = XkcdDb::searchComic(db, "sandwich");
+      REQUIRE( found.has_value() );
+      REQUIRE( found.value() == 149 );
+    }
+
+    SECTION("comic matching more words wins")
+    {
+      const auto found = XkcdDb::searchComic(db, "school computer make");
+      REQUIRE( found.has_value() );
+      REQUIRE( found.value() == 327 );
+    }
+
+    SECTION("special characters do not break the query")
+    {
+      REQUIRE_NOTHROW( XkcdDb::searchComic(db, "\"unbalanced OR ( NEAR* -") );
+      const auto found = XkcdDb::searchComic(db, "(compiling)");
+      REQUIRE( found.has_value() );
+      REQUIRE( found.value() == 303 );
+    }
+
+    SECTION("no match")
+    {
+      REQUIRE_FALSE( XkcdDb::searchComic(db, "velociraptor").has_value() );
+      REQUIRE_FALSE( XkcdDb::searchComic(db, "   ").has_value() );
+    }
+
+    SECTION("updated comics are indexed again")
+    {
+      REQUIRE( XkcdDb::insertComic(db, XkcdData(303, "Compiling", "https://example.org/303.png",
+                                   "Velociraptor attack.", "alt")) );
+      const auto found = XkcdDb::searchComic(db, "velociraptor");
+      REQUIRE( found.has_value() );
+      REQUIRE( found.value() == 303 );
+      REQUIRE_FALSE( XkcdDb::searchComic(db, "sword").has_value() );
+    }
+  }
+
+  SECTION("search index includes comics that were stored before")
+  {
+    REQUIRE( XkcdDb::insertComic(db, XkcdData(10, "Pi Equals", "https://example.org/10.png", "", "My most famous drawing")) );
+    REQUIRE( XkcdDb::prepareSearchIndex(db) );
+    // Preparing the index again must not duplicate anything.
+    REQUIRE( XkcdDb::prepareSearchIndex(db) );
+
+    const auto found = XkcdDb::searchComic(db, "famous");
+    REQUIRE( found.has_value() );
+    REQUIRE( found.value() == 10 );
+  }
+}
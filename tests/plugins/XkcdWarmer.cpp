@@ -0,0 +1,139 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the test suite for botvinnik.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+#include "../locate_catch.hpp"
+#include <vector>
+#include "../../src/botvinnik/plugins/xkcd/XkcdDb.hpp"
+#include "../../src/botvinnik/plugins/xkcd/XkcdWarmer.hpp"
+
+TEST_CASE("plugin Xkcd: XkcdWarmer")
+{
+  using namespace bvn;
+
+  sql::Connection db(":memory:");
+  REQUIRE( XkcdDb::prepareDatabase(db) );
+  for (unsigned int num = 1; num <= 4; ++num)
+  {
+    REQUIRE( XkcdDb::insertComic(db, XkcdData(num, "Comic " + std::to_string(num), "https://example.org/" + std::to_string(num) + ".png", "", "alt")) );
+  }
+  REQUIRE( XkcdDb::insertMxcUri(db, 2, "mxc://example.org/2") );
+
+  std::vector<unsigned int> uploads;
+  const XkcdWarmer::Uploader uploader = [&db, &uploads](const XkcdData& data)
+  {
+    uploads.push_back(data.num);
+    return XkcdDb::insertMxcUri(db, data.num, "mxc://example.org/" + std::to_string(data.num));
+  };
+  const XkcdWarmer::IdleCheck alwaysIdle = [](const std::chrono::milliseconds&) { return true; };
+
+  XkcdWarmer::Settings settings;
+  settings.uploadsPerHour = 60;
+
+  SECTION("comic without upload")
+  {
+    const auto comic = XkcdDb::comicWithoutUpload(db, 1000);
+    REQUIRE( comic.has_value() );
+    REQUIRE( comic.value().num == 4 );
+    REQUIRE( comic.value().img == "https://example.org/4.png" );
+
+    const auto below = XkcdDb::comicWithoutUpload(db, 3);
+    REQUIRE( below.has_value() );
+    REQUIRE( below.value().num == 1 );
+
+    REQUIRE_FALSE( XkcdDb::comicWithoutUpload(db, 1).has_value() );
+  }
+
+  SECTION("uploads newest comics first and skips uploaded ones")
+  {
+    XkcdWarmer warmer(db, uploader, alwaysIdle, settings);
+    REQUIRE( warmer.warmOne() );
+    REQUIRE( warmer.warmOne() );
+    REQUIRE( warmer.warmOne() );
+    REQUIRE_FALSE( warmer.warmOne() );
+
+    const std::vector<unsigned int> expected = { 4, 3, 1 };
+    REQUIRE( uploads == expected );
+    REQUIRE( XkcdDb::getMxcUri(db, 1).has_value() );
+  }
+
+  SECTION("failed uploads are tried again after the other comics")
+  {
+    const XkcdWarmer::Uploader failsForThree = [&db, &uploads](const XkcdData& data)
+    {
+      uploads.push_back(data.num);
+      if (data.num == 3)
+      {
+        return false;
+      }
+      return XkcdDb::insertMxcUri(db, data.num, "mxc://example.org/" + std::to_string(data.num));
+    };
+    XkcdWarmer warmer(db, failsForThree, alwaysIdle, settings);
+    REQUIRE( warmer.warmOne() );
+    REQUIRE_FALSE( warmer.warmOne() );
+    REQUIRE( warmer.warmOne() );
+    REQUIRE_FALSE( warmer.warmOne() );
+
+    const std::vector<unsigned int> expected = { 4, 3, 1, 3 };
+    REQUIRE( uploads == expected );
+  }
+
+  SECTION("interval between uploads")
+  {
+    {
+      XkcdWarmer warmer(db, uploader, alwaysIdle, settings);
+      REQUIRE( warmer.interval() == std::chrono::minutes(1) );
+    }
+
+    settings.uploadsPerHour = 7;
+    {
+      XkcdWarmer warmer(db, uploader, alwaysIdle, settings);
+      REQUIRE( warmer.interval() == std::chrono::milliseconds(514285) );
+    }
+
+    settings.uploadsPerHour = 1;
+    {
+      XkcdWarmer warmer(db, uploader, alwaysIdle, settings);
+      REQUIRE( warmer.interval() == std::chrono::hours(1) );
+    }
+
+    settings.uploadsPerHour = 0;
+    XkcdWarmer warmer(db, uploader, alwaysIdle, settings);
+    REQUIRE( warmer.interval() == std::chrono::milliseconds::zero() );
+  }
+
+  SECTION("start does nothing when the warmer is disabled")
+  {
+    settings.uploadsPerHour = 0;
+    XkcdWarmer warmer(db, uploader, alwaysIdle, settings);
+    warmer.start();
+    REQUIRE( uploads.empty() );
+  }
+
+  SECTION("destructor stops the background thread quickly")
+  {
+    const auto start = std::chrono::steady_clock::now();
+    {
+      XkcdWarmer warmer(db, uploader, alwaysIdle, settings);
+      warmer.start();
+    }
+    REQUIRE( std::chrono::steady_clock::now() - start < std::chrono::seconds(5) );
+    REQUIRE( uploads.empty() );
+  }
+}
@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2020, 2021, 2022, 2023, 2024, 2025  Dirk Stolle
+    Copyright (C) 2020, 2021, 2022, 2023, 2024, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -56,7 +56,7 @@ TEST_CASE("plugin registration for all known plugins")
   Ping ping(std::chrono::milliseconds(2345));
   Weather weather;
   Wikipedia wiki;
-  Xkcd xkcd(bot.matrix());
+  Xkcd xkcd(bot.matrix(), "");
 
   SECTION("plugin registration")
   {
@@ -86,9 +86,10 @@ TEST_CASE("plugin registration failures")
   {
     class NoCommands final : public DeactivatablePlugin
     {
-      std::vector<std::string> commands() const override
+      const std::vector<std::string>& commands() const override
       {
-        return { };
+        static const std::vector<std::string> cmds = { };
+        return cmds;
       }
 
       Message handleCommand([[maybe_unused]] const std::string_view& command,
@@ -122,9 +123,10 @@ TEST_CASE("plugin registration failures")
   {
     class EmptyCommand : public DeactivatablePlugin
     {
-      std::vector<std::string> commands() const override
+      const std::vector<std::string>& commands() const override
       {
-        return { "" };
+        static const std::vector<std::string> cmds = { "" };
+        return cmds;
       }
 
       Message handleCommand([[maybe_unused]] const std::string_view& command,
@@ -158,9 +160,10 @@ TEST_CASE("plugin registration failures")
   {
     class DoubleCommand final : public DeactivatablePlugin
     {
-      std::vector<std::string> commands() const override
+      const std::vector<std::string>& commands() const override
       {
-        return { "foo", "bar" };
+        static const std::vector<std::string> cmds = { "foo", "bar" };
+        return cmds;
       }
 
       Message handleCommand([[maybe_unused]] const std::string_view& command,
@@ -0,0 +1,198 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "../../locate_catch.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include "../../../src/botvinnik/plugins/weather/ForecastBatcher.hpp"
+#include "../../../src/util/Deadline.hpp"
+
+TEST_CASE("plugin Weather: ForecastBatcher")
+{
+  using namespace bvn;
+  using namespace std::chrono_literals;
+
+  std::atomic<int> calls = 0;
+  std::atomic<std::size_t> largest = 0;
+  const auto fetcher = [&calls, &largest](const std::vector<Location>& locations)
+      -> nonstd::expected<std::vector<WeatherData>, std::string>
+  {
+    ++calls;
+    if (locations.size() > largest)
+    {
+      largest = locations.size();
+    }
+    std::vector<WeatherData> result;
+    for (const auto& location: locations)
+    {
+      WeatherData data;
+      data.current.temperature_celsius = location.latitude;
+      result.push_back(data);
+    }
+    return result;
+  };
+
+  const auto locationAt = [](const int i)
+  {
+    Location location;
+    location.latitude = i;
+    location.longitude = i;
+    return location;
+  };
+
+  SECTION("single request")
+  {
+    ForecastBatcher batcher(fetcher, 10ms);
+    const auto result = batcher.get(locationAt(5));
+    REQUIRE( result.has_value() );
+    REQUIRE( result.value().current.temperature_celsius == 5.0 );
+    REQUIRE( calls == 1 );
+  }
+
+  SECTION("concurrent requests are batched")
+  {
+    ForecastBatcher batcher(fetcher, 200ms);
+    std::vector<std::future<ForecastBatcher::Result>> results;
+    for (int i = 0; i < 8; ++i)
+    {
+      results.push_back(std::async(std::launch::async, [&batcher, &locationAt, i]()
+      {
+        return batcher.get(locationAt(i));
+      }));
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+      const auto result = results[i].get();
+      REQUIRE( result.has_value() );
+      // Each caller gets the data for its own location.
+      REQUIRE( result.value().current.temperature_celsius == static_cast<double>(i) );
+    }
+    REQUIRE( calls == 1 );
+    REQUIRE( largest == 8 );
+  }
+
+  SECTION("batch size is limited")
+  {
+    ForecastBatcher batcher(fetcher, 200ms, 3);
+    std::vector<std::future<ForecastBatcher::Result>> results;
+    for (int i = 0; i < 7; ++i)
+    {
+      results.push_back(std::async(std::launch::async, [&batcher, &locationAt, i]()
+      {
+        return batcher.get(locationAt(i));
+      }));
+    }
+    for (auto& result: results)
+    {
+      REQUIRE( result.get().has_value() );
+    }
+    REQUIRE( calls >= 3 );
+    REQUIRE( largest <= 3 );
+  }
+
+  SECTION("errors are passed to all callers")
+  {
+    ForecastBatcher batcher([&calls](const std::vector<Location>&)
+        -> nonstd::expected<std::vector<WeatherData>, std::string>
+    {
+      ++calls;
+      return nonstd::make_unexpected(std::string("Request failed."));
+    }, 100ms);
+    auto other = std::async(std::launch::async, [&batcher, &locationAt]()
+    {
+      return batcher.get(locationAt(2));
+    });
+    const auto result = batcher.get(locationAt(1));
+    REQUIRE_FALSE( result.has_value() );
+    REQUIRE( result.error() == "Request failed." );
+    const auto otherResult = other.get();
+    REQUIRE_FALSE( otherResult.has_value() );
+    REQUIRE( otherResult.error() == "Request failed." );
+  }
+
+  SECTION("exceptions are passed to all callers")
+  {
+    ForecastBatcher batcher([&calls](const std::vector<Location>&)
+        -> nonstd::expected<std::vector<WeatherData>, std::string>
+    {
+      ++calls;
+      throw std::runtime_error("Request failed.");
+    }, 100ms);
+    auto other = std::async(std::launch::async, [&batcher, &locationAt]()
+    {
+      return batcher.get(locationAt(2));
+    });
+    REQUIRE_THROWS_AS( batcher.get(locationAt(1)), std::runtime_error );
+    REQUIRE_THROWS_AS( other.get(), std::runtime_error );
+    REQUIRE( calls == 1 );
+  }
+
+  SECTION("request uses the latest deadline of the batch")
+  {
+    std::atomic<bool> expired = true;
+    std::atomic<bool> limited = true;
+    ForecastBatcher batcher([&calls, &expired, &limited](const std::vector<Location>& locations)
+        -> nonstd::expected<std::vector<WeatherData>, std::string>
+    {
+      ++calls;
+      const Deadline deadline = Deadline::current();
+      expired = deadline.expired();
+      limited = deadline.limited();
+      return std::vector<WeatherData>(locations.size());
+    }, 100ms);
+
+    SECTION("caller without time limit")
+    {
+      auto other = std::async(std::launch::async, [&batcher, &locationAt]()
+      {
+        std::this_thread::sleep_for(20ms);
+        return batcher.get(locationAt(2));
+      });
+      // The deadline of the first caller expires within the batch window.
+      const Deadline short_deadline(30ms);
+      Deadline::Scope scope(short_deadline);
+      REQUIRE( batcher.get(locationAt(1)).has_value() );
+      REQUIRE( other.get().has_value() );
+      REQUIRE( calls == 1 );
+      REQUIRE_FALSE( expired );
+      REQUIRE_FALSE( limited );
+    }
+
+    SECTION("callers with time limits")
+    {
+      auto other = std::async(std::launch::async, [&batcher, &locationAt]()
+      {
+        const Deadline long_deadline(5000ms);
+        Deadline::Scope scope(long_deadline);
+        std::this_thread::sleep_for(20ms);
+        return batcher.get(locationAt(2));
+      });
+      const Deadline short_deadline(30ms);
+      Deadline::Scope scope(short_deadline);
+      REQUIRE( batcher.get(locationAt(1)).has_value() );
+      REQUIRE( other.get().has_value() );
+      REQUIRE( calls == 1 );
+      REQUIRE_FALSE( expired );
+      REQUIRE( limited );
+    }
+  }
+}
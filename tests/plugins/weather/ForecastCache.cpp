@@ -0,0 +1,221 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "../../locate_catch.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include "../../../src/botvinnik/plugins/weather/ForecastCache.hpp"
+
+TEST_CASE("plugin Weather: ForecastCache")
+{
+  using namespace bvn;
+  using namespace std::chrono_literals;
+
+  std::atomic<int> calls = 0;
+  const auto fetcher = [&calls](const Location& location) -> ForecastCache::Result
+  {
+    ++calls;
+    std::this_thread::sleep_for(50ms);
+    WeatherData data;
+    data.current.temperature_celsius = location.latitude;
+    data.current.apparent_temperature = location.longitude;
+    data.current.relative_humidity = calls;
+    return data;
+  };
+
+  Location berlin;
+  berlin.latitude = 52.5170365;
+  berlin.longitude = 13.3888599;
+  berlin.name = "Berlin";
+  berlin.display_name = "Berlin, Deutschland";
+
+  ThreadPool pool(4);
+
+  SECTION("gridPoint()")
+  {
+    const Location point = ForecastCache::gridPoint(berlin);
+    REQUIRE( point.latitude == 52.5 );
+    REQUIRE( point.longitude == 13.4 );
+    REQUIRE( point.name == "Berlin" );
+
+    Location south;
+    south.latitude = -33.8688;
+    south.longitude = -151.2093;
+    REQUIRE( ForecastCache::gridPoint(south).latitude == -33.9 );
+    REQUIRE( ForecastCache::gridPoint(south).longitude == -151.2 );
+  }
+
+  SECTION("location without coordinates")
+  {
+    ForecastCache cache(fetcher);
+    const auto result = cache.get(Location(), pool);
+    REQUIRE_FALSE( result.has_value() );
+    REQUIRE( calls == 0 );
+  }
+
+  SECTION("data is fetched once for nearby locations")
+  {
+    ForecastCache cache(fetcher);
+    const auto first = cache.get(berlin, pool);
+    REQUIRE( first.has_value() );
+    // Data is requested for the grid point.
+    REQUIRE( first.value().current.temperature_celsius == 52.5 );
+    REQUIRE( first.value().current.apparent_temperature == 13.4 );
+
+    Location nearby = berlin;
+    nearby.latitude = 52.53;
+    nearby.longitude = 13.41;
+    const auto second = cache.get(nearby, pool);
+    REQUIRE( second.has_value() );
+    REQUIRE( calls == 1 );
+    REQUIRE( cache.size() == 1 );
+
+    Location hamburg;
+    hamburg.latitude = 53.55;
+    hamburg.longitude = 9.99;
+    REQUIRE( cache.get(hamburg, pool).has_value() );
+    REQUIRE( calls == 2 );
+    REQUIRE( cache.size() == 2 );
+  }
+
+  SECTION("concurrent requests share one fetch")
+  {
+    ForecastCache cache(fetcher);
+    std::vector<std::future<ForecastCache::Result>> results;
+    for (int i = 0; i < 20; ++i)
+    {
+      results.push_back(std::async(std::launch::async, [&cache, &berlin, &pool]()
+      {
+        return cache.get(berlin, pool);
+      }));
+    }
+    for (auto& result: results)
+    {
+      REQUIRE( result.get().has_value() );
+    }
+    REQUIRE( calls == 1 );
+  }
+
+  SECTION("errors are not cached")
+  {
+    ForecastCache cache([&calls](const Location&) -> ForecastCache::Result
+    {
+      ++calls;
+      return nonstd::make_unexpected(std::string("Request failed."));
+    });
+    REQUIRE_FALSE( cache.get(berlin, pool).has_value() );
+    REQUIRE_FALSE( cache.get(berlin, pool).has_value() );
+    REQUIRE( calls == 2 );
+    REQUIRE( cache.size() == 0 );
+  }
+
+  SECTION("stale data is returned and refreshed in the background")
+  {
+    ForecastCache cache(fetcher, std::chrono::seconds(1), std::chrono::seconds(3600));
+    const auto first = cache.get(berlin, pool);
+    REQUIRE( first.has_value() );
+    REQUIRE( first.value().current.relative_humidity == 1 );
+
+    // wait for the end of the update interval
+    std::this_thread::sleep_for(1100ms);
+    const auto stale = cache.get(berlin, pool);
+    REQUIRE( stale.has_value() );
+    REQUIRE( stale.value().current.relative_humidity == 1 );
+
+    // wait for the background refresh
+    for (int i = 0; (i < 100) && (calls < 2); ++i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+    std::this_thread::sleep_for(100ms);
+    REQUIRE( calls == 2 );
+    const auto fresh = cache.get(berlin, pool);
+    REQUIRE( fresh.has_value() );
+    REQUIRE( fresh.value().current.relative_humidity == 2 );
+  }
+
+  SECTION("stale data is refreshed by a pool without threads")
+  {
+    ThreadPool inlinePool(0);
+    ForecastCache cache(fetcher, std::chrono::seconds(1), std::chrono::seconds(3600));
+    REQUIRE( cache.get(berlin, inlinePool).has_value() );
+    REQUIRE( calls == 1 );
+
+    // wait for the end of the update interval
+    std::this_thread::sleep_for(1100ms);
+    const auto stale = cache.get(berlin, inlinePool);
+    REQUIRE( stale.has_value() );
+    REQUIRE( stale.value().current.relative_humidity == 1 );
+    // The refresh is done before get() returns.
+    REQUIRE( calls == 2 );
+
+    const auto refreshed = cache.get(berlin, inlinePool);
+    REQUIRE( refreshed.has_value() );
+    REQUIRE( refreshed.value().current.relative_humidity >= 2 );
+  }
+
+  SECTION("exception of the fetch function")
+  {
+    const auto throwing = [&calls, &fetcher](const Location& location) -> ForecastCache::Result
+    {
+      if (calls == 0)
+      {
+        ++calls;
+        throw std::runtime_error("Request failed.");
+      }
+      return fetcher(location);
+    };
+
+    SECTION("next request tries again")
+    {
+      ForecastCache cache(throwing);
+      REQUIRE_THROWS_AS( cache.get(berlin, pool), std::runtime_error );
+      REQUIRE( cache.size() == 0 );
+
+      const auto result = cache.get(berlin, pool);
+      REQUIRE( result.has_value() );
+      REQUIRE( calls == 2 );
+    }
+
+    SECTION("failed refresh keeps stale data and ends")
+    {
+      ThreadPool inlinePool(0);
+      ForecastCache cache(throwing, std::chrono::seconds(1), std::chrono::seconds(3600));
+      // let the first call throw during the refresh
+      calls = 1;
+      REQUIRE( cache.get(berlin, inlinePool).has_value() );
+      REQUIRE( calls == 2 );
+      calls = 0;
+
+      // wait for the end of the update interval
+      std::this_thread::sleep_for(1100ms);
+      const auto stale = cache.get(berlin, inlinePool);
+      REQUIRE( stale.has_value() );
+      REQUIRE( calls == 1 );
+
+      // The failed refresh has ended, so the next request starts another one.
+      const auto retry = cache.get(berlin, inlinePool);
+      REQUIRE( retry.has_value() );
+      REQUIRE( calls == 2 );
+    }
+  }
+}
@@ -0,0 +1,169 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "../../locate_catch.hpp"
+#include <cstdio>
+#include <filesystem>
+#include "../../../src/botvinnik/plugins/weather/GeocodeCache.hpp"
+#include "../../../src/botvinnik/plugins/weather/LocationLookup.hpp"
+
+TEST_CASE("plugin Weather: GeocodeCache")
+{
+  using namespace bvn;
+
+  Location berlin;
+  berlin.latitude = 52.5170365;
+  berlin.longitude = 13.3888599;
+  berlin.name = "Berlin";
+  berlin.display_name = "Berlin, Deutschland";
+
+  SECTION("normalize()")
+  {
+    REQUIRE( GeocodeCache::normalize("") == "" );
+    REQUIRE( GeocodeCache::normalize("   ") == "" );
+    REQUIRE( GeocodeCache::normalize("Berlin") == "berlin" );
+    REQUIRE( GeocodeCache::normalize("  New   York ") == "new york" );
+    REQUIRE( GeocodeCache::normalize("Frankfurt\tam Main") == "frankfurt am main" );
+    // non-ASCII characters stay as they are
+    REQUIRE( GeocodeCache::normalize("MÜNCHEN") == "mÜnchen" );
+  }
+
+  SECTION("memory only")
+  {
+    GeocodeCache cache("");
+    REQUIRE( cache.size() == 0 );
+    REQUIRE_FALSE( cache.get("Berlin").has_value() );
+
+    SECTION("found location")
+    {
+      cache.put("Berlin", berlin);
+      REQUIRE( cache.size() == 1 );
+
+      const auto entry = cache.get("  berlin ");
+      REQUIRE( entry.has_value() );
+      REQUIRE( entry.value().has_value() );
+      REQUIRE( entry.value().value().name == "Berlin" );
+      REQUIRE( entry.value().value().display_name == "Berlin, Deutschland" );
+      REQUIRE( entry.value().value().latitude == berlin.latitude );
+      REQUIRE( entry.value().value().longitude == berlin.longitude );
+    }
+
+    SECTION("location that does not exist is cached")
+    {
+      cache.put("Nowhere", nonstd::make_unexpected(LocationLookup::not_found));
+      REQUIRE( cache.size() == 1 );
+
+      const auto entry = cache.get("nowhere");
+      REQUIRE( entry.has_value() );
+      REQUIRE_FALSE( entry.value().has_value() );
+      REQUIRE( entry.value().error() == LocationLookup::not_found );
+    }
+
+    SECTION("other errors are not cached")
+    {
+      cache.put("Berlin", nonstd::make_unexpected(std::string("Request failed.")));
+      REQUIRE( cache.size() == 0 );
+      REQUIRE_FALSE( cache.get("Berlin").has_value() );
+    }
+  }
+
+  SECTION("least recently used entries are evicted")
+  {
+    GeocodeCache cache("", 2);
+    cache.put("Berlin", berlin);
+    cache.put("Nowhere", nonstd::make_unexpected(LocationLookup::not_found));
+    REQUIRE( cache.size() == 2 );
+
+    // Using Berlin makes "Nowhere" the least recently used entry.
+    REQUIRE( cache.get("Berlin").has_value() );
+    cache.put("Berlin Mitte", berlin);
+    REQUIRE( cache.size() == 2 );
+
+    REQUIRE_FALSE( cache.get("Nowhere").has_value() );
+    REQUIRE( cache.get("Berlin").has_value() );
+    REQUIRE( cache.get("Berlin Mitte").has_value() );
+  }
+
+  SECTION("entries persist in database")
+  {
+    const auto fileName = (std::filesystem::temp_directory_path() / "bvn-test-geocode.db").string();
+    std::remove(fileName.c_str());
+
+    {
+      GeocodeCache cache(fileName);
+      REQUIRE( cache.size() == 0 );
+      cache.put("Berlin", berlin);
+      cache.put("Nowhere", nonstd::make_unexpected(LocationLookup::not_found));
+      REQUIRE( cache.size() == 2 );
+    }
+
+    GeocodeCache cache(fileName);
+    REQUIRE( cache.size() == 2 );
+
+    const auto entry = cache.get("BERLIN");
+    REQUIRE( entry.has_value() );
+    REQUIRE( entry.value().has_value() );
+    REQUIRE( entry.value().value().name == "Berlin" );
+    REQUIRE( entry.value().value().display_name == "Berlin, Deutschland" );
+    REQUIRE( entry.value().value().latitude == berlin.latitude );
+    REQUIRE( entry.value().value().longitude == berlin.longitude );
+
+    const auto missing = cache.get("nowhere");
+    REQUIRE( missing.has_value() );
+    REQUIRE_FALSE( missing.value().has_value() );
+
+    std::remove(fileName.c_str());
+  }
+
+  SECTION("evicted entries are removed from database")
+  {
+    const auto fileName = (std::filesystem::temp_directory_path() / "bvn-test-geocode-evict.db").string();
+    std::remove(fileName.c_str());
+
+    {
+      GeocodeCache cache(fileName, 2);
+      cache.put("Berlin", berlin);
+      cache.put("Nowhere", nonstd::make_unexpected(LocationLookup::not_found));
+      cache.put("Berlin Mitte", berlin);
+      REQUIRE( cache.size() == 2 );
+    }
+
+    {
+      GeocodeCache cache(fileName, 10);
+      REQUIRE( cache.size() == 2 );
+      REQUIRE_FALSE( cache.get("Berlin").has_value() );
+      REQUIRE( cache.get("Nowhere").has_value() );
+      REQUIRE( cache.get("Berlin Mitte").has_value() );
+    }
+
+    // A smaller limit drops the surplus entries when the cache is loaded.
+    {
+      GeocodeCache cache(fileName, 1);
+      REQUIRE( cache.size() == 1 );
+    }
+    GeocodeCache cache(fileName, 10);
+    REQUIRE( cache.size() == 1 );
+    // The found location expires later than the unknown name.
+    REQUIRE( cache.get("Berlin Mitte").has_value() );
+
+    std::remove(fileName.c_str());
+  }
+}
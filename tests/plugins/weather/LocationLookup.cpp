@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2024, 2025  Dirk Stolle
+    Copyright (C) 2024, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -20,6 +20,9 @@
 
 #include "../../locate_catch.hpp"
 #include "../../../src/botvinnik/plugins/weather/LocationLookup.hpp"
+#include "../../../src/botvinnik/plugins/weather/LocationLookupOpenMeteo.hpp"
+#include "../../../src/botvinnik/plugins/weather/LocationLookupOpenStreetMap.hpp"
+#include "../../../src/net/CircuitBreaker.hpp"
 
 TEST_CASE("plugin Weather: generic location lookup")
 {
@@ -75,4 +78,50 @@ TEST_CASE("plugin Weather: generic location lookup")
       REQUIRE( display_name_match );
     }
   }
+
+  SECTION("find_location with thread pool")
+  {
+    ThreadPool pool(2);
+
+    SECTION("attempt to find location that does not exist")
+    {
+      const auto location = LocationLookup::find_location("Waaaaaaargablah", pool);
+
+      REQUIRE_FALSE( location.has_value() );
+      REQUIRE( location.error() == "No matching location was found." );
+    }
+
+    SECTION("find existing location")
+    {
+      const auto location = LocationLookup::find_location("Leipzig", pool);
+
+      REQUIRE( location.has_value() );
+      const auto data = location.value();
+
+      REQUIRE( data.latitude >= 50.9 );
+      REQUIRE( data.latitude <= 51.7 );
+
+      REQUIRE( data.longitude >= 12.0 );
+      REQUIRE( data.longitude <= 12.6 );
+
+      REQUIRE( data.name == "Leipzig" );
+      REQUIRE( data.display_name == "Leipzig, Saxony, Germany" );
+    }
+
+    SECTION("repeated races keep both hosts available")
+    {
+      // The loser of each race gets cancelled, which must not open its
+      // circuit, although there are more races than the minimum number of
+      // requests of the circuit breaker.
+      for (unsigned int i = 0; i < 6; ++i)
+      {
+        const auto location = LocationLookup::find_location("Leipzig", pool);
+        REQUIRE( location.has_value() );
+      }
+
+      auto& breaker = CircuitBreaker::upstreams();
+      REQUIRE( breaker.state(LocationLookupOpenStreetMap::host) == CircuitBreaker::State::closed );
+      REQUIRE( breaker.state(LocationLookupOpenMeteo::host) == CircuitBreaker::State::closed );
+    }
+  }
 }
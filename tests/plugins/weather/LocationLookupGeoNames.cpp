@@ -0,0 +1,135 @@
+/*
+ -------------------------------------------------------------------------------
+    This file is part of the botvinnik Matrix bot.
+    Copyright (C) 2026  Dirk Stolle
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ -------------------------------------------------------------------------------
+*/
+
+
+#include "../../locate_catch.hpp"
+#include <cmath>
+#include <fstream>
+#include "../../FileGuard.hpp"
+#include "../../../src/botvinnik/plugins/weather/LocationLookup.hpp"
+#include "../../../src/botvinnik/plugins/weather/LocationLookupGeoNames.hpp"
+
+TEST_CASE("plugin Weather: LocationLookupGeoNames")
+{
+  using namespace bvn;
+
+  // small excerpt in the format of the GeoNames dump files
+  const std::string fixture =
+      "2950159\tBerlin\tBerlin\tBER,Berlin,Berlino,Berlín,Berlijn\t52.52437\t13.41053\tP\tPPLC\tDE\t\t16\t00\t11000\t11000000\t3426354\t74\t43\tEurope/Berlin\t2022-05-11\n"
+      "5083330\tBerlin\tBerlin\tBerlin\t44.46867\t-71.18508\tP\tPPL\tUS\t\tNH\t007\t\t\t10051\t311\t310\tAmerica/New_York\t2017-05-23\n"
+      "4717560\tParis\tParis\t\t33.66094\t-95.55551\tP\tPPLA2\tUS\t\tTX\t277\t\t\t25171\t183\t182\tAmerica/Chicago\t2017-03-09\r\n"
+      "2988507\tParis\tParis\tLutece,Paname,Pariisi,Parigi,Parîs\t48.85341\t2.3488\tP\tPPLC\tFR\t\t11\t75\t751\t75056\t2138551\t\t42\tEurope/Paris\t2023-02-15\r\n"
+      "2867714\tMunich\tMunich\tMonaco di Baviera,Muenchen,München,Munchen\t48.13743\t11.57549\tP\tPPLA\tDE\t\t02\t091\t09162\t09162000\t1260391\t524\t525\tEurope/Berlin\t2023-10-12\n"
+      "this line is broken\n"
+      "2911298\tHamburg\tHamburg\t\t53,55073\t10.00000\tP\tPPLA\tDE\t\t04\t00\t02000\t02000000\t9999999\t\t8\tEurope/Berlin\t2024-01-01\n"
+      "2911299\tHamburg\tHamburg\t\t53.55073\t9.99302\tP\tPPLA\tDE\t\t04\t00\t02000\t02000000\t1845229\t\t8\tEurope/Berlin\t2024-01-01\n"
+      "2944388\tBremen\tBremen\t\t53.07516\t8.80777x\tP\tPPLA\tDE\t\t03\t00\t04011\t04011000\t546501\t\t11\tEurope/Berlin\t2024-01-01\n"
+      "6559559\tNew  York\tNew York\t\t40.71427\t-74.00597\tP\tPPL\tUS\t\tNY\t\t\t\t8804190\t10\t57\tAmerica/New_York\t2024-03-19";
+
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "bvn-test-cities.txt";
+  {
+    std::ofstream stream(path, std::ios::out | std::ios::binary);
+    stream.write(fixture.c_str(), fixture.size());
+    REQUIRE( stream.good() );
+  }
+  FileGuard guard{path};
+
+  SECTION("empty index finds nothing")
+  {
+    LocationLookupGeoNames lookup;
+    REQUIRE( lookup.size() == 0 );
+    const auto location = lookup.find_location("Berlin");
+    REQUIRE_FALSE( location.has_value() );
+    REQUIRE( location.error() == LocationLookup::not_found );
+  }
+
+  SECTION("load fails for missing file")
+  {
+    LocationLookupGeoNames lookup;
+    REQUIRE_FALSE( lookup.load((std::filesystem::temp_directory_path() / "bvn-test-does-not-exist.txt").string()) );
+  }
+
+  LocationLookupGeoNames lookup;
+  REQUIRE( lookup.load(path.string()) );
+  // Berlin (DE): 5 distinct names, Berlin (US): 1, Paris (US): 1,
+  // Paris (FR): 6, Munich: 5, Hamburg: 1 + 1, Bremen: 1, New York: 1
+  REQUIRE( lookup.size() == 22 );
+
+  SECTION("place with largest population wins")
+  {
+    const auto berlin = lookup.find_location("Berlin");
+    REQUIRE( berlin.has_value() );
+    REQUIRE( berlin.value().name == "Berlin" );
+    REQUIRE( berlin.value().display_name == "Berlin, DE" );
+    REQUIRE( std::fabs(berlin.value().latitude - 52.52437) < 0.000001 );
+    REQUIRE( std::fabs(berlin.value().longitude - 13.41053) < 0.000001 );
+
+    const auto paris = lookup.find_location("paris");
+    REQUIRE( paris.has_value() );
+    REQUIRE( paris.value().display_name == "Paris, FR" );
+    REQUIRE( std::fabs(paris.value().latitude - 48.85341) < 0.000001 );
+    REQUIRE( std::fabs(paris.value().longitude - 2.3488) < 0.000001 );
+  }
+
+  SECTION("alternate names")
+  {
+    const auto munich = lookup.find_location("München");
+    REQUIRE( munich.has_value() );
+    REQUIRE( munich.value().name == "Munich" );
+    REQUIRE( munich.value().display_name == "Munich, DE" );
+
+    const auto muenchen = lookup.find_location("  MUENCHEN ");
+    REQUIRE( muenchen.has_value() );
+    REQUIRE( muenchen.value().name == "Munich" );
+
+    const auto parigi = lookup.find_location("Parigi");
+    REQUIRE( parigi.has_value() );
+    REQUIRE( parigi.value().display_name == "Paris, FR" );
+  }
+
+  SECTION("whitespace in names is normalized")
+  {
+    const auto location = lookup.find_location("new york");
+    REQUIRE( location.has_value() );
+    REQUIRE( location.value().name == "New  York" );
+    REQUIRE( std::fabs(location.value().longitude + 74.00597) < 0.000001 );
+  }
+
+  SECTION("lines with malformed coordinates are skipped")
+  {
+    // The line with the larger population has a decimal comma.
+    const auto hamburg = lookup.find_location("Hamburg");
+    REQUIRE( hamburg.has_value() );
+    REQUIRE( std::fabs(hamburg.value().latitude - 53.55073) < 0.000001 );
+    REQUIRE( std::fabs(hamburg.value().longitude - 9.99302) < 0.000001 );
+
+    // The only line for Bremen has trailing garbage in the longitude.
+    const auto bremen = lookup.find_location("Bremen");
+    REQUIRE_FALSE( bremen.has_value() );
+    REQUIRE( bremen.error() == LocationLookup::not_found );
+  }
+
+  SECTION("unknown place")
+  {
+    const auto location = lookup.find_location("Atlantis");
+    REQUIRE_FALSE( location.has_value() );
+    REQUIRE( location.error() == LocationLookup::not_found );
+  }
+}
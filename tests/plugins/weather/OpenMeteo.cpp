@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2024, 2025  Dirk Stolle
+    Copyright (C) 2024, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -163,6 +163,80 @@ TEST_CASE("plugin Weather: weather data from Open-Meteo")
       REQUIRE( weather.forecast[6].temperature_min == 14.4 );
     }
 
+    SECTION("parse batch response for several locations")
+    {
+      const std::string json = R"json(
+      [
+        {
+          "latitude": 52.52, "longitude": 13.419998,
+          "current": {
+            "time": "2024-04-18T01:00", "interval": 900,
+            "temperature_2m": 3.7, "relative_humidity_2m": 88,
+            "apparent_temperature": 0.9, "precipitation": 0, "weather_code": 0,
+            "surface_pressure": 1007, "wind_speed_10m": 6.8, "wind_direction_10m": 18
+          },
+          "daily": {
+            "time": [ "2024-04-24", "2024-04-25" ],
+            "weather_code": [ 80, 3 ],
+            "temperature_2m_max": [ 9.5, 9.9 ],
+            "temperature_2m_min": [ 3.3, 1.5 ]
+          }
+        },
+        {
+          "latitude": 48.86, "longitude": 2.35,
+          "current": {
+            "time": "2024-04-18T01:00", "interval": 900,
+            "temperature_2m": 8.2, "relative_humidity_2m": 71,
+            "apparent_temperature": 6.5, "precipitation": 0.2, "weather_code": 61,
+            "surface_pressure": 1012, "wind_speed_10m": 11.3, "wind_direction_10m": 250
+          },
+          "daily": {
+            "time": [ "2024-04-24", "2024-04-25" ],
+            "weather_code": [ 61, 2 ],
+            "temperature_2m_max": [ 12.5, 14.0 ],
+            "temperature_2m_min": [ 6.1, 5.8 ]
+          }
+        }
+      ]
+      )json";
+
+      const auto data = OpenMeteo::parse_batch_response(json, 2);
+      REQUIRE( data.has_value() );
+      REQUIRE( data.value().size() == 2 );
+      REQUIRE( data.value()[0].current.temperature_celsius == 3.7 );
+      REQUIRE( data.value()[0].forecast.size() == 2 );
+      REQUIRE( data.value()[0].forecast[0].weather_code == 80 );
+      REQUIRE( data.value()[1].current.temperature_celsius == 8.2 );
+      REQUIRE( data.value()[1].current.weather_code == 61 );
+      REQUIRE( data.value()[1].forecast.size() == 2 );
+      REQUIRE( data.value()[1].forecast[1].temperature_max == 14.0 );
+
+      SECTION("failure: number of elements does not match")
+      {
+        const auto wrong = OpenMeteo::parse_batch_response(json, 3);
+        REQUIRE_FALSE( wrong.has_value() );
+        REQUIRE( wrong.error() == "Open-Meteo request returned invalid JSON: Number of elements does not match the number of locations!" );
+      }
+    }
+
+    SECTION("failure: batch response is not an array")
+    {
+      const std::string json = "{ \"latitude\": 52.52 }";
+
+      const auto data = OpenMeteo::parse_batch_response(json, 2);
+      REQUIRE_FALSE( data.has_value() );
+      REQUIRE( data.error() == "Open-Meteo request returned invalid JSON: Root element is not an array!" );
+    }
+
+    SECTION("failure: batch response contains element that is not an object")
+    {
+      const std::string json = "[ 1, 2 ]";
+
+      const auto data = OpenMeteo::parse_batch_response(json, 2);
+      REQUIRE_FALSE( data.has_value() );
+      REQUIRE( data.error() == "Open-Meteo request returned invalid JSON: Array element is not an object!" );
+    }
+
     SECTION("failure: response is not valid JSON")
     {
       const std::string json = "{\"generationtime_ms\":0.47898293";
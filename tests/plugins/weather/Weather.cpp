@@ -1,7 +1,7 @@
 /*
  -------------------------------------------------------------------------------
     This file is part of the test suite for botvinnik.
-    Copyright (C) 2024, 2025  Dirk Stolle
+    Copyright (C) 2024, 2025, 2026  Dirk Stolle
 
     This program is free software: you can redistribute it and/or modify
     it under the terms of the GNU General Public License as published by
@@ -43,7 +43,7 @@ TEST_CASE("plugin Weather")
   using namespace std::chrono;
   Configuration conf;
   Bot bot(conf);
-  Weather plugin;
+  Weather plugin("");
 
   const auto commands = plugin.commands();
 
@@ -117,6 +117,29 @@ TEST_CASE("plugin Weather")
     }
   }
 
+  SECTION("command handler: return error message when too many locations are given")
+  {
+    const std::string_view mockUserId = "@alice:bob.charlie.tld";
+    const std::string_view mockRoomId = "!AbcDeFgHiJk345:bob.charlie.tld";
+    const milliseconds ts = duration_cast<milliseconds>(system_clock::now().time_since_epoch());
+    for (const auto& cmd : commands)
+    {
+      const auto message = cmd + " A; B; C; D; E; F";
+      const auto response = plugin.handleCommand(cmd, message, mockUserId, mockRoomId, ts);
+      REQUIRE( response.body.find("Please enter at most 5 locations") != std::string::npos );
+    }
+  }
+
+  SECTION("splitLocations()")
+  {
+    REQUIRE( Weather::splitLocations("").empty() );
+    REQUIRE( Weather::splitLocations(" ; ;").empty() );
+    REQUIRE( Weather::splitLocations("Berlin") == std::vector<std::string>{ "Berlin" } );
+    REQUIRE( Weather::splitLocations("New York") == std::vector<std::string>{ "New York" } );
+    const std::vector<std::string> expected = { "Berlin", "Paris", "Rome" };
+    REQUIRE( Weather::splitLocations("Berlin; Paris;Rome ;") == expected );
+  }
+
   SECTION("command handler: return error message when location cannot be found")
   {
     const std::string_view mockUserId = "@alice:bob.charlie.tld";